@@ -34,6 +34,7 @@
 #include <string>
 #include <tuple>
 #include <unordered_map>
+#include <utility>
 #include <vector>
 
 #include "AL/al.h"
@@ -297,6 +298,7 @@ void FreeEffectSlot(ALCcontext *context, ALeffectslot *slot)
     const size_t lidx{id >> 6};
     const ALuint slidx{id & 0x3f};
 
+    slot->removeFromDirtyList(context);
     std::destroy_at(slot);
 
     context->mEffectSlotList[lidx].FreeMask |= 1_u64 << slidx;
@@ -311,7 +313,7 @@ inline void UpdateProps(ALeffectslot *slot, ALCcontext *context)
         slot->updateProps(context);
         return;
     }
-    slot->mPropsDirty = true;
+    slot->markPropsDirty(context);
 }
 
 } // namespace
@@ -565,9 +567,14 @@ try {
 
         if(slot->mState == SlotState::Playing)
         {
-            EffectStateFactory *factory{getFactoryByType(slot->Effect.Type)};
-            assert(factory);
-            al::intrusive_ptr<EffectState> state{factory->create()};
+            al::intrusive_ptr<EffectState> state{
+                context->mEffectStatePool.acquire(slot->Effect.Type)};
+            if(!state)
+            {
+                EffectStateFactory *factory{getFactoryByType(slot->Effect.Type)};
+                assert(factory);
+                state = factory->create();
+            }
 
             ALCdevice *device{context->mALDevice.get()};
             auto bufferlock = std::unique_lock{device->BufferLock};
@@ -628,7 +635,7 @@ try {
             FPUCtl mixer_mode{};
             auto *state = slot->Effect.State.get();
             state->deviceUpdate(device, buffer);
-            slot->mPropsDirty = true;
+            slot->markPropsDirty(context);
         }
         return;
 
@@ -852,12 +859,51 @@ catch(al::context_error& e) {
 }
 
 
-ALeffectslot::ALeffectslot(ALCcontext *context)
+EffectStatePool::EffectStatePool()
+{
+    /* Reserve the space up front, so giving back states never allocates. */
+    for(auto &states : mStates)
+        states.reserve(MaxPooledStates);
+}
+
+auto EffectStatePool::acquire(EffectSlotType type) -> al::intrusive_ptr<EffectState>
 {
-    EffectStateFactory *factory{getFactoryByType(EffectSlotType::None)};
-    if(!factory) throw std::runtime_error{"Failed to get null effect factory"};
+    auto poollock = std::lock_guard{mLock};
+    auto &states = mStates[al::to_underlying(type)];
+    if(states.empty())
+        return nullptr;
+    auto state = std::move(states.back());
+    states.pop_back();
+    return state;
+}
+
+void EffectStatePool::release(EffectSlotType type, al::intrusive_ptr<EffectState> state) noexcept
+{
+    /* Convolution states keep a reference to their buffer's prepared filter,
+     * which shouldn't be held on to while idle.
+     */
+    if(!state || type == EffectSlotType::Convolution)
+        return;
+
+    /* If the pool is full, the state gets deleted on return, after the lock
+     * is released.
+     */
+    auto poollock = std::lock_guard{mLock};
+    auto &states = mStates[al::to_underlying(type)];
+    if(states.size() < MaxPooledStates)
+        states.emplace_back(std::move(state));
+}
+
 
-    al::intrusive_ptr<EffectState> state{factory->create()};
+ALeffectslot::ALeffectslot(ALCcontext *context)
+{
+    al::intrusive_ptr<EffectState> state{context->mEffectStatePool.acquire(EffectSlotType::None)};
+    if(!state)
+    {
+        EffectStateFactory *factory{getFactoryByType(EffectSlotType::None)};
+        if(!factory) throw std::runtime_error{"Failed to get null effect factory"};
+        state = factory->create();
+    }
     Effect.State = state;
 
     mSlot = context->getEffectSlot();
@@ -893,7 +939,8 @@ ALenum ALeffectslot::initEffect(ALuint effectId, ALenum effectType, const Effect
             ERR("Failed to find factory for effect slot type %d\n", static_cast<int>(newtype));
             return AL_INVALID_ENUM;
         }
-        al::intrusive_ptr<EffectState> state{factory->create()};
+        al::intrusive_ptr<EffectState> state{context->mEffectStatePool.acquire(newtype)};
+        if(!state) state = factory->create();
 
         ALCdevice *device{context->mALDevice.get()};
         state->mOutTarget = device->Dry.Buffer;
@@ -969,6 +1016,51 @@ void ALeffectslot::SetName(ALCcontext* context, ALuint id, std::string_view name
     context->mEffectSlotNames.insert_or_assign(id, name);
 }
 
+void ALeffectslot::markPropsDirty(ALCcontext *context) noexcept
+{
+    mPropsDirty = true;
+    if(!mInDirtyList)
+    {
+        mNextDirty = std::exchange(context->mDirtySlots, this);
+        if(mNextDirty)
+            mNextDirty->mPrevDirty = this;
+        mPrevDirty = nullptr;
+        mInDirtyList = true;
+    }
+}
+
+void ALeffectslot::removeFromDirtyList(ALCcontext *context) noexcept
+{
+    if(!mInDirtyList)
+        return;
+
+    if(mPrevDirty)
+        mPrevDirty->mNextDirty = mNextDirty;
+    else
+        context->mDirtySlots = mNextDirty;
+    if(mNextDirty)
+        mNextDirty->mPrevDirty = mPrevDirty;
+    mNextDirty = nullptr;
+    mPrevDirty = nullptr;
+    mInDirtyList = false;
+}
+
+void UpdateDirtyEffectSlotProps(ALCcontext *context)
+{
+    std::lock_guard<std::mutex> slotlock{context->mEffectSlotLock};
+    ALeffectslot *slot{std::exchange(context->mDirtySlots, nullptr)};
+    while(slot)
+    {
+        ALeffectslot *next{std::exchange(slot->mNextDirty, nullptr)};
+        slot->mPrevDirty = nullptr;
+        slot->mInDirtyList = false;
+
+        if(std::exchange(slot->mPropsDirty, false))
+            slot->updateProps(context);
+        slot = next;
+    }
+}
+
 void UpdateAllEffectSlotProps(ALCcontext *context)
 {
     std::lock_guard<std::mutex> slotlock{context->mEffectSlotLock};
@@ -1453,7 +1545,7 @@ void ALeffectslot::eax_set_efx_slot_effect(EaxEffect &effect)
         return;
     }
 
-    mPropsDirty = true;
+    markPropsDirty(eax_al_context_);
 
 #undef EAX_PREFIX
 }
@@ -1464,7 +1556,7 @@ void ALeffectslot::eax_set_efx_slot_send_auto(bool is_send_auto)
         return;
 
     AuxSendAuto = is_send_auto;
-    mPropsDirty = true;
+    markPropsDirty(eax_al_context_);
 }
 
 void ALeffectslot::eax_set_efx_slot_gain(ALfloat gain)
@@ -1477,7 +1569,7 @@ void ALeffectslot::eax_set_efx_slot_gain(ALfloat gain)
         ERR(EAX_PREFIX "Gain out of range (%f)\n", gain);
 
     Gain = std::clamp(gain, 0.0f, 1.0f);
-    mPropsDirty = true;
+    markPropsDirty(eax_al_context_);
 
 #undef EAX_PREFIX
 }
@@ -4,8 +4,10 @@
 #include <array>
 #include <atomic>
 #include <cstdint>
+#include <mutex>
 #include <string_view>
 #include <utility>
+#include <vector>
 
 #include "AL/al.h"
 #include "AL/alc.h"
@@ -41,6 +43,28 @@ enum class SlotState : bool {
     Initial, Playing,
 };
 
+/* Effect states that are no longer used, kept per effect type so an effect
+ * slot changing effects can reuse one instead of constructing a new state. A
+ * reused state is still re-initialized with deviceUpdate, which may allocate.
+ */
+class EffectStatePool {
+    static constexpr size_t MaxPooledStates{4};
+    static constexpr size_t NumTypes{static_cast<size_t>(EffectSlotType::Max) + 1};
+
+    std::mutex mLock;
+    std::array<std::vector<al::intrusive_ptr<EffectState>>,NumTypes> mStates;
+
+public:
+    EffectStatePool();
+
+    /* Takes an idle state of the given type, or returns null if none. */
+    auto acquire(EffectSlotType type) -> al::intrusive_ptr<EffectState>;
+    /* Gives back a state of the given type that no longer has any other
+     * references. It's deleted if the pool for its type is full.
+     */
+    void release(EffectSlotType type, al::intrusive_ptr<EffectState> state) noexcept;
+};
+
 struct ALeffectslot {
     ALuint EffectId{};
     float Gain{1.0f};
@@ -57,6 +81,10 @@ struct ALeffectslot {
     EffectData Effect;
 
     bool mPropsDirty{true};
+    /* Links in the context's list of dirty slots, when mInDirtyList is set. */
+    bool mInDirtyList{false};
+    ALeffectslot *mNextDirty{nullptr};
+    ALeffectslot *mPrevDirty{nullptr};
 
     SlotState mState{SlotState::Initial};
 
@@ -76,6 +104,14 @@ struct ALeffectslot {
         ALCcontext *context);
     void updateProps(ALCcontext *context) const;
 
+    /**
+     * Flags the slot as having property changes, adding it to the context's
+     * dirty list to apply with the next update commit.
+     */
+    void markPropsDirty(ALCcontext *context) noexcept;
+    /** Removes the slot from the context's dirty list, if it's in it. */
+    void removeFromDirtyList(ALCcontext *context) noexcept;
+
     static void SetName(ALCcontext *context, ALuint id, std::string_view name);
 
 
@@ -359,6 +395,7 @@ public:
 };
 
 void UpdateAllEffectSlotProps(ALCcontext *context);
+void UpdateDirtyEffectSlotProps(ALCcontext *context);
 
 #ifdef ALSOFT_EAX
 using EaxAlEffectSlotUPtr = std::unique_ptr<ALeffectslot, ALeffectslot::EaxDeleter>;
@@ -33,7 +33,6 @@
 #include <limits>
 #include <memory>
 #include <mutex>
-#include <numeric>
 #include <optional>
 #include <stdexcept>
 #include <string>
@@ -178,20 +177,25 @@ constexpr ALbitfieldSOFT INVALID_MAP_FLAGS{~unsigned(AL_MAP_READ_BIT_SOFT | AL_M
 
 auto EnsureBuffers(ALCdevice *device, size_t needed) noexcept -> bool
 try {
-    size_t count{std::accumulate(device->BufferList.cbegin(), device->BufferList.cend(), 0_uz,
-        [](size_t cur, const BufferSubList &sublist) noexcept -> size_t
-        { return cur + static_cast<ALuint>(al::popcount(sublist.FreeMask)); })};
+    static constexpr auto SubListSize = std::tuple_size_v<SubListAllocator::value_type>;
+    size_t count{device->BufferList.size()*SubListSize - device->NumBuffers};
 
     while(needed > count)
     {
         if(device->BufferList.size() >= 1<<25) UNLIKELY
             return false;
 
+        /* Make sure the free list can hold every sublist, so freeing a buffer
+         * never needs to allocate.
+         */
+        device->FreeBufferSubLists.reserve(device->BufferList.size()+1);
+
         BufferSubList sublist{};
         sublist.FreeMask = ~0_u64;
         sublist.Buffers = SubListAllocator{}.allocate(1);
         device->BufferList.emplace_back(std::move(sublist));
-        count += std::tuple_size_v<SubListAllocator::value_type>;
+        device->FreeBufferSubLists.emplace_back(static_cast<ALuint>(device->BufferList.size()-1));
+        count += SubListSize;
     }
     return true;
 }
@@ -199,23 +203,37 @@ catch(...) {
     return false;
 }
 
-ALbuffer *AllocBuffer(ALCdevice *device) noexcept
+/* Allocates a buffer for each of the given IDs, taking as many as it can from
+ * each free sublist at once. EnsureBuffers must have been called first.
+ */
+void AllocBuffers(ALCdevice *device, const al::span<ALuint> bids) noexcept
 {
-    auto sublist = std::find_if(device->BufferList.begin(), device->BufferList.end(),
-        [](const BufferSubList &entry) noexcept -> bool
-        { return entry.FreeMask != 0; });
-    auto lidx = static_cast<ALuint>(std::distance(device->BufferList.begin(), sublist));
-    auto slidx = static_cast<ALuint>(al::countr_zero(sublist->FreeMask));
-    ASSUME(slidx < 64);
+    auto bididx = bids.begin();
+    while(bididx != bids.end())
+    {
+        const ALuint lidx{device->FreeBufferSubLists.back()};
+        BufferSubList &sublist = device->BufferList[lidx];
 
-    ALbuffer *buffer{al::construct_at(al::to_address(sublist->Buffers->begin() + slidx))};
+        uint64_t freemask{sublist.FreeMask};
+        ASSUME(freemask != 0);
+        do {
+            const auto slidx = static_cast<ALuint>(al::countr_zero(freemask));
+            ASSUME(slidx < 64);
+            freemask &= freemask - 1;
 
-    /* Add 1 to avoid buffer ID 0. */
-    buffer->id = ((lidx<<6) | slidx) + 1;
+            ALbuffer *buffer{al::construct_at(al::to_address(sublist.Buffers->begin() + slidx))};
 
-    sublist->FreeMask &= ~(1_u64 << slidx);
+            /* Add 1 to avoid buffer ID 0. */
+            buffer->id = ((lidx<<6) | slidx) + 1;
+            *(bididx++) = buffer->id;
 
-    return buffer;
+            device->NumBuffers += 1;
+        } while(freemask != 0 && bididx != bids.end());
+
+        sublist.FreeMask = freemask;
+        if(!freemask)
+            device->FreeBufferSubLists.pop_back();
+    }
 }
 
 void FreeBuffer(ALCdevice *device, ALbuffer *buffer)
@@ -232,7 +250,11 @@ void FreeBuffer(ALCdevice *device, ALbuffer *buffer)
 
     std::destroy_at(buffer);
 
-    device->BufferList[lidx].FreeMask |= 1_u64 << slidx;
+    BufferSubList &sublist = device->BufferList[lidx];
+    if(!sublist.FreeMask)
+        device->FreeBufferSubLists.emplace_back(static_cast<ALuint>(lidx));
+    sublist.FreeMask |= 1_u64 << slidx;
+    device->NumBuffers -= 1;
 }
 
 auto LookupBuffer(ALCdevice *device, ALuint id) noexcept -> ALbuffer*
@@ -675,7 +697,7 @@ try {
         throw al::context_error{AL_OUT_OF_MEMORY, "Failed to allocate %d buffer%s", n,
             (n == 1) ? "" : "s"};
 
-    std::generate(bids.begin(), bids.end(), [device]{ return AllocBuffer(device)->id; });
+    AllocBuffers(device, bids);
 }
 catch(al::context_error& e) {
     context->setError(e.errorCode(), "%s", e.what());
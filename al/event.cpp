@@ -68,9 +68,10 @@ int EventThread(ALCcontext *context)
 
             auto enabledevts = context->mEnabledEvts.load(std::memory_order_acquire);
             auto proc_killthread = [](AsyncKillThread&) { };
-            auto proc_release = [](AsyncEffectReleaseEvent &evt)
+            auto proc_release = [context](AsyncEffectReleaseEvent &evt)
             {
-                al::intrusive_ptr<EffectState>{evt.mEffectState};
+                context->mEffectStatePool.release(evt.mType,
+                    al::intrusive_ptr<EffectState>{evt.mEffectState});
             };
             auto proc_srcstate = [context,enabledevts](AsyncSourceStateEvent &evt)
             {
@@ -23,7 +23,10 @@
 #include "listener.h"
 
 #include <algorithm>
+#include <chrono>
+#include <cinttypes>
 #include <cmath>
+#include <cstdint>
 #include <mutex>
 
 #include "AL/al.h"
@@ -111,6 +114,7 @@ try {
         listener.Position[0] = value1;
         listener.Position[1] = value2;
         listener.Position[2] = value3;
+        listener.mHasMotion = false;
         CommitAndUpdateProps(context);
         return;
 
@@ -161,6 +165,7 @@ try {
         /* AT then UP */
         std::copy_n(vals.cbegin(), 3, listener.OrientAt.begin());
         std::copy_n(vals.cbegin()+3, 3, listener.OrientUp.begin());
+        listener.mHasMotion = false;
         CommitAndUpdateProps(context);
         return;
     }
@@ -170,6 +175,35 @@ catch(al::context_error& e) {
     context->setError(e.errorCode(), "%s", e.what());
 }
 
+AL_API DECL_FUNCEXT2(void, alListenerMotionfv,SOFT, ALint64SOFT,pose_time, const ALfloat*,values)
+FORCE_ALIGN void AL_APIENTRY alListenerMotionfvDirectSOFT(ALCcontext *context,
+    ALint64SOFT pose_time, const ALfloat *values) noexcept
+try {
+    if(pose_time < 0)
+        throw al::context_error{AL_INVALID_VALUE, "Invalid pose time %" PRId64, pose_time};
+    if(!values)
+        throw al::context_error{AL_INVALID_VALUE, "NULL pointer"};
+
+    /* Position, AT, UP, linear velocity, then angular velocity. */
+    auto vals = al::span<const float,15>{values, 15_uz};
+    if(!std::all_of(vals.cbegin(), vals.cend(), [](float f) { return std::isfinite(f); }))
+        throw al::context_error{AL_INVALID_VALUE, "Listener motion out of range"};
+
+    ALlistener &listener = context->mListener;
+    std::lock_guard<std::mutex> proplock{context->mPropLock};
+    std::copy_n(vals.cbegin(), 3, listener.Position.begin());
+    std::copy_n(vals.cbegin()+3, 3, listener.OrientAt.begin());
+    std::copy_n(vals.cbegin()+6, 3, listener.OrientUp.begin());
+    std::copy_n(vals.cbegin()+9, 3, listener.mMotionVelocity.begin());
+    std::copy_n(vals.cbegin()+12, 3, listener.mAngularVelocity.begin());
+    listener.mMotionTime = std::chrono::nanoseconds{pose_time};
+    listener.mHasMotion = true;
+    CommitAndUpdateProps(context);
+}
+catch(al::context_error& e) {
+    context->setError(e.errorCode(), "%s", e.what());
+}
+
 
 AL_API DECL_FUNC2(void, alListeneri, ALenum,param, ALint,value)
 FORCE_ALIGN void AL_APIENTRY alListeneriDirect(ALCcontext *context, ALenum param, ALint /*value*/) noexcept
@@ -2,6 +2,7 @@
 #define AL_LISTENER_H
 
 #include <array>
+#include <chrono>
 
 #include "AL/efx.h"
 
@@ -16,6 +17,14 @@ struct ALlistener {
     float Gain{1.0f};
     float mMetersPerUnit{AL_DEFAULT_METERS_PER_UNIT};
 
+    /* Motion given with the last pose, for the mixer to predict the pose from
+     * (cleared when the position or orientation is set directly).
+     */
+    bool mHasMotion{false};
+    std::chrono::nanoseconds mMotionTime{};
+    std::array<float,3> mMotionVelocity{};
+    std::array<float,3> mAngularVelocity{};
+
     DISABLE_ALLOC
 };
 
@@ -37,7 +37,6 @@
 #include <limits>
 #include <memory>
 #include <mutex>
-#include <numeric>
 #include <optional>
 #include <ratio>
 #include <stdexcept>
@@ -556,6 +555,19 @@ void InitVoice(Voice *voice, ALsource *source, ALbufferQueueItem *BufferList, AL
 
     voice->prepare(device);
 
+    /* Drop any parameter events left over from the voice's last use. */
+    auto free_param_events = [context](VoiceParamEvent *evt)
+    {
+        while(evt)
+        {
+            VoiceParamEvent *next{evt->next.load(std::memory_order_relaxed)};
+            AtomicReplaceHead(context->mFreeVoiceParams, evt);
+            evt = next;
+        }
+    };
+    free_param_events(voice->mScheduledParams.exchange(nullptr, std::memory_order_acquire));
+    free_param_events(std::exchange(voice->mParamTimeline, nullptr));
+
     source->mPropsDirty = false;
     UpdateSourceProps(source, voice, context);
 
@@ -608,6 +620,95 @@ void SendVoiceChanges(ALCcontext *ctx, VoiceChange *tail)
 }
 
 
+/* Takes a chain of count voice changes off the free list in one piece,
+ * allocating more as needed. The changes are linked in order, with the last
+ * one's mNext being null.
+ */
+VoiceChange *GetVoiceChangers(ALCcontext *ctx, const size_t count)
+{
+    static constexpr size_t clustersize{
+        std::tuple_size_v<ContextBase::VoiceChangeCluster::element_type>};
+    ASSUME(count > 0);
+
+    /* Count the free changes up to the mixer's current one, and allocate more
+     * if there's not enough.
+     */
+    VoiceChange *const current{ctx->mCurrentVoiceChange.load(std::memory_order_acquire)};
+    size_t avail{0};
+    for(VoiceChange *vchg{ctx->mVoiceChangeTail};avail < count && vchg != current;
+        vchg = vchg->mNext.load(std::memory_order_relaxed))
+        ++avail;
+    for(;avail < count;avail += clustersize)
+        ctx->allocVoiceChanges();
+
+    VoiceChange *head{ctx->mVoiceChangeTail};
+    VoiceChange *last{head};
+    for(size_t i{1};i < count;++i)
+        last = last->mNext.load(std::memory_order_relaxed);
+    ctx->mVoiceChangeTail = last->mNext.exchange(nullptr, std::memory_order_relaxed);
+
+    return head;
+}
+
+/* Puts a chain of unused voice changes back on the free list. */
+void ReturnVoiceChangers(ALCcontext *ctx, VoiceChange *head)
+{
+    if(!head) return;
+
+    VoiceChange *last{head};
+    while(VoiceChange *next{last->mNext.load(std::memory_order_relaxed)})
+        last = next;
+    last->mNext.store(ctx->mVoiceChangeTail, std::memory_order_relaxed);
+    ctx->mVoiceChangeTail = head;
+}
+
+/* A batch of voice changes, taken from the free list together for a multi-
+ * source call. The changes that get used are sent to the mixer with a single
+ * publish, and any left over are given back to the free list.
+ */
+class VoiceChangeBatch {
+    ALCcontext *mContext;
+    VoiceChange *mHead;
+    VoiceChange *mNext;
+    VoiceChange *mLast{nullptr};
+
+public:
+    VoiceChangeBatch(ALCcontext *ctx, const size_t count)
+        : mContext{ctx}, mHead{GetVoiceChangers(ctx, count)}, mNext{mHead}
+    { }
+    VoiceChangeBatch(const VoiceChangeBatch&) = delete;
+    ~VoiceChangeBatch() { ReturnVoiceChangers(mContext, mHead); }
+
+    VoiceChangeBatch& operator=(const VoiceChangeBatch&) = delete;
+
+    /* Gets the next unused voice change in the batch. */
+    [[nodiscard]] auto next() noexcept -> VoiceChange*
+    {
+        mLast = mNext;
+        mNext = mNext->mNext.load(std::memory_order_relaxed);
+        return mLast;
+    }
+
+    /* Sends the used voice changes, if any, returning true if something was
+     * sent.
+     */
+    auto send() -> bool
+    {
+        VoiceChange *head{std::exchange(mHead, nullptr)};
+        if(!mLast)
+        {
+            ReturnVoiceChangers(mContext, head);
+            return false;
+        }
+
+        mLast->mNext.store(nullptr, std::memory_order_relaxed);
+        ReturnVoiceChangers(mContext, mNext);
+        SendVoiceChanges(mContext, head);
+        return true;
+    }
+};
+
+
 bool SetVoiceOffset(Voice *oldvoice, const VoicePos &vpos, ALsource *source, ALCcontext *context,
     ALCdevice *device)
 {
@@ -729,9 +830,8 @@ inline ALenum GetSourceState(ALsource *source, Voice *voice)
 
 bool EnsureSources(ALCcontext *context, size_t needed)
 {
-    size_t count{std::accumulate(context->mSourceList.cbegin(), context->mSourceList.cend(), 0_uz,
-        [](size_t cur, const SourceSubList &sublist) noexcept -> size_t
-        { return cur + static_cast<ALuint>(al::popcount(sublist.FreeMask)); })};
+    static constexpr auto SubListSize = std::tuple_size_v<SubListAllocator::value_type>;
+    size_t count{context->mSourceList.size()*SubListSize - context->mNumSources};
 
     try {
         while(needed > count)
@@ -739,11 +839,18 @@ bool EnsureSources(ALCcontext *context, size_t needed)
             if(context->mSourceList.size() >= 1<<25) UNLIKELY
                 return false;
 
+            /* Make sure the free list can hold every sublist, so freeing a
+             * source never needs to allocate.
+             */
+            context->mFreeSourceSubLists.reserve(context->mSourceList.size()+1);
+
             SourceSubList sublist{};
             sublist.FreeMask = ~0_u64;
             sublist.Sources = SubListAllocator{}.allocate(1);
             context->mSourceList.emplace_back(std::move(sublist));
-            count += std::tuple_size_v<SubListAllocator::value_type>;
+            context->mFreeSourceSubLists.emplace_back(
+                static_cast<ALuint>(context->mSourceList.size()-1));
+            count += SubListSize;
         }
     }
     catch(...) {
@@ -752,27 +859,40 @@ bool EnsureSources(ALCcontext *context, size_t needed)
     return true;
 }
 
-ALsource *AllocSource(ALCcontext *context) noexcept
+/* Allocates a source for each of the given IDs, taking as many as it can from
+ * each free sublist at once. EnsureSources must have been called first.
+ */
+void AllocSources(ALCcontext *context, const al::span<ALuint> sids) noexcept
 {
-    auto sublist = std::find_if(context->mSourceList.begin(), context->mSourceList.end(),
-        [](const SourceSubList &entry) noexcept -> bool
-        { return entry.FreeMask != 0; });
-    auto lidx = static_cast<ALuint>(std::distance(context->mSourceList.begin(), sublist));
-    auto slidx = static_cast<ALuint>(al::countr_zero(sublist->FreeMask));
-    ASSUME(slidx < 64);
-
-    ALsource *source{al::construct_at(al::to_address(sublist->Sources->begin() + slidx))};
+    auto sididx = sids.begin();
+    while(sididx != sids.end())
+    {
+        const ALuint lidx{context->mFreeSourceSubLists.back()};
+        SourceSubList &sublist = context->mSourceList[lidx];
+
+        uint64_t freemask{sublist.FreeMask};
+        ASSUME(freemask != 0);
+        do {
+            const auto slidx = static_cast<ALuint>(al::countr_zero(freemask));
+            ASSUME(slidx < 64);
+            freemask &= freemask - 1;
+
+            ALsource *source{al::construct_at(al::to_address(sublist.Sources->begin() + slidx))};
 #ifdef ALSOFT_EAX
-    source->eaxInitialize(context);
+            source->eaxInitialize(context);
 #endif // ALSOFT_EAX
 
-    /* Add 1 to avoid source ID 0. */
-    source->id = ((lidx<<6) | slidx) + 1;
+            /* Add 1 to avoid source ID 0. */
+            source->id = ((lidx<<6) | slidx) + 1;
+            *(sididx++) = source->id;
 
-    context->mNumSources += 1;
-    sublist->FreeMask &= ~(1_u64 << slidx);
+            context->mNumSources += 1;
+        } while(freemask != 0 && sididx != sids.end());
 
-    return source;
+        sublist.FreeMask = freemask;
+        if(!freemask)
+            context->mFreeSourceSubLists.pop_back();
+    }
 }
 
 void FreeSource(ALCcontext *context, ALsource *source)
@@ -795,9 +915,13 @@ void FreeSource(ALCcontext *context, ALsource *source)
         SendVoiceChanges(context, vchg);
     }
 
+    source->removeFromDirtyList(context);
     std::destroy_at(source);
 
-    context->mSourceList[lidx].FreeMask |= 1_u64 << slidx;
+    SourceSubList &sublist = context->mSourceList[lidx];
+    if(!sublist.FreeMask)
+        context->mFreeSourceSubLists.emplace_back(static_cast<ALuint>(lidx));
+    sublist.FreeMask |= 1_u64 << slidx;
     context->mNumSources--;
 }
 
@@ -1349,8 +1473,11 @@ void UpdateSourceProps(ALsource *source, ALCcontext *context)
             UpdateSourceProps(source, voice, context);
             return;
         }
+        /* Not playing, so the properties get sent when it starts. */
+        source->mPropsDirty = true;
+        return;
     }
-    source->mPropsDirty = true;
+    source->markPropsDirty(context);
 }
 #ifdef ALSOFT_EAX
 void CommitAndUpdateSourceProps(ALsource *source, ALCcontext *context)
@@ -1364,8 +1491,10 @@ void CommitAndUpdateSourceProps(ALsource *source, ALCcontext *context)
             UpdateSourceProps(source, voice, context);
             return;
         }
+        source->mPropsDirty = true;
+        return;
     }
-    source->mPropsDirty = true;
+    source->markPropsDirty(context);
 }
 
 #else
@@ -2540,7 +2669,7 @@ void StartSources(ALCcontext *const context, const al::span<ALsource*> srchandle
 
     auto voiceiter = voicelist.begin();
     ALuint vidx{0};
-    VoiceChange *tail{}, *cur{};
+    VoiceChangeBatch vchanges{context, srchandles.size()};
     for(ALsource *source : srchandles)
     {
         /* Check that there is a queue containing at least one valid, non zero
@@ -2563,13 +2692,7 @@ void StartSources(ALCcontext *const context, const al::span<ALsource*> srchandle
             continue;
         }
 
-        if(!cur)
-            cur = tail = GetVoiceChanger(context);
-        else
-        {
-            cur->mNext.store(GetVoiceChanger(context), std::memory_order_relaxed);
-            cur = cur->mNext.load(std::memory_order_relaxed);
-        }
+        VoiceChange *cur{vchanges.next()};
 
         Voice *voice{GetSourceVoice(source, context)};
         switch(GetSourceState(source, voice))
@@ -2657,8 +2780,58 @@ void StartSources(ALCcontext *const context, const al::span<ALsource*> srchandle
         cur->mSourceID = source->id;
         cur->mState = VChangeState::Play;
     }
-    if(tail) LIKELY
-        SendVoiceChanges(context, tail);
+    vchanges.send();
+}
+
+/* Schedules a parameter change on the source's voice for the given device
+ * clock time. The source property is set right away, so it reports the new
+ * value and later updates carry it, while the mixer holds the old value until
+ * the event's sample offset. With no playing voice, it's a normal update.
+ */
+void ScheduleSourceParam(ALsource *source, ALCcontext *context, const nanoseconds time,
+    const VoiceParamEvent::Param param, const al::span<const float> values)
+{
+    switch(param)
+    {
+    case VoiceParamEvent::Param::Gain:
+        source->Gain = values[0];
+        break;
+    case VoiceParamEvent::Param::Pitch:
+        source->Pitch = values[0];
+        break;
+    case VoiceParamEvent::Param::Position:
+        std::copy_n(values.begin(), source->Position.size(), source->Position.begin());
+        break;
+    case VoiceParamEvent::Param::DirectFilter:
+        source->Direct.Gain = values[0];
+        source->Direct.GainHF = values[1];
+        source->Direct.HFReference = values[2];
+        source->Direct.GainLF = values[3];
+        source->Direct.LFReference = values[4];
+        break;
+    }
+
+    Voice *voice{GetSourceVoice(source, context)};
+    if(!voice)
+        return UpdateSourceProps(source, context);
+
+    VoiceParamEvent *evt{context->mFreeVoiceParams.load(std::memory_order_acquire)};
+    if(!evt)
+    {
+        context->allocVoiceParams();
+        evt = context->mFreeVoiceParams.load(std::memory_order_acquire);
+    }
+    VoiceParamEvent *next;
+    do {
+        next = evt->next.load(std::memory_order_relaxed);
+    } while(context->mFreeVoiceParams.compare_exchange_weak(evt, next,
+        std::memory_order_acq_rel, std::memory_order_acquire) == false);
+
+    evt->mTime = time;
+    evt->mParam = param;
+    std::copy(values.begin(), values.end(), evt->mValues.begin());
+
+    AtomicReplaceHead(voice->mScheduledParams, evt);
 }
 
 } // namespace
@@ -2681,7 +2854,7 @@ try {
         throw al::context_error{AL_OUT_OF_MEMORY, "Failed to allocate %d source%s", n,
             (n == 1) ? "" : "s"};
 
-    std::generate(sids.begin(), sids.end(), [context]{ return AllocSource(context)->id; });
+    AllocSources(context, sids);
 }
 catch(al::context_error& e) {
     context->setError(e.errorCode(), "%s", e.what());
@@ -3267,6 +3440,189 @@ catch(al::context_error& e) {
 }
 
 
+FORCE_ALIGN DECL_FUNCEXT4(void, alSourceScheduledfv,SOFT, ALuint,source, ALint64SOFT,update_time, ALenum,param, const ALfloat*,values)
+FORCE_ALIGN void AL_APIENTRY alSourceScheduledfvDirectSOFT(ALCcontext *context, ALuint source,
+    ALint64SOFT update_time, ALenum param, const ALfloat *values) noexcept
+try {
+    if(update_time < 0)
+        throw al::context_error{AL_INVALID_VALUE, "Invalid time point %" PRId64, update_time};
+
+    std::lock_guard<std::mutex> proplock{context->mPropLock};
+    std::lock_guard<std::mutex> sourcelock{context->mSourceLock};
+    ALsource *Source{LookupSource(context, source)};
+    if(!Source)
+        throw al::context_error{AL_INVALID_NAME, "Invalid source ID %u", source};
+    if(!values)
+        throw al::context_error{AL_INVALID_VALUE, "NULL pointer"};
+
+    switch(param)
+    {
+    case AL_GAIN:
+        if(!(values[0] >= 0.0f && std::isfinite(values[0])))
+            throw al::context_error{AL_INVALID_VALUE, "Gain out of range"};
+        return ScheduleSourceParam(Source, context, nanoseconds{update_time},
+            VoiceParamEvent::Param::Gain, {values, 1});
+
+    case AL_PITCH:
+        if(!(values[0] >= 0.0f && std::isfinite(values[0])))
+            throw al::context_error{AL_INVALID_VALUE, "Pitch out of range"};
+        return ScheduleSourceParam(Source, context, nanoseconds{update_time},
+            VoiceParamEvent::Param::Pitch, {values, 1});
+
+    case AL_POSITION:
+        if(!(std::isfinite(values[0]) && std::isfinite(values[1]) && std::isfinite(values[2])))
+            throw al::context_error{AL_INVALID_VALUE, "Position out of range"};
+        return ScheduleSourceParam(Source, context, nanoseconds{update_time},
+            VoiceParamEvent::Param::Position, {values, 3});
+    }
+    throw al::context_error{AL_INVALID_ENUM, "Invalid scheduled source float property 0x%04x",
+        param};
+}
+catch(al::context_error& e) {
+    context->setError(e.errorCode(), "%s", e.what());
+}
+
+FORCE_ALIGN DECL_FUNCEXT4(void, alSourceSchedulediv,SOFT, ALuint,source, ALint64SOFT,update_time, ALenum,param, const ALint*,values)
+FORCE_ALIGN void AL_APIENTRY alSourceScheduledivDirectSOFT(ALCcontext *context, ALuint source,
+    ALint64SOFT update_time, ALenum param, const ALint *values) noexcept
+try {
+    if(update_time < 0)
+        throw al::context_error{AL_INVALID_VALUE, "Invalid time point %" PRId64, update_time};
+
+    std::lock_guard<std::mutex> proplock{context->mPropLock};
+    std::lock_guard<std::mutex> sourcelock{context->mSourceLock};
+    ALsource *Source{LookupSource(context, source)};
+    if(!Source)
+        throw al::context_error{AL_INVALID_NAME, "Invalid source ID %u", source};
+    if(!values)
+        throw al::context_error{AL_INVALID_VALUE, "NULL pointer"};
+
+    switch(param)
+    {
+    case AL_DIRECT_FILTER:
+        {
+            auto filtervals = std::array{1.0f, 1.0f, LowPassFreqRef, 1.0f, HighPassFreqRef};
+            if(const auto filterid = static_cast<ALuint>(values[0]))
+            {
+                ALCdevice *device{context->mALDevice.get()};
+                std::lock_guard<std::mutex> filterlock{device->FilterLock};
+                ALfilter *filter{LookupFilter(device, filterid)};
+                if(!filter)
+                    throw al::context_error{AL_INVALID_VALUE, "Invalid filter ID %u", filterid};
+                filtervals = {filter->Gain, filter->GainHF, filter->HFReference, filter->GainLF,
+                    filter->LFReference};
+            }
+            return ScheduleSourceParam(Source, context, nanoseconds{update_time},
+                VoiceParamEvent::Param::DirectFilter, filtervals);
+        }
+    }
+    throw al::context_error{AL_INVALID_ENUM, "Invalid scheduled source integer property 0x%04x",
+        param};
+}
+catch(al::context_error& e) {
+    context->setError(e.errorCode(), "%s", e.what());
+}
+
+
+FORCE_ALIGN DECL_FUNCEXT5(void, alGetSourcePlaybackv,SOFT, ALsizei,n, const ALuint*,sources, ALint*,states, ALint64SOFT*,offsets, ALint*,processed)
+FORCE_ALIGN void AL_APIENTRY alGetSourcePlaybackvDirectSOFT(ALCcontext *context, ALsizei n,
+    const ALuint *sources, ALint *states, ALint64SOFT *offsets, ALint *processed) noexcept
+try {
+    if(n < 0)
+        throw al::context_error{AL_INVALID_VALUE, "Getting playback of %d sources", n};
+    if(n <= 0) UNLIKELY return;
+
+    al::span sids{sources, static_cast<ALuint>(n)};
+    source_store_variant source_store;
+    const auto srchandles = [&source_store](size_t count) -> al::span<ALsource*>
+    {
+        if(count > std::tuple_size_v<source_store_array>)
+            return al::span{source_store.emplace<source_store_vector>(count)};
+        return al::span{source_store.emplace<source_store_array>()}.first(count);
+    }(sids.size());
+
+    std::lock_guard<std::mutex> sourcelock{context->mSourceLock};
+    auto lookup_src = [context](const ALuint sid) -> ALsource*
+    {
+        if(ALsource *src{LookupSource(context, sid)})
+            return src;
+        throw al::context_error{AL_INVALID_NAME, "Invalid source ID %u", sid};
+    };
+    std::transform(sids.cbegin(), sids.cend(), srchandles.begin(), lookup_src);
+
+    /* Copy the published playback info for all the sources at once, retrying
+     * if the mixer started writing over the set being read.
+     */
+    struct PlaybackInfo {
+        ALuint mSourceID;
+        ALuint mBufferIndex;
+        int64_t mReadPos;
+    };
+    std::vector<PlaybackInfo> infos(srchandles.size());
+    const auto voicelist = context->getVoicesSpan();
+    uint seq{};
+    do {
+        seq = context->mPlaybackInfoSeq.load(std::memory_order_acquire) & ~1u;
+        const size_t infoidx{(seq>>1) & 1};
+        std::transform(srchandles.cbegin(), srchandles.cend(), infos.begin(),
+            [voicelist,infoidx](const ALsource *source) noexcept -> PlaybackInfo
+            {
+                if(source->VoiceIdx >= voicelist.size())
+                    return PlaybackInfo{0u, 0u, 0};
+                const VoicePlaybackInfo &info = voicelist[source->VoiceIdx]->mPlaybackInfo[infoidx];
+                return PlaybackInfo{info.mSourceID.load(std::memory_order_relaxed),
+                    info.mBufferIndex.load(std::memory_order_relaxed),
+                    info.mReadPos.load(std::memory_order_relaxed)};
+            });
+        std::atomic_thread_fence(std::memory_order_acquire);
+    } while(context->mPlaybackInfoSeq.load(std::memory_order_relaxed) - seq > 2);
+
+    /* The queue positions are relative to when the queue was created, so
+     * offset them by the current queue head (processed buffers may have since
+     * been unqueued).
+     */
+    for(size_t i{0};i < srchandles.size();++i)
+    {
+        ALsource *source{srchandles[i]};
+        const PlaybackInfo &info = infos[i];
+        const bool hasinfo{info.mSourceID == source->id && !source->mQueue.empty()};
+        const ALenum state{GetSourceState(source, GetSourceVoice(source, context))};
+
+        if(states)
+            states[i] = state;
+        if(offsets)
+        {
+            int64_t readpos{0};
+            if(hasinfo)
+            {
+                const auto headpos = static_cast<int64_t>(source->mQueue.front().mQueueOffset);
+                readpos = std::max(info.mReadPos - (headpos<<MixerFracBits), int64_t{0});
+            }
+            if(readpos > std::numeric_limits<int64_t>::max() >> (32-MixerFracBits))
+                offsets[i] = std::numeric_limits<int64_t>::max();
+            else
+                offsets[i] = readpos << (32-MixerFracBits);
+        }
+        if(processed)
+        {
+            if(source->Looping || source->SourceType != AL_STREAMING || state == AL_INITIAL)
+                processed[i] = 0;
+            else if(!hasinfo)
+                processed[i] = static_cast<ALint>(source->mQueue.size());
+            else
+            {
+                const auto played = static_cast<int>(info.mBufferIndex -
+                    source->mQueue.front().mQueueIndex);
+                processed[i] = std::clamp(played, 0, static_cast<int>(source->mQueue.size()));
+            }
+        }
+    }
+}
+catch(al::context_error& e) {
+    context->setError(e.errorCode(), "%s", e.what());
+}
+
+
 AL_API DECL_FUNC1(void, alSourcePause, ALuint,source)
 FORCE_ALIGN void AL_APIENTRY alSourcePauseDirect(ALCcontext *context, ALuint source) noexcept
 { alSourcePausevDirect(context, 1, &source); }
@@ -3301,27 +3657,20 @@ try {
      * detected to be playing, chamge the voice (asynchronously) to
      * stopping/paused.
      */
-    VoiceChange *tail{}, *cur{};
+    VoiceChangeBatch vchanges{context, srchandles.size()};
     for(ALsource *source : srchandles)
     {
         Voice *voice{GetSourceVoice(source, context)};
         if(GetSourceState(source, voice) == AL_PLAYING)
         {
-            if(!cur)
-                cur = tail = GetVoiceChanger(context);
-            else
-            {
-                cur->mNext.store(GetVoiceChanger(context), std::memory_order_relaxed);
-                cur = cur->mNext.load(std::memory_order_relaxed);
-            }
+            VoiceChange *cur{vchanges.next()};
             cur->mVoice = voice;
             cur->mSourceID = source->id;
             cur->mState = VChangeState::Pause;
         }
     }
-    if(tail) LIKELY
+    if(vchanges.send())
     {
-        SendVoiceChanges(context, tail);
         /* Second, now that the voice changes have been sent, because it's
          * possible that the voice stopped after it was detected playing and
          * before the voice got paused, recheck that the source is still
@@ -3370,18 +3719,12 @@ try {
     };
     std::transform(sids.cbegin(), sids.cend(), srchandles.begin(), lookup_src);
 
-    VoiceChange *tail{}, *cur{};
+    VoiceChangeBatch vchanges{context, srchandles.size()};
     for(ALsource *source : srchandles)
     {
         if(Voice *voice{GetSourceVoice(source, context)})
         {
-            if(!cur)
-                cur = tail = GetVoiceChanger(context);
-            else
-            {
-                cur->mNext.store(GetVoiceChanger(context), std::memory_order_relaxed);
-                cur = cur->mNext.load(std::memory_order_relaxed);
-            }
+            VoiceChange *cur{vchanges.next()};
             voice->mPendingChange.store(true, std::memory_order_relaxed);
             cur->mVoice = voice;
             cur->mSourceID = source->id;
@@ -3392,8 +3735,7 @@ try {
         source->OffsetType = AL_NONE;
         source->VoiceIdx = InvalidVoiceIndex;
     }
-    if(tail) LIKELY
-        SendVoiceChanges(context, tail);
+    vchanges.send();
 }
 catch(al::context_error& e) {
     context->setError(e.errorCode(), "%s", e.what());
@@ -3430,19 +3772,13 @@ try {
     };
     std::transform(sids.cbegin(), sids.cend(), srchandles.begin(), lookup_src);
 
-    VoiceChange *tail{}, *cur{};
+    VoiceChangeBatch vchanges{context, srchandles.size()};
     for(ALsource *source : srchandles)
     {
         Voice *voice{GetSourceVoice(source, context)};
         if(source->state != AL_INITIAL)
         {
-            if(!cur)
-                cur = tail = GetVoiceChanger(context);
-            else
-            {
-                cur->mNext.store(GetVoiceChanger(context), std::memory_order_relaxed);
-                cur = cur->mNext.load(std::memory_order_relaxed);
-            }
+            VoiceChange *cur{vchanges.next()};
             if(voice)
                 voice->mPendingChange.store(true, std::memory_order_relaxed);
             cur->mVoice = voice;
@@ -3454,8 +3790,7 @@ try {
         source->OffsetType = AL_NONE;
         source->VoiceIdx = InvalidVoiceIndex;
     }
-    if(tail) LIKELY
-        SendVoiceChanges(context, tail);
+    vchanges.send();
 }
 catch(al::context_error& e) {
     context->setError(e.errorCode(), "%s", e.what());
@@ -3524,6 +3859,12 @@ try {
                 BufferList->mNext.store(&item, std::memory_order_relaxed);
                 BufferList = &item;
             }
+            if(const size_t count{source->mQueue.size()}; count > 1)
+            {
+                const auto &prev = source->mQueue[count-2];
+                BufferList->mQueueIndex = prev.mQueueIndex + 1;
+                BufferList->mQueueOffset = prev.mQueueOffset + prev.mSampleLen;
+            }
             if(!buffer) return;
             BufferList->mBlockAlign = buffer->mBlockAlign;
             BufferList->mSampleLen = buffer->mSampleLen;
@@ -3680,6 +4021,60 @@ ALsource::~ALsource()
     std::for_each(Send.begin(), Send.end(), clear_send);
 }
 
+void ALsource::markPropsDirty(ALCcontext *context) noexcept
+{
+    mPropsDirty = true;
+    if(!mInDirtyList)
+    {
+        mNextDirty = std::exchange(context->mDirtySources, this);
+        if(mNextDirty)
+            mNextDirty->mPrevDirty = this;
+        mPrevDirty = nullptr;
+        mInDirtyList = true;
+    }
+}
+
+void ALsource::removeFromDirtyList(ALCcontext *context) noexcept
+{
+    if(!mInDirtyList)
+        return;
+
+    if(mPrevDirty)
+        mPrevDirty->mNextDirty = mNextDirty;
+    else
+        context->mDirtySources = mNextDirty;
+    if(mNextDirty)
+        mNextDirty->mPrevDirty = mPrevDirty;
+    mNextDirty = nullptr;
+    mPrevDirty = nullptr;
+    mInDirtyList = false;
+}
+
+void UpdateDirtySourceProps(ALCcontext *context)
+{
+    std::lock_guard<std::mutex> srclock{context->mSourceLock};
+    ALsource *source{std::exchange(context->mDirtySources, nullptr)};
+    while(source)
+    {
+        ALsource *next{std::exchange(source->mNextDirty, nullptr)};
+        source->mPrevDirty = nullptr;
+        source->mInDirtyList = false;
+
+        /* Sources that aren't playing stay dirty, to send their properties
+         * when they start.
+         */
+        if(source->mPropsDirty)
+        {
+            if(Voice *voice{GetSourceVoice(source, context)})
+            {
+                source->mPropsDirty = false;
+                UpdateSourceProps(source, voice, context);
+            }
+        }
+        source = next;
+    }
+}
+
 void UpdateAllSourceProps(ALCcontext *context)
 {
     std::lock_guard<std::mutex> srclock{context->mSourceLock};
@@ -4145,7 +4540,7 @@ void ALsource::eax_update_direct_filter()
     Direct.HFReference = LowPassFreqRef;
     Direct.GainLF = 1.0f;
     Direct.LFReference = HighPassFreqRef;
-    mPropsDirty = true;
+    markPropsDirty(mEaxAlContext);
 }
 
 void ALsource::eax_update_room_filters()
@@ -4927,7 +5322,7 @@ void ALsource::eax_set_al_source_send(ALeffectslot *slot, size_t sendidx, const
         DecrementRef(oldslot->ref);
 
     send.Slot = slot;
-    mPropsDirty = true;
+    markPropsDirty(mEaxAlContext);
 }
 
 void ALsource::eax_commit_active_fx_slots()
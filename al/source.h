@@ -145,6 +145,10 @@ struct ALsource {
     std::deque<ALbufferQueueItem> mQueue;
 
     bool mPropsDirty{true};
+    /* Links in the context's list of dirty sources, when mInDirtyList is set. */
+    bool mInDirtyList{false};
+    ALsource *mNextDirty{nullptr};
+    ALsource *mPrevDirty{nullptr};
 
     /* Index into the context's Voices array. Lazily updated, only checked and
      * reset when looking up the voice.
@@ -161,6 +165,14 @@ struct ALsource {
     ALsource(const ALsource&) = delete;
     ALsource& operator=(const ALsource&) = delete;
 
+    /**
+     * Flags the source as having property changes, adding it to the context's
+     * dirty list to apply with the next update commit.
+     */
+    void markPropsDirty(ALCcontext *context) noexcept;
+    /** Removes the source from the context's dirty list, if it's in it. */
+    void removeFromDirtyList(ALCcontext *context) noexcept;
+
     static void SetName(ALCcontext *context, ALuint id, std::string_view name);
 
     DISABLE_ALLOC
@@ -1052,6 +1064,7 @@ private:
 };
 
 void UpdateAllSourceProps(ALCcontext *context);
+void UpdateDirtySourceProps(ALCcontext *context);
 
 struct SourceSubList {
     uint64_t FreeMask{~0_u64};
@@ -616,6 +616,10 @@ void UpdateContextProps(ALCcontext *context)
     props->OrientUp = listener.OrientUp;
     props->Gain = listener.Gain;
     props->MetersPerUnit = listener.mMetersPerUnit;
+    props->HasMotion = listener.mHasMotion;
+    props->MotionTime = listener.mMotionTime;
+    props->MotionVelocity = listener.mMotionVelocity;
+    props->AngularVelocity = listener.mAngularVelocity;
 
     props->AirAbsorptionGainHF = context->mAirAbsorptionGainHF;
     props->DopplerFactor = context->mDopplerFactor;
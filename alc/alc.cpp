@@ -53,6 +53,7 @@
 #include <stdexcept>
 #include <string>
 #include <string_view>
+#include <thread>
 #include <tuple>
 #include <utility>
 #include <vector>
@@ -106,6 +107,7 @@
 #include "strutils.h"
 
 #include "backends/base.h"
+#include "backends/mixergroup.h"
 #include "backends/null.h"
 #include "backends/loopback.h"
 #ifdef HAVE_PIPEWIRE
@@ -319,6 +321,7 @@ constexpr uint DitherRNGSeed{22222u};
         "ALC_EXT_direct_context "
         "ALC_EXT_EFX "
         "ALC_EXT_thread_local_context "
+        "ALC_SOFTX_capture_direct_access "
         "ALC_SOFT_loopback "
         "ALC_SOFT_loopback_bformat "
         "ALC_SOFT_reopen_device "
@@ -335,6 +338,7 @@ constexpr uint DitherRNGSeed{22222u};
         "ALC_EXT_disconnect "
         "ALC_EXT_EFX "
         "ALC_EXT_thread_local_context "
+        "ALC_SOFTX_capture_direct_access "
         "ALC_SOFT_device_clock "
         "ALC_SOFT_HRTF "
         "ALC_SOFT_loopback "
@@ -416,7 +420,10 @@ void alc_initconfig()
         }
         TRACE("Supported backends: %s\n", names.c_str());
     }
-    ReadALConfig();
+    {
+        PhaseTimer conftimer{"Reading config"};
+        ReadALConfig();
+    }
 
     if(auto suspendmode = al::getenv("__ALSOFT_SUSPEND_CONTEXT"))
     {
@@ -499,6 +506,16 @@ void alc_initconfig()
         RTPrioLevel = *priopt;
     if(auto limopt = ConfigValueBool({}, {}, "rt-time-limit"sv))
         AllowRTTimeLimit = *limopt;
+    if(auto thrdopt = ConfigValueUInt({}, {}, "mixer-threads"sv))
+    {
+        /* More shared mixing threads than the system can run at once can't
+         * help, and each one is a real-time thread.
+         */
+        const uint maxthreads{std::max(std::thread::hardware_concurrency(), 1u)};
+        if(*thrdopt > maxthreads)
+            WARN("Clamping mixer-threads %u to %u hardware threads\n", *thrdopt, maxthreads);
+        MixerGroupThreads = std::min(*thrdopt, maxthreads);
+    }
 
     {
         CompatFlagBitset compatflags{};
@@ -572,6 +589,15 @@ void alc_initconfig()
         const float valf{std::isfinite(*boostopt) ? std::clamp(*boostopt, -24.0f, 24.0f) : 0.0f};
         ReverbBoost *= std::pow(10.0f, valf / 20.0f);
     }
+    if(auto qualopt = ConfigValueStr({}, "pitch-shifter"sv, "quality"sv))
+    {
+        if(al::case_compare(*qualopt, "fast"sv) == 0)
+            PitchShifterQuality = PshifterQuality::Fast;
+        else if(al::case_compare(*qualopt, "accurate"sv) == 0)
+            PitchShifterQuality = PshifterQuality::Accurate;
+        else
+            WARN("Unsupported pitch-shifter/quality: %s\n", qualopt->c_str());
+    }
 
     auto BackendListEnd = BackendList.end();
     auto devopt = al::getenv("ALSOFT_DRIVERS");
@@ -655,7 +681,10 @@ void alc_initconfig()
             TRACE("Added \"%s\" for capture\n", backend.name);
         }
     };
-    std::for_each(BackendList.begin(), BackendListEnd, init_backend);
+    {
+        PhaseTimer backendtimer{"Initializing backends"};
+        std::for_each(BackendList.begin(), BackendListEnd, init_backend);
+    }
 
     LoopbackBackendFactory::getFactory().init();
 
@@ -712,7 +741,13 @@ void alc_initconfig()
 #endif // ALSOFT_EAX
 }
 inline void InitConfig()
-{ std::call_once(alc_config_once, [](){alc_initconfig();}); }
+{
+    std::call_once(alc_config_once, []
+    {
+        PhaseTimer inittimer{"Library initialization"};
+        alc_initconfig();
+    });
+}
 
 
 /************************************************
@@ -997,7 +1032,7 @@ constexpr std::array X71Downmix{
 };
 
 
-std::unique_ptr<Compressor> CreateDeviceLimiter(const ALCdevice *device, const float threshold)
+std::unique_ptr<Compressor> CreateDeviceLimiter(ALCdevice *device, const float threshold)
 {
     static constexpr bool AutoKnee{true};
     static constexpr bool AutoAttack{true};
@@ -1013,9 +1048,24 @@ std::unique_ptr<Compressor> CreateDeviceLimiter(const ALCdevice *device, const f
     static constexpr float AttackTime{0.02f};
     static constexpr float ReleaseTime{0.2f};
 
+    /* The environment override is checked on each reset, letting the two
+     * implementations be compared on the same device.
+     */
+    bool blockProcess{true};
+    auto modeopt = al::getenv("__ALSOFT_LIMITER_MODE");
+    if(!modeopt)
+        modeopt = device->configValue<std::string>({}, "output-limiter-mode");
+    if(modeopt)
+    {
+        if(al::case_compare(*modeopt, "reference"sv) == 0)
+            blockProcess = false;
+        else if(al::case_compare(*modeopt, "block"sv) != 0)
+            ERR("Unexpected output-limiter-mode: %s\n", modeopt->c_str());
+    }
+
     return Compressor::Create(device->RealOut.Buffer.size(), static_cast<float>(device->Frequency),
         AutoKnee, AutoAttack, AutoRelease, AutoPostGain, AutoDeclip, LookAheadTime, HoldTime,
-        PreGainDb, PostGainDb, threshold, Ratio, KneeDb, AttackTime, ReleaseTime);
+        PreGainDb, PostGainDb, threshold, Ratio, KneeDb, AttackTime, ReleaseTime, blockProcess);
 }
 
 /**
@@ -2205,7 +2255,8 @@ static size_t GetIntegerv(ALCdevice *device, ALCenum param, const al::span<int>
                 values[i++] = ALC_MINOR_VERSION;
                 values[i++] = alcMinorVersion;
                 values[i++] = ALC_CAPTURE_SAMPLES;
-                values[i++] = static_cast<int>(device->Backend->availableSamples());
+                values[i++] = device->mCaptureAcquired ? 0
+                    : static_cast<int>(device->Backend->availableSamples());
                 values[i++] = ALC_CONNECTED;
                 values[i++] = device->Connected.load(std::memory_order_relaxed);
                 values[i++] = 0;
@@ -2223,7 +2274,11 @@ static size_t GetIntegerv(ALCdevice *device, ALCenum param, const al::span<int>
             return 1;
 
         case ALC_CAPTURE_SAMPLES:
-            values[0] = static_cast<int>(device->Backend->availableSamples());
+            /* Nothing more can be captured until acquired samples are
+             * released.
+             */
+            values[0] = device->mCaptureAcquired ? 0
+                : static_cast<int>(device->Backend->availableSamples());
             return 1;
 
         case ALC_CONNECTED:
@@ -2897,6 +2952,7 @@ ALC_API ALCdevice* ALC_APIENTRY alcGetContextsDevice(ALCcontext *Context) noexce
 
 ALC_API ALCdevice* ALC_APIENTRY alcOpenDevice(const ALCchar *deviceName) noexcept
 {
+    PhaseTimer opentimer{"Opening playback device"};
     InitConfig();
 
     if(!PlaybackFactory)
@@ -2966,6 +3022,7 @@ ALC_API ALCdevice* ALC_APIENTRY alcOpenDevice(const ALCchar *deviceName) noexcep
     device->NumAuxSends = DefaultSends;
 
     try {
+        PhaseTimer backendtimer{"Opening playback backend"};
         auto backend = PlaybackFactory->createBackend(device.get(), BackendType::Playback);
         std::lock_guard<std::recursive_mutex> listlock{ListLock};
         backend->open(devname);
@@ -3244,6 +3301,11 @@ ALC_API void ALC_APIENTRY alcCaptureSamples(ALCdevice *device, ALCvoid *buffer,
 
     std::lock_guard<std::mutex> statelock{dev->StateLock};
     BackendBase *backend{dev->Backend.get()};
+    if(dev->mCaptureAcquired)
+    {
+        alcSetError(dev.get(), ALC_INVALID_DEVICE);
+        return;
+    }
 
     const auto usamples = static_cast<uint>(samples);
     if(usamples > backend->availableSamples())
@@ -3255,6 +3317,78 @@ ALC_API void ALC_APIENTRY alcCaptureSamples(ALCdevice *device, ALCvoid *buffer,
     backend->captureSamples(static_cast<std::byte*>(buffer), usamples);
 }
 
+/** Acquires captured samples for reading in place, instead of copying them. */
+ALC_API void ALC_APIENTRY alcCaptureAcquireSamplesSOFT(ALCdevice *device, ALCsizei samples,
+    const ALCvoid **buffers, ALCsizei *lengths) noexcept
+{
+    DeviceRef dev{VerifyDevice(device)};
+    if(!dev || dev->Type != DeviceType::Capture)
+    {
+        alcSetError(dev.get(), ALC_INVALID_DEVICE);
+        return;
+    }
+
+    if(samples < 0 || !buffers || !lengths)
+    {
+        alcSetError(dev.get(), ALC_INVALID_VALUE);
+        return;
+    }
+
+    std::lock_guard<std::mutex> statelock{dev->StateLock};
+    BackendBase *backend{dev->Backend.get()};
+    if(dev->mCaptureAcquired)
+    {
+        alcSetError(dev.get(), ALC_INVALID_DEVICE);
+        return;
+    }
+
+    const auto usamples = static_cast<uint>(samples);
+    if(usamples > backend->availableSamples())
+    {
+        alcSetError(dev.get(), ALC_INVALID_VALUE);
+        return;
+    }
+
+    const auto outbufs = al::span{buffers, 2_uz};
+    const auto outlens = al::span{lengths, 2_uz};
+    if(usamples < 1)
+    {
+        std::fill(outbufs.begin(), outbufs.end(), nullptr);
+        std::fill(outlens.begin(), outlens.end(), 0);
+        return;
+    }
+
+    const size_t framesize{dev->frameSizeFromFmt()};
+    const auto segments = backend->acquireCaptureSamples(usamples);
+    for(size_t i{0};i < segments.size();++i)
+    {
+        outbufs[i] = segments[i].empty() ? nullptr : segments[i].data();
+        outlens[i] = static_cast<ALCsizei>(segments[i].size() / framesize);
+    }
+    dev->mCaptureAcquired = usamples;
+}
+
+/** Releases the samples from the last alcCaptureAcquireSamplesSOFT call. */
+ALC_API void ALC_APIENTRY alcCaptureReleaseSamplesSOFT(ALCdevice *device) noexcept
+{
+    DeviceRef dev{VerifyDevice(device)};
+    if(!dev || dev->Type != DeviceType::Capture)
+    {
+        alcSetError(dev.get(), ALC_INVALID_DEVICE);
+        return;
+    }
+
+    std::lock_guard<std::mutex> statelock{dev->StateLock};
+    if(!dev->mCaptureAcquired)
+    {
+        alcSetError(dev.get(), ALC_INVALID_DEVICE);
+        return;
+    }
+
+    dev->Backend->releaseCaptureSamples(dev->mCaptureAcquired);
+    dev->mCaptureAcquired = 0;
+}
+
 
 /************************************************
  * ALC loopback functions
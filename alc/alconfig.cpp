@@ -40,8 +40,8 @@
 #include <limits>
 #include <string>
 #include <string_view>
+#include <unordered_map>
 #include <utility>
-#include <vector>
 
 #include "almalloc.h"
 #include "alstring.h"
@@ -67,11 +67,10 @@ struct CoTaskMemDeleter {
 };
 #endif
 
-struct ConfigEntry {
-    std::string key;
-    std::string value;
-};
-std::vector<ConfigEntry> ConfOpts;
+/* Config options are looked up often while initializing and opening devices,
+ * so they're kept in a hash map keyed by their full "block/device/key" name.
+ */
+std::unordered_map<std::string,std::string> ConfOpts;
 
 
 std::string &lstrip(std::string &line)
@@ -274,21 +273,12 @@ void LoadConfigFromFile(std::istream &f)
 
         TRACE(" setting '%s' = '%.*s'\n", fullKey.c_str(), al::sizei(valpart), valpart.data());
 
-        /* Check if we already have this option set */
-        auto find_key = [&fullKey](const ConfigEntry &entry) -> bool
-        { return entry.key == fullKey; };
-        auto ent = std::find_if(ConfOpts.begin(), ConfOpts.end(), find_key);
-        if(ent != ConfOpts.end())
-        {
-            if(!valpart.empty())
-                ent->value = expdup(valpart);
-            else
-                ConfOpts.erase(ent);
-        }
-        else if(!valpart.empty())
-            ConfOpts.emplace_back(ConfigEntry{std::move(fullKey), expdup(valpart)});
+        /* An empty value clears any previous setting for this option. */
+        if(!valpart.empty())
+            ConfOpts.insert_or_assign(std::move(fullKey), expdup(valpart));
+        else
+            ConfOpts.erase(fullKey);
     }
-    ConfOpts.shrink_to_fit();
 }
 
 const char *GetConfigValue(const std::string_view devName, const std::string_view blockName,
@@ -298,6 +288,7 @@ const char *GetConfigValue(const std::string_view devName, const std::string_vie
         return nullptr;
 
     std::string key;
+    key.reserve(blockName.size() + devName.size() + keyName.size() + 2);
     if(!blockName.empty() && al::case_compare(blockName, "general"sv) != 0)
     {
         key = blockName;
@@ -310,13 +301,12 @@ const char *GetConfigValue(const std::string_view devName, const std::string_vie
     }
     key += keyName;
 
-    auto iter = std::find_if(ConfOpts.cbegin(), ConfOpts.cend(),
-        [&key](const ConfigEntry &entry) -> bool { return entry.key == key; });
+    auto iter = ConfOpts.find(key);
     if(iter != ConfOpts.cend())
     {
-        TRACE("Found option %s = \"%s\"\n", key.c_str(), iter->value.c_str());
-        if(!iter->value.empty())
-            return iter->value.c_str();
+        TRACE("Found option %s = \"%s\"\n", key.c_str(), iter->second.c_str());
+        if(!iter->second.empty())
+            return iter->second.c_str();
         return nullptr;
     }
 
@@ -70,6 +70,7 @@
 #include "core/mixer/defs.h"
 #include "core/mixer/hrtfdefs.h"
 #include "core/resampler_limits.h"
+#include "core/rtcheck.h"
 #include "core/uhjfilter.h"
 #include "core/voice.h"
 #include "core/voice_change.h"
@@ -406,18 +407,25 @@ constexpr auto GetAmbi2DLayout(AmbiLayout layouttype) noexcept
 }
 
 
-bool CalcContextParams(ContextBase *ctx)
-{
-    ContextProps *props{ctx->mParams.ContextUpdate.exchange(nullptr, std::memory_order_acq_rel)};
-    if(!props) return false;
+/* The furthest from its given time that listener motion will be predicted. */
+constexpr auto MaxMotionPrediction = milliseconds{100};
 
-    const alu::Vector pos{props->Position[0], props->Position[1], props->Position[2], 1.0f};
-    ctx->mParams.Position = pos;
+/* How far the predicted listener orientation (within 1 degree) or position
+ * (in meters) can drift from what the voices were last updated with, before
+ * they all get recalculated.
+ */
+constexpr float MotionAngleThreshold{0.999847695f};
+constexpr float MotionDistanceThreshold{0.01f};
+
+void SetListenerPose(ContextParams &params, const alu::Vector &pos, const alu::Vector &at,
+    const alu::Vector &up)
+{
+    params.Position = pos;
 
     /* AT then UP */
-    alu::Vector N{props->OrientAt[0], props->OrientAt[1], props->OrientAt[2], 0.0f};
+    alu::Vector N{at};
     N.normalize();
-    alu::Vector V{props->OrientUp[0], props->OrientUp[1], props->OrientUp[2], 0.0f};
+    alu::Vector V{up};
     V.normalize();
     /* Build and normalize right-vector */
     alu::Vector U{N.cross_product(V)};
@@ -428,31 +436,132 @@ bool CalcContextParams(ContextBase *ctx)
         U[1], V[1], -N[1], 0.0,
         U[2], V[2], -N[2], 0.0,
          0.0,  0.0,   0.0, 1.0};
-    const alu::Vector vel{props->Velocity[0], props->Velocity[1], props->Velocity[2], 0.0};
 
-    ctx->mParams.Matrix = rot;
-    ctx->mParams.Velocity = rot * vel;
+    params.Matrix = rot;
+    params.Velocity = rot * params.ListenerVelocity;
+}
+
+/* Rotates a vector around the (normalized) axis by the given angle, using
+ * Rodrigues' rotation formula.
+ */
+alu::Vector RotateVector(const alu::Vector &vec, const alu::Vector &axis, const float angle)
+{
+    const float c{std::cos(angle)};
+    const float s{std::sin(angle)};
+    const alu::Vector cross{axis.cross_product(vec)};
+    const float d{axis.dot_product(vec) * (1.0f-c)};
+    return alu::Vector{vec[0]*c + cross[0]*s + axis[0]*d, vec[1]*c + cross[1]*s + axis[1]*d,
+        vec[2]*c + cross[2]*s + axis[2]*d, 0.0f};
+}
 
-    ctx->mParams.Gain = props->Gain * ctx->mGainBoost;
-    ctx->mParams.MetersPerUnit = props->MetersPerUnit
+bool CalcContextParams(ContextBase *ctx, const nanoseconds curtime)
+{
+    ContextParams &params = ctx->mParams;
+    bool force{false};
+
+    if(ContextProps *props{params.ContextUpdate.exchange(nullptr, std::memory_order_acq_rel)})
+    {
+        const alu::Vector pos{props->Position[0], props->Position[1], props->Position[2], 1.0f};
+        const alu::Vector at{props->OrientAt[0], props->OrientAt[1], props->OrientAt[2], 0.0f};
+        const alu::Vector up{props->OrientUp[0], props->OrientUp[1], props->OrientUp[2], 0.0f};
+        const alu::Vector vel{props->Velocity[0], props->Velocity[1], props->Velocity[2], 0.0f};
+
+        const float gain{props->Gain * ctx->mGainBoost};
+        const float metersPerUnit{props->MetersPerUnit
 #ifdef ALSOFT_EAX
-        * props->DistanceFactor
+            * props->DistanceFactor
 #endif
-        ;
-    ctx->mParams.AirAbsorptionGainHF = props->AirAbsorptionGainHF;
-
-    ctx->mParams.DopplerFactor = props->DopplerFactor;
-    ctx->mParams.SpeedOfSound = props->SpeedOfSound * props->DopplerVelocity
+        };
+        const float speedOfSound{props->SpeedOfSound * props->DopplerVelocity
 #ifdef ALSOFT_EAX
-        / props->DistanceFactor
+            / props->DistanceFactor
 #endif
-        ;
+        };
 
-    ctx->mParams.SourceDistanceModel = props->SourceDistanceModel;
-    ctx->mParams.mDistanceModel = props->mDistanceModel;
+        /* An update that only changes the listener's motion doesn't need to
+         * recalculate all the voices, as long as the predicted pose stays
+         * close to what they were last updated with.
+         */
+        force = !props->HasMotion || !params.HasMotion
+            || vel[0] != params.ListenerVelocity[0] || vel[1] != params.ListenerVelocity[1]
+            || vel[2] != params.ListenerVelocity[2] || gain != params.Gain
+            || metersPerUnit != params.MetersPerUnit
+            || props->AirAbsorptionGainHF != params.AirAbsorptionGainHF
+            || props->DopplerFactor != params.DopplerFactor
+            || speedOfSound != params.SpeedOfSound
+            || props->SourceDistanceModel != params.SourceDistanceModel
+            || props->mDistanceModel != params.mDistanceModel;
+
+        params.ListenerVelocity = vel;
+        params.HasMotion = props->HasMotion;
+        if(!params.HasMotion)
+            SetListenerPose(params, pos, at, up);
+        else
+        {
+            params.MotionTime = props->MotionTime;
+            params.MotionPosition = pos;
+            params.MotionAt = at;
+            params.MotionAt.normalize();
+            params.MotionUp = up;
+            params.MotionUp.normalize();
+            params.MotionVelocity = alu::Vector{props->MotionVelocity[0],
+                props->MotionVelocity[1], props->MotionVelocity[2], 0.0f};
+            params.AngularVelocity = alu::Vector{props->AngularVelocity[0],
+                props->AngularVelocity[1], props->AngularVelocity[2], 0.0f};
+        }
 
-    AtomicReplaceHead(ctx->mFreeContextProps, props);
-    return true;
+        params.Gain = gain;
+        params.MetersPerUnit = metersPerUnit;
+        params.AirAbsorptionGainHF = props->AirAbsorptionGainHF;
+
+        params.DopplerFactor = props->DopplerFactor;
+        params.SpeedOfSound = speedOfSound;
+
+        params.SourceDistanceModel = props->SourceDistanceModel;
+        params.mDistanceModel = props->mDistanceModel;
+
+        AtomicReplaceHead(ctx->mFreeContextProps, props);
+    }
+
+    if(params.HasMotion)
+    {
+        /* Predict the listener pose for this update from its last given pose
+         * and motion.
+         */
+        const auto dt = std::clamp(curtime - params.MotionTime, nanoseconds{-MaxMotionPrediction},
+            nanoseconds{MaxMotionPrediction});
+        const float dtsecs{duration<float>{dt}.count()};
+
+        const alu::Vector pos{params.MotionPosition[0] + params.MotionVelocity[0]*dtsecs,
+            params.MotionPosition[1] + params.MotionVelocity[1]*dtsecs,
+            params.MotionPosition[2] + params.MotionVelocity[2]*dtsecs, 1.0f};
+        alu::Vector at{params.MotionAt};
+        alu::Vector up{params.MotionUp};
+        alu::Vector axis{params.AngularVelocity};
+        if(const float rate{axis.normalize()}; rate > 0.0f)
+        {
+            at = RotateVector(at, axis, rate*dtsecs);
+            up = RotateVector(up, axis, rate*dtsecs);
+        }
+        SetListenerPose(params, pos, at, up);
+
+        if(!force)
+        {
+            const alu::Vector diff{pos - params.VoicePosition};
+            const float dist{std::sqrt(diff.dot_product(diff)) * params.MetersPerUnit};
+            force = at.dot_product(params.VoiceAt) < MotionAngleThreshold
+                || up.dot_product(params.VoiceUp) < MotionAngleThreshold
+                || dist > MotionDistanceThreshold;
+        }
+        if(force)
+        {
+            params.VoicePosition = pos;
+            params.VoiceAt = at;
+            params.VoiceUp = up;
+        }
+    }
+
+    return force;
 }
 
 bool CalcEffectSlotParams(EffectSlot *slot, EffectSlot **sorted_slots, ContextBase *context)
@@ -468,6 +577,7 @@ bool CalcEffectSlotParams(EffectSlot *slot, EffectSlot **sorted_slots, ContextBa
     slot->Gain = props->Gain;
     slot->AuxSendAuto = props->AuxSendAuto;
     slot->Target = props->Target;
+    const EffectSlotType oldtype{slot->EffectType};
     slot->EffectType = props->Type;
     slot->mEffectProps = props->Props;
     /* If this effect slot's Auxiliary Send Auto is off, don't apply the
@@ -513,6 +623,7 @@ bool CalcEffectSlotParams(EffectSlot *slot, EffectSlot **sorted_slots, ContextBa
         {
             auto &evt = InitAsyncEvent<AsyncEffectReleaseEvent>(evt_vec.first.buf);
             evt.mEffectState = oldstate;
+            evt.mType = oldtype;
             ring->writeAdvance(1);
         }
         else
@@ -1467,6 +1578,21 @@ void CalcPanningAndFilters(Voice *voice, const float xpos, const float ypos, con
             voice->mChans[c].mWetParams[i].HighPass.copyParamsFrom(highpass);
         }
     }
+
+    /* Note which output channels need to be mixed with the new gains,
+     * including any still fading out from the current gains.
+     */
+    for(auto &chandata : voice->mChans)
+    {
+        auto &drygains = chandata.mDryParams.Gains;
+        drygains.Active.update(drygains.Current, drygains.Target, voice->mDirect.Buffer.size());
+        for(uint i{0};i < NumSends;i++)
+        {
+            auto &wetgains = chandata.mWetParams[i].Gains;
+            wetgains.Active.update(wetgains.Current, wetgains.Target,
+                voice->mSend[i].Buffer.size());
+        }
+    }
 }
 
 void CalcNonAttnSourceParams(Voice *voice, const VoiceProps *props, const ContextBase *context)
@@ -1807,6 +1933,138 @@ void CalcAttnSourceParams(Voice *voice, const VoiceProps *props, const ContextBa
         Distance, spread, DryGain, WetGain, SendSlots, props, context->mParams, Device);
 }
 
+void CalcVoiceParams(Voice *voice, ContextBase *context)
+{
+    if((voice->mProps.DirectChannels != DirectMode::Off && voice->mFmtChannels != FmtMono
+            && !IsAmbisonic(voice->mFmtChannels))
+        || voice->mProps.mSpatializeMode == SpatializeMode::Off
+        || (voice->mProps.mSpatializeMode==SpatializeMode::Auto && voice->mFmtChannels != FmtMono))
+        CalcNonAttnSourceParams(voice, &voice->mProps, context);
+    else
+        CalcAttnSourceParams(voice, &voice->mProps, context);
+}
+
+/* Merges two time-ordered event lists into one. Events in the first list go
+ * before events in the second with the same time.
+ */
+VoiceParamEvent *MergeParamEvents(VoiceParamEvent *first, VoiceParamEvent *second) noexcept
+{
+    VoiceParamEvent *head{nullptr};
+    VoiceParamEvent *tail{nullptr};
+    auto append = [&head,&tail](VoiceParamEvent *evt) noexcept
+    {
+        if(tail) tail->next.store(evt, std::memory_order_relaxed);
+        else head = evt;
+        tail = evt;
+    };
+    while(first && second)
+    {
+        VoiceParamEvent *&src = (second->mTime < first->mTime) ? second : first;
+        VoiceParamEvent *evt{src};
+        src = evt->next.load(std::memory_order_relaxed);
+        append(evt);
+    }
+    append(first ? first : second);
+    return head;
+}
+
+/* Sorts a list of events by time, keeping events with the same time in their
+ * list order. This is a bottom-up merge sort, where bins[i] holds a sorted run
+ * of 2^i events (or nothing), so it doesn't need to allocate.
+ */
+VoiceParamEvent *SortParamEvents(VoiceParamEvent *evt) noexcept
+{
+    std::array<VoiceParamEvent*,sizeof(size_t)*8> bins{};
+    while(evt)
+    {
+        VoiceParamEvent *run{evt};
+        evt = evt->next.load(std::memory_order_relaxed);
+        run->next.store(nullptr, std::memory_order_relaxed);
+
+        /* Runs in the bins are older than the new one, so they go first. */
+        size_t i{0};
+        for(;bins[i] && i+1 < bins.size();++i)
+        {
+            run = MergeParamEvents(bins[i], run);
+            bins[i] = nullptr;
+        }
+        bins[i] = MergeParamEvents(bins[i], run);
+    }
+
+    /* Higher bins hold older runs. */
+    VoiceParamEvent *ret{nullptr};
+    for(VoiceParamEvent *run : bins)
+        ret = MergeParamEvents(run, ret);
+    return ret;
+}
+
+/* Moves newly scheduled parameter events into the voice's timeline, keeping it
+ * sorted by time. Events scheduled for the same time stay in the order they
+ * were scheduled in.
+ */
+void MergeScheduledParams(Voice *voice)
+{
+    VoiceParamEvent *evt{voice->mScheduledParams.exchange(nullptr, std::memory_order_acq_rel)};
+    if(!evt) LIKELY return;
+
+    /* The incoming list is newest first, so reverse it into the order the
+     * events were scheduled in before sorting it, then merge it after the
+     * older events already on the timeline.
+     */
+    VoiceParamEvent *ordered{nullptr};
+    while(evt)
+    {
+        VoiceParamEvent *next{evt->next.load(std::memory_order_relaxed)};
+        evt->next.store(ordered, std::memory_order_relaxed);
+        ordered = evt;
+        evt = next;
+    }
+    voice->mParamTimeline = MergeParamEvents(voice->mParamTimeline, SortParamEvents(ordered));
+}
+
+void ApplyParamEvent(VoiceProps &props, const VoiceParamEvent &evt)
+{
+    switch(evt.mParam)
+    {
+    case VoiceParamEvent::Param::Gain:
+        props.Gain = evt.mValues[0];
+        break;
+    case VoiceParamEvent::Param::Pitch:
+        props.Pitch = evt.mValues[0];
+        break;
+    case VoiceParamEvent::Param::Position:
+        std::copy_n(evt.mValues.cbegin(), props.Position.size(), props.Position.begin());
+        break;
+    case VoiceParamEvent::Param::DirectFilter:
+        props.Direct.Gain = evt.mValues[0];
+        props.Direct.GainHF = evt.mValues[1];
+        props.Direct.HFReference = evt.mValues[2];
+        props.Direct.GainLF = evt.mValues[3];
+        props.Direct.LFReference = evt.mValues[4];
+        break;
+    }
+}
+
+/* Restores the given parameter in a new property set from the current one. */
+void KeepCurrentParam(VoiceProps &props, const VoiceProps &current, VoiceParamEvent::Param param)
+{
+    switch(param)
+    {
+    case VoiceParamEvent::Param::Gain:
+        props.Gain = current.Gain;
+        break;
+    case VoiceParamEvent::Param::Pitch:
+        props.Pitch = current.Pitch;
+        break;
+    case VoiceParamEvent::Param::Position:
+        props.Position = current.Position;
+        break;
+    case VoiceParamEvent::Param::DirectFilter:
+        props.Direct = current.Direct;
+        break;
+    }
+}
+
 void CalcSourceParams(Voice *voice, ContextBase *context, bool force)
 {
     VoicePropsItem *props{voice->mUpdate.exchange(nullptr, std::memory_order_acq_rel)};
@@ -1814,28 +2072,109 @@ void CalcSourceParams(Voice *voice, ContextBase *context, bool force)
 
     if(props)
     {
+        /* The source already holds the values of its scheduled parameters, so
+         * they need to keep their current values here until their events are
+         * reached.
+         */
+        MergeScheduledParams(voice);
+        for(auto *evt = voice->mParamTimeline;evt;evt = evt->next.load(std::memory_order_relaxed))
+            KeepCurrentParam(*props, voice->mProps, evt->mParam);
+
         voice->mProps = static_cast<VoiceProps&>(*props);
 
         AtomicReplaceHead(context->mFreeVoiceProps, props);
     }
 
-    if((voice->mProps.DirectChannels != DirectMode::Off && voice->mFmtChannels != FmtMono
-            && !IsAmbisonic(voice->mFmtChannels))
-        || voice->mProps.mSpatializeMode == SpatializeMode::Off
-        || (voice->mProps.mSpatializeMode==SpatializeMode::Auto && voice->mFmtChannels != FmtMono))
-        CalcNonAttnSourceParams(voice, &voice->mProps, context);
-    else
-        CalcAttnSourceParams(voice, &voice->mProps, context);
+    CalcVoiceParams(voice, context);
 }
 
+/* Mixes a voice for the update, splitting the mix at the sample offsets of any
+ * scheduled parameter events that come due.
+ */
+void MixVoice(Voice *voice, Voice::State vstate, ContextBase *context, const nanoseconds curtime,
+    const uint SamplesToDo)
+{
+    MergeScheduledParams(voice);
+    if(!voice->mParamTimeline || vstate != Voice::Playing) LIKELY
+        return voice->mix(vstate, context, curtime, 0, SamplesToDo);
+
+    const uint frequency{context->mDevice->Frequency};
+    uint outpos{0};
+    while(VoiceParamEvent *evt{voice->mParamTimeline})
+    {
+        /* Get the sample offset the event applies at, stopping when it's past
+         * this update.
+         */
+        if(evt->mTime > curtime)
+        {
+            const auto diff = evt->mTime - curtime;
+            if(diff >= seconds{1})
+                break;
+            const auto offset = static_cast<uint>(round<seconds>(diff*frequency).count());
+            if(offset >= SamplesToDo)
+                break;
+
+            if(offset > outpos)
+            {
+                voice->mix(vstate, context, curtime, outpos, offset);
+                outpos = offset;
+
+                /* Stop applying events if the voice stopped playing, and let
+                 * it finish out the update.
+                 */
+                vstate = voice->mPlayState.load(std::memory_order_acquire);
+                if(vstate != Voice::Playing)
+                    break;
+            }
+        }
+
+        voice->mParamTimeline = evt->next.load(std::memory_order_relaxed);
+        ApplyParamEvent(voice->mProps, *evt);
+        AtomicReplaceHead(context->mFreeVoiceParams, evt);
 
-void SendSourceStateEvent(ContextBase *context, uint id, VChangeState state)
+        CalcVoiceParams(voice, context);
+    }
+
+    if(vstate == Voice::Playing || vstate == Voice::Stopping)
+        voice->mix(vstate, context, curtime, outpos, SamplesToDo);
+}
+
+/* Publishes the voices' current playback positions, so they can be read in
+ * bulk without waiting on the mixer.
+ */
+void PublishPlaybackInfo(ContextBase *context, const al::span<Voice*> voices)
 {
-    RingBuffer *ring{context->mAsyncEvents.get()};
-    auto evt_vec = ring->getWriteVector();
-    if(evt_vec.first.len < 1) return;
+    const uint seq{context->mPlaybackInfoSeq.load(std::memory_order_relaxed)};
+    context->mPlaybackInfoSeq.store(seq+1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    const size_t infoidx{((seq>>1)+1) & 1};
+    for(Voice *voice : voices)
+    {
+        VoicePlaybackInfo &info = voice->mPlaybackInfo[infoidx];
+        const VoiceBufferItem *current{voice->mCurrentBuffer.load(std::memory_order_relaxed)};
+        if(!current)
+        {
+            info.mSourceID.store(0u, std::memory_order_relaxed);
+            continue;
+        }
 
-    auto &evt = InitAsyncEvent<AsyncSourceStateEvent>(evt_vec.first.buf);
+        const int64_t pos{voice->mPosition.load(std::memory_order_relaxed)};
+        const uint frac{voice->mPositionFrac.load(std::memory_order_relaxed)};
+        const auto readpos = (static_cast<int64_t>(current->mQueueOffset)+pos)<<MixerFracBits;
+        info.mSourceID.store(voice->mSourceID.load(std::memory_order_relaxed),
+            std::memory_order_relaxed);
+        info.mBufferIndex.store(current->mQueueIndex, std::memory_order_relaxed);
+        info.mReadPos.store(readpos + frac, std::memory_order_relaxed);
+    }
+
+    context->mPlaybackInfoSeq.store(seq+2, std::memory_order_release);
+}
+
+
+void InitSourceStateEvent(std::byte *evtbuf, uint id, VChangeState state)
+{
+    auto &evt = InitAsyncEvent<AsyncSourceStateEvent>(evtbuf);
     evt.mId = id;
     switch(state)
     {
@@ -1855,8 +2194,6 @@ void SendSourceStateEvent(ContextBase *context, uint id, VChangeState state)
     case VChangeState::Restart:
         al::unreachable();
     }
-
-    ring->writeAdvance(1);
 }
 
 void ProcessVoiceChanges(ContextBase *ctx)
@@ -1865,7 +2202,29 @@ void ProcessVoiceChanges(ContextBase *ctx)
     VoiceChange *next{cur->mNext.load(std::memory_order_acquire)};
     if(!next) return;
 
+    /* Source state events for the whole batch of changes are written into
+     * the event queue as they're generated, and published together at the
+     * end.
+     */
     const auto enabledevt = ctx->mEnabledEvts.load(std::memory_order_acquire);
+    const bool stateevts{enabledevt.test(al::to_underlying(AsyncEnableBits::SourceState))};
+    RingBuffer *ring{ctx->mAsyncEvents.get()};
+    const auto evt_vec = stateevts ? ring->getWriteVector() : RingBuffer::DataPair{};
+    const size_t elemsize{ring->getElemSize()};
+    size_t evt_count{0};
+    auto send_state_event = [&evt_vec,elemsize,&evt_count](uint id, VChangeState state)
+    {
+        std::byte *evtbuf{};
+        if(evt_count < evt_vec.first.len)
+            evtbuf = evt_vec.first.buf + evt_count*elemsize;
+        else if(evt_count-evt_vec.first.len < evt_vec.second.len)
+            evtbuf = evt_vec.second.buf + (evt_count-evt_vec.first.len)*elemsize;
+        else
+            return;
+        InitSourceStateEvent(evtbuf, id, state);
+        ++evt_count;
+    };
+
     do {
         cur = next;
 
@@ -1946,23 +2305,27 @@ void ProcessVoiceChanges(ContextBase *ctx)
             }
             oldvoice->mPendingChange.store(false, std::memory_order_release);
         }
-        if(sendevt && enabledevt.test(al::to_underlying(AsyncEnableBits::SourceState)))
-            SendSourceStateEvent(ctx, cur->mSourceID, cur->mState);
+        if(sendevt && stateevts)
+            send_state_event(cur->mSourceID, cur->mState);
 
         next = cur->mNext.load(std::memory_order_acquire);
     } while(next);
     ctx->mCurrentVoiceChange.store(cur, std::memory_order_release);
+
+    if(evt_count > 0)
+        ring->writeAdvance(evt_count);
 }
 
 void ProcessParamUpdates(ContextBase *ctx, const al::span<EffectSlot*> slots,
-    const al::span<EffectSlot*> sorted_slots, const al::span<Voice*> voices)
+    const al::span<EffectSlot*> sorted_slots, const al::span<Voice*> voices,
+    const nanoseconds curtime)
 {
     ProcessVoiceChanges(ctx);
 
     IncrementRef(ctx->mUpdateCount);
     if(!ctx->mHoldUpdates.load(std::memory_order_acquire)) LIKELY
     {
-        bool force{CalcContextParams(ctx)};
+        bool force{CalcContextParams(ctx, curtime)};
         auto sorted_slot_base = al::to_address(sorted_slots.begin());
         for(EffectSlot *slot : slots)
             force |= CalcEffectSlotParams(slot, sorted_slot_base, ctx);
@@ -1974,7 +2337,12 @@ void ProcessParamUpdates(ContextBase *ctx, const al::span<EffectSlot*> slots,
                 CalcSourceParams(voice, ctx, force);
         }
     }
-    IncrementRef(ctx->mUpdateCount);
+    ctx->mUpdateCount.fetch_add(1u, std::memory_order_seq_cst);
+    if(ctx->mUpdateWaiting.load(std::memory_order_seq_cst)) UNLIKELY
+    {
+        if(ctx->mUpdateWaiting.exchange(false, std::memory_order_acq_rel))
+            ctx->mUpdateSem.post();
+    }
 }
 
 void ProcessContexts(DeviceBase *device, const uint SamplesToDo)
@@ -1993,7 +2361,7 @@ void ProcessContexts(DeviceBase *device, const uint SamplesToDo)
         const al::span<Voice*> voices{ctx->getVoicesSpanAcquired()};
 
         /* Process pending property updates for objects on the context. */
-        ProcessParamUpdates(ctx, auxslots, sorted_slots, voices);
+        ProcessParamUpdates(ctx, auxslots, sorted_slots, voices, curtime);
 
         /* Clear auxiliary effect slot mixing buffers. */
         for(EffectSlot *slot : auxslots)
@@ -2007,8 +2375,9 @@ void ProcessContexts(DeviceBase *device, const uint SamplesToDo)
         {
             const Voice::State vstate{voice->mPlayState.load(std::memory_order_acquire)};
             if(vstate != Voice::Stopped && vstate != Voice::Pending)
-                voice->mix(vstate, ctx, curtime, SamplesToDo);
+                MixVoice(voice, vstate, ctx, curtime, SamplesToDo);
         }
+        PublishPlaybackInfo(ctx, voices);
 
         /* Process effects. */
         if(!auxslots.empty())
@@ -2213,6 +2582,7 @@ void Write(const al::span<const FloatBufferLine> InBuffer, al::span<void*> OutBu
 
 uint DeviceBase::renderSamples(const uint numSamples)
 {
+    [[maybe_unused]] const RealtimeSection rtsection{};
     const uint samplesToDo{std::min(numSamples, uint{BufferLineSize})};
 
     /* Clear main mixing buffers. */
@@ -922,6 +922,8 @@ struct AlsaCapture final : public BackendBase {
     void stop() override;
     void captureSamples(std::byte *buffer, uint samples) override;
     uint availableSamples() override;
+    auto acquireCaptureSamples(uint samples) -> CaptureSegments override;
+    void releaseCaptureSamples(uint samples) override;
     ClockLatency getClockLatency() override;
 
     snd_pcm_t *mPcmHandle{nullptr};
@@ -1142,6 +1144,20 @@ void AlsaCapture::captureSamples(std::byte *buffer, uint samples)
             std::byte((mDevice->FmtType == DevFmtUByte) ? 0x80 : 0));
 }
 
+auto AlsaCapture::acquireCaptureSamples(uint samples) -> CaptureSegments
+{
+    /* Without a ring buffer, samples are read from the device on demand. */
+    if(!mRing)
+        return BackendBase::acquireCaptureSamples(samples);
+    return AcquireRingSamples(*mRing, samples);
+}
+
+void AlsaCapture::releaseCaptureSamples(uint samples)
+{
+    if(mRing)
+        ReleaseRingSamples(*mRing, samples);
+}
+
 uint AlsaCapture::availableSamples()
 {
     snd_pcm_sframes_t avail{0};
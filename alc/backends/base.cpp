@@ -35,6 +35,16 @@ void BackendBase::captureSamples(std::byte*, uint)
 uint BackendBase::availableSamples()
 { return 0; }
 
+auto BackendBase::acquireCaptureSamples(uint samples) -> CaptureSegments
+{
+    mCaptureStaging.resize(size_t{samples} * mDevice->frameSizeFromFmt());
+    captureSamples(mCaptureStaging.data(), samples);
+    return {mCaptureStaging, {}};
+}
+
+void BackendBase::releaseCaptureSamples(uint)
+{ }
+
 ClockLatency BackendBase::getClockLatency()
 {
     ClockLatency ret{};
@@ -1,6 +1,8 @@
 #ifndef ALC_BACKENDS_BASE_H
 #define ALC_BACKENDS_BASE_H
 
+#include <algorithm>
+#include <array>
 #include <chrono>
 #include <cstdarg>
 #include <cstddef>
@@ -10,9 +12,11 @@
 #include <string_view>
 #include <vector>
 
+#include "alspan.h"
 #include "core/device.h"
 #include "core/except.h"
 #include "alc/events.h"
+#include "ringbuffer.h"
 
 
 using uint = unsigned int;
@@ -22,6 +26,9 @@ struct ClockLatency {
     std::chrono::nanoseconds Latency;
 };
 
+/* Up to two segments of captured sample data that can be read in place. */
+using CaptureSegments = std::array<al::span<const std::byte>,2>;
+
 struct BackendBase {
     virtual void open(std::string_view name) = 0;
 
@@ -32,6 +39,15 @@ struct BackendBase {
     virtual void captureSamples(std::byte *buffer, uint samples);
     virtual uint availableSamples();
 
+    /**
+     * Provides read access to the given number of captured samples (no more
+     * than availableSamples()), which stay valid until released. The default
+     * captures into a staging buffer, while backends that capture into a ring
+     * buffer can return its storage directly.
+     */
+    virtual auto acquireCaptureSamples(uint samples) -> CaptureSegments;
+    virtual void releaseCaptureSamples(uint samples);
+
     virtual ClockLatency getClockLatency();
 
     DeviceBase *const mDevice;
@@ -51,6 +67,9 @@ protected:
     void setDefaultChannelOrder() const;
     /** Sets the default channel order used by WaveFormatEx. */
     void setDefaultWFXChannelOrder() const;
+
+private:
+    std::vector<std::byte> mCaptureStaging;
 };
 using BackendPtr = std::unique_ptr<BackendBase>;
 
@@ -70,6 +89,22 @@ inline ClockLatency GetClockLatency(DeviceBase *device, BackendBase *backend)
     return ret;
 }
 
+/* Helpers for backends that capture into a RingBuffer, to acquire and release
+ * samples directly from it.
+ */
+inline auto AcquireRingSamples(RingBuffer &ring, size_t samples) noexcept -> CaptureSegments
+{
+    const size_t elemsize{ring.getElemSize()};
+    const auto [seg0, seg1] = ring.getReadVector();
+    const size_t len0{std::min(seg0.len, samples)};
+    const size_t len1{std::min(seg1.len, samples-len0)};
+    return {al::span<const std::byte>{seg0.buf, len0*elemsize},
+        al::span<const std::byte>{seg1.buf, len1*elemsize}};
+}
+
+inline void ReleaseRingSamples(RingBuffer &ring, size_t samples) noexcept
+{ ring.readAdvance(samples); }
+
 
 struct BackendFactory {
     BackendFactory() = default;
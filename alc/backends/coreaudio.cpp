@@ -611,6 +611,8 @@ struct CoreAudioCapture final : public BackendBase {
     void stop() override;
     void captureSamples(std::byte *buffer, uint samples) override;
     uint availableSamples() override;
+    auto acquireCaptureSamples(uint samples) -> CaptureSegments override;
+    void releaseCaptureSamples(uint samples) override;
 
     AudioUnit mAudioUnit{0};
 
@@ -942,6 +944,20 @@ void CoreAudioCapture::captureSamples(std::byte *buffer, uint samples)
     mRing->readAdvance(total_read);
 }
 
+auto CoreAudioCapture::acquireCaptureSamples(uint samples) -> CaptureSegments
+{
+    /* Samples that need conversion can't be read in place. */
+    if(mConverter)
+        return BackendBase::acquireCaptureSamples(samples);
+    return AcquireRingSamples(*mRing, samples);
+}
+
+void CoreAudioCapture::releaseCaptureSamples(uint samples)
+{
+    if(!mConverter)
+        ReleaseRingSamples(*mRing, samples);
+}
+
 uint CoreAudioCapture::availableSamples()
 {
     if(!mConverter) return static_cast<uint>(mRing->readSpace());
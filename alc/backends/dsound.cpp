@@ -548,6 +548,8 @@ struct DSoundCapture final : public BackendBase {
     void stop() override;
     void captureSamples(std::byte *buffer, uint samples) override;
     uint availableSamples() override;
+    auto acquireCaptureSamples(uint samples) -> CaptureSegments override;
+    void releaseCaptureSamples(uint samples) override;
 
     ComPtr<IDirectSoundCapture> mDSC;
     ComPtr<IDirectSoundCaptureBuffer> mDSCbuffer;
@@ -712,6 +714,12 @@ void DSoundCapture::stop()
 void DSoundCapture::captureSamples(std::byte *buffer, uint samples)
 { std::ignore = mRing->read(buffer, samples); }
 
+auto DSoundCapture::acquireCaptureSamples(uint samples) -> CaptureSegments
+{ return AcquireRingSamples(*mRing, samples); }
+
+void DSoundCapture::releaseCaptureSamples(uint samples)
+{ ReleaseRingSamples(*mRing, samples); }
+
 uint DSoundCapture::availableSamples()
 {
     if(!mDevice->Connected.load(std::memory_order_acquire))
@@ -0,0 +1,189 @@
+#include "config.h"
+
+#include "mixergroup.h"
+
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <memory>
+#include <ratio>
+
+#include "althrd_setname.h"
+#include "core/device.h"
+#include "core/helpers.h"
+#include "core/logging.h"
+
+
+namespace {
+
+using std::chrono::seconds;
+using std::chrono::nanoseconds;
+
+std::mutex gGroupLock;
+std::weak_ptr<MixerGroup> gGroup;
+
+} // namespace
+
+
+auto MixerGroup::Get() -> std::shared_ptr<MixerGroup>
+{
+    if(MixerGroupThreads < 1)
+        return nullptr;
+
+    auto grouplock = std::lock_guard{gGroupLock};
+    if(auto group = gGroup.lock())
+        return group;
+
+    auto group = std::shared_ptr<MixerGroup>{new MixerGroup{}};
+    try {
+        group->mThreads.reserve(MixerGroupThreads);
+        while(group->mThreads.size() < MixerGroupThreads)
+            group->mThreads.emplace_back(std::mem_fn(&MixerGroup::mixerProc), group.get());
+    }
+    catch(std::exception &e) {
+        ERR("Failed to start shared mixer thread: %s\n", e.what());
+    }
+    if(group->mThreads.empty())
+        return nullptr;
+
+    TRACE("Started %zu shared mixer thread%s\n", group->mThreads.size(),
+        (group->mThreads.size()==1) ? "" : "s");
+    gGroup = group;
+    return group;
+}
+
+MixerGroup::~MixerGroup()
+{
+    auto lock = std::unique_lock{mLock};
+    mQuit = true;
+    lock.unlock();
+    mCond.notify_all();
+    mTimerCond.notify_all();
+
+    for(auto &thrd : mThreads)
+        thrd.join();
+    TRACE("Stopped shared mixer threads\n");
+}
+
+
+void MixerGroup::schedule(Member &member)
+{
+    /* The deadline is when the next update's worth of samples is available,
+     * rounded up so it's never early.
+     */
+    const uint frequency{member.mDevice->Frequency};
+    const int64_t samples{member.mDone + member.mDevice->UpdateSize};
+    member.mDeadline = member.mStart + nanoseconds{(samples*std::nano::den + frequency - 1)
+        / frequency};
+
+    member.mScheduled = true;
+    mQueue.emplace_back(&member);
+    std::push_heap(mQueue.begin(), mQueue.end(), deadline_gt);
+
+    /* If this is now the earliest deadline, the thread waiting on a later one
+     * needs to wake up for it, or an idle thread needs to start waiting.
+     */
+    if(mQueue.front() == &member)
+    {
+        if(mTimerWaiting)
+            mTimerCond.notify_one();
+        else
+            mCond.notify_one();
+    }
+}
+
+void MixerGroup::add(Member &member)
+{
+    auto lock = std::lock_guard{mLock};
+    member.mStart = std::chrono::steady_clock::now();
+    member.mDone = 0;
+    member.mActive = true;
+    schedule(member);
+}
+
+void MixerGroup::remove(Member &member)
+{
+    auto lock = std::unique_lock{mLock};
+    member.mActive = false;
+    if(member.mScheduled)
+    {
+        mQueue.erase(std::find(mQueue.begin(), mQueue.end(), &member));
+        std::make_heap(mQueue.begin(), mQueue.end(), deadline_gt);
+        member.mScheduled = false;
+    }
+    mRemoveCond.wait(lock, [&member]{ return !member.mRendering; });
+}
+
+
+void MixerGroup::mixerProc()
+{
+    SetRTPriority();
+    althrd_setname(GetMixerThreadName());
+
+    auto lock = std::unique_lock{mLock};
+    while(!mQuit)
+    {
+        /* Only one thread waits for the earliest deadline. */
+        if(mQueue.empty() || mTimerWaiting)
+        {
+            mCond.wait(lock);
+            continue;
+        }
+
+        /* A member with an earlier deadline may be added in the mean time, so
+         * check again after waking.
+         */
+        const auto deadline = mQueue.front()->mDeadline;
+        if(std::chrono::steady_clock::now() < deadline)
+        {
+            mTimerWaiting = true;
+            mTimerCond.wait_until(lock, deadline);
+            mTimerWaiting = false;
+            continue;
+        }
+
+        std::pop_heap(mQueue.begin(), mQueue.end(), deadline_gt);
+        Member &member = *mQueue.back();
+        mQueue.pop_back();
+        member.mScheduled = false;
+        member.mRendering = true;
+
+        /* Have an idle thread wait for the next deadline while this one
+         * renders.
+         */
+        if(!mQueue.empty())
+            mCond.notify_one();
+        lock.unlock();
+
+        /* Render all the updates that are due, the same as a dedicated mixing
+         * thread would.
+         */
+        DeviceBase *device{member.mDevice};
+        bool running{device->Connected.load(std::memory_order_acquire)};
+        const auto now = std::chrono::steady_clock::now();
+        const int64_t avail{std::chrono::duration_cast<seconds>((now-member.mStart) *
+            device->Frequency).count()};
+        while(running && avail-member.mDone >= device->UpdateSize)
+        {
+            running = member.mRender();
+            member.mDone += device->UpdateSize;
+        }
+
+        /* For every completed second, increment the start time and reduce the
+         * samples done, to keep the difference from growing too large.
+         */
+        if(member.mDone >= device->Frequency)
+        {
+            const seconds s{member.mDone/device->Frequency};
+            member.mStart += s;
+            member.mDone -= device->Frequency*s.count();
+        }
+
+        lock.lock();
+        member.mRendering = false;
+        if(!member.mActive)
+            mRemoveCond.notify_all();
+        else if(running && device->Connected.load(std::memory_order_acquire))
+            schedule(member);
+    }
+}
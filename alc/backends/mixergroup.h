@@ -0,0 +1,100 @@
+#ifndef BACKENDS_MIXERGROUP_H
+#define BACKENDS_MIXERGROUP_H
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+struct DeviceBase;
+
+using uint = unsigned int;
+
+
+/* The number of threads to use for the shared mixer group. 0 disables it, so
+ * each timer-driven backend uses its own mixing thread.
+ */
+inline uint MixerGroupThreads{0};
+
+/* A group of real-time mixing threads shared between devices that render on a
+ * timer rather than being driven by an audio API (e.g. the null and wave
+ * backends). Instead of each device having its own thread that sleeps until
+ * its next update, the group threads render whichever device has the earliest
+ * deadline, so many such devices can be serviced by a few threads.
+ *
+ * The group is shared by the backends using it, and its threads are stopped
+ * when the last one lets go of it.
+ */
+class MixerGroup {
+public:
+    /* Renders one update for the member's device. Returns false if the device
+     * can't continue, removing it from the schedule.
+     */
+    using RenderFunc = std::function<bool()>;
+
+    class Member {
+        DeviceBase *mDevice{};
+        RenderFunc mRender;
+
+        std::chrono::steady_clock::time_point mStart;
+        std::chrono::steady_clock::time_point mDeadline;
+        int64_t mDone{0};
+        bool mActive{false};
+        bool mScheduled{false};
+        bool mRendering{false};
+
+        friend class MixerGroup;
+
+    public:
+        Member(DeviceBase *device, RenderFunc render)
+            : mDevice{device}, mRender{std::move(render)}
+        { }
+    };
+
+    /* Gets the shared mixer group, starting its threads as needed. Returns
+     * nullptr if the group is disabled or couldn't be started.
+     */
+    static auto Get() -> std::shared_ptr<MixerGroup>;
+
+    /* Starts scheduling the member's updates, from the current time. */
+    void add(Member &member);
+    /* Stops scheduling the member, waiting for any update in progress to
+     * finish.
+     */
+    void remove(Member &member);
+
+    MixerGroup(const MixerGroup&) = delete;
+    ~MixerGroup();
+
+    MixerGroup& operator=(const MixerGroup&) = delete;
+
+private:
+    MixerGroup() = default;
+
+    static bool deadline_gt(const Member *lhs, const Member *rhs) noexcept
+    { return lhs->mDeadline > rhs->mDeadline; }
+
+    void mixerProc();
+    void schedule(Member &member);
+
+    std::mutex mLock;
+    /* Idle threads wait on this without a timeout, while one thread waits on
+     * mTimerCond for the earliest deadline. Each deadline then only wakes
+     * that thread, which hands the timer to an idle one before rendering.
+     */
+    std::condition_variable mCond;
+    std::condition_variable mTimerCond;
+    std::condition_variable mRemoveCond;
+    bool mTimerWaiting{false};
+    /* Scheduled members, as a min-heap ordered by deadline. */
+    std::vector<Member*> mQueue;
+    std::vector<std::thread> mThreads;
+    bool mQuit{false};
+};
+
+#endif /* BACKENDS_MIXERGROUP_H */
@@ -28,12 +28,15 @@
 #include <cstdint>
 #include <cstring>
 #include <functional>
+#include <memory>
+#include <optional>
 #include <thread>
 
 #include "alstring.h"
 #include "althrd_setname.h"
 #include "core/device.h"
 #include "core/helpers.h"
+#include "mixergroup.h"
 
 
 namespace {
@@ -58,6 +61,9 @@ struct NullBackend final : public BackendBase {
 
     std::atomic<bool> mKillNow{true};
     std::thread mThread;
+
+    std::shared_ptr<MixerGroup> mGroup;
+    std::optional<MixerGroup::Member> mGroupMember;
 };
 
 int NullBackend::mixerProc()
@@ -123,6 +129,17 @@ bool NullBackend::reset()
 
 void NullBackend::start()
 {
+    if(!mGroup)
+        mGroup = MixerGroup::Get();
+    if(mGroup)
+    {
+        mGroup->add(mGroupMember.emplace(mDevice, [this]
+        {
+            mDevice->renderSamples(nullptr, mDevice->UpdateSize, 0u);
+            return true;
+        }));
+        return;
+    }
     try {
         mKillNow.store(false, std::memory_order_release);
         mThread = std::thread{std::mem_fn(&NullBackend::mixerProc), this};
@@ -135,6 +152,12 @@ void NullBackend::start()
 
 void NullBackend::stop()
 {
+    if(mGroupMember)
+    {
+        mGroup->remove(*mGroupMember);
+        mGroupMember.reset();
+        return;
+    }
     if(mKillNow.exchange(true, std::memory_order_acq_rel) || !mThread.joinable())
         return;
     mThread.join();
@@ -231,6 +231,8 @@ struct OboeCapture final : public BackendBase, public oboe::AudioStreamCallback
     void stop() override;
     void captureSamples(std::byte *buffer, uint samples) override;
     uint availableSamples() override;
+    auto acquireCaptureSamples(uint samples) -> CaptureSegments override;
+    void releaseCaptureSamples(uint samples) override;
 };
 
 oboe::DataCallbackResult OboeCapture::onAudioReady(oboe::AudioStream*, void *audioData,
@@ -339,6 +341,12 @@ uint OboeCapture::availableSamples()
 void OboeCapture::captureSamples(std::byte *buffer, uint samples)
 { std::ignore = mRing->read(buffer, samples); }
 
+auto OboeCapture::acquireCaptureSamples(uint samples) -> CaptureSegments
+{ return AcquireRingSamples(*mRing, samples); }
+
+void OboeCapture::releaseCaptureSamples(uint samples)
+{ ReleaseRingSamples(*mRing, samples); }
+
 } // namespace
 
 bool OboeBackendFactory::init() { return true; }
@@ -473,6 +473,8 @@ struct OSScapture final : public BackendBase {
     void stop() override;
     void captureSamples(std::byte *buffer, uint samples) override;
     uint availableSamples() override;
+    auto acquireCaptureSamples(uint samples) -> CaptureSegments override;
+    void releaseCaptureSamples(uint samples) override;
 
     int mFd{-1};
 
@@ -643,6 +645,12 @@ void OSScapture::stop()
 void OSScapture::captureSamples(std::byte *buffer, uint samples)
 { std::ignore = mRing->read(buffer, samples); }
 
+auto OSScapture::acquireCaptureSamples(uint samples) -> CaptureSegments
+{ return AcquireRingSamples(*mRing, samples); }
+
+void OSScapture::releaseCaptureSamples(uint samples)
+{ ReleaseRingSamples(*mRing, samples); }
+
 uint OSScapture::availableSamples()
 { return static_cast<uint>(mRing->readSpace()); }
 
@@ -1916,6 +1916,8 @@ class PipeWireCapture final : public BackendBase {
     void stop() override;
     void captureSamples(std::byte *buffer, uint samples) override;
     uint availableSamples() override;
+    auto acquireCaptureSamples(uint samples) -> CaptureSegments override;
+    void releaseCaptureSamples(uint samples) override;
 
     uint64_t mTargetId{PwIdAny};
     ThreadMainloop mLoop;
@@ -2189,6 +2191,12 @@ uint PipeWireCapture::availableSamples()
 void PipeWireCapture::captureSamples(std::byte *buffer, uint samples)
 { std::ignore = mRing->read(buffer, samples); }
 
+auto PipeWireCapture::acquireCaptureSamples(uint samples) -> CaptureSegments
+{ return AcquireRingSamples(*mRing, samples); }
+
+void PipeWireCapture::releaseCaptureSamples(uint samples)
+{ ReleaseRingSamples(*mRing, samples); }
+
 } // namespace
 
 
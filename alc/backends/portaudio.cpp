@@ -302,6 +302,8 @@ struct PortCapture final : public BackendBase {
     void stop() override;
     void captureSamples(std::byte *buffer, uint samples) override;
     uint availableSamples() override;
+    auto acquireCaptureSamples(uint samples) -> CaptureSegments override;
+    void releaseCaptureSamples(uint samples) override;
 
     PaStream *mStream{nullptr};
     PaStreamParameters mParams{};
@@ -421,6 +423,12 @@ uint PortCapture::availableSamples()
 void PortCapture::captureSamples(std::byte *buffer, uint samples)
 { std::ignore = mRing->read(buffer, samples); }
 
+auto PortCapture::acquireCaptureSamples(uint samples) -> CaptureSegments
+{ return AcquireRingSamples(*mRing, samples); }
+
+void PortCapture::releaseCaptureSamples(uint samples)
+{ ReleaseRingSamples(*mRing, samples); }
+
 } // namespace
 
 
@@ -290,6 +290,8 @@ struct SndioCapture final : public BackendBase {
     void stop() override;
     void captureSamples(std::byte *buffer, uint samples) override;
     uint availableSamples() override;
+    auto acquireCaptureSamples(uint samples) -> CaptureSegments override;
+    void releaseCaptureSamples(uint samples) override;
 
     sio_hdl *mSndHandle{nullptr};
 
@@ -503,6 +505,12 @@ void SndioCapture::stop()
 void SndioCapture::captureSamples(std::byte *buffer, uint samples)
 { std::ignore = mRing->read(buffer, samples); }
 
+auto SndioCapture::acquireCaptureSamples(uint samples) -> CaptureSegments
+{ return AcquireRingSamples(*mRing, samples); }
+
+void SndioCapture::releaseCaptureSamples(uint samples)
+{ ReleaseRingSamples(*mRing, samples); }
+
 uint SndioCapture::availableSamples()
 { return static_cast<uint>(mRing->readSpace()); }
 
@@ -2145,6 +2145,8 @@ struct WasapiCapture final : public BackendBase, WasapiProxy {
 
     void captureSamples(std::byte *buffer, uint samples) override;
     uint availableSamples() override;
+    auto acquireCaptureSamples(uint samples) -> CaptureSegments override;
+    void releaseCaptureSamples(uint samples) override;
 
     HRESULT mOpenStatus{E_FAIL};
     DeviceHandle mMMDev{nullptr};
@@ -2693,6 +2695,12 @@ void WasapiCapture::stopProxy()
 void WasapiCapture::captureSamples(std::byte *buffer, uint samples)
 { std::ignore = mRing->read(buffer, samples); }
 
+auto WasapiCapture::acquireCaptureSamples(uint samples) -> CaptureSegments
+{ return AcquireRingSamples(*mRing, samples); }
+
+void WasapiCapture::releaseCaptureSamples(uint samples)
+{ ReleaseRingSamples(*mRing, samples); }
+
 uint WasapiCapture::availableSamples()
 { return static_cast<uint>(mRing->readSpace()); }
 
@@ -31,6 +31,8 @@
 #include <cstring>
 #include <exception>
 #include <functional>
+#include <memory>
+#include <optional>
 #include <system_error>
 #include <thread>
 #include <vector>
@@ -44,6 +46,7 @@
 #include "core/device.h"
 #include "core/helpers.h"
 #include "core/logging.h"
+#include "mixergroup.h"
 #include "opthelpers.h"
 #include "strutils.h"
 
@@ -102,6 +105,7 @@ struct WaveBackend final : public BackendBase {
     WaveBackend(DeviceBase *device) noexcept : BackendBase{device} { }
     ~WaveBackend() override;
 
+    bool writeUpdate();
     int mixerProc();
 
     void open(std::string_view name) override;
@@ -116,19 +120,56 @@ struct WaveBackend final : public BackendBase {
 
     std::atomic<bool> mKillNow{true};
     std::thread mThread;
+
+    std::shared_ptr<MixerGroup> mGroup;
+    std::optional<MixerGroup::Member> mGroupMember;
 };
 
 WaveBackend::~WaveBackend() = default;
 
+bool WaveBackend::writeUpdate()
+{
+    const size_t frameStep{mDevice->channelsFromFmt()};
+    const size_t frameSize{mDevice->frameSizeFromFmt()};
+
+    mDevice->renderSamples(mBuffer.data(), mDevice->UpdateSize, frameStep);
+    if(al::endian::native != al::endian::little)
+    {
+        const uint bytesize{mDevice->bytesFromFmt()};
+
+        if(bytesize == 2)
+        {
+            const size_t len{mBuffer.size() & ~1_uz};
+            for(size_t i{0};i < len;i+=2)
+                std::swap(mBuffer[i], mBuffer[i+1]);
+        }
+        else if(bytesize == 4)
+        {
+            const size_t len{mBuffer.size() & ~3_uz};
+            for(size_t i{0};i < len;i+=4)
+            {
+                std::swap(mBuffer[i  ], mBuffer[i+3]);
+                std::swap(mBuffer[i+1], mBuffer[i+2]);
+            }
+        }
+    }
+
+    const size_t fs{fwrite(mBuffer.data(), frameSize, mDevice->UpdateSize, mFile.get())};
+    if(fs < mDevice->UpdateSize || ferror(mFile.get()))
+    {
+        ERR("Error writing to file\n");
+        mDevice->handleDisconnect("Failed to write playback samples");
+        return false;
+    }
+    return true;
+}
+
 int WaveBackend::mixerProc()
 {
     const milliseconds restTime{mDevice->UpdateSize*1000/mDevice->Frequency / 2};
 
     althrd_setname(GetMixerThreadName());
 
-    const size_t frameStep{mDevice->channelsFromFmt()};
-    const size_t frameSize{mDevice->frameSizeFromFmt()};
-
     int64_t done{0};
     auto start = std::chrono::steady_clock::now();
     while(!mKillNow.load(std::memory_order_acquire)
@@ -146,37 +187,9 @@ int WaveBackend::mixerProc()
         }
         while(avail-done >= mDevice->UpdateSize)
         {
-            mDevice->renderSamples(mBuffer.data(), mDevice->UpdateSize, frameStep);
-            done += mDevice->UpdateSize;
-
-            if(al::endian::native != al::endian::little)
-            {
-                const uint bytesize{mDevice->bytesFromFmt()};
-
-                if(bytesize == 2)
-                {
-                    const size_t len{mBuffer.size() & ~1_uz};
-                    for(size_t i{0};i < len;i+=2)
-                        std::swap(mBuffer[i], mBuffer[i+1]);
-                }
-                else if(bytesize == 4)
-                {
-                    const size_t len{mBuffer.size() & ~3_uz};
-                    for(size_t i{0};i < len;i+=4)
-                    {
-                        std::swap(mBuffer[i  ], mBuffer[i+3]);
-                        std::swap(mBuffer[i+1], mBuffer[i+2]);
-                    }
-                }
-            }
-
-            const size_t fs{fwrite(mBuffer.data(), frameSize, mDevice->UpdateSize, mFile.get())};
-            if(fs < mDevice->UpdateSize || ferror(mFile.get()))
-            {
-                ERR("Error writing to file\n");
-                mDevice->handleDisconnect("Failed to write playback samples");
+            if(!writeUpdate())
                 break;
-            }
+            done += mDevice->UpdateSize;
         }
 
         /* For every completed second, increment the start time and reduce the
@@ -340,6 +353,14 @@ void WaveBackend::start()
 {
     if(mDataStart > 0 && fseek(mFile.get(), 0, SEEK_END) != 0)
         WARN("Failed to seek on output file\n");
+
+    if(!mGroup)
+        mGroup = MixerGroup::Get();
+    if(mGroup)
+    {
+        mGroup->add(mGroupMember.emplace(mDevice, [this]{ return writeUpdate(); }));
+        return;
+    }
     try {
         mKillNow.store(false, std::memory_order_release);
         mThread = std::thread{std::mem_fn(&WaveBackend::mixerProc), this};
@@ -352,9 +373,17 @@ void WaveBackend::start()
 
 void WaveBackend::stop()
 {
-    if(mKillNow.exchange(true, std::memory_order_acq_rel) || !mThread.joinable())
-        return;
-    mThread.join();
+    if(mGroupMember)
+    {
+        mGroup->remove(*mGroupMember);
+        mGroupMember.reset();
+    }
+    else
+    {
+        if(mKillNow.exchange(true, std::memory_order_acq_rel) || !mThread.joinable())
+            return;
+        mThread.join();
+    }
 
     if(mDataStart > 0)
     {
@@ -365,6 +365,8 @@ struct WinMMCapture final : public BackendBase {
     void stop() override;
     void captureSamples(std::byte *buffer, uint samples) override;
     uint availableSamples() override;
+    auto acquireCaptureSamples(uint samples) -> CaptureSegments override;
+    void releaseCaptureSamples(uint samples) override;
 
     std::atomic<uint> mReadable{0u};
     al::semaphore mSem;
@@ -563,6 +565,12 @@ void WinMMCapture::stop()
 void WinMMCapture::captureSamples(std::byte *buffer, uint samples)
 { std::ignore = mRing->read(buffer, samples); }
 
+auto WinMMCapture::acquireCaptureSamples(uint samples) -> CaptureSegments
+{ return AcquireRingSamples(*mRing, samples); }
+
+void WinMMCapture::releaseCaptureSamples(uint samples)
+{ ReleaseRingSamples(*mRing, samples); }
+
 uint WinMMCapture::availableSamples()
 { return static_cast<uint>(mRing->readSpace()); }
 
@@ -46,6 +46,11 @@ namespace {
 using namespace std::string_view_literals;
 using voidp = void*;
 
+/* How many times to check for the mixer finishing its updates before waiting
+ * to be signaled.
+ */
+constexpr unsigned int UpdateWaitSpinCount{256u};
+
 /* Default context extensions */
 std::vector<std::string_view> getContextExtensions() noexcept
 {
@@ -82,12 +87,15 @@ std::vector<std::string_view> getContextExtensions() noexcept
         "AL_SOFT_events"sv,
         "AL_SOFT_gain_clamp_ex"sv,
         "AL_SOFTX_hold_on_disconnect"sv,
+        "AL_SOFTX_listener_motion"sv,
         "AL_SOFT_loop_points"sv,
         "AL_SOFTX_map_buffer"sv,
         "AL_SOFT_MSADPCM"sv,
+        "AL_SOFTX_scheduled_source_params"sv,
         "AL_SOFT_source_latency"sv,
         "AL_SOFT_source_length"sv,
         "AL_SOFTX_source_panning"sv,
+        "AL_SOFTX_source_playback_snapshot"sv,
         "AL_SOFT_source_resampler"sv,
         "AL_SOFT_source_spatialize"sv,
         "AL_SOFT_source_start_delay"sv,
@@ -133,6 +141,7 @@ ALCcontext::~ALCcontext()
     if(count > 0)
         WARN("%zu Source%s not deleted\n", count, (count==1)?"":"s");
     mSourceList.clear();
+    mFreeSourceSubLists.clear();
     mNumSources = 0;
 
 #ifdef ALSOFT_EAX
@@ -302,11 +311,18 @@ void ALCcontext::deinit()
 void ALCcontext::applyAllUpdates()
 {
     /* Tell the mixer to stop applying updates, then wait for any active
-     * updating to finish, before providing updates.
+     * updating to finish, before providing updates. The mixer's updates are
+     * short, so spin a little before sleeping until it signals it's done.
      */
     mHoldUpdates.store(true, std::memory_order_release);
-    while((mUpdateCount.load(std::memory_order_acquire)&1) != 0) {
-        /* busy-wait */
+    for(unsigned int spins{0u};(mUpdateCount.load(std::memory_order_acquire)&1) != 0;++spins)
+    {
+        if(spins < UpdateWaitSpinCount)
+            continue;
+
+        mUpdateWaiting.store(true, std::memory_order_seq_cst);
+        if((mUpdateCount.load(std::memory_order_seq_cst)&1) != 0)
+            mUpdateSem.wait();
     }
 
 #ifdef ALSOFT_EAX
@@ -316,8 +332,8 @@ void ALCcontext::applyAllUpdates()
 
     if(std::exchange(mPropsDirty, false))
         UpdateContextProps(this);
-    UpdateAllEffectSlotProps(this);
-    UpdateAllSourceProps(this);
+    UpdateDirtyEffectSlotProps(this);
+    UpdateDirtySourceProps(this);
 
     /* Now with all updates declared, let the mixer continue applying them so
      * they all happen at once.
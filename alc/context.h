@@ -17,6 +17,7 @@
 #include "AL/alc.h"
 #include "AL/alext.h"
 
+#include "al/auxeffectslot.h"
 #include "al/listener.h"
 #include "almalloc.h"
 #include "alnumeric.h"
@@ -107,16 +108,30 @@ struct ALCcontext : public al::intrusive_ref<ALCcontext>, ContextBase {
     ALlistener mListener{};
 
     std::vector<SourceSubList> mSourceList;
+    /* Indices of the source sublists that have free entries, so allocating
+     * doesn't need to search for one.
+     */
+    std::vector<ALuint> mFreeSourceSubLists;
     ALuint mNumSources{0};
     std::mutex mSourceLock;
+    /* Sources with pending property changes, linked through their mNextDirty
+     * and mPrevDirty members. Guarded by mSourceLock.
+     */
+    ALsource *mDirtySources{nullptr};
 
     std::vector<EffectSlotSubList> mEffectSlotList;
     ALuint mNumEffectSlots{0u};
     std::mutex mEffectSlotLock;
+    /* Effect slots with pending property changes, linked through their
+     * mNextDirty and mPrevDirty members. Guarded by mEffectSlotLock.
+     */
+    ALeffectslot *mDirtySlots{nullptr};
 
     /* Default effect slot */
     std::unique_ptr<ALeffectslot> mDefaultSlot;
 
+    EffectStatePool mEffectStatePool;
+
     std::vector<std::string_view> mExtensions;
     std::string mExtensionsString{};
 
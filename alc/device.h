@@ -68,9 +68,17 @@ struct ALCdevice : public al::intrusive_ref<ALCdevice>, DeviceBase {
 
     std::atomic<ALCenum> LastError{ALC_NO_ERROR};
 
+    /* Number of capture samples acquired by the app for reading in place, and
+     * not yet released. Protected by StateLock.
+     */
+    uint mCaptureAcquired{0u};
+
     // Map of Buffers for this device
     std::mutex BufferLock;
     std::vector<BufferSubList> BufferList;
+    /* Indices of the buffer sublists that have free entries. */
+    std::vector<ALuint> FreeBufferSubLists;
+    size_t NumBuffers{0};
 
     // Map of Effects for this device
     std::mutex EffectLock;
@@ -9,6 +9,16 @@
  */
 inline float ReverbBoost{1.0f};
 
+/* This is a user config option for choosing between accurate and fast (but
+ * approximate) math for the pitch shifter's frequency analysis and synthesis.
+ * The fast math slightly changes the output, so it needs to be opted into.
+ */
+enum class PshifterQuality : unsigned char {
+    Fast,
+    Accurate
+};
+inline PshifterQuality PitchShifterQuality{PshifterQuality::Accurate};
+
 
 EffectStateFactory *NullStateFactory_getFactory();
 EffectStateFactory *ReverbStateFactory_getFactory();
@@ -25,6 +25,7 @@
 #include <cmath>
 #include <cstdlib>
 #include <limits>
+#include <tuple>
 #include <variant>
 #include <vector>
 
@@ -41,6 +42,7 @@
 #include "core/effectslot.h"
 #include "core/mixer.h"
 #include "core/mixer/defs.h"
+#include "core/oscillator.h"
 #include "core/resampler_limits.h"
 #include "intrusive_ptr.h"
 #include "opthelpers.h"
@@ -62,9 +64,8 @@ struct ChorusState final : public EffectState {
     std::vector<float> mDelayBuffer;
     uint mOffset{0};
 
+    Oscillator mLfo;
     uint mLfoOffset{0};
-    uint mLfoRange{1};
-    float mLfoScale{0.0f};
     uint mLfoDisp{0};
 
     /* Calculated delays to apply to the left and right outputs. */
@@ -81,13 +82,10 @@ struct ChorusState final : public EffectState {
     std::array<OutGains,2> mGains;
 
     /* effect parameters */
-    ChorusWaveform mWaveform{};
     int mDelay{0};
-    float mDepth{0.0f};
     float mFeedback{0.0f};
 
-    void calcTriangleDelays(const size_t todo);
-    void calcSinusoidDelays(const size_t todo);
+    void calcDelays(const size_t todo);
 
     void deviceUpdate(const DeviceBase *device, const float MaxDelay);
     void update(const ContextBase *context, const EffectSlot *slot, const ChorusWaveform waveform,
@@ -111,6 +109,12 @@ void ChorusState::deviceUpdate(const DeviceBase *Device, const BufferStorage*)
         decltype(mDelayBuffer)(maxlen).swap(mDelayBuffer);
 
     std::fill(mDelayBuffer.begin(), mDelayBuffer.end(), 0.0f);
+    mOffset = 0;
+
+    mLfo = Oscillator{};
+    mLfoOffset = 0;
+    mLfoDisp = 0;
+
     for(auto &e : mGains)
     {
         e.Current.fill(0.0f);
@@ -130,11 +134,15 @@ void ChorusState::update(const ContextBase *context, const EffectSlot *slot,
     const DeviceBase *device{context->mDevice};
     const auto frequency = static_cast<float>(device->Frequency);
 
-    mWaveform = props.Waveform;
+    switch(props.Waveform)
+    {
+    case ChorusWaveform::Triangle: mLfo.mWaveform = OscWaveform::Triangle; break;
+    case ChorusWaveform::Sinusoid: mLfo.mWaveform = OscWaveform::Sinusoid; break;
+    }
 
     const auto stepscale = float{frequency * gCubicTable.sTableSteps};
     mDelay = std::max(float2int(std::round(props.Delay * stepscale)), mindelay);
-    mDepth = std::min(static_cast<float>(mDelay) * props.Depth,
+    mLfo.mGain = std::min(static_cast<float>(mDelay) * props.Depth,
         static_cast<float>(mDelay - mindelay));
 
     mFeedback = props.Feedback;
@@ -155,8 +163,8 @@ void ChorusState::update(const ContextBase *context, const EffectSlot *slot,
     if(!(props.Rate > 0.0f))
     {
         mLfoOffset = 0;
-        mLfoRange = 1;
-        mLfoScale = 0.0f;
+        mLfo.mRange = 1;
+        mLfo.mScale = 0.0f;
         mLfoDisp = 0;
     }
     else
@@ -168,98 +176,31 @@ void ChorusState::update(const ContextBase *context, const EffectSlot *slot,
         const auto range = std::round(frequency / props.Rate);
         const uint lfo_range{float2uint(std::min(range, float{range_limit}))};
 
-        mLfoOffset = mLfoOffset * lfo_range / mLfoRange;
-        mLfoRange = lfo_range;
-        switch(mWaveform)
-        {
-        case ChorusWaveform::Triangle:
-            mLfoScale = 4.0f / static_cast<float>(mLfoRange);
-            break;
-        case ChorusWaveform::Sinusoid:
-            mLfoScale = al::numbers::pi_v<float>*2.0f / static_cast<float>(mLfoRange);
-            break;
-        }
+        mLfoOffset = mLfoOffset * lfo_range / mLfo.mRange;
+        mLfo.mRange = lfo_range;
+        mLfo.mScale = 1.0f / static_cast<float>(lfo_range);
 
         /* Calculate lfo phase displacement */
         auto phase = props.Phase;
         if(phase < 0) phase += 360;
-        mLfoDisp = (mLfoRange*static_cast<uint>(phase) + 180) / 360;
+        mLfoDisp = (lfo_range*static_cast<uint>(phase) + 180) / 360;
     }
 }
 
 
-void ChorusState::calcTriangleDelays(const size_t todo)
-{
-    const uint lfo_range{mLfoRange};
-    const float lfo_scale{mLfoScale};
-    const float depth{mDepth};
-    const int delay{mDelay};
-
-    auto gen_lfo = [lfo_scale,depth,delay](const uint offset) -> uint
-    {
-        const float offset_norm{static_cast<float>(offset) * lfo_scale};
-        return static_cast<uint>(fastf2i((1.0f-std::abs(2.0f-offset_norm)) * depth) + delay);
-    };
-
-    uint offset{mLfoOffset};
-    ASSUME(lfo_range > offset);
-    auto ldelays = mModDelays[0].begin();
-    for(size_t i{0};i < todo;)
-    {
-        const size_t rem{std::min(todo-i, size_t{lfo_range-offset})};
-        ldelays = std::generate_n(ldelays, rem, [&offset,gen_lfo] { return gen_lfo(offset++); });
-        if(offset == lfo_range) offset = 0;
-        i += rem;
-    }
-
-    offset = (mLfoOffset+mLfoDisp) % lfo_range;
-    auto rdelays = mModDelays[1].begin();
-    for(size_t i{0};i < todo;)
-    {
-        const size_t rem{std::min(todo-i, size_t{lfo_range-offset})};
-        rdelays = std::generate_n(rdelays, rem, [&offset,gen_lfo] { return gen_lfo(offset++); });
-        if(offset == lfo_range) offset = 0;
-        i += rem;
-    }
-
-    mLfoOffset = static_cast<uint>(mLfoOffset+todo) % lfo_range;
-}
-
-void ChorusState::calcSinusoidDelays(const size_t todo)
+void ChorusState::calcDelays(const size_t todo)
 {
-    const uint lfo_range{mLfoRange};
-    const float lfo_scale{mLfoScale};
-    const float depth{mDepth};
+    alignas(16) std::array<float,BufferLineSize> lfo{};
+    const auto lfobuf = al::span{lfo}.first(todo);
     const int delay{mDelay};
+    auto to_delay = [delay](const float mod) -> uint
+    { return static_cast<uint>(fastf2i(mod) + delay); };
 
-    auto gen_lfo = [lfo_scale,depth,delay](const uint offset) -> uint
-    {
-        const float offset_norm{static_cast<float>(offset) * lfo_scale};
-        return static_cast<uint>(fastf2i(std::sin(offset_norm)*depth) + delay);
-    };
-
-    uint offset{mLfoOffset};
-    ASSUME(lfo_range > offset);
-    auto ldelays = mModDelays[0].begin();
-    for(size_t i{0};i < todo;)
-    {
-        const size_t rem{std::min(todo-i, size_t{lfo_range-offset})};
-        ldelays = std::generate_n(ldelays, rem, [&offset,gen_lfo] { return gen_lfo(offset++); });
-        if(offset == lfo_range) offset = 0;
-        i += rem;
-    }
-
-    offset = (mLfoOffset+mLfoDisp) % lfo_range;
-    auto rdelays = mModDelays[1].begin();
-    for(size_t i{0};i < todo;)
-    {
-        const size_t rem{std::min(todo-i, size_t{lfo_range-offset})};
-        rdelays = std::generate_n(rdelays, rem, [&offset,gen_lfo] { return gen_lfo(offset++); });
-        if(offset == lfo_range) offset = 0;
-        i += rem;
-    }
+    std::ignore = mLfo.generate(lfobuf, (mLfoOffset+mLfoDisp) % mLfo.mRange);
+    std::transform(lfobuf.begin(), lfobuf.end(), mModDelays[1].begin(), to_delay);
 
-    mLfoOffset = static_cast<uint>(mLfoOffset+todo) % lfo_range;
+    mLfoOffset = mLfo.generate(lfobuf, mLfoOffset);
+    std::transform(lfobuf.begin(), lfobuf.end(), mModDelays[0].begin(), to_delay);
 }
 
 void ChorusState::process(const size_t samplesToDo, const al::span<const FloatBufferLine> samplesIn, const al::span<FloatBufferLine> samplesOut)
@@ -270,10 +211,7 @@ void ChorusState::process(const size_t samplesToDo, const al::span<const FloatBu
     const uint avgdelay{(static_cast<uint>(mDelay) + MixerFracHalf) >> MixerFracBits};
     uint offset{mOffset};
 
-    if(mWaveform == ChorusWaveform::Sinusoid)
-        calcSinusoidDelays(samplesToDo);
-    else /*if(mWaveform == ChorusWaveform::Triangle)*/
-        calcTriangleDelays(samplesToDo);
+    calcDelays(samplesToDo);
 
     const auto ldelays = al::span{mModDelays[0]};
     const auto rdelays = al::span{mModDelays[1]};
@@ -97,6 +97,8 @@ void CompressorState::deviceUpdate(const DeviceBase *device, const BufferStorage
      */
     mAttackMult  = std::pow(AmpEnvelopeMax/AmpEnvelopeMin, 1.0f/attackCount);
     mReleaseMult = std::pow(AmpEnvelopeMin/AmpEnvelopeMax, 1.0f/releaseCount);
+
+    mEnvFollower = 1.0f;
 }
 
 void CompressorState::update(const ContextBase*, const EffectSlot *slot,
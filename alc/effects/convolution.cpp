@@ -3,13 +3,23 @@
 
 #include <algorithm>
 #include <array>
+#include <atomic>
 #include <cassert>
 #include <cmath>
 #include <complex>
+#include <condition_variable>
 #include <cstddef>
 #include <cstdint>
+#include <cstring>
+#include <deque>
+#include <exception>
 #include <functional>
 #include <memory>
+#include <mutex>
+#include <system_error>
+#include <thread>
+#include <tuple>
+#include <utility>
 #include <vector>
 #include <variant>
 
@@ -35,6 +45,7 @@
 #include "core/effectslot.h"
 #include "core/filters/splitter.h"
 #include "core/fmt_traits.h"
+#include "core/logging.h"
 #include "core/mixer.h"
 #include "core/uhjfilter.h"
 #include "intrusive_ptr.h"
@@ -216,6 +227,332 @@ void apply_fir(al::span<float> dst, const al::span<const float> input, const al:
 }
 
 
+/* An impulse response prepared for convolution. It's prepared on a separate
+ * thread, and may be shared by multiple effect states using the same buffer
+ * data with the same device sample rate.
+ */
+struct ConvolutionFilter {
+    /* The first segment of each channel, stored in reverse to apply as a
+     * time-domain FIR filter.
+     */
+    al::vector<std::array<float,ConvolveUpdateSamples>,16> mFilter;
+    /* The remaining segments of each channel, in the frequency domain. */
+    al::vector<float,16> mComplexData;
+
+    /* Set once the filter is prepared. The above is read-only after. */
+    std::atomic<bool> mReady{false};
+};
+using ConvolutionFilterPtr = std::shared_ptr<ConvolutionFilter>;
+
+/* Identifies a prepared filter by the buffer's format and a hash of its data,
+ * along with the device sample rate it was prepared for. Matching keys are
+ * confirmed by comparing the data itself, so a hash collision can't pick the
+ * wrong impulse response.
+ */
+struct FilterKey {
+    uint64_t mDataHash{};
+    size_t mDataSize{};
+    uint mSampleLen{}, mSampleRate{}, mDeviceRate{};
+    FmtChannels mChannels{};
+    FmtType mType{};
+    AmbiLayout mAmbiLayout{};
+    AmbiScaling mAmbiScaling{};
+    uint mAmbiOrder{};
+
+    [[nodiscard]] auto tie() const noexcept
+    {
+        return std::tie(mDataHash, mDataSize, mSampleLen, mSampleRate, mDeviceRate, mChannels,
+            mType, mAmbiLayout, mAmbiScaling, mAmbiOrder);
+    }
+    bool operator==(const FilterKey &rhs) const noexcept { return tie() == rhs.tie(); }
+};
+
+FilterKey MakeFilterKey(const BufferStorage &buffer, const uint devrate) noexcept
+{
+    /* FNV-1a, over 64-bit words with any remaining bytes. */
+    static constexpr uint64_t FnvPrime{0x100000001b3};
+    uint64_t hash{0xcbf29ce484222325};
+    auto data = al::span<const std::byte>{buffer.mData};
+    for(;data.size() >= sizeof(uint64_t);data = data.subspan(sizeof(uint64_t)))
+    {
+        uint64_t word{};
+        std::memcpy(&word, data.data(), sizeof(word));
+        hash = (hash^word) * FnvPrime;
+    }
+    for(const std::byte b : data)
+        hash = (hash^static_cast<uint64_t>(b)) * FnvPrime;
+
+    return FilterKey{hash, buffer.mData.size(), buffer.mSampleLen, buffer.mSampleRate, devrate,
+        buffer.mChannels, buffer.mType, buffer.mAmbiLayout, buffer.mAmbiScaling,
+        buffer.mAmbiOrder};
+}
+
+bool FilterMatches(const FilterKey &key, const al::span<const std::byte> data,
+    const FilterKey &otherkey, const std::vector<std::byte> &otherdata) noexcept
+{
+    return key == otherkey && std::equal(data.begin(), data.end(), otherdata.cbegin(),
+        otherdata.cend());
+}
+
+/* Resamples the loaded impulse response to the device rate, and splits it
+ * into the FIR segment and frequency-domain segments for each channel.
+ */
+void PrepareFilter(ConvolutionFilter &filter, const al::span<const float> srcsamples,
+    const size_t srclinelength, const uint srcLength, const uint srcRate, const uint devRate,
+    const size_t numChannels, const size_t numSegs)
+{
+    /* The impulse response needs to have the same sample rate as the input and
+     * output. The bsinc24 resampler is decent, but there is high-frequency
+     * attenuation that some people may be able to pick up on. Since this is
+     * called very infrequently, go ahead and use the polyphase resampler.
+     */
+    PPhaseResampler resampler;
+    if(devRate != srcRate)
+        resampler.init(srcRate, devRate);
+    const auto resampledCount = static_cast<uint>(
+        (uint64_t{srcLength}*devRate + (srcRate-1)) / srcRate);
+
+    /* Resample all the channels to match the device. */
+    auto ressamples = std::vector<float>(resampler ? resampledCount*numChannels : 0_uz);
+    if(resampler)
+        resampler.processBatch(srcsamples, srclinelength, srcLength, ressamples, resampledCount,
+            resampledCount);
+
+    const PFFFTSetup fft{ConvolveUpdateSize, PFFFT_REAL};
+    auto ffttmp = al::vector<float,16>(ConvolveUpdateSize);
+    auto fftbuffer = std::vector<std::complex<double>>(ConvolveUpdateSize);
+
+    filter.mFilter.resize(numChannels, {});
+    filter.mComplexData.resize(numSegs * ConvolveUpdateSize * numChannels, 0.0f);
+    auto filteriter = filter.mComplexData.begin();
+    for(size_t c{0};c < numChannels;++c)
+    {
+        const auto chansamples = resampler
+            ? al::span{std::as_const(ressamples)}.subspan(resampledCount*c, resampledCount)
+            : srcsamples.subspan(srclinelength*c, resampledCount);
+
+        /* Store the first segment's samples in reverse in the time-domain, to
+         * apply as a FIR filter.
+         */
+        const size_t first_size{std::min(size_t{resampledCount}, ConvolveUpdateSamples)};
+        auto sampleseg = chansamples.first(first_size);
+        std::copy(sampleseg.cbegin(), sampleseg.cend(), filter.mFilter[c].rbegin());
+
+        size_t done{first_size};
+        for(size_t s{0};s < numSegs;++s)
+        {
+            const size_t todo{std::min(resampledCount-done, ConvolveUpdateSamples)};
+            sampleseg = chansamples.subspan(done, todo);
+
+            /* Apply a double-precision forward FFT for more precise frequency
+             * measurements.
+             */
+            auto iter = std::copy(sampleseg.cbegin(), sampleseg.cend(), fftbuffer.begin());
+            done += todo;
+            std::fill(iter, fftbuffer.end(), std::complex<double>{});
+            forward_fft(al::span{fftbuffer});
+
+            /* Convert to, and pack in, a float buffer for PFFFT. Note that the
+             * first bin stores the real component of the half-frequency bin in
+             * the imaginary component. Also scale the FFT by its length so the
+             * iFFT'd output will be normalized.
+             */
+            static constexpr float fftscale{1.0f / float{ConvolveUpdateSize}};
+            for(size_t i{0};i < ConvolveUpdateSamples;++i)
+            {
+                ffttmp[i*2    ] = static_cast<float>(fftbuffer[i].real()) * fftscale;
+                ffttmp[i*2 + 1] = static_cast<float>((i == 0) ?
+                    fftbuffer[ConvolveUpdateSamples].real() : fftbuffer[i].imag()) * fftscale;
+            }
+            /* Reorder backward to make it suitable for pffft_zconvolve and the
+             * subsequent pffft_transform(..., PFFFT_BACKWARD).
+             */
+            fft.zreorder(ffttmp.data(), al::to_address(filteriter), PFFFT_BACKWARD);
+            filteriter += ConvolveUpdateSize;
+        }
+    }
+
+    filter.mReady.store(true, std::memory_order_release);
+}
+
+
+/* The loaded impulse response samples and parameters for preparing a filter,
+ * along with a copy of the buffer data it's for.
+ */
+struct FilterJob {
+    FilterKey mKey;
+    std::vector<std::byte> mData;
+    ConvolutionFilterPtr mFilter;
+    std::vector<float> mSamples;
+    size_t mLineLength{};
+    uint mSrcLength{}, mSrcRate{}, mDevRate{};
+    size_t mNumChannels{}, mNumSegs{};
+
+    FilterJob() = default;
+    FilterJob(FilterJob&&) = default;
+    ~FilterJob();
+
+    FilterJob& operator=(FilterJob&&) = default;
+
+    void prepare() const
+    {
+        PrepareFilter(*mFilter, mSamples, mLineLength, mSrcLength, mSrcRate, mDevRate,
+            mNumChannels, mNumSegs);
+    }
+};
+FilterJob::~FilterJob() = default;
+
+/* Prepares filters, and keeps the most recently used ones so rebinding an
+ * impulse response or resetting the device doesn't need to prepare them
+ * again. One instance is shared by all convolution effect states, created
+ * with the first and deleted with the last, so the cached filters (which can
+ * be large) are freed once no convolution effect exists.
+ *
+ * Filters are prepared on a single worker thread, in the order they're
+ * queued. The thread is started with the first queued job, and is stopped and
+ * joined with the instance, waiting for the job in progress to finish. Jobs
+ * for filters no effect state uses anymore are skipped.
+ */
+class FilterPreparer {
+    static constexpr size_t MaxCachedFilters{4};
+
+    struct CacheEntry {
+        FilterKey mKey;
+        std::vector<std::byte> mData;
+        ConvolutionFilterPtr mFilter;
+    };
+
+    static inline std::mutex sInstanceLock;
+    static inline std::weak_ptr<FilterPreparer> sInstance;
+
+    std::mutex mLock;
+    std::condition_variable mCond;
+    std::deque<FilterJob> mJobs;
+    /* The job being prepared by the worker thread. */
+    const FilterJob *mCurrentJob{};
+    /* Prepared filters, from least to most recently used. */
+    std::vector<CacheEntry> mCache;
+    std::thread mThread;
+    bool mQuit{false};
+
+    /* Adds the prepared job's filter to the cache. Must be called with the
+     * lock held.
+     */
+    void cacheFilter(FilterJob &job)
+    {
+        if(mCache.size() >= MaxCachedFilters)
+            mCache.erase(mCache.begin());
+        mCache.emplace_back(CacheEntry{job.mKey, std::move(job.mData), std::move(job.mFilter)});
+    }
+
+    void workerProc()
+    {
+        auto lock = std::unique_lock{mLock};
+        while(true)
+        {
+            mCond.wait(lock, [this]{ return mQuit || !mJobs.empty(); });
+            if(mQuit) break;
+
+            auto job = std::move(mJobs.front());
+            mJobs.pop_front();
+            if(job.mFilter.use_count() == 1)
+                continue;
+            mCurrentJob = &job;
+            lock.unlock();
+
+            /* On failure, the filter is dropped, leaving the effect silent. */
+            bool prepared{false};
+            try {
+                job.prepare();
+                prepared = true;
+            }
+            catch(std::exception &e) {
+                ERR("Failed to prepare convolution filter: %s\n", e.what());
+            }
+            catch(...) {
+                ERR("Failed to prepare convolution filter\n");
+            }
+
+            lock.lock();
+            mCurrentJob = nullptr;
+            if(prepared)
+                cacheFilter(job);
+        }
+    }
+
+public:
+    FilterPreparer() = default;
+    FilterPreparer(const FilterPreparer&) = delete;
+    ~FilterPreparer()
+    {
+        auto lock = std::unique_lock{mLock};
+        mQuit = true;
+        lock.unlock();
+        mCond.notify_all();
+        if(mThread.joinable())
+            mThread.join();
+    }
+
+    FilterPreparer& operator=(const FilterPreparer&) = delete;
+
+    /* Gets the shared instance, creating it if needed. */
+    static auto Get() -> std::shared_ptr<FilterPreparer>
+    {
+        auto instlock = std::lock_guard{sInstanceLock};
+        auto inst = sInstance.lock();
+        if(!inst)
+        {
+            inst = std::make_shared<FilterPreparer>();
+            sInstance = inst;
+        }
+        return inst;
+    }
+
+    /* Returns the prepared or pending filter for the buffer data, if any. */
+    auto find(const FilterKey &key, const al::span<const std::byte> data) -> ConvolutionFilterPtr
+    {
+        auto lock = std::lock_guard{mLock};
+        auto cacheiter = std::find_if(mCache.begin(), mCache.end(),
+            [&key,data](const CacheEntry &entry) noexcept
+            { return FilterMatches(key, data, entry.mKey, entry.mData); });
+        if(cacheiter != mCache.end())
+        {
+            std::rotate(cacheiter, cacheiter+1, mCache.end());
+            return mCache.back().mFilter;
+        }
+
+        if(mCurrentJob && FilterMatches(key, data, mCurrentJob->mKey, mCurrentJob->mData))
+            return mCurrentJob->mFilter;
+        auto jobiter = std::find_if(mJobs.cbegin(), mJobs.cend(),
+            [&key,data](const FilterJob &job) noexcept
+            { return FilterMatches(key, data, job.mKey, job.mData); });
+        return (jobiter != mJobs.cend()) ? jobiter->mFilter : nullptr;
+    }
+
+    /* Prepares the job's filter on the calling thread, caching it once it's
+     * ready.
+     */
+    void prepare(FilterJob&& job)
+    {
+        job.prepare();
+        auto lock = std::lock_guard{mLock};
+        cacheFilter(job);
+    }
+
+    /* Queues the job for the worker thread, starting it if needed. Throws if
+     * the thread can't be started.
+     */
+    void queue(FilterJob&& job)
+    {
+        auto lock = std::lock_guard{mLock};
+        if(!mThread.joinable())
+            mThread = std::thread{std::mem_fn(&FilterPreparer::workerProc), this};
+        mJobs.emplace_back(std::move(job));
+        mCond.notify_one();
+    }
+};
+
+
 struct ConvolutionState final : public EffectState {
     FmtChannels mChannels{};
     AmbiLayout mAmbiLayout{};
@@ -224,7 +561,6 @@ struct ConvolutionState final : public EffectState {
 
     size_t mFifoPos{0};
     alignas(16) std::array<float,ConvolveUpdateSamples*2> mInput{};
-    al::vector<std::array<float,ConvolveUpdateSamples>,16> mFilter;
     al::vector<std::array<float,ConvolveUpdateSamples*2>,16> mOutput;
 
     PFFFTSetup mFft{};
@@ -242,8 +578,12 @@ struct ConvolutionState final : public EffectState {
         std::array<float,MaxOutputChannels> Target{};
     };
     std::vector<ChannelData> mChans;
+    /* The frequency-domain input history. */
     al::vector<float,16> mComplexData;
 
+    ConvolutionFilterPtr mIrFilter;
+    std::shared_ptr<FilterPreparer> mPreparer;
+
 
     ConvolutionState() = default;
     ~ConvolutionState() override = default;
@@ -292,7 +632,6 @@ void ConvolutionState::deviceUpdate(const DeviceBase *device, const BufferStorag
 
     mFifoPos = 0;
     mInput.fill(0.0f);
-    decltype(mFilter){}.swap(mFilter);
     decltype(mOutput){}.swap(mOutput);
     mFftBuffer.fill(0.0f);
     mFftWorkBuffer.fill(0.0f);
@@ -302,6 +641,7 @@ void ConvolutionState::deviceUpdate(const DeviceBase *device, const BufferStorag
 
     decltype(mChans){}.swap(mChans);
     decltype(mComplexData){}.swap(mComplexData);
+    mIrFilter = nullptr;
 
     /* An empty buffer doesn't need a convolution filter. */
     if(!buffer || buffer->mSampleLen < 1) return;
@@ -316,14 +656,6 @@ void ConvolutionState::deviceUpdate(const DeviceBase *device, const BufferStorag
 
     mChans.resize(numChannels);
 
-    /* The impulse response needs to have the same sample rate as the input and
-     * output. The bsinc24 resampler is decent, but there is high-frequency
-     * attenuation that some people may be able to pick up on. Since this is
-     * called very infrequently, go ahead and use the polyphase resampler.
-     */
-    PPhaseResampler resampler;
-    if(device->Frequency != buffer->mSampleRate)
-        resampler.init(buffer->mSampleRate, device->Frequency);
     const auto resampledCount = static_cast<uint>(
         (uint64_t{buffer->mSampleLen}*device->Frequency+(buffer->mSampleRate-1)) /
         buffer->mSampleRate);
@@ -332,7 +664,6 @@ void ConvolutionState::deviceUpdate(const DeviceBase *device, const BufferStorag
     for(auto &e : mChans)
         e.mFilter = splitter;
 
-    mFilter.resize(numChannels, {});
     mOutput.resize(numChannels, {});
 
     /* Calculate the number of segments needed to hold the impulse response and
@@ -343,13 +674,31 @@ void ConvolutionState::deviceUpdate(const DeviceBase *device, const BufferStorag
     mNumConvolveSegs = (resampledCount+(ConvolveUpdateSamples-1)) / ConvolveUpdateSamples;
     mNumConvolveSegs = std::max(mNumConvolveSegs, 2_uz) - 1_uz;
 
-    const size_t complex_length{mNumConvolveSegs * ConvolveUpdateSize * (numChannels+1)};
-    mComplexData.resize(complex_length, 0.0f);
+    mComplexData.resize(mNumConvolveSegs * ConvolveUpdateSize, 0.0f);
+
+    /* Use the previously prepared filter if this buffer was already used at
+     * this device rate, or the one being prepared for it.
+     */
+    if(!mPreparer)
+        mPreparer = FilterPreparer::Get();
+    const auto key = MakeFilterKey(*buffer, device->Frequency);
+    if((mIrFilter=mPreparer->find(key, buffer->mData)))
+        return;
 
     /* Load the samples from the buffer. */
-    const size_t srclinelength{RoundUp(buffer->mSampleLen+DecoderPadding, 16)};
-    auto srcsamples = std::vector<float>(srclinelength * numChannels);
-    std::fill(srcsamples.begin(), srcsamples.end(), 0.0f);
+    FilterJob job{};
+    job.mKey = key;
+    job.mData.assign(buffer->mData.begin(), buffer->mData.end());
+    job.mLineLength = RoundUp(buffer->mSampleLen+DecoderPadding, 16);
+    job.mSrcLength = buffer->mSampleLen;
+    job.mSrcRate = buffer->mSampleRate;
+    job.mDevRate = device->Frequency;
+    job.mNumChannels = numChannels;
+    job.mNumSegs = mNumConvolveSegs;
+
+    auto &srcsamples = job.mSamples;
+    const size_t srclinelength{job.mLineLength};
+    srcsamples.resize(srclinelength * numChannels, 0.0f);
     for(size_t c{0};c < numChannels && c < realChannels;++c)
         LoadSamples(al::span{srcsamples}.subspan(srclinelength*c, buffer->mSampleLen),
             buffer->mData.data(), c, realChannels, buffer->mType);
@@ -363,64 +712,26 @@ void ConvolutionState::deviceUpdate(const DeviceBase *device, const BufferStorag
         decoder->decode({samples.data(), numChannels}, buffer->mSampleLen, buffer->mSampleLen);
     }
 
-    auto ressamples = std::vector<double>(buffer->mSampleLen + (resampler ? resampledCount : 0));
-    auto ffttmp = al::vector<float,16>(ConvolveUpdateSize);
-    auto fftbuffer = std::vector<std::complex<double>>(ConvolveUpdateSize);
+    mIrFilter = std::make_shared<ConvolutionFilter>();
+    job.mFilter = mIrFilter;
 
-    auto filteriter = mComplexData.begin() + ptrdiff_t(mNumConvolveSegs*ConvolveUpdateSize);
-    for(size_t c{0};c < numChannels;++c)
+    /* Resampling and transforming the impulse response can take a while, so
+     * do it on the worker thread. The effect stays silent until it's ready,
+     * which depends on the length of the impulse response and how busy the
+     * system is. Loopback devices are rendered on demand, where the output
+     * should only depend on the calls made, so prepare it here for them.
+     */
+    if(device->Type == DeviceType::Loopback)
     {
-        auto bufsamples = al::span{srcsamples}.subspan(srclinelength*c, buffer->mSampleLen);
-        /* Resample to match the device. */
-        if(resampler)
-        {
-            auto restmp = al::span{ressamples}.subspan(resampledCount, buffer->mSampleLen);
-            std::copy(bufsamples.cbegin(), bufsamples.cend(), restmp.begin());
-            resampler.process(restmp, al::span{ressamples}.first(resampledCount));
-        }
-        else
-            std::copy(bufsamples.cbegin(), bufsamples.cend(), ressamples.begin());
-
-        /* Store the first segment's samples in reverse in the time-domain, to
-         * apply as a FIR filter.
-         */
-        const size_t first_size{std::min(size_t{resampledCount}, ConvolveUpdateSamples)};
-        auto sampleseg = al::span{ressamples.cbegin(), first_size};
-        std::transform(sampleseg.cbegin(), sampleseg.cend(), mFilter[c].rbegin(),
-            [](const double d) noexcept -> float { return static_cast<float>(d); });
-
-        size_t done{first_size};
-        for(size_t s{0};s < mNumConvolveSegs;++s)
-        {
-            const size_t todo{std::min(resampledCount-done, ConvolveUpdateSamples)};
-            sampleseg = al::span{ressamples}.subspan(done, todo);
-
-            /* Apply a double-precision forward FFT for more precise frequency
-             * measurements.
-             */
-            auto iter = std::copy(sampleseg.cbegin(), sampleseg.cend(), fftbuffer.begin());
-            done += todo;
-            std::fill(iter, fftbuffer.end(), std::complex<double>{});
-            forward_fft(al::span{fftbuffer});
-
-            /* Convert to, and pack in, a float buffer for PFFFT. Note that the
-             * first bin stores the real component of the half-frequency bin in
-             * the imaginary component. Also scale the FFT by its length so the
-             * iFFT'd output will be normalized.
-             */
-            static constexpr float fftscale{1.0f / float{ConvolveUpdateSize}};
-            for(size_t i{0};i < ConvolveUpdateSamples;++i)
-            {
-                ffttmp[i*2    ] = static_cast<float>(fftbuffer[i].real()) * fftscale;
-                ffttmp[i*2 + 1] = static_cast<float>((i == 0) ?
-                    fftbuffer[ConvolveUpdateSamples].real() : fftbuffer[i].imag()) * fftscale;
-            }
-            /* Reorder backward to make it suitable for pffft_zconvolve and the
-             * subsequent pffft_transform(..., PFFFT_BACKWARD).
-             */
-            mFft.zreorder(ffttmp.data(), al::to_address(filteriter), PFFFT_BACKWARD);
-            filteriter += ConvolveUpdateSize;
-        }
+        mPreparer->prepare(std::move(job));
+        return;
+    }
+    try {
+        mPreparer->queue(std::move(job));
+    }
+    catch(std::system_error &e) {
+        WARN("Failed to start convolution filter thread: %s\n", e.what());
+        mPreparer->prepare(std::move(job));
     }
 }
 
@@ -628,7 +939,7 @@ void ConvolutionState::update(const ContextBase *context, const EffectSlot *slot
 void ConvolutionState::process(const size_t samplesToDo,
     const al::span<const FloatBufferLine> samplesIn, const al::span<FloatBufferLine> samplesOut)
 {
-    if(mNumConvolveSegs < 1) UNLIKELY
+    if(mNumConvolveSegs < 1 || !mIrFilter->mReady.load(std::memory_order_acquire)) UNLIKELY
         return;
 
     size_t curseg{mCurrentSegment};
@@ -646,7 +957,7 @@ void ConvolutionState::process(const size_t samplesToDo,
         for(size_t c{0};c < mChans.size();++c)
         {
             auto outspan = al::span{mChans[c].mBuffer}.subspan(base, todo);
-            apply_fir(outspan, al::span{mInput}.subspan(1+mFifoPos), mFilter[c]);
+            apply_fir(outspan, al::span{mInput}.subspan(1+mFifoPos), mIrFilter->mFilter[c]);
 
             auto fifospan = al::span{mOutput[c]}.subspan(mFifoPos, todo);
             std::transform(fifospan.cbegin(), fifospan.cend(), outspan.cbegin(), outspan.begin(),
@@ -670,7 +981,7 @@ void ConvolutionState::process(const size_t samplesToDo,
         mFft.transform(mInput.data(), &mComplexData[curseg*ConvolveUpdateSize],
             mFftWorkBuffer.data(), PFFFT_FORWARD);
 
-        auto filter = mComplexData.cbegin() + ptrdiff_t(mNumConvolveSegs*ConvolveUpdateSize);
+        auto filter = mIrFilter->mComplexData.cbegin();
         for(size_t c{0};c < mChans.size();++c)
         {
             /* Convolve each input segment with its IR filter counterpart
@@ -26,6 +26,12 @@
 #include <cstdlib>
 #include <variant>
 
+#ifdef HAVE_SSE_INTRINSICS
+#include <xmmintrin.h>
+#elif defined(HAVE_NEON)
+#include <arm_neon.h>
+#endif
+
 #include "alc/effects/base.h"
 #include "alnumbers.h"
 #include "alnumeric.h"
@@ -37,6 +43,7 @@
 #include "core/effects/base.h"
 #include "core/effectslot.h"
 #include "core/filters/biquad.h"
+#include "core/filters/oversampler.h"
 #include "core/mixer.h"
 #include "core/mixer/defs.h"
 #include "intrusive_ptr.h"
@@ -45,13 +52,72 @@ struct BufferStorage;
 
 namespace {
 
+/* Waveshaper function to emulate signal processing during tube overdriving.
+ * Three steps of waveshaping are intended to modify waveform without boost/
+ * clipping/attenuation process.
+ */
+void ApplyWaveshaper(const al::span<float> samples, const float fc)
+{
+    size_t pos{0};
+#ifdef HAVE_SSE_INTRINSICS
+    const __m128 scale{_mm_set1_ps(1.0f + fc)};
+    const __m128 coeff{_mm_set1_ps(fc)};
+    const __m128 one{_mm_set1_ps(1.0f)};
+    const __m128 signmask{_mm_set1_ps(-0.0f)};
+    auto shape4 = [scale,coeff,one,signmask](const __m128 smp) noexcept -> __m128
+    {
+        const __m128 denom{_mm_add_ps(one, _mm_mul_ps(coeff, _mm_andnot_ps(signmask, smp)))};
+        return _mm_div_ps(_mm_mul_ps(scale, smp), denom);
+    };
+    for(;samples.size()-pos >= 4;pos += 4)
+    {
+        __m128 smp{_mm_loadu_ps(&samples[pos])};
+        smp = shape4(smp);
+        smp = _mm_xor_ps(shape4(smp), signmask);
+        smp = shape4(smp);
+        _mm_storeu_ps(&samples[pos], smp);
+    }
+#elif defined(HAVE_NEON)
+    const float32x4_t scale{vdupq_n_f32(1.0f + fc)};
+    const float32x4_t coeff{vdupq_n_f32(fc)};
+    const float32x4_t one{vdupq_n_f32(1.0f)};
+    auto shape4 = [scale,coeff,one](const float32x4_t smp) noexcept -> float32x4_t
+    {
+        const float32x4_t denom{vaddq_f32(one, vmulq_f32(coeff, vabsq_f32(smp)))};
+        /* Refine the reciprocal estimate twice for full precision. */
+        float32x4_t rcp{vrecpeq_f32(denom)};
+        rcp = vmulq_f32(vrecpsq_f32(denom, rcp), rcp);
+        rcp = vmulq_f32(vrecpsq_f32(denom, rcp), rcp);
+        return vmulq_f32(vmulq_f32(scale, smp), rcp);
+    };
+    for(;samples.size()-pos >= 4;pos += 4)
+    {
+        float32x4_t smp{vld1q_f32(&samples[pos])};
+        smp = shape4(smp);
+        smp = vnegq_f32(shape4(smp));
+        smp = shape4(smp);
+        vst1q_f32(&samples[pos], smp);
+    }
+#endif
+
+    auto proc_sample = [fc](float smp) -> float
+    {
+        smp = (1.0f + fc) * smp/(1.0f + fc*std::fabs(smp));
+        smp = (1.0f + fc) * smp/(1.0f + fc*std::fabs(smp)) * -1.0f;
+        smp = (1.0f + fc) * smp/(1.0f + fc*std::fabs(smp));
+        return smp;
+    };
+    const auto remaining = samples.subspan(pos);
+    std::transform(remaining.begin(), remaining.end(), remaining.begin(), proc_sample);
+}
+
+
 struct DistortionState final : public EffectState {
     /* Effect gains for each channel */
     std::array<float,MaxAmbiChannels> mGain{};
 
     /* Effect parameters */
-    BiquadFilter mLowpass;
-    BiquadFilter mBandpass;
+    BiquadOversampler mOversampler;
     float mAttenuation{};
     float mEdgeCoeff{};
 
@@ -67,8 +133,7 @@ struct DistortionState final : public EffectState {
 
 void DistortionState::deviceUpdate(const DeviceBase*, const BufferStorage*)
 {
-    mLowpass.clear();
-    mBandpass.clear();
+    mOversampler.clear();
 }
 
 void DistortionState::update(const ContextBase *context, const EffectSlot *slot,
@@ -87,13 +152,17 @@ void DistortionState::update(const ContextBase *context, const EffectSlot *slot,
     /* Divide normalized frequency by the amount of oversampling done during
      * processing.
      */
-    auto frequency = static_cast<float>(device->Frequency);
-    mLowpass.setParamsFromBandwidth(BiquadType::LowPass, cutoff/frequency/4.0f, 1.0f, bandwidth);
+    const auto frequency = static_cast<float>(device->Frequency * OversampleFactor);
+    BiquadFilter lowpass;
+    lowpass.setParamsFromBandwidth(BiquadType::LowPass, cutoff/frequency, 1.0f, bandwidth);
 
     cutoff = props.EQCenter;
     /* Convert bandwidth in Hz to octaves. */
     bandwidth = props.EQBandwidth / (cutoff * 0.67f);
-    mBandpass.setParamsFromBandwidth(BiquadType::BandPass, cutoff/frequency/4.0f, 1.0f, bandwidth);
+    BiquadFilter bandpass;
+    bandpass.setParamsFromBandwidth(BiquadType::BandPass, cutoff/frequency, 1.0f, bandwidth);
+
+    mOversampler.setFilters(lowpass, bandpass);
 
     static constexpr auto coeffs = CalcDirectionCoeffs(std::array{0.0f, 0.0f, -1.0f});
 
@@ -106,64 +175,40 @@ void DistortionState::process(const size_t samplesToDo, const al::span<const Flo
     const float fc{mEdgeCoeff};
     for(size_t base{0u};base < samplesToDo;)
     {
+        const size_t todo{std::min(BufferLineSize/OversampleFactor, samplesToDo-base)};
+        const auto oversampled = al::span{mBuffer[0]}.first(todo*OversampleFactor);
+        const auto output = al::span{mBuffer[1]}.first(todo);
+
         /* Perform 4x oversampling to avoid aliasing. Oversampling greatly
          * improves distortion quality and allows to implement lowpass and
          * bandpass filters using high frequencies, at which classic IIR
          * filters became unstable.
+         *
+         * First step, upsample the original signal, which also does the
+         * lowpass filtering (fortunately the first step of distortion).
          */
-        size_t todo{std::min(BufferLineSize, (samplesToDo-base) * 4_uz)};
+        mOversampler.upsample(al::span{samplesIn[0]}.subspan(base, todo), oversampled);
 
-        /* Fill oversample buffer using zero stuffing. Multiply the sample by
-         * the amount of oversampling to maintain the signal's power.
-         */
-        for(size_t i{0u};i < todo;i++)
-            mBuffer[0][i] = !(i&3) ? samplesIn[0][(i>>2)+base] * 4.0f : 0.0f;
+        /* Second step, do distortion using the waveshaper. */
+        ApplyWaveshaper(oversampled, fc);
 
-        /* First step, do lowpass filtering of original signal. Additionally
-         * perform buffer interpolation and lowpass cutoff for oversampling
-         * (which is fortunately first step of distortion). So combine three
-         * operations into the one.
+        /* Third step, do bandpass filtering of the distorted signal while
+         * decimating it back to the original rate.
          */
-        mLowpass.process(al::span{mBuffer[0]}.first(todo), mBuffer[1]);
-
-        /* Second step, do distortion using waveshaper function to emulate
-         * signal processing during tube overdriving. Three steps of
-         * waveshaping are intended to modify waveform without boost/clipping/
-         * attenuation process.
-         */
-        auto proc_sample = [fc](float smp) -> float
-        {
-            smp = (1.0f + fc) * smp/(1.0f + fc*std::fabs(smp));
-            smp = (1.0f + fc) * smp/(1.0f + fc*std::fabs(smp)) * -1.0f;
-            smp = (1.0f + fc) * smp/(1.0f + fc*std::fabs(smp));
-            return smp;
-        };
-        std::transform(mBuffer[1].begin(), mBuffer[1].begin()+todo, mBuffer[0].begin(),
-            proc_sample);
-
-        /* Third step, do bandpass filtering of distorted signal. */
-        mBandpass.process(al::span{mBuffer[0]}.first(todo), mBuffer[1]);
+        mOversampler.downsample(oversampled, output);
 
-        todo >>= 2;
         auto outgains = mGain.cbegin();
-        auto proc_bufline = [this,base,todo,&outgains](FloatBufferSpan output)
+        auto proc_bufline = [base,output,&outgains](FloatBufferSpan bufline)
         {
-            /* Fourth step, final, do attenuation and perform decimation,
-             * storing only one sample out of four.
-             */
+            /* Fourth step, final, do attenuation. */
             const float gain{*(outgains++)};
             if(!(std::fabs(gain) > GainSilenceThreshold))
                 return;
 
-            auto src = mBuffer[1].cbegin();
-            const auto dst = al::span{output}.subspan(base, todo);
-            auto dec_sample = [gain,&src](float sample) noexcept -> float
-            {
-                sample += *src * gain;
-                src += 4;
-                return sample;
-            };
-            std::transform(dst.begin(), dst.end(), dst.begin(), dec_sample);
+            const auto dst = al::span{bufline}.subspan(base, output.size());
+            std::transform(dst.begin(), dst.end(), output.begin(), dst.begin(),
+                [gain](const float sample, const float src) noexcept -> float
+                { return sample + src*gain; });
         };
         std::for_each(samplesOut.begin(), samplesOut.end(), proc_bufline);
 
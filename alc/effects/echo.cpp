@@ -88,6 +88,8 @@ void EchoState::deviceUpdate(const DeviceBase *Device, const BufferStorage*)
         decltype(mSampleBuffer)(maxlen).swap(mSampleBuffer);
 
     std::fill(mSampleBuffer.begin(), mSampleBuffer.end(), 0.0f);
+    mOffset = 0;
+    mFilter.clear();
     for(auto &e : mGains)
     {
         std::fill(e.Current.begin(), e.Current.end(), 0.0f);
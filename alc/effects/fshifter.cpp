@@ -23,12 +23,10 @@
 #include <algorithm>
 #include <array>
 #include <cmath>
-#include <complex>
 #include <cstdlib>
 #include <variant>
 
 #include "alc/effects/base.h"
-#include "alcomplex.h"
 #include "alnumbers.h"
 #include "alnumeric.h"
 #include "alspan.h"
@@ -42,13 +40,13 @@
 #include "core/mixer/defs.h"
 #include "intrusive_ptr.h"
 #include "opthelpers.h"
+#include "pffft.h"
 
 struct BufferStorage;
 
 namespace {
 
 using uint = unsigned int;
-using complex_d = std::complex<double>;
 
 constexpr size_t HilSize{1024};
 constexpr size_t HilHalfSize{HilSize >> 1};
@@ -59,7 +57,7 @@ constexpr size_t HilStep{HilSize / OversampleFactor};
 
 /* Define a Hann window, used to filter the HIL input and output. */
 struct Windower {
-    alignas(16) std::array<double,HilSize> mData{};
+    alignas(16) std::array<float,HilSize> mData{};
 
     Windower()
     {
@@ -68,7 +66,7 @@ struct Windower {
         {
             constexpr double scale{al::numbers::pi / double{HilSize}};
             const double val{std::sin((static_cast<double>(i)+0.5) * scale)};
-            mData[i] = mData[HilSize-1-i] = val * val;
+            mData[i] = mData[HilSize-1-i] = static_cast<float>(val * val);
         }
     }
 };
@@ -81,14 +79,31 @@ struct FshifterState final : public EffectState {
     size_t mPos{};
     std::array<uint,2> mPhaseStep{};
     std::array<uint,2> mPhase{};
-    std::array<double,2> mSign{};
-
-    /* Effects buffers */
-    std::array<double,HilSize> mInFIFO{};
-    std::array<complex_d,HilStep> mOutFIFO{};
-    std::array<complex_d,HilSize> mOutputAccum{};
-    std::array<complex_d,HilSize> mAnalytic{};
-    std::array<complex_d,BufferLineSize> mOutdata{};
+    std::array<float,2> mSign{};
+
+    /* Effects buffers. The analytic signal is kept as separate real and
+     * imaginary parts, where the real part is the (windowed) input and the
+     * imaginary part is its Hilbert transform.
+     */
+    std::array<float,HilSize> mInFIFO{};
+    std::array<float,HilStep> mOutFIFOReal{};
+    std::array<float,HilStep> mOutFIFOImag{};
+    std::array<float,HilSize> mOutputAccumReal{};
+    std::array<float,HilSize> mOutputAccumImag{};
+
+    PFFFTSetup mFft;
+    /* The frequency response giving the analytic signal's imaginary part (i
+     * for positive frequencies, 0 for DC and Nyquist), in pffft's internal
+     * order.
+     */
+    alignas(16) std::array<float,HilSize> mHilbertFilter{};
+    alignas(16) std::array<float,HilSize> mWindowed{};
+    alignas(16) std::array<float,HilSize> mFftBuffer{};
+    alignas(16) std::array<float,HilSize> mHilbertBuffer{};
+    alignas(16) std::array<float,HilSize> mFftWorkBuffer{};
+
+    alignas(16) std::array<float,BufferLineSize> mOutdataReal{};
+    alignas(16) std::array<float,BufferLineSize> mOutdataImag{};
 
     alignas(16) FloatBufferLine mBufferOut{};
 
@@ -115,17 +130,31 @@ void FshifterState::deviceUpdate(const DeviceBase*, const BufferStorage*)
 
     mPhaseStep.fill(0u);
     mPhase.fill(0u);
-    mSign.fill(1.0);
-    mInFIFO.fill(0.0);
-    mOutFIFO.fill(complex_d{});
-    mOutputAccum.fill(complex_d{});
-    mAnalytic.fill(complex_d{});
+    mSign.fill(1.0f);
+    mInFIFO.fill(0.0f);
+    mOutFIFOReal.fill(0.0f);
+    mOutFIFOImag.fill(0.0f);
+    mOutputAccumReal.fill(0.0f);
+    mOutputAccumImag.fill(0.0f);
 
     for(auto &gain : mGains)
     {
         gain.Current.fill(0.0f);
         gain.Target.fill(0.0f);
     }
+
+    if(!mFft)
+    {
+        mFft = PFFFTSetup{HilSize, PFFFT_REAL};
+
+        /* The real FFT's canonical order packs the (real) DC and Nyquist bins
+         * into the first complex value, followed by the positive frequencies.
+         */
+        mFftBuffer.fill(0.0f);
+        for(size_t k{1};k < HilHalfSize;++k)
+            mFftBuffer[k*2 + 1] = 1.0f;
+        mFft.zreorder(mFftBuffer.data(), mHilbertFilter.data(), PFFFT_BACKWARD);
+    }
 }
 
 void FshifterState::update(const ContextBase *context, const EffectSlot *slot,
@@ -140,10 +169,10 @@ void FshifterState::update(const ContextBase *context, const EffectSlot *slot,
     switch(props.LeftDirection)
     {
     case FShifterDirection::Down:
-        mSign[0] = -1.0;
+        mSign[0] = -1.0f;
         break;
     case FShifterDirection::Up:
-        mSign[0] = 1.0;
+        mSign[0] = 1.0f;
         break;
     case FShifterDirection::Off:
         mPhase[0]     = 0;
@@ -154,10 +183,10 @@ void FshifterState::update(const ContextBase *context, const EffectSlot *slot,
     switch(props.RightDirection)
     {
     case FShifterDirection::Down:
-        mSign[1] = -1.0;
+        mSign[1] = -1.0f;
         break;
     case FShifterDirection::Up:
-        mSign[1] = 1.0;
+        mSign[1] = 1.0f;
         break;
     case FShifterDirection::Off:
         mPhase[1]     = 0;
@@ -178,65 +207,110 @@ void FshifterState::update(const ContextBase *context, const EffectSlot *slot,
     ComputePanGains(target.Main, rcoeffs, slot->Gain, mGains[1].Target);
 }
 
-void FshifterState::process(const size_t samplesToDo, const al::span<const FloatBufferLine> samplesIn, const al::span<FloatBufferLine> samplesOut)
+void FshifterState::process(const size_t samplesToDo,
+    const al::span<const FloatBufferLine> samplesIn, const al::span<FloatBufferLine> samplesOut)
 {
     for(size_t base{0u};base < samplesToDo;)
     {
-        size_t todo{std::min(HilStep-mCount, samplesToDo-base)};
-
-        /* Fill FIFO buffer with samples data */
-        const size_t pos{mPos};
-        size_t count{mCount};
-        do {
-            mInFIFO[pos+count] = samplesIn[0][base];
-            mOutdata[base] = mOutFIFO[count];
-            ++base; ++count;
-        } while(--todo);
-        mCount = count;
+        const size_t todo{std::min(HilStep-mCount, samplesToDo-base)};
+
+        /* Retrieve the output samples from the FIFO and fill in the new input
+         * samples.
+         */
+        std::copy_n(mOutFIFOReal.cbegin()+mCount, todo, mOutdataReal.begin()+base);
+        std::copy_n(mOutFIFOImag.cbegin()+mCount, todo, mOutdataImag.begin()+base);
+        std::copy_n(samplesIn[0].cbegin()+base, todo, mInFIFO.begin()+mPos+mCount);
+        mCount += todo;
+        base += todo;
 
         /* Check whether FIFO buffer is filled */
         if(mCount < HilStep) break;
         mCount = 0;
         mPos = (mPos+HilStep) & (HilSize-1);
 
-        /* Real signal windowing and store in Analytic buffer */
+        /* Real signal windowing */
         for(size_t src{mPos}, k{0u};src < HilSize;++src,++k)
-            mAnalytic[k] = mInFIFO[src]*gWindow.mData[k];
+            mWindowed[k] = mInFIFO[src] * gWindow.mData[k];
         for(size_t src{0u}, k{HilSize-mPos};src < mPos;++src,++k)
-            mAnalytic[k] = mInFIFO[src]*gWindow.mData[k];
-
-        /* Processing signal by Discrete Hilbert Transform (analytical signal). */
-        complex_hilbert(mAnalytic);
+            mWindowed[k] = mInFIFO[src] * gWindow.mData[k];
+
+        /* Get the Hilbert transform of the windowed signal by applying its
+         * frequency response to the signal's spectrum. The real part of the
+         * analytic signal is the windowed signal itself.
+         */
+        mFft.transform(mWindowed.data(), mFftBuffer.data(), mFftWorkBuffer.data(),
+            PFFFT_FORWARD);
+        mHilbertBuffer.fill(0.0f);
+        mFft.zconvolve_scale_accumulate(mFftBuffer.data(), mHilbertFilter.data(),
+            mHilbertBuffer.data(), 1.0f/float{HilSize});
+        mFft.transform(mHilbertBuffer.data(), mHilbertBuffer.data(), mFftWorkBuffer.data(),
+            PFFFT_BACKWARD);
 
         /* Windowing and add to output accumulator */
+        static constexpr float scale{2.0f / OversampleFactor};
         for(size_t dst{mPos}, k{0u};dst < HilSize;++dst,++k)
-            mOutputAccum[dst] += 2.0/OversampleFactor*gWindow.mData[k]*mAnalytic[k];
+        {
+            const float gain{gWindow.mData[k] * scale};
+            mOutputAccumReal[dst] += gain*mWindowed[k];
+            mOutputAccumImag[dst] += gain*mHilbertBuffer[k];
+        }
         for(size_t dst{0u}, k{HilSize-mPos};dst < mPos;++dst,++k)
-            mOutputAccum[dst] += 2.0/OversampleFactor*gWindow.mData[k]*mAnalytic[k];
+        {
+            const float gain{gWindow.mData[k] * scale};
+            mOutputAccumReal[dst] += gain*mWindowed[k];
+            mOutputAccumImag[dst] += gain*mHilbertBuffer[k];
+        }
 
         /* Copy out the accumulated result, then clear for the next iteration. */
-        std::copy_n(mOutputAccum.cbegin() + mPos, HilStep, mOutFIFO.begin());
-        std::fill_n(mOutputAccum.begin() + mPos, HilStep, complex_d{});
+        std::copy_n(mOutputAccumReal.cbegin() + mPos, HilStep, mOutFIFOReal.begin());
+        std::copy_n(mOutputAccumImag.cbegin() + mPos, HilStep, mOutFIFOImag.begin());
+        std::fill_n(mOutputAccumReal.begin() + mPos, HilStep, 0.0f);
+        std::fill_n(mOutputAccumImag.begin() + mPos, HilStep, 0.0f);
     }
 
     /* Process frequency shifter using the analytic signal obtained. */
     for(size_t c{0};c < 2;++c)
     {
-        const double sign{mSign[c]};
+        static constexpr double PhaseScale{al::numbers::pi*2.0 / MixerFracOne};
+        static constexpr size_t NumLanes{4};
+
+        /* Rather than evaluating the sine and cosine for each sample, rotate
+         * a unit phasor for each of four interleaved lanes. The phasors are
+         * set from the exact phase at the start of each update, so rounding
+         * errors don't accumulate over time.
+         */
+        const float sign{mSign[c]};
         const uint phase_step{mPhaseStep[c]};
-        uint phase_idx{mPhase[c]};
-        std::transform(mOutdata.cbegin(), mOutdata.cbegin()+samplesToDo, mBufferOut.begin(),
-            [&phase_idx,phase_step,sign](const complex_d &in) -> float
+        const uint phase_idx{mPhase[c]};
+
+        auto rotReal = std::array<float,NumLanes>{};
+        auto rotImag = std::array<float,NumLanes>{};
+        for(size_t i{0};i < NumLanes;++i)
+        {
+            const uint idx{(phase_idx + phase_step*static_cast<uint>(i)) & MixerFracMask};
+            const double phase{idx * PhaseScale};
+            rotReal[i] = static_cast<float>(std::cos(phase));
+            rotImag[i] = static_cast<float>(std::sin(phase)) * sign;
+        }
+        const double lane_phase{((phase_step*NumLanes) & MixerFracMask) * PhaseScale};
+        const auto stepReal = static_cast<float>(std::cos(lane_phase));
+        const auto stepImag = static_cast<float>(std::sin(lane_phase)) * sign;
+
+        const size_t todo{(samplesToDo+NumLanes-1) & ~(NumLanes-1)};
+        for(size_t base{0};base < todo;base += NumLanes)
+        {
+            for(size_t i{0};i < NumLanes;++i)
             {
-                const double phase{phase_idx * (al::numbers::pi*2.0 / MixerFracOne)};
-                const auto out = static_cast<float>(in.real()*std::cos(phase) +
-                    in.imag()*std::sin(phase)*sign);
-
-                phase_idx += phase_step;
-                phase_idx &= MixerFracMask;
-                return out;
-            });
-        mPhase[c] = phase_idx;
+                mBufferOut[base+i] = mOutdataReal[base+i]*rotReal[i]
+                    + mOutdataImag[base+i]*rotImag[i];
+
+                const float re{rotReal[i]*stepReal - rotImag[i]*stepImag};
+                const float im{rotImag[i]*stepReal + rotReal[i]*stepImag};
+                rotReal[i] = re;
+                rotImag[i] = im;
+            }
+        }
+        mPhase[c] = (phase_idx + phase_step*static_cast<uint>(samplesToDo)) & MixerFracMask;
 
         /* Now, mix the processed sound data to the output. */
         MixSamples(al::span{mBufferOut}.first(samplesToDo), samplesOut, mGains[c].Current,
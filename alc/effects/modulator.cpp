@@ -26,10 +26,8 @@
 #include <cstdint>
 #include <cstdlib>
 #include <functional>
-#include <variant>
 
 #include "alc/effects/base.h"
-#include "alnumbers.h"
 #include "alnumeric.h"
 #include "alspan.h"
 #include "core/ambidefs.h"
@@ -40,6 +38,7 @@
 #include "core/effectslot.h"
 #include "core/filters/biquad.h"
 #include "core/mixer.h"
+#include "core/oscillator.h"
 #include "intrusive_ptr.h"
 #include "opthelpers.h"
 
@@ -49,33 +48,9 @@ namespace {
 
 using uint = unsigned int;
 
-struct SinFunc {
-    static auto Get(uint index, float scale) noexcept(noexcept(std::sin(0.0f))) -> float
-    { return std::sin(static_cast<float>(index) * scale); }
-};
-
-struct SawFunc {
-    static constexpr auto Get(uint index, float scale) noexcept -> float
-    { return static_cast<float>(index)*scale - 1.0f; }
-};
-
-struct SquareFunc {
-    static constexpr auto Get(uint index, float scale) noexcept -> float
-    { return float(static_cast<float>(index)*scale < 0.5f)*2.0f - 1.0f; }
-};
-
-struct OneFunc {
-    static constexpr auto Get(uint, float) noexcept -> float
-    { return 1.0f; }
-};
-
-
 struct ModulatorState final : public EffectState {
-    std::variant<OneFunc,SinFunc,SawFunc,SquareFunc> mSampleGen;
-
+    Oscillator mOscillator;
     uint mIndex{0};
-    uint mRange{1};
-    float mIndexScale{0.0f};
 
     alignas(16) FloatBufferLine mModSamples{};
     alignas(16) FloatBufferLine mBuffer{};
@@ -100,6 +75,9 @@ struct ModulatorState final : public EffectState {
 
 void ModulatorState::deviceUpdate(const DeviceBase*, const BufferStorage*)
 {
+    mOscillator = Oscillator{};
+    mIndex = 0;
+
     for(auto &e : mChans)
     {
         e.mTargetChannel = InvalidChannelIndex;
@@ -126,23 +104,26 @@ void ModulatorState::update(const ContextBase *context, const EffectSlot *slot,
         : 1.0f};
     const uint range{static_cast<uint>(std::clamp(samplesPerCycle, 1.0f,
         static_cast<float>(device->Frequency)))};
-    mIndex = static_cast<uint>(uint64_t{mIndex} * range / mRange);
-    mRange = range;
+    mIndex = static_cast<uint>(uint64_t{mIndex} * range / mOscillator.mRange);
+    mOscillator.mRange = range;
 
-    if(mRange == 1)
+    if(range == 1)
     {
-        mIndexScale = 0.0f;
-        mSampleGen.emplace<OneFunc>();
+        /* With a single sample per cycle, a square wave will always generate
+         * 1 (unmodulated).
+         */
+        mOscillator.mScale = 0.0f;
+        mOscillator.mWaveform = OscWaveform::Square;
     }
     else if(props.Waveform == ModulatorWaveform::Sinusoid)
     {
-        mIndexScale = al::numbers::pi_v<float>*2.0f / static_cast<float>(mRange);
-        mSampleGen.emplace<SinFunc>();
+        mOscillator.mScale = 1.0f / static_cast<float>(range);
+        mOscillator.mWaveform = OscWaveform::Sinusoid;
     }
     else if(props.Waveform == ModulatorWaveform::Sawtooth)
     {
-        mIndexScale = 2.0f / static_cast<float>(mRange-1);
-        mSampleGen.emplace<SawFunc>();
+        mOscillator.mScale = 1.0f / static_cast<float>(range-1);
+        mOscillator.mWaveform = OscWaveform::Sawtooth;
     }
     else if(props.Waveform == ModulatorWaveform::Square)
     {
@@ -150,9 +131,9 @@ void ModulatorState::update(const ContextBase *context, const EffectSlot *slot,
          * number of high and low samples). An odd number of samples per cycle
          * would need a more complex value generator.
          */
-        mRange = (mRange+1) & ~1u;
-        mIndexScale = 1.0f / static_cast<float>(mRange-1);
-        mSampleGen.emplace<SquareFunc>();
+        mOscillator.mRange = (range+1) & ~1u;
+        mOscillator.mScale = 1.0f / static_cast<float>(mOscillator.mRange-1);
+        mOscillator.mWaveform = OscWaveform::Square;
     }
 
     float f0norm{props.HighPassCutoff / static_cast<float>(device->Frequency)};
@@ -175,25 +156,7 @@ void ModulatorState::process(const size_t samplesToDo, const al::span<const Floa
 {
     ASSUME(samplesToDo > 0);
 
-    std::visit([this,samplesToDo](auto&& type)
-    {
-        const uint range{mRange};
-        const float scale{mIndexScale};
-        uint index{mIndex};
-
-        ASSUME(range > 1);
-
-        for(size_t i{0};i < samplesToDo;)
-        {
-            size_t rem{std::min(samplesToDo-i, size_t{range-index})};
-            do {
-                mModSamples[i++] = type.Get(index++, scale);
-            } while(--rem);
-            if(index == range)
-                index = 0;
-        }
-        mIndex = index;
-    }, mSampleGen);
+    mIndex = mOscillator.generate(al::span{mModSamples}.first(samplesToDo), mIndex);
 
     auto chandata = mChans.begin();
     for(const auto &input : samplesIn)
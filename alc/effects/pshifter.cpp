@@ -24,9 +24,16 @@
 #include <array>
 #include <cmath>
 #include <complex>
+#include <cstdint>
 #include <cstdlib>
+#include <limits>
+#include <numeric>
 #include <variant>
 
+#ifdef HAVE_SSE_INTRINSICS
+#include <emmintrin.h>
+#endif
+
 #include "alc/effects/base.h"
 #include "alnumbers.h"
 #include "alnumeric.h"
@@ -57,6 +64,11 @@ constexpr size_t OversampleFactor{8};
 static_assert(StftSize%OversampleFactor == 0, "Factor must be a clean divisor of the size");
 constexpr size_t StftStep{StftSize / OversampleFactor};
 
+/* The number of frequency bins, padded to a multiple of 4 so the loops over
+ * them can be vectorized without a remainder. The padding bins stay silent.
+ */
+constexpr size_t StftBinCount{(StftHalfSize+1 + 3) & ~size_t{3}};
+
 /* Define a Hann window, used to filter the STFT input and output. */
 struct Windower {
     alignas(16) std::array<float,StftSize> mData{};
@@ -75,10 +87,189 @@ struct Windower {
 const Windower gWindow{};
 
 
-struct FrequencyBin {
-    float Magnitude;
-    float FreqBin;
-};
+using BinArray = std::array<float,StftBinCount>;
+
+#ifdef HAVE_SSE_INTRINSICS
+
+inline __m128 select_ps(const __m128 mask, const __m128 a, const __m128 b) noexcept
+{ return _mm_or_ps(_mm_and_ps(mask, a), _mm_andnot_ps(mask, b)); }
+
+/* Wraps values to be between -1 and +1, by subtracting the nearest multiple
+ * of 2 (truncating to an integer, then adjusting odd integers away from 0).
+ */
+inline __m128 wrap_unit(const __m128 val) noexcept
+{
+    const __m128i qpd{_mm_cvttps_epi32(val)};
+    /* qpd%2, which has the same sign as qpd. */
+    const __m128i sign{_mm_srai_epi32(qpd, 31)};
+    const __m128i odd{_mm_and_si128(qpd, _mm_set1_epi32(1))};
+    const __m128i rem{_mm_sub_epi32(_mm_xor_si128(odd, sign), sign)};
+    return _mm_sub_ps(val, _mm_cvtepi32_ps(_mm_add_epi32(qpd, rem)));
+}
+
+/* Approximates atan2(y, x), with a maximum error of about 1e-5 radians. */
+inline __m128 fast_atan2(const __m128 y, const __m128 x) noexcept
+{
+    const __m128 absmask{_mm_castsi128_ps(_mm_set1_epi32(0x7fffffff))};
+    const __m128 ax{_mm_and_ps(x, absmask)};
+    const __m128 ay{_mm_and_ps(y, absmask)};
+    const __m128 a{_mm_div_ps(_mm_min_ps(ax, ay), _mm_max_ps(_mm_max_ps(ax, ay),
+        _mm_set1_ps(std::numeric_limits<float>::min())))};
+    const __m128 s{_mm_mul_ps(a, a)};
+    __m128 r{_mm_set1_ps(0.0208351f)};
+    r = _mm_add_ps(_mm_mul_ps(r, s), _mm_set1_ps(-0.0851330f));
+    r = _mm_add_ps(_mm_mul_ps(r, s), _mm_set1_ps(0.1801410f));
+    r = _mm_add_ps(_mm_mul_ps(r, s), _mm_set1_ps(-0.3302995f));
+    r = _mm_add_ps(_mm_mul_ps(r, s), _mm_set1_ps(0.9998660f));
+    r = _mm_mul_ps(r, a);
+    r = select_ps(_mm_cmpgt_ps(ay, ax), _mm_sub_ps(_mm_set1_ps(al::numbers::pi_v<float>*0.5f), r),
+        r);
+    r = select_ps(_mm_cmplt_ps(x, _mm_setzero_ps()),
+        _mm_sub_ps(_mm_set1_ps(al::numbers::pi_v<float>), r), r);
+    return select_ps(absmask, r, y);
+}
+
+/* Approximates sin(x) for x in [-pi/2, +pi/2]. */
+inline __m128 fast_sin_halfpi(const __m128 x) noexcept
+{
+    const __m128 x2{_mm_mul_ps(x, x)};
+    __m128 r{_mm_set1_ps(-1.0f/39916800.0f)};
+    r = _mm_add_ps(_mm_mul_ps(r, x2), _mm_set1_ps(1.0f/362880.0f));
+    r = _mm_add_ps(_mm_mul_ps(r, x2), _mm_set1_ps(-1.0f/5040.0f));
+    r = _mm_add_ps(_mm_mul_ps(r, x2), _mm_set1_ps(1.0f/120.0f));
+    r = _mm_add_ps(_mm_mul_ps(r, x2), _mm_set1_ps(-1.0f/6.0f));
+    r = _mm_add_ps(_mm_mul_ps(r, x2), _mm_set1_ps(1.0f));
+    return _mm_mul_ps(r, x);
+}
+
+/* Approximates sin(x) and cos(x) for x in [-pi, +pi]. */
+inline void fast_sincos(const __m128 x, __m128 &sinx, __m128 &cosx) noexcept
+{
+    const __m128 pi{_mm_set1_ps(al::numbers::pi_v<float>)};
+    const __m128 halfpi{_mm_set1_ps(al::numbers::pi_v<float>*0.5f)};
+    const __m128 absmask{_mm_castsi128_ps(_mm_set1_epi32(0x7fffffff))};
+    __m128 sx{select_ps(_mm_cmpgt_ps(x, halfpi), _mm_sub_ps(pi, x), x)};
+    sx = select_ps(_mm_cmplt_ps(x, _mm_sub_ps(_mm_setzero_ps(), halfpi)),
+        _mm_sub_ps(_mm_sub_ps(_mm_setzero_ps(), pi), x), sx);
+    sinx = fast_sin_halfpi(sx);
+    cosx = fast_sin_halfpi(_mm_sub_ps(halfpi, _mm_and_ps(x, absmask)));
+}
+
+#else
+
+/* Wraps values to be between -1 and +1, by subtracting the nearest multiple
+ * of 2 (truncating to an integer, then adjusting odd integers away from 0).
+ */
+inline float wrap_unit(const float val) noexcept
+{
+    const int qpd{float2int(val)};
+    return val - static_cast<float>(qpd + (qpd%2));
+}
+
+/* Approximates atan2(y, x), with a maximum error of about 1e-5 radians. */
+inline float fast_atan2(const float y, const float x) noexcept
+{
+    static constexpr float pi{al::numbers::pi_v<float>};
+    const float ax{std::abs(x)};
+    const float ay{std::abs(y)};
+    const float a{std::min(ax, ay) / std::max(std::max(ax, ay),
+        std::numeric_limits<float>::min())};
+    const float s{a * a};
+    float r{((((0.0208351f*s - 0.0851330f)*s + 0.1801410f)*s - 0.3302995f)*s + 0.9998660f) * a};
+    r = (ay > ax) ? pi*0.5f - r : r;
+    r = (x < 0.0f) ? pi - r : r;
+    return std::copysign(r, y);
+}
+
+/* Approximates sin(x) for x in [-pi/2, +pi/2]. */
+inline float fast_sin_halfpi(const float x) noexcept
+{
+    const float x2{x * x};
+    return x * (1.0f + x2*(-1.0f/6.0f + x2*(1.0f/120.0f + x2*(-1.0f/5040.0f
+        + x2*(1.0f/362880.0f + x2*(-1.0f/39916800.0f))))));
+}
+
+/* Approximates sin(x) and cos(x) for x in [-pi, +pi]. */
+inline void fast_sincos(const float x, float &sinx, float &cosx) noexcept
+{
+    static constexpr float pi{al::numbers::pi_v<float>};
+    const float sx{(x > pi*0.5f) ? pi - x : (x < -pi*0.5f) ? -pi - x : x};
+    sinx = fast_sin_halfpi(sx);
+    cosx = fast_sin_halfpi(pi*0.5f - std::abs(x));
+}
+#endif
+
+
+/* Converts the bins from rectangular to polar form. The phase is stored in
+ * the frequency bin array, to be processed further.
+ */
+void ToPolarBins(const BinArray &binReal, const BinArray &binImag, BinArray &magnitude,
+    BinArray &phase)
+{
+    if(PitchShifterQuality == PshifterQuality::Accurate)
+    {
+        for(size_t k{0u};k < StftBinCount;++k)
+        {
+            const auto cplx = complex_f{binReal[k], binImag[k]};
+            magnitude[k] = std::abs(cplx);
+            phase[k] = std::arg(cplx);
+        }
+        return;
+    }
+
+#ifdef HAVE_SSE_INTRINSICS
+    for(size_t k{0u};k < StftBinCount;k += 4)
+    {
+        const __m128 re{_mm_load_ps(&binReal[k])};
+        const __m128 im{_mm_load_ps(&binImag[k])};
+        _mm_store_ps(&magnitude[k], _mm_sqrt_ps(_mm_add_ps(_mm_mul_ps(re, re),
+            _mm_mul_ps(im, im))));
+        _mm_store_ps(&phase[k], fast_atan2(im, re));
+    }
+#else
+    for(size_t k{0u};k < StftBinCount;++k)
+    {
+        const float re{binReal[k]}, im{binImag[k]};
+        magnitude[k] = std::sqrt(re*re + im*im);
+        phase[k] = fast_atan2(im, re);
+    }
+#endif
+}
+
+/* Converts the bins from polar to rectangular form. */
+void ToRectBins(const BinArray &magnitude, const BinArray &phase, BinArray &binReal,
+    BinArray &binImag)
+{
+    if(PitchShifterQuality == PshifterQuality::Accurate)
+    {
+        for(size_t k{0u};k < StftBinCount;++k)
+        {
+            const complex_f cplx{std::polar(magnitude[k], phase[k])};
+            binReal[k] = cplx.real();
+            binImag[k] = cplx.imag();
+        }
+        return;
+    }
+
+#ifdef HAVE_SSE_INTRINSICS
+    for(size_t k{0u};k < StftBinCount;k += 4)
+    {
+        const __m128 mag{_mm_load_ps(&magnitude[k])};
+        __m128 sinx, cosx;
+        fast_sincos(_mm_load_ps(&phase[k]), sinx, cosx);
+        _mm_store_ps(&binReal[k], _mm_mul_ps(mag, cosx));
+        _mm_store_ps(&binImag[k], _mm_mul_ps(mag, sinx));
+    }
+#else
+    for(size_t k{0u};k < StftBinCount;++k)
+    {
+        float sinx, cosx;
+        fast_sincos(phase[k], sinx, cosx);
+        binReal[k] = magnitude[k] * cosx;
+        binImag[k] = magnitude[k] * sinx;
+    }
+#endif
+}
 
 
 struct PshifterState final : public EffectState {
@@ -90,16 +281,30 @@ struct PshifterState final : public EffectState {
 
     /* Effects buffers */
     std::array<float,StftSize> mFIFO{};
-    std::array<float,StftHalfSize+1> mLastPhase{};
-    std::array<float,StftHalfSize+1> mSumPhase{};
+    alignas(16) std::array<float,StftBinCount> mLastPhase{};
+    alignas(16) std::array<float,StftBinCount> mSumPhase{};
     std::array<float,StftSize> mOutputAccum{};
 
     PFFFTSetup mFft;
     alignas(16) std::array<float,StftSize> mFftBuffer{};
     alignas(16) std::array<float,StftSize> mFftWorkBuffer{};
 
-    std::array<FrequencyBin,StftHalfSize+1> mAnalysisBuffer{};
-    std::array<FrequencyBin,StftHalfSize+1> mSynthesisBuffer{};
+    /* The positions of the real and imaginary parts of each frequency bin in
+     * pffft's internal z-domain order, so the transform output can be used
+     * without reordering it.
+     */
+    std::array<std::uint16_t,StftHalfSize+1> mRealIndex{};
+    std::array<std::uint16_t,StftHalfSize+1> mImagIndex{};
+
+    /* Per-bin values, kept as separate arrays so the loops over them can be
+     * vectorized.
+     */
+    alignas(16) std::array<float,StftBinCount> mBinReal{};
+    alignas(16) std::array<float,StftBinCount> mBinImag{};
+    alignas(16) std::array<float,StftBinCount> mAnalysisMagnitude{};
+    alignas(16) std::array<float,StftBinCount> mAnalysisFreqBin{};
+    alignas(16) std::array<float,StftBinCount> mSynthesisMagnitude{};
+    alignas(16) std::array<float,StftBinCount> mSynthesisFreqBin{};
 
     alignas(16) FloatBufferLine mBufferOut{};
 
@@ -128,14 +333,39 @@ void PshifterState::deviceUpdate(const DeviceBase*, const BufferStorage*)
     mSumPhase.fill(0.0f);
     mOutputAccum.fill(0.0f);
     mFftBuffer.fill(0.0f);
-    mAnalysisBuffer.fill(FrequencyBin{});
-    mSynthesisBuffer.fill(FrequencyBin{});
+    mAnalysisMagnitude.fill(0.0f);
+    mAnalysisFreqBin.fill(0.0f);
+    mSynthesisMagnitude.fill(0.0f);
+    mSynthesisFreqBin.fill(0.0f);
 
     mCurrentGains.fill(0.0f);
     mTargetGains.fill(0.0f);
 
     if(!mFft)
+    {
         mFft = PFFFTSetup{StftSize, PFFFT_REAL};
+
+        /* Find where each value of the canonical order (DC, Nyquist, then the
+         * real and imaginary parts of each other bin) ends up in the internal
+         * order, by reordering a ramp of indices.
+         */
+        std::iota(mFftWorkBuffer.begin(), mFftWorkBuffer.end(), 0.0f);
+        mFft.zreorder(mFftWorkBuffer.data(), mFftBuffer.data(), PFFFT_BACKWARD);
+        auto canonToInternal = std::array<std::uint16_t,StftSize>{};
+        for(size_t i{0};i < StftSize;++i)
+            canonToInternal[static_cast<size_t>(mFftBuffer[i])] = static_cast<std::uint16_t>(i);
+
+        mRealIndex[0] = canonToInternal[0];
+        mImagIndex[0] = canonToInternal[0];
+        for(size_t k{1};k < StftHalfSize;++k)
+        {
+            mRealIndex[k] = canonToInternal[k*2];
+            mImagIndex[k] = canonToInternal[k*2 + 1];
+        }
+        mRealIndex[StftHalfSize] = canonToInternal[1];
+        mImagIndex[StftHalfSize] = canonToInternal[1];
+        mFftBuffer.fill(0.0f);
+    }
 }
 
 void PshifterState::update(const ContextBase*, const EffectSlot *slot,
@@ -192,55 +422,72 @@ void PshifterState::process(const size_t samplesToDo,
             mFftBuffer[k] = mFIFO[src] * gWindow.mData[k];
         for(size_t src{0u}, k{StftSize-mPos};src < mPos;++src,++k)
             mFftBuffer[k] = mFIFO[src] * gWindow.mData[k];
-        mFft.transform_ordered(mFftBuffer.data(), mFftBuffer.data(), mFftWorkBuffer.data(),
+        mFft.transform(mFftBuffer.data(), mFftBuffer.data(), mFftWorkBuffer.data(),
             PFFFT_FORWARD);
 
-        /* Analyze the obtained data. Since the real FFT is symmetric, only
-         * StftHalfSize+1 samples are needed.
+        /* Pull out the frequency bins. Since the real FFT is symmetric, only
+         * StftHalfSize+1 bins are needed. The DC and Nyquist bins are real.
+         */
+        std::transform(mRealIndex.cbegin(), mRealIndex.cend(), mBinReal.begin(),
+            [this](const size_t idx) { return mFftBuffer[idx]; });
+        std::transform(mImagIndex.cbegin()+1, mImagIndex.cend()-1, mBinImag.begin()+1,
+            [this](const size_t idx) { return mFftBuffer[idx]; });
+        mBinImag[0] = mBinImag[StftHalfSize] = 0.0f;
+
+        /* Analyze the obtained data. */
+        ToPolarBins(mBinReal, mBinImag, mAnalysisMagnitude, mAnalysisFreqBin);
+
+        /* Compute the phase difference from the last update and subtract the
+         * expected phase difference for each bin.
+         *
+         * When oversampling, the expected per-update offset increments by
+         * 1/OversampleFactor for every frequency bin. So, the offset wraps
+         * every 'OversampleFactor' bin.
+         *
+         * Then normalize from pi and wrap the delta between -1 and +1, get the
+         * deviation from the bin frequency (-0.5 to +0.5) accounting for
+         * oversampling, and compute the k-th partials' frequency bin target.
+         * We don't need the "true frequency" since it's a linear relationship
+         * with the bin.
          */
-        for(size_t k{0u};k < StftHalfSize+1;++k)
+        static_assert(OversampleFactor%4 == 0, "Bin offsets assume groups of 4 bins");
+#ifdef HAVE_SSE_INTRINSICS
+        for(size_t k{0u};k < StftBinCount;k += 4)
         {
-            const auto cplx = (k == 0) ? complex_f{mFftBuffer[0]} :
-                (k == StftHalfSize) ? complex_f{mFftBuffer[1]} :
-                complex_f{mFftBuffer[k*2], mFftBuffer[k*2 + 1]};
-            const float magnitude{std::abs(cplx)};
-            const float phase{std::arg(cplx)};
-
-            /* Compute the phase difference from the last update and subtract
-             * the expected phase difference for this bin.
-             *
-             * When oversampling, the expected per-update offset increments by
-             * 1/OversampleFactor for every frequency bin. So, the offset wraps
-             * every 'OversampleFactor' bin.
-             */
+            const __m128 ramp{_mm_setr_ps(0.0f, 1.0f, 2.0f, 3.0f)};
+            const __m128 bin_offset{_mm_add_ps(
+                _mm_set1_ps(static_cast<float>(k % OversampleFactor)), ramp)};
+            const __m128 phase{_mm_load_ps(&mAnalysisFreqBin[k])};
+            __m128 tmp{_mm_sub_ps(_mm_sub_ps(phase, _mm_load_ps(&mLastPhase[k])),
+                _mm_mul_ps(bin_offset, _mm_set1_ps(expected_cycles)))};
+            /* Store the actual phase for the next update. */
+            _mm_store_ps(&mLastPhase[k], phase);
+
+            tmp = wrap_unit(_mm_mul_ps(tmp, _mm_set1_ps(al::numbers::inv_pi_v<float>)));
+            tmp = _mm_mul_ps(tmp, _mm_set1_ps(0.5f * OversampleFactor));
+            _mm_store_ps(&mAnalysisFreqBin[k],
+                _mm_add_ps(_mm_add_ps(_mm_set1_ps(static_cast<float>(k)), ramp), tmp));
+        }
+#else
+        for(size_t k{0u};k < StftBinCount;++k)
+        {
+            const float phase{mAnalysisFreqBin[k]};
             const auto bin_offset = static_cast<float>(k % OversampleFactor);
             float tmp{(phase - mLastPhase[k]) - bin_offset*expected_cycles};
             /* Store the actual phase for the next update. */
             mLastPhase[k] = phase;
 
-            /* Normalize from pi, and wrap the delta between -1 and +1. */
-            tmp *= al::numbers::inv_pi_v<float>;
-            int qpd{float2int(tmp)};
-            tmp -= static_cast<float>(qpd + (qpd%2));
-
-            /* Get deviation from bin frequency (-0.5 to +0.5), and account for
-             * oversampling.
-             */
+            tmp = wrap_unit(tmp * al::numbers::inv_pi_v<float>);
             tmp *= 0.5f * OversampleFactor;
-
-            /* Compute the k-th partials' frequency bin target and store the
-             * magnitude and frequency bin in the analysis buffer. We don't
-             * need the "true frequency" since it's a linear relationship with
-             * the bin.
-             */
-            mAnalysisBuffer[k].Magnitude = magnitude;
-            mAnalysisBuffer[k].FreqBin = static_cast<float>(k) + tmp;
+            mAnalysisFreqBin[k] = static_cast<float>(k) + tmp;
         }
+#endif
 
         /* Shift the frequency bins according to the pitch adjustment,
          * accumulating the magnitudes of overlapping frequency bins.
          */
-        std::fill(mSynthesisBuffer.begin(), mSynthesisBuffer.end(), FrequencyBin{});
+        mSynthesisMagnitude.fill(0.0f);
+        mSynthesisFreqBin.fill(0.0f);
 
         static constexpr size_t bin_limit{((StftHalfSize+1)<<MixerFracBits) - MixerFracHalf - 1};
         const size_t bin_count{std::min(StftHalfSize+1, bin_limit/mPitchShiftI + 1)};
@@ -252,46 +499,46 @@ void PshifterState::process(const size_t samplesToDo,
              * bin for the one with the dominant magnitude. There might be a
              * better way to handle this, but it's better than last-index-wins.
              */
-            if(mAnalysisBuffer[k].Magnitude > mSynthesisBuffer[j].Magnitude)
-                mSynthesisBuffer[j].FreqBin = mAnalysisBuffer[k].FreqBin * mPitchShift;
-            mSynthesisBuffer[j].Magnitude += mAnalysisBuffer[k].Magnitude;
+            if(mAnalysisMagnitude[k] > mSynthesisMagnitude[j])
+                mSynthesisFreqBin[j] = mAnalysisFreqBin[k] * mPitchShift;
+            mSynthesisMagnitude[j] += mAnalysisMagnitude[k];
         }
 
         /* Reconstruct the frequency-domain signal from the adjusted frequency
-         * bins.
+         * bins. Calculate the actual delta phase for each bin's target
+         * frequency bin, and accumulate it to get the actual bin phase.
+         *
+         * Wrap between -pi and +pi for the sum. If mSumPhase is left to grow
+         * indefinitely, it will lose precision and produce less exact phase
+         * over time.
          */
-        for(size_t k{0u};k < StftHalfSize+1;k++)
+#ifdef HAVE_SSE_INTRINSICS
+        for(size_t k{0u};k < StftBinCount;k += 4)
         {
-            /* Calculate the actual delta phase for this bin's target frequency
-             * bin, and accumulate it to get the actual bin phase.
-             */
-            float tmp{mSumPhase[k] + mSynthesisBuffer[k].FreqBin*expected_cycles};
-
-            /* Wrap between -pi and +pi for the sum. If mSumPhase is left to
-             * grow indefinitely, it will lose precision and produce less exact
-             * phase over time.
-             */
-            tmp *= al::numbers::inv_pi_v<float>;
-            int qpd{float2int(tmp)};
-            tmp -= static_cast<float>(qpd + (qpd%2));
-            mSumPhase[k] = tmp * al::numbers::pi_v<float>;
-
-            const complex_f cplx{std::polar(mSynthesisBuffer[k].Magnitude, mSumPhase[k])};
-            if(k == 0)
-                mFftBuffer[0] = cplx.real();
-            else if(k == StftHalfSize)
-                mFftBuffer[1] = cplx.real();
-            else
-            {
-                mFftBuffer[k*2 + 0] = cplx.real();
-                mFftBuffer[k*2 + 1] = cplx.imag();
-            }
+            __m128 tmp{_mm_add_ps(_mm_load_ps(&mSumPhase[k]),
+                _mm_mul_ps(_mm_load_ps(&mSynthesisFreqBin[k]), _mm_set1_ps(expected_cycles)))};
+            tmp = wrap_unit(_mm_mul_ps(tmp, _mm_set1_ps(al::numbers::inv_pi_v<float>)));
+            _mm_store_ps(&mSumPhase[k], _mm_mul_ps(tmp, _mm_set1_ps(al::numbers::pi_v<float>)));
         }
+#else
+        for(size_t k{0u};k < StftBinCount;k++)
+        {
+            const float tmp{mSumPhase[k] + mSynthesisFreqBin[k]*expected_cycles};
+            mSumPhase[k] = wrap_unit(tmp * al::numbers::inv_pi_v<float>)
+                * al::numbers::pi_v<float>;
+        }
+#endif
+        ToRectBins(mSynthesisMagnitude, mSumPhase, mBinReal, mBinImag);
 
-        /* Apply an inverse FFT to get the time-domain signal, and accumulate
-         * for the output with windowing.
+        /* Put the bins back in pffft's internal order (the DC and Nyquist bins
+         * only use the real part), then apply an inverse FFT to get the time-
+         * domain signal, and accumulate for the output with windowing.
          */
-        mFft.transform_ordered(mFftBuffer.data(), mFftBuffer.data(), mFftWorkBuffer.data(),
+        for(size_t k{0u};k < StftHalfSize+1;k++)
+            mFftBuffer[mRealIndex[k]] = mBinReal[k];
+        for(size_t k{1u};k < StftHalfSize;k++)
+            mFftBuffer[mImagIndex[k]] = mBinImag[k];
+        mFft.transform(mFftBuffer.data(), mFftBuffer.data(), mFftWorkBuffer.data(),
             PFFFT_BACKWARD);
 
         static constexpr float scale{3.0f / OversampleFactor / StftSize};
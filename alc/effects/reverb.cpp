@@ -799,6 +799,8 @@ void ReverbState::deviceUpdate(const DeviceBase *device, const BufferStorage*)
 
     std::for_each(mPipelines.begin(), mPipelines.end(), std::mem_fn(&ReverbPipeline::clear));
     mPipelineState = DeviceClear;
+    mCurrentPipeline = false;
+    mParams = Params{};
 
     /* Reset offset base. */
     mOffset = 0;
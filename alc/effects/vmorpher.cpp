@@ -50,6 +50,7 @@
 #include "core/effects/base.h"
 #include "core/effectslot.h"
 #include "core/mixer.h"
+#include "core/oscillator.h"
 #include "intrusive_ptr.h"
 
 struct BufferStorage;
@@ -69,32 +70,6 @@ enum : size_t {
 
 constexpr size_t WaveformFracBits{24};
 constexpr size_t WaveformFracOne{1<<WaveformFracBits};
-constexpr size_t WaveformFracMask{WaveformFracOne-1};
-
-inline float Sin(uint index)
-{
-    constexpr float scale{al::numbers::pi_v<float>*2.0f / float{WaveformFracOne}};
-    return std::sin(static_cast<float>(index) * scale)*0.5f + 0.5f;
-}
-
-inline float Saw(uint index)
-{ return static_cast<float>(index) / float{WaveformFracOne}; }
-
-inline float Triangle(uint index)
-{ return std::fabs(static_cast<float>(index)*(2.0f/WaveformFracOne) - 1.0f); }
-
-inline float Half(uint) { return 0.5f; }
-
-template<float (&func)(uint)>
-void Oscillate(const al::span<float> dst, uint index, const uint step)
-{
-    std::generate(dst.begin(), dst.end(), [&index,step]
-    {
-        index += step;
-        index &= WaveformFracMask;
-        return func(index);
-    });
-}
 
 struct FormantFilter {
     float mCoeff{0.0f};
@@ -159,10 +134,9 @@ struct VmorpherState final : public EffectState {
     };
     std::array<OutParams,MaxAmbiChannels> mChans;
 
-    void (*mGetSamples)(const al::span<float> dst, uint index, const uint step){};
+    Oscillator mOscillator;
 
     uint mIndex{0};
-    uint mStep{1};
 
     /* Effects buffers */
     alignas(16) std::array<float,MaxUpdateSamples> mSampleBufferA{};
@@ -233,6 +207,9 @@ std::array<FormantFilter,NumFormants> VmorpherState::getFiltersByPhoneme(VMorphe
 
 void VmorpherState::deviceUpdate(const DeviceBase*, const BufferStorage*)
 {
+    mOscillator = Oscillator{};
+    mIndex = 0;
+
     for(auto &e : mChans)
     {
         e.mTargetChannel = InvalidChannelIndex;
@@ -251,16 +228,37 @@ void VmorpherState::update(const ContextBase *context, const EffectSlot *slot,
     const DeviceBase *device{context->mDevice};
     const float frequency{static_cast<float>(device->Frequency)};
     const float step{props.Rate / frequency};
-    mStep = fastf2u(std::clamp(step*WaveformFracOne, 0.0f, WaveformFracOne-1.0f));
+    mOscillator.mStep = fastf2u(std::clamp(step*WaveformFracOne, 0.0f, WaveformFracOne-1.0f));
+    mOscillator.mRange = WaveformFracOne;
+    mOscillator.mScale = 1.0f / float{WaveformFracOne};
 
-    if(mStep == 0)
-        mGetSamples = Oscillate<Half>;
+    /* The LFO blends between the two vowels, so it needs to be in the range
+     * [0,1] instead of [-1,+1]. The triangle is inverted, to start on the
+     * first vowel.
+     */
+    if(mOscillator.mStep == 0)
+    {
+        mOscillator.mGain = 0.0f;
+        mOscillator.mOffset = 0.5f;
+    }
     else if(props.Waveform == VMorpherWaveform::Sinusoid)
-        mGetSamples = Oscillate<Sin>;
+    {
+        mOscillator.mWaveform = OscWaveform::Sinusoid;
+        mOscillator.mGain = 0.5f;
+        mOscillator.mOffset = 0.5f;
+    }
     else if(props.Waveform == VMorpherWaveform::Triangle)
-        mGetSamples = Oscillate<Triangle>;
+    {
+        mOscillator.mWaveform = OscWaveform::Triangle;
+        mOscillator.mGain = -0.5f;
+        mOscillator.mOffset = 0.5f;
+    }
     else /*if(props.Waveform == VMorpherWaveform::Sawtooth)*/
-        mGetSamples = Oscillate<Saw>;
+    {
+        mOscillator.mWaveform = OscWaveform::Sawtooth;
+        mOscillator.mGain = 0.5f;
+        mOscillator.mOffset = 0.5f;
+    }
 
     const float pitchA{std::pow(2.0f, static_cast<float>(props.PhonemeACoarseTuning) / 12.0f)};
     const float pitchB{std::pow(2.0f, static_cast<float>(props.PhonemeBCoarseTuning) / 12.0f)};
@@ -295,9 +293,7 @@ void VmorpherState::process(const size_t samplesToDo, const al::span<const Float
     {
         const size_t td{std::min(MaxUpdateSamples, samplesToDo-base)};
 
-        mGetSamples(al::span{mLfo}.first(td), mIndex, mStep);
-        mIndex += static_cast<uint>(mStep * td);
-        mIndex &= WaveformFracMask;
+        mIndex = mOscillator.generate(al::span{mLfo}.first(td), mIndex);
 
         auto chandata = mChans.begin();
         for(const auto &input : samplesIn)
@@ -39,6 +39,8 @@ inline const FuncExport alcFunctions[]{
     DECL(alcCaptureStart),
     DECL(alcCaptureStop),
     DECL(alcCaptureSamples),
+    DECL(alcCaptureAcquireSamplesSOFT),
+    DECL(alcCaptureReleaseSamplesSOFT),
 
     DECL(alcSetThreadContext),
     DECL(alcGetThreadContext),
@@ -205,6 +207,13 @@ inline const FuncExport alcFunctions[]{
     DECL(alSourcePlayAtTimeSOFT),
     DECL(alSourcePlayAtTimevSOFT),
 
+    DECL(alSourceScheduledfvSOFT),
+    DECL(alSourceScheduledivSOFT),
+
+    DECL(alGetSourcePlaybackvSOFT),
+
+    DECL(alListenerMotionfvSOFT),
+
     DECL(alBufferSubDataSOFT),
 
     DECL(alBufferDataStatic),
@@ -355,6 +364,12 @@ inline const FuncExport alcFunctions[]{
     DECL(alGetSourcedvDirectSOFT),
     DECL(alSourcePlayAtTimeDirectSOFT),
     DECL(alSourcePlayAtTimevDirectSOFT),
+    DECL(alSourceScheduledfvDirectSOFT),
+    DECL(alSourceScheduledivDirectSOFT),
+
+    DECL(alGetSourcePlaybackvDirectSOFT),
+
+    DECL(alListenerMotionfvDirectSOFT),
 
     DECL(alEventControlDirectSOFT),
     DECL(alEventCallbackDirectSOFT),
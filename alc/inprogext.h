@@ -84,6 +84,50 @@ void AL_APIENTRY alFlushMappedBufferDirectSOFT(ALCcontext *context, ALuint buffe
 #define AL_PAN_SOFT                              0x19ED
 #endif
 
+#ifndef AL_SOFT_scheduled_source_params
+#define AL_SOFT_scheduled_source_params
+typedef void (AL_APIENTRY*LPALSOURCESCHEDULEDFVSOFT)(ALuint source, ALint64SOFT update_time, ALenum param, const ALfloat *values) AL_API_NOEXCEPT17;
+typedef void (AL_APIENTRY*LPALSOURCESCHEDULEDIVSOFT)(ALuint source, ALint64SOFT update_time, ALenum param, const ALint *values) AL_API_NOEXCEPT17;
+typedef void (AL_APIENTRY*LPALSOURCESCHEDULEDFVDIRECTSOFT)(ALCcontext *context, ALuint source, ALint64SOFT update_time, ALenum param, const ALfloat *values) AL_API_NOEXCEPT17;
+typedef void (AL_APIENTRY*LPALSOURCESCHEDULEDIVDIRECTSOFT)(ALCcontext *context, ALuint source, ALint64SOFT update_time, ALenum param, const ALint *values) AL_API_NOEXCEPT17;
+#ifdef AL_ALEXT_PROTOTYPES
+AL_API void AL_APIENTRY alSourceScheduledfvSOFT(ALuint source, ALint64SOFT update_time, ALenum param, const ALfloat *values) AL_API_NOEXCEPT;
+AL_API void AL_APIENTRY alSourceScheduledivSOFT(ALuint source, ALint64SOFT update_time, ALenum param, const ALint *values) AL_API_NOEXCEPT;
+void AL_APIENTRY alSourceScheduledfvDirectSOFT(ALCcontext *context, ALuint source, ALint64SOFT update_time, ALenum param, const ALfloat *values) AL_API_NOEXCEPT;
+void AL_APIENTRY alSourceScheduledivDirectSOFT(ALCcontext *context, ALuint source, ALint64SOFT update_time, ALenum param, const ALint *values) AL_API_NOEXCEPT;
+#endif
+#endif
+
+#ifndef AL_SOFT_source_playback_snapshot
+#define AL_SOFT_source_playback_snapshot
+typedef void (AL_APIENTRY*LPALGETSOURCEPLAYBACKVSOFT)(ALsizei n, const ALuint *sources, ALint *states, ALint64SOFT *offsets, ALint *processed) AL_API_NOEXCEPT17;
+typedef void (AL_APIENTRY*LPALGETSOURCEPLAYBACKVDIRECTSOFT)(ALCcontext *context, ALsizei n, const ALuint *sources, ALint *states, ALint64SOFT *offsets, ALint *processed) AL_API_NOEXCEPT17;
+#ifdef AL_ALEXT_PROTOTYPES
+AL_API void AL_APIENTRY alGetSourcePlaybackvSOFT(ALsizei n, const ALuint *sources, ALint *states, ALint64SOFT *offsets, ALint *processed) AL_API_NOEXCEPT;
+void AL_APIENTRY alGetSourcePlaybackvDirectSOFT(ALCcontext *context, ALsizei n, const ALuint *sources, ALint *states, ALint64SOFT *offsets, ALint *processed) AL_API_NOEXCEPT;
+#endif
+#endif
+
+#ifndef AL_SOFT_listener_motion
+#define AL_SOFT_listener_motion
+typedef void (AL_APIENTRY*LPALLISTENERMOTIONFVSOFT)(ALint64SOFT pose_time, const ALfloat *values) AL_API_NOEXCEPT17;
+typedef void (AL_APIENTRY*LPALLISTENERMOTIONFVDIRECTSOFT)(ALCcontext *context, ALint64SOFT pose_time, const ALfloat *values) AL_API_NOEXCEPT17;
+#ifdef AL_ALEXT_PROTOTYPES
+AL_API void AL_APIENTRY alListenerMotionfvSOFT(ALint64SOFT pose_time, const ALfloat *values) AL_API_NOEXCEPT;
+void AL_APIENTRY alListenerMotionfvDirectSOFT(ALCcontext *context, ALint64SOFT pose_time, const ALfloat *values) AL_API_NOEXCEPT;
+#endif
+#endif
+
+#ifndef ALC_SOFT_capture_direct_access
+#define ALC_SOFT_capture_direct_access
+typedef void (ALC_APIENTRY*LPALCCAPTUREACQUIRESAMPLESSOFT)(ALCdevice *device, ALCsizei samples, const ALCvoid **buffers, ALCsizei *lengths) ALC_API_NOEXCEPT17;
+typedef void (ALC_APIENTRY*LPALCCAPTURERELEASESAMPLESSOFT)(ALCdevice *device) ALC_API_NOEXCEPT17;
+#ifdef AL_ALEXT_PROTOTYPES
+ALC_API void ALC_APIENTRY alcCaptureAcquireSamplesSOFT(ALCdevice *device, ALCsizei samples, const ALCvoid **buffers, ALCsizei *lengths) ALC_API_NOEXCEPT;
+ALC_API void ALC_APIENTRY alcCaptureReleaseSamplesSOFT(ALCdevice *device) ALC_API_NOEXCEPT;
+#endif
+#endif
+
 /* Non-standard exports. Not part of any extension. */
 AL_API const ALchar* AL_APIENTRY alsoft_get_version(void) noexcept;
 
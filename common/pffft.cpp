@@ -55,6 +55,8 @@
  * in order to take advantage of SIMD instructions of modern CPUs.
  */
 
+#include "config.h"
+
 #include "pffft.h"
 
 #include <algorithm>
@@ -75,9 +77,30 @@
 #include "alspan.h"
 #include "opthelpers.h"
 
+#if defined(HAVE_AVX) && !defined(PFFFT_SIMD_DISABLE) && defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
 
 using uint = unsigned int;
 
+#if defined(HAVE_AVX) && !defined(PFFFT_SIMD_DISABLE)
+/* Defined in pffft_avx.cpp. The zconvolve count is the number of complex
+ * vectors (8 floats each). The radix-4 passes take the same parameters as the
+ * 4-wide passes below, and only handle their twiddled loops (ido > 2).
+ */
+void pffft_zconvolve_accumulate_avx(const float *a, const float *b, float *ab, size_t count)
+    noexcept;
+void pffft_zconvolve_scale_accumulate_avx(const float *a, const float *b, float *ab,
+    float scaling, size_t count) noexcept;
+void pffft_passf4_avx(const size_t ido, const size_t l1, const float *cc, float *ch,
+    const float *wa1, const float fsign) noexcept;
+void pffft_radf4_avx(const size_t ido, const size_t l1, const float *cc, float *ch,
+    const float *wa1) noexcept;
+void pffft_radb4_avx(const size_t ido, const size_t l1, const float *cc, float *ch,
+    const float *wa1) noexcept;
+#endif
+
 namespace {
 
 #if defined(__GNUC__) || defined(_MSC_VER)
@@ -518,7 +541,7 @@ NOINLINE void passf3_ps(const size_t ido, const size_t l1, const v4sf *cc, v4sf
 } /* passf3 */
 
 NOINLINE void passf4_ps(const size_t ido, const size_t l1, const v4sf *cc, v4sf *RESTRICT ch,
-    const float *const wa1, const float fsign)
+    const float *const wa1, const float fsign, const bool useavx [[maybe_unused]])
 {
     /* fsign == -1 for forward transform and +1 for backward transform */
     const v4sf vsign{ld_ps1(fsign)};
@@ -548,6 +571,11 @@ NOINLINE void passf4_ps(const size_t ido, const size_t l1, const v4sf *cc, v4sf
     }
     else
     {
+#if defined(HAVE_AVX) && !defined(PFFFT_SIMD_DISABLE)
+        if(useavx)
+            return pffft_passf4_avx(ido, l1, reinterpret_cast<const float*>(cc),
+                reinterpret_cast<float*>(ch), wa1, fsign);
+#endif
         const auto wa2 = wa1 + ido;
         const auto wa3 = wa2 + ido;
         for(size_t k{0};k < l1ido;k += ido, ch+=ido, cc += 4*ido)
@@ -846,7 +874,7 @@ void radb3_ps(const size_t ido, const size_t l1, const v4sf *RESTRICT cc, v4sf *
 } /* radb3 */
 
 NOINLINE void radf4_ps(const size_t ido, const size_t l1, const v4sf *RESTRICT cc,
-    v4sf *RESTRICT ch, const float *const wa1)
+    v4sf *RESTRICT ch, const float *const wa1, const bool useavx [[maybe_unused]])
 {
     const size_t l1ido{l1*ido};
     {
@@ -875,6 +903,12 @@ NOINLINE void radf4_ps(const size_t ido, const size_t l1, const v4sf *RESTRICT c
         const auto wa2 = wa1 + ido;
         const auto wa3 = wa2 + ido;
 
+#if defined(HAVE_AVX) && !defined(PFFFT_SIMD_DISABLE)
+        if(useavx)
+            pffft_radf4_avx(ido, l1, reinterpret_cast<const float*>(cc),
+                reinterpret_cast<float*>(ch), wa1);
+        else
+#endif
         for(size_t k{0};k < l1ido;k += ido)
         {
             const v4sf *RESTRICT pc{cc + 1 + k};
@@ -939,7 +973,7 @@ NOINLINE void radf4_ps(const size_t ido, const size_t l1, const v4sf *RESTRICT c
 
 
 NOINLINE void radb4_ps(const size_t ido, const size_t l1, const v4sf *RESTRICT cc,
-    v4sf *RESTRICT ch, const float *const wa1)
+    v4sf *RESTRICT ch, const float *const wa1, const bool useavx [[maybe_unused]])
 {
     const v4sf two{ld_ps1(2.0f)};
     const size_t l1ido{l1*ido};
@@ -970,6 +1004,12 @@ NOINLINE void radb4_ps(const size_t ido, const size_t l1, const v4sf *RESTRICT c
         const auto wa2 = wa1 + ido;
         const auto wa3 = wa2 + ido;
 
+#if defined(HAVE_AVX) && !defined(PFFFT_SIMD_DISABLE)
+        if(useavx)
+            pffft_radb4_avx(ido, l1, reinterpret_cast<const float*>(cc),
+                reinterpret_cast<float*>(ch), wa1);
+        else
+#endif
         for(size_t k{0};k < l1ido;k += ido)
         {
             const v4sf *RESTRICT pc{cc - 1 + 4*k};
@@ -1199,7 +1239,7 @@ void radb5_ps(const size_t ido, const size_t l1, const v4sf *RESTRICT cc, v4sf *
 } /* radb5 */
 
 NOINLINE v4sf *rfftf1_ps(const size_t n, const v4sf *input_readonly, v4sf *work1, v4sf *work2,
-    const float *wa, const al::span<const uint,15> ifac)
+    const float *wa, const al::span<const uint,15> ifac, const bool useavx)
 {
     assert(work1 != work2);
 
@@ -1222,7 +1262,7 @@ NOINLINE v4sf *rfftf1_ps(const size_t n, const v4sf *input_readonly, v4sf *work1
             radf5_ps(ido, l1, in, out, &wa[iw]);
             break;
         case 4:
-            radf4_ps(ido, l1, in, out, &wa[iw]);
+            radf4_ps(ido, l1, in, out, &wa[iw], useavx);
             break;
         case 3:
             radf3_ps(ido, l1, in, out, &wa[iw]);
@@ -1251,7 +1291,7 @@ NOINLINE v4sf *rfftf1_ps(const size_t n, const v4sf *input_readonly, v4sf *work1
 } /* rfftf1 */
 
 NOINLINE v4sf *rfftb1_ps(const size_t n, const v4sf *input_readonly, v4sf *work1, v4sf *work2,
-    const float *wa, const al::span<const uint,15> ifac)
+    const float *wa, const al::span<const uint,15> ifac, const bool useavx)
 {
     assert(work1 != work2);
 
@@ -1272,7 +1312,7 @@ NOINLINE v4sf *rfftb1_ps(const size_t n, const v4sf *input_readonly, v4sf *work1
             radb5_ps(ido, l1, in, out, &wa[iw]);
             break;
         case 4:
-            radb4_ps(ido, l1, in, out, &wa[iw]);
+            radb4_ps(ido, l1, in, out, &wa[iw], useavx);
             break;
         case 3:
             radb3_ps(ido, l1, in, out, &wa[iw]);
@@ -1303,7 +1343,7 @@ NOINLINE v4sf *rfftb1_ps(const size_t n, const v4sf *input_readonly, v4sf *work1
 }
 
 v4sf *cfftf1_ps(const size_t n, const v4sf *input_readonly, v4sf *work1, v4sf *work2,
-    const float *wa, const al::span<const uint,15> ifac, const float fsign)
+    const float *wa, const al::span<const uint,15> ifac, const float fsign, const bool useavx)
 {
     assert(work1 != work2);
 
@@ -1324,7 +1364,7 @@ v4sf *cfftf1_ps(const size_t n, const v4sf *input_readonly, v4sf *work1, v4sf *w
             passf5_ps(idot, l1, in, out, &wa[iw], fsign);
             break;
         case 4:
-            passf4_ps(idot, l1, in, out, &wa[iw], fsign);
+            passf4_ps(idot, l1, in, out, &wa[iw], fsign, useavx);
             break;
         case 3:
             passf3_ps(idot, l1, in, out, &wa[iw], fsign);
@@ -1457,6 +1497,27 @@ void cffti1_ps(const uint n, float *wa, const al::span<uint,15> ifac)
     }
 } /* cffti1 */
 
+#if defined(HAVE_AVX) && !defined(PFFFT_SIMD_DISABLE)
+/* Checks for AVX and FMA support, including the OS saving the YMM registers. */
+bool CheckAvxFma() noexcept
+{
+#if defined(__GNUC__)
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx") && __builtin_cpu_supports("fma");
+#elif defined(_MSC_VER)
+    std::array<int,4> regs{};
+    __cpuid(regs.data(), 1);
+    /* FMA is bit 12, OSXSAVE is bit 27, and AVX is bit 28. */
+    static constexpr int mask{(1<<12) | (1<<27) | (1<<28)};
+    if((regs[2]&mask) != mask)
+        return false;
+    return (_xgetbv(0)&6) == 6;
+#else
+    return false;
+#endif
+}
+#endif
+
 } // namespace
 
 /* NOLINTNEXTLINE(clang-analyzer-optin.performance.Padding) */
@@ -1465,6 +1526,7 @@ struct PFFFT_Setup {
     uint Ncvec{}; /* nb of complex simd vectors (N/4 if PFFFT_COMPLEX, N/8 if PFFFT_REAL) */
     std::array<uint,15> ifac{};
     pffft_transform_t transform{};
+    bool useAvx{}; /* Use the AVX+FMA radix-4 passes and z-domain convolution. */
 
     float *twiddle{}; /* N/4 elements */
     al::span<v4sf> e; /* N/4*3 elements */
@@ -1496,6 +1558,10 @@ PFFFTSetupPtr pffft_new_setup(unsigned int N, pffft_transform_t transform)
     s->N = N;
     s->transform = transform;
     s->Ncvec = Ncvec;
+#if defined(HAVE_AVX) && !defined(PFFFT_SIMD_DISABLE)
+    static const bool haveAvx{CheckAvxFma()};
+    s->useAvx = haveAvx;
+#endif
 
     const size_t ecount{2_zu*Ncvec*(SimdSize-1)/SimdSize};
     s->e = {std::launder(reinterpret_cast<v4sf*>(extrastore.data())), ecount};
@@ -1873,7 +1939,8 @@ void pffft_transform_internal(const PFFFT_Setup *setup, const v4sf *vinput, v4sf
         ib = !ib;
         if(setup->transform == PFFFT_REAL)
         {
-            ib = (rfftf1_ps(Ncvec*2, vinput, buff[ib], buff[!ib], setup->twiddle, setup->ifac) == buff[1]);
+            ib = (rfftf1_ps(Ncvec*2, vinput, buff[ib], buff[!ib], setup->twiddle, setup->ifac,
+                setup->useAvx) == buff[1]);
             pffft_real_finalize(Ncvec, buff[ib], buff[!ib], setup->e.data());
         }
         else
@@ -1882,7 +1949,8 @@ void pffft_transform_internal(const PFFFT_Setup *setup, const v4sf *vinput, v4sf
             for(size_t k=0; k < Ncvec; ++k)
                 uninterleave2(vinput[k*2], vinput[k*2+1], tmp[k*2], tmp[k*2+1]);
 
-            ib = (cfftf1_ps(Ncvec, buff[ib], buff[!ib], buff[ib], setup->twiddle, setup->ifac, -1.0f) == buff[1]);
+            ib = (cfftf1_ps(Ncvec, buff[ib], buff[!ib], buff[ib], setup->twiddle, setup->ifac,
+                -1.0f, setup->useAvx) == buff[1]);
             pffft_cplx_finalize(Ncvec, buff[ib], buff[!ib], setup->e.data());
         }
         if(ordered)
@@ -1906,12 +1974,14 @@ void pffft_transform_internal(const PFFFT_Setup *setup, const v4sf *vinput, v4sf
         if(setup->transform == PFFFT_REAL)
         {
             pffft_real_preprocess(Ncvec, vinput, buff[ib], setup->e.data());
-            ib = (rfftb1_ps(Ncvec*2, buff[ib], buff[0], buff[1], setup->twiddle, setup->ifac) == buff[1]);
+            ib = (rfftb1_ps(Ncvec*2, buff[ib], buff[0], buff[1], setup->twiddle, setup->ifac,
+                setup->useAvx) == buff[1]);
         }
         else
         {
             pffft_cplx_preprocess(Ncvec, vinput, buff[ib], setup->e.data());
-            ib = (cfftf1_ps(Ncvec, buff[ib], buff[0], buff[1],  setup->twiddle, setup->ifac, +1.0f) == buff[1]);
+            ib = (cfftf1_ps(Ncvec, buff[ib], buff[0], buff[1],  setup->twiddle, setup->ifac,
+                +1.0f, setup->useAvx) == buff[1]);
             for(size_t k{0};k < Ncvec;++k)
                 interleave2(buff[ib][k*2], buff[ib][k*2+1], buff[ib][k*2], buff[ib][k*2+1]);
         }
@@ -2062,20 +2132,27 @@ void pffft_zconvolve_scale_accumulate(const PFFFT_Setup *s, const float *a, cons
 
 #else
 
-    /* Default routine, works fine for non-arm cpus with current compilers. */
-    const v4sf vscal{ld_ps1(scaling)};
-    for(size_t i{0};i < Ncvec;i += 2)
+#if defined(HAVE_AVX)
+    if(s->useAvx)
+        pffft_zconvolve_scale_accumulate_avx(a, b, ab, scaling, Ncvec);
+    else
+#endif
     {
-        v4sf ar4{va[2*i+0]}, ai4{va[2*i+1]};
-        v4sf br4{vb[2*i+0]}, bi4{vb[2*i+1]};
-        vcplxmul(ar4, ai4, br4, bi4);
-        vab[2*i+0] = vmadd(ar4, vscal, vab[2*i+0]);
-        vab[2*i+1] = vmadd(ai4, vscal, vab[2*i+1]);
-        ar4 = va[2*i+2]; ai4 = va[2*i+3];
-        br4 = vb[2*i+2]; bi4 = vb[2*i+3];
-        vcplxmul(ar4, ai4, br4, bi4);
-        vab[2*i+2] = vmadd(ar4, vscal, vab[2*i+2]);
-        vab[2*i+3] = vmadd(ai4, vscal, vab[2*i+3]);
+        /* Default routine, works fine for non-arm cpus with current compilers. */
+        const v4sf vscal{ld_ps1(scaling)};
+        for(size_t i{0};i < Ncvec;i += 2)
+        {
+            v4sf ar4{va[2*i+0]}, ai4{va[2*i+1]};
+            v4sf br4{vb[2*i+0]}, bi4{vb[2*i+1]};
+            vcplxmul(ar4, ai4, br4, bi4);
+            vab[2*i+0] = vmadd(ar4, vscal, vab[2*i+0]);
+            vab[2*i+1] = vmadd(ai4, vscal, vab[2*i+1]);
+            ar4 = va[2*i+2]; ai4 = va[2*i+3];
+            br4 = vb[2*i+2]; bi4 = vb[2*i+3];
+            vcplxmul(ar4, ai4, br4, bi4);
+            vab[2*i+2] = vmadd(ar4, vscal, vab[2*i+2]);
+            vab[2*i+3] = vmadd(ai4, vscal, vab[2*i+3]);
+        }
     }
 #endif
 
@@ -2115,6 +2192,11 @@ void pffft_zconvolve_accumulate(const PFFFT_Setup *s, const float *a, const floa
     const float abr1{vextract0(vab[0])};
     const float abi1{vextract0(vab[1])};
 
+#if defined(HAVE_AVX)
+    if(s->useAvx)
+        pffft_zconvolve_accumulate_avx(a, b, ab, Ncvec);
+    else
+#endif
     /* No inline assembly for this version. I'm not familiar enough with NEON
      * assembly, and I don't know that it's needed with today's optimizers.
      */
@@ -2181,9 +2263,9 @@ void pffft_transform_internal(const PFFFT_Setup *setup, const float *input, floa
     if(direction == PFFFT_FORWARD)
     {
         if(setup->transform == PFFFT_REAL)
-            ib = (rfftf1_ps(Ncvec*2, input, buff[ib], buff[!ib], setup->twiddle, setup->ifac) == buff[1]);
+            ib = (rfftf1_ps(Ncvec*2, input, buff[ib], buff[!ib], setup->twiddle, setup->ifac, false) == buff[1]);
         else
-            ib = (cfftf1_ps(Ncvec, input, buff[ib], buff[!ib], setup->twiddle, setup->ifac, -1.0f) == buff[1]);
+            ib = (cfftf1_ps(Ncvec, input, buff[ib], buff[!ib], setup->twiddle, setup->ifac, -1.0f, false) == buff[1]);
         if(ordered)
         {
             pffft_zreorder(setup, buff[ib], buff[!ib], PFFFT_FORWARD);
@@ -2202,9 +2284,9 @@ void pffft_transform_internal(const PFFFT_Setup *setup, const float *input, floa
             ib = !ib;
         }
         if(setup->transform == PFFFT_REAL)
-            ib = (rfftb1_ps(Ncvec*2, input, buff[ib], buff[!ib],  setup->twiddle, setup->ifac) == buff[1]);
+            ib = (rfftb1_ps(Ncvec*2, input, buff[ib], buff[!ib],  setup->twiddle, setup->ifac, false) == buff[1]);
         else
-            ib = (cfftf1_ps(Ncvec, input, buff[ib], buff[!ib], setup->twiddle, setup->ifac, +1.0f) == buff[1]);
+            ib = (cfftf1_ps(Ncvec, input, buff[ib], buff[!ib], setup->twiddle, setup->ifac, +1.0f, false) == buff[1]);
     }
     if(buff[ib] != output)
     {
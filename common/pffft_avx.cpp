@@ -0,0 +1,205 @@
+#include "config.h"
+
+#include <immintrin.h>
+
+#include <cstddef>
+
+
+#if defined(__GNUC__) && !defined(__clang__) && !(defined(__AVX__) && defined(__FMA__))
+#pragma GCC target("avx,fma")
+#elif defined(__clang__)
+#pragma clang attribute push(__attribute__((target("avx,fma"))), apply_to=function)
+#endif
+
+/* pffft's z-domain data is stored as groups of 4 real values followed by 4
+ * imaginary values. The complex multiply for a group is done as a single
+ * 256-bit vector, by multiplying a with b's broadcasted real values, then
+ * adding the half-swapped a multiplied with b's broadcasted imaginary values
+ * (negated for the real half).
+ */
+
+void pffft_zconvolve_accumulate_avx(const float *a, const float *b, float *ab, size_t count)
+    noexcept
+{
+    const __m256 signmask{_mm256_setr_ps(-0.0f, -0.0f, -0.0f, -0.0f, 0.0f, 0.0f, 0.0f, 0.0f)};
+    for(size_t i{0};i < count;++i)
+    {
+        const __m256 va{_mm256_loadu_ps(a)};
+        const __m256 vaswap{_mm256_permute2f128_ps(va, va, 0x01)};
+        const __m256 vbr{_mm256_broadcast_ps(reinterpret_cast<const __m128*>(b))};
+        const __m256 vbi{_mm256_xor_ps(_mm256_broadcast_ps(reinterpret_cast<const __m128*>(b+4)),
+            signmask)};
+        const __m256 res{_mm256_fmadd_ps(vaswap, vbi, _mm256_mul_ps(va, vbr))};
+        _mm256_storeu_ps(ab, _mm256_add_ps(_mm256_loadu_ps(ab), res));
+        a += 8; b += 8; ab += 8;
+    }
+}
+
+void pffft_zconvolve_scale_accumulate_avx(const float *a, const float *b, float *ab,
+    float scaling, size_t count) noexcept
+{
+    const __m256 signmask{_mm256_setr_ps(-0.0f, -0.0f, -0.0f, -0.0f, 0.0f, 0.0f, 0.0f, 0.0f)};
+    const __m256 vscale{_mm256_set1_ps(scaling)};
+    for(size_t i{0};i < count;++i)
+    {
+        const __m256 va{_mm256_loadu_ps(a)};
+        const __m256 vaswap{_mm256_permute2f128_ps(va, va, 0x01)};
+        const __m256 vbr{_mm256_broadcast_ps(reinterpret_cast<const __m128*>(b))};
+        const __m256 vbi{_mm256_xor_ps(_mm256_broadcast_ps(reinterpret_cast<const __m128*>(b+4)),
+            signmask)};
+        const __m256 res{_mm256_fmadd_ps(vaswap, vbi, _mm256_mul_ps(va, vbr))};
+        _mm256_storeu_ps(ab, _mm256_fmadd_ps(res, vscale, _mm256_loadu_ps(ab)));
+        a += 8; b += 8; ab += 8;
+    }
+}
+
+
+/* The radix-4 passes use the same packing. pffft's transforms work on pairs of
+ * 4-float vectors, holding the real and imaginary parts of 4 interleaved
+ * sub-transforms, so a 256-bit vector holds one such complex pair. The
+ * butterflies then work on both parts at once, and the twiddle multiplies use
+ * the half-swap above. These only replace the twiddled loops of the passes,
+ * the rest stays with the 4-wide code. Offsets and counts are in 4-float
+ * vectors, as with the 4-wide passes.
+ */
+
+namespace {
+
+inline __m256 load_cplx(const float *ptr, size_t idx) noexcept
+{ return _mm256_loadu_ps(ptr + idx*4); }
+
+inline void store_cplx(float *ptr, size_t idx, __m256 val) noexcept
+{ _mm256_storeu_ps(ptr + idx*4, val); }
+
+inline __m256 swap_halves(__m256 v) noexcept
+{ return _mm256_permute2f128_ps(v, v, 0x01); }
+
+/* Returns v * (wr + i*wi). */
+inline __m256 cplxmul(__m256 v, float wr, float wi) noexcept
+{
+    const __m256 vwi{_mm256_setr_ps(-wi, -wi, -wi, -wi, wi, wi, wi, wi)};
+    return _mm256_fmadd_ps(swap_halves(v), vwi, _mm256_mul_ps(v, _mm256_set1_ps(wr)));
+}
+
+/* Returns v * conj(wr + i*wi). */
+inline __m256 cplxmulconj(__m256 v, float wr, float wi) noexcept
+{
+    const __m256 vwi{_mm256_setr_ps(wi, wi, wi, wi, -wi, -wi, -wi, -wi)};
+    return _mm256_fmadd_ps(swap_halves(v), vwi, _mm256_mul_ps(v, _mm256_set1_ps(wr)));
+}
+
+} // namespace
+
+void pffft_passf4_avx(const size_t ido, const size_t l1, const float *cc, float *ch,
+    const float *wa1, const float fsign) noexcept
+{
+    /* Multiplies the swapped difference by the sign, negating the real half
+     * as it's moved.
+     */
+    const __m256 vsign{_mm256_setr_ps(-fsign, -fsign, -fsign, -fsign, fsign, fsign, fsign,
+        fsign)};
+    const size_t l1ido{l1*ido};
+    const float *wa2{wa1 + ido};
+    const float *wa3{wa2 + ido};
+    for(size_t k{0};k < l1ido;k += ido, ch += ido*4, cc += 4*ido*4)
+    {
+        for(size_t i{0};i < ido-1;i += 2)
+        {
+            const __m256 c0{load_cplx(cc, i)};
+            const __m256 c1{load_cplx(cc, i + 1*ido)};
+            const __m256 c2{load_cplx(cc, i + 2*ido)};
+            const __m256 c3{load_cplx(cc, i + 3*ido)};
+
+            const __m256 t1{_mm256_sub_ps(c0, c2)};
+            const __m256 t2{_mm256_add_ps(c0, c2)};
+            const __m256 t3{_mm256_add_ps(c1, c3)};
+            const __m256 t4{_mm256_mul_ps(swap_halves(_mm256_sub_ps(c1, c3)), vsign)};
+
+            store_cplx(ch, i, _mm256_add_ps(t2, t3));
+            store_cplx(ch, i + 1*l1ido, cplxmul(_mm256_add_ps(t1, t4), wa1[i],
+                fsign*wa1[i+1]));
+            store_cplx(ch, i + 2*l1ido, cplxmul(_mm256_sub_ps(t2, t3), wa2[i],
+                fsign*wa2[i+1]));
+            store_cplx(ch, i + 3*l1ido, cplxmul(_mm256_sub_ps(t1, t4), wa3[i],
+                fsign*wa3[i+1]));
+        }
+    }
+}
+
+void pffft_radf4_avx(const size_t ido, const size_t l1, const float *cc, float *ch,
+    const float *wa1) noexcept
+{
+    const __m256 hisign{_mm256_setr_ps(0.0f, 0.0f, 0.0f, 0.0f, -0.0f, -0.0f, -0.0f, -0.0f)};
+    const __m256 losign{_mm256_setr_ps(-0.0f, -0.0f, -0.0f, -0.0f, 0.0f, 0.0f, 0.0f, 0.0f)};
+    const size_t l1ido{l1*ido};
+    const float *wa2{wa1 + ido};
+    const float *wa3{wa2 + ido};
+    for(size_t k{0};k < l1ido;k += ido)
+    {
+        const float *pc{cc + (1 + k)*4};
+        for(size_t i{2};i < ido;i += 2, pc += 2*4)
+        {
+            const size_t ic{ido - i};
+
+            const __m256 c2{cplxmulconj(load_cplx(pc, 1*l1ido), wa1[i-2], wa1[i-1])};
+            const __m256 c3{cplxmulconj(load_cplx(pc, 2*l1ido), wa2[i-2], wa2[i-1])};
+            const __m256 c4{cplxmulconj(load_cplx(pc, 3*l1ido), wa3[i-2], wa3[i-1])};
+            const __m256 c0{load_cplx(pc, 0)};
+
+            /* {tr1, ti1}, {tr2, ti2}, {tr3, ti3}, and {ti4, tr4}. */
+            const __m256 t1{_mm256_add_ps(c2, c4)};
+            const __m256 t2{_mm256_add_ps(c0, c3)};
+            const __m256 t3{_mm256_sub_ps(c0, c3)};
+            const __m256 t4{_mm256_xor_ps(swap_halves(_mm256_sub_ps(c4, c2)), losign)};
+
+            store_cplx(ch, i - 1 + 4*k, _mm256_add_ps(t2, t1));
+            store_cplx(ch, ic - 1 + 4*k + 3*ido, _mm256_xor_ps(_mm256_sub_ps(t2, t1), hisign));
+            store_cplx(ch, i - 1 + 4*k + 2*ido, _mm256_add_ps(t3, t4));
+            store_cplx(ch, ic - 1 + 4*k + 1*ido, _mm256_xor_ps(_mm256_sub_ps(t3, t4), hisign));
+        }
+    }
+}
+
+void pffft_radb4_avx(const size_t ido, const size_t l1, const float *cc, float *ch,
+    const float *wa1) noexcept
+{
+    const __m256 losign{_mm256_setr_ps(-0.0f, -0.0f, -0.0f, -0.0f, 0.0f, 0.0f, 0.0f, 0.0f)};
+    const size_t l1ido{l1*ido};
+    const float *wa2{wa1 + ido};
+    const float *wa3{wa2 + ido};
+    for(size_t k{0};k < l1ido;k += ido)
+    {
+        /* The input starts one vector before the first complex pair. */
+        const float *pc{cc + 4*k*4 - 4};
+        float *ph{ch + (k + 1)*4};
+        for(size_t i{2};i < ido;i += 2, ph += 2*4)
+        {
+            const __m256 a{load_cplx(pc, i)};
+            const __m256 b{load_cplx(pc, 4*ido - i)};
+            const __m256 c{load_cplx(pc, 2*ido + i)};
+            const __m256 d{load_cplx(pc, 2*ido - i)};
+
+            /* {tr2, ti1} and {tr1, ti2}, then {tr3, tr4} and {ti4, ti3}. */
+            const __m256 absum{_mm256_add_ps(a, b)};
+            const __m256 abdiff{_mm256_sub_ps(a, b)};
+            const __m256 cdsum{_mm256_add_ps(c, d)};
+            const __m256 cddiff{_mm256_sub_ps(c, d)};
+
+            const __m256 t2{_mm256_blend_ps(absum, abdiff, 0xf0)};
+            const __m256 t1{_mm256_blend_ps(abdiff, absum, 0xf0)};
+            const __m256 t3{_mm256_blend_ps(cdsum, cddiff, 0xf0)};
+            /* {-tr4, ti4} */
+            const __m256 t4{_mm256_xor_ps(swap_halves(_mm256_blend_ps(cddiff, cdsum, 0xf0)),
+                losign)};
+
+            store_cplx(ph, 0, _mm256_add_ps(t2, t3));
+            store_cplx(ph, 1*l1ido, cplxmul(_mm256_add_ps(t1, t4), wa1[i-2], wa1[i-1]));
+            store_cplx(ph, 2*l1ido, cplxmul(_mm256_sub_ps(t2, t3), wa2[i-2], wa2[i-1]));
+            store_cplx(ph, 3*l1ido, cplxmul(_mm256_sub_ps(t1, t4), wa3[i-2], wa3[i-1]));
+        }
+    }
+}
+
+#if defined(__clang__)
+#pragma clang attribute pop
+#endif
@@ -1,12 +1,22 @@
 
+#include "config.h"
+
 #include "polyphase_resampler.h"
 
 #include <algorithm>
+#include <array>
 #include <cmath>
 #include <cstddef>
+#include <cstdint>
 #include <numeric>
+#include <system_error>
+#include <thread>
 #include <tuple>
 
+#ifdef HAVE_SSE_INTRINSICS
+#include <xmmintrin.h>
+#endif
+
 #include "alnumbers.h"
 #include "opthelpers.h"
 
@@ -132,6 +142,36 @@ double SincFilter(const uint l, const double beta, const double besseli_0_beta,
     return Kaiser(beta, x/l, besseli_0_beta) * 2.0 * gain * cutoff * Sinc(2.0 * cutoff * x);
 }
 
+/* Calculates the dot product of the filter phase and input samples. The
+ * length is a multiple of 4.
+ */
+float DotProduct(const float *filter, const float *in, const size_t len)
+{
+#ifdef HAVE_SSE_INTRINSICS
+    __m128 r4{_mm_setzero_ps()};
+    for(size_t j{0};j < len;j += 4)
+        r4 = _mm_add_ps(r4, _mm_mul_ps(_mm_load_ps(&filter[j]), _mm_loadu_ps(&in[j])));
+    r4 = _mm_add_ps(r4, _mm_shuffle_ps(r4, r4, _MM_SHUFFLE(0, 1, 2, 3)));
+    r4 = _mm_add_ps(r4, _mm_movehl_ps(r4, r4));
+    return _mm_cvtss_f32(r4);
+#else
+    std::array<float,4> r{};
+    for(size_t j{0};j < len;j += 4)
+    {
+        r[0] += filter[j+0] * in[j+0];
+        r[1] += filter[j+1] * in[j+1];
+        r[2] += filter[j+2] * in[j+2];
+        r[3] += filter[j+3] * in[j+3];
+    }
+    return (r[0] + r[1]) + (r[2] + r[3]);
+#endif
+}
+
+/* Batches with less work than this (in multiply-adds) aren't worth spreading
+ * over multiple threads.
+ */
+constexpr size_t MinThreadedWork{size_t{1}<<22};
+
 } // namespace
 
 // Calculate the resampling metrics and build the Kaiser-windowed sinc filter
@@ -159,11 +199,26 @@ void PPhaseResampler::init(const uint srcRate, const uint dstRate)
     mF.resize(mM);
     for(uint i{0};i < mM;i++)
         mF[i] = SincFilter(l, beta, besseli_0_beta, mP, cutoff, i);
+
+    /* Split the filter into its phases for single-precision processing. The
+     * output phase (l + q*i) % p uses every p-th coefficient starting from
+     * the phase index, each applied to successively older input samples.
+     * Store them in reverse so they apply to the input in order.
+     */
+    mPhaseLen = (((mM+mP-1) / mP) + 3) & ~3u;
+    mPhaseF.assign(size_t{mP}*mPhaseLen, 0.0f);
+    for(uint phase{0};phase < mP;++phase)
+    {
+        const auto dst = al::span{mPhaseF}.subspan(size_t{phase}*mPhaseLen, mPhaseLen);
+        size_t k{dst.size()};
+        for(uint j_f{phase};j_f < mM;j_f += mP)
+            dst[--k] = static_cast<float>(mF[j_f]);
+    }
 }
 
 // Perform the upsample-filter-downsample resampling operation using a
 // polyphase filter implementation.
-void PPhaseResampler::process(const al::span<const double> in, const al::span<double> out)
+void PPhaseResampler::process(const al::span<const double> in, const al::span<double> out) const
 {
     if(out.empty()) UNLIKELY
         return;
@@ -213,3 +268,98 @@ void PPhaseResampler::process(const al::span<const double> in, const al::span<do
     if(work.data() != out.data())
         std::copy(work.cbegin(), work.cend(), out.begin());
 }
+
+
+void PPhaseResampler::process(const al::span<const float> in, const al::span<float> out) const
+{
+    std::vector<float> buffer;
+    processChannels(in, in.size(), in.size(), out, out.size(), out.size(), buffer);
+}
+
+void PPhaseResampler::processBatch(const al::span<const float> in, const size_t inStride,
+    const size_t inLen, const al::span<float> out, const size_t outStride, const size_t outLen)
+    const
+{
+    if(outLen == 0 || out.empty()) UNLIKELY
+        return;
+    const size_t count{(out.size()-outLen)/outStride + 1};
+
+    const size_t work{count * outLen * mPhaseLen};
+    const size_t numThreads{std::min({size_t{std::max(std::thread::hardware_concurrency(), 1u)},
+        count, work/MinThreadedWork + 1})};
+
+    auto process_range = [this,in,inStride,inLen,out,outStride,outLen](const size_t start, const size_t end, std::vector<float> &buffer)
+    {
+        processChannels(in.subspan(start*inStride), inStride, inLen,
+            out.subspan(start*outStride, (end-start-1)*outStride + outLen), outStride, outLen,
+            buffer);
+    };
+
+    /* Each thread gets an even share of the channels, with the calling thread
+     * handling the first share and any that couldn't get a thread.
+     */
+    std::vector<float> buffer;
+    const size_t per_thread{(count+numThreads-1) / numThreads};
+    std::vector<std::thread> threads;
+    threads.reserve(numThreads-1);
+    size_t next{per_thread};
+    try {
+        while(next < count)
+        {
+            const size_t end{std::min(next+per_thread, count)};
+            threads.emplace_back([process_range,next,end]
+            {
+                std::vector<float> threadbuf;
+                process_range(next, end, threadbuf);
+            });
+            next = end;
+        }
+    }
+    catch(std::system_error&) {
+    }
+
+    process_range(0, std::min(per_thread, count), buffer);
+    if(next < count)
+        process_range(next, count, buffer);
+    for(auto &thrd : threads)
+        thrd.join();
+}
+
+void PPhaseResampler::processChannels(const al::span<const float> in, const size_t inStride,
+    const size_t inLen, const al::span<float> out, const size_t outStride, const size_t outLen,
+    std::vector<float> &buffer) const
+{
+    if(outLen == 0 || out.empty()) UNLIKELY
+        return;
+
+    /* Pad the input with enough zeros before and after so every output
+     * sample can apply the full filter phase without bounds checks.
+     */
+    const uint p{mP}, q{mQ}, l{mL};
+    const size_t phaselen{mPhaseLen};
+    const size_t lastpos{(l + uint64_t{q}*(outLen-1)) / p};
+    const size_t srclen{std::max(inLen, lastpos+1)};
+    buffer.resize(phaselen + srclen);
+
+    const auto filter = al::span{mPhaseF};
+    for(size_t c{0};c*outStride < out.size();++c)
+    {
+        const auto src = in.subspan(c*inStride, inLen);
+        auto biter = std::fill_n(buffer.begin(), phaselen, 0.0f);
+        biter = std::copy(src.cbegin(), src.cend(), biter);
+        std::fill(biter, buffer.end(), 0.0f);
+
+        /* Input starts at l to compensate for the filter delay. This will drop
+         * any build-up from the first half of the filter.
+         */
+        const auto dst = out.subspan(c*outStride, outLen);
+        uint64_t pos{l};
+        for(float &sample : dst)
+        {
+            const size_t phase{pos % p};
+            const size_t j_s{pos / p};
+            sample = DotProduct(&filter[phase*phaselen], &buffer[j_s+1], phaselen);
+            pos += q;
+        }
+    }
+}
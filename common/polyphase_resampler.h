@@ -1,9 +1,11 @@
 #ifndef POLYPHASE_RESAMPLER_H
 #define POLYPHASE_RESAMPLER_H
 
+#include <cstddef>
 #include <vector>
 
 #include "alspan.h"
+#include "vector.h"
 
 
 using uint = unsigned int;
@@ -37,13 +39,38 @@ using uint = unsigned int;
 
 struct PPhaseResampler {
     void init(const uint srcRate, const uint dstRate);
-    void process(const al::span<const double> in, const al::span<double> out);
+    void process(const al::span<const double> in, const al::span<double> out) const;
+
+    /* Single-precision resampling, using the filter split into per-phase
+     * tables. This is less precise than the double-precision version, but
+     * considerably faster, and suitable for converting data that will be used
+     * for single-precision mixing.
+     */
+    void process(const al::span<const float> in, const al::span<float> out) const;
+
+    /* Resamples a batch of channels. Each channel's input is inLen samples,
+     * spaced inStride apart in the input span, and each channel's output is
+     * outLen samples, spaced outStride apart in the output span. Large
+     * batches are split across multiple threads.
+     */
+    void processBatch(const al::span<const float> in, const size_t inStride, const size_t inLen,
+        const al::span<float> out, const size_t outStride, const size_t outLen) const;
 
     explicit operator bool() const noexcept { return !mF.empty(); }
 
 private:
+    void processChannels(const al::span<const float> in, const size_t inStride,
+        const size_t inLen, const al::span<float> out, const size_t outStride,
+        const size_t outLen, std::vector<float> &buffer) const;
+
     uint mP{}, mQ{}, mM{}, mL{};
     std::vector<double> mF;
+
+    /* The filter split into mP phases, each mPhaseLen taps long (zero-padded
+     * at the front to a multiple of 4) and stored in reverse.
+     */
+    uint mPhaseLen{};
+    al::vector<float,16> mPhaseF;
 };
 
 #endif /* POLYPHASE_RESAMPLER_H */
@@ -9,6 +9,7 @@
 #include "almalloc.h"
 
 struct EffectState;
+enum class EffectSlotType : unsigned char;
 
 using uint = unsigned int;
 
@@ -46,6 +47,7 @@ struct AsyncDisconnectEvent {
 
 struct AsyncEffectReleaseEvent {
     EffectState *mEffectState;
+    EffectSlotType mType;
 };
 
 using AsyncEvent = std::variant<AsyncKillThread,
@@ -9,86 +9,171 @@
 #include <functional>
 #include <utility>
 
+#ifdef HAVE_SSE_INTRINSICS
+#include <xmmintrin.h>
+#elif defined(HAVE_NEON)
+#include <arm_neon.h>
+#endif
+
 #include "alnumbers.h"
+#include "alnumeric.h"
 #include "bufferline.h"
 #include "filters/splitter.h"
 #include "flexarray.h"
 #include "front_stablizer.h"
-#include "mixer.h"
+#include "mixer/defs.h"
 #include "opthelpers.h"
 
 
-namespace {
-
-template<typename... Ts>
-struct overloaded : Ts... { using Ts::operator()...; };
-
-template<typename... Ts>
-overloaded(Ts...) -> overloaded<Ts...>;
-
-} // namespace
-
 BFormatDec::BFormatDec(const size_t inchans, const al::span<const ChannelDec> coeffs,
     const al::span<const ChannelDec> coeffslf, const float xover_f0norm,
     std::unique_ptr<FrontStablizer> stablizer)
     : mStablizer{std::move(stablizer)}
 {
-    if(coeffslf.empty())
+    const size_t numbands{coeffslf.empty() ? 1_uz : sNumBands};
+    mNumLines = std::min(inchans, MaxAmbiChannels) * numbands;
+    if(numbands > 1)
+    {
+        mXOver.resize(mNumLines / numbands);
+        mXOver[0].init(xover_f0norm);
+        std::fill(mXOver.begin()+1, mXOver.end(), mXOver[0]);
+    }
+
+    /* Build a sparse matrix of the non-silent gains for each output. Entries
+     * that would be skipped by the mixer anyway are left out.
+     */
+    auto add_entries = [this](const ChannelDec &incoeffs, const size_t band, const size_t stride)
     {
-        auto &decoder = mChannelDec.emplace<std::vector<ChannelDecoderSingle>>(inchans);
-        for(size_t j{0};j < decoder.size();++j)
+        for(size_t j{0};j < mNumLines/stride;++j)
         {
-            std::transform(coeffs.cbegin(), coeffs.cend(), decoder[j].mGains.begin(),
-                [j](const ChannelDec &incoeffs) { return incoeffs[j]; });
+            if(std::abs(incoeffs[j]) > GainSilenceThreshold)
+                mMatrix.emplace_back(MatrixEntry{j*stride + band, incoeffs[j]});
         }
-    }
-    else
+    };
+    for(size_t i{0};i < coeffs.size();++i)
     {
-        auto &decoder = mChannelDec.emplace<std::vector<ChannelDecoderDual>>(inchans);
-        decoder[0].mXOver.init(xover_f0norm);
-        for(size_t j{1};j < decoder.size();++j)
-            decoder[j].mXOver = decoder[0].mXOver;
-
-        for(size_t j{0};j < decoder.size();++j)
+        const size_t start{mMatrix.size()};
+        if(numbands == 1)
+            add_entries(coeffs[i], 0, 1);
+        else
         {
-            std::transform(coeffs.cbegin(), coeffs.cend(), decoder[j].mGains[sHFBand].begin(),
-                [j](const ChannelDec &incoeffs) { return incoeffs[j]; });
+            add_entries(coeffs[i], sHFBand, sNumBands);
+            if(i < coeffslf.size())
+                add_entries(coeffslf[i], sLFBand, sNumBands);
+        }
+        if(const size_t count{mMatrix.size() - start}; count > 0)
+            mRows.emplace_back(OutputRow{i, start, count});
+    }
+}
+
 
-            std::transform(coeffslf.cbegin(), coeffslf.cend(), decoder[j].mGains[sLFBand].begin(),
-                [j](const ChannelDec &incoeffs) { return incoeffs[j]; });
+namespace {
+
+/* Mixes the input lines, scaled by their matrix gains, into the output. Each
+ * group of output samples is accumulated in registers over all the inputs, so
+ * the output is only read and written once regardless of the number of input
+ * lines.
+ */
+template<typename T, size_t N>
+void MixMatrixRow(const al::span<float> output, const al::span<const T> entries,
+    const std::array<const float*,N> &lines)
+{
+    const size_t todo{output.size()};
+    size_t base{0};
+#ifdef HAVE_SSE_INTRINSICS
+    for(;base < (todo&~15_uz);base += 16)
+    {
+        __m128 acc0{_mm_setzero_ps()}, acc1{_mm_setzero_ps()};
+        __m128 acc2{_mm_setzero_ps()}, acc3{_mm_setzero_ps()};
+        for(const auto &entry : entries)
+        {
+            const float *src{lines[entry.mLine] + base};
+            const __m128 gain4{_mm_set1_ps(entry.mGain)};
+            acc0 = _mm_add_ps(acc0, _mm_mul_ps(_mm_loadu_ps(src), gain4));
+            acc1 = _mm_add_ps(acc1, _mm_mul_ps(_mm_loadu_ps(src+4), gain4));
+            acc2 = _mm_add_ps(acc2, _mm_mul_ps(_mm_loadu_ps(src+8), gain4));
+            acc3 = _mm_add_ps(acc3, _mm_mul_ps(_mm_loadu_ps(src+12), gain4));
+        }
+        float *dst{&output[base]};
+        _mm_storeu_ps(dst, _mm_add_ps(_mm_loadu_ps(dst), acc0));
+        _mm_storeu_ps(dst+4, _mm_add_ps(_mm_loadu_ps(dst+4), acc1));
+        _mm_storeu_ps(dst+8, _mm_add_ps(_mm_loadu_ps(dst+8), acc2));
+        _mm_storeu_ps(dst+12, _mm_add_ps(_mm_loadu_ps(dst+12), acc3));
+    }
+    for(;base < (todo&~3_uz);base += 4)
+    {
+        __m128 acc{_mm_setzero_ps()};
+        for(const auto &entry : entries)
+        {
+            const __m128 gain4{_mm_set1_ps(entry.mGain)};
+            acc = _mm_add_ps(acc, _mm_mul_ps(_mm_loadu_ps(lines[entry.mLine] + base), gain4));
         }
+        _mm_storeu_ps(&output[base], _mm_add_ps(_mm_loadu_ps(&output[base]), acc));
+    }
+#elif defined(HAVE_NEON)
+    for(;base < (todo&~7_uz);base += 8)
+    {
+        float32x4_t acc0{vdupq_n_f32(0.0f)}, acc1{vdupq_n_f32(0.0f)};
+        for(const auto &entry : entries)
+        {
+            const float *src{lines[entry.mLine] + base};
+            acc0 = vmlaq_n_f32(acc0, vld1q_f32(src), entry.mGain);
+            acc1 = vmlaq_n_f32(acc1, vld1q_f32(src+4), entry.mGain);
+        }
+        float *dst{&output[base]};
+        vst1q_f32(dst, vaddq_f32(vld1q_f32(dst), acc0));
+        vst1q_f32(dst+4, vaddq_f32(vld1q_f32(dst+4), acc1));
+    }
+#endif
+    for(;base < todo;++base)
+    {
+        float acc{0.0f};
+        for(const auto &entry : entries)
+            acc += lines[entry.mLine][base] * entry.mGain;
+        output[base] += acc;
     }
 }
 
+} // namespace
 
 void BFormatDec::process(const al::span<FloatBufferLine> OutBuffer,
     const al::span<const FloatBufferLine> InSamples, const size_t SamplesToDo)
 {
     ASSUME(SamplesToDo > 0);
 
-    auto decode_dualband = [=](std::vector<ChannelDecoderDual> &decoder)
+    std::array<const float*,MaxAmbiChannels*sNumBands> lines{};
+    for(size_t base{0};base < SamplesToDo;)
     {
-        auto input = InSamples.cbegin();
-        const auto hfSamples = al::span<float>{mSamples[sHFBand]}.first(SamplesToDo);
-        const auto lfSamples = al::span<float>{mSamples[sLFBand]}.first(SamplesToDo);
-        for(auto &chandec : decoder)
+        const size_t todo{std::min(SamplesToDo-base, sChunkSize)};
+
+        if(mXOver.empty())
         {
-            chandec.mXOver.process(al::span{*input++}.first(SamplesToDo), hfSamples, lfSamples);
-            MixSamples(hfSamples, OutBuffer, chandec.mGains[sHFBand], chandec.mGains[sHFBand],0,0);
-            MixSamples(lfSamples, OutBuffer, chandec.mGains[sLFBand], chandec.mGains[sLFBand],0,0);
+            for(size_t j{0};j < mNumLines;++j)
+                lines[j] = InSamples[j].data() + base;
         }
-    };
-    auto decode_singleband = [=](std::vector<ChannelDecoderSingle> &decoder)
-    {
-        auto input = InSamples.cbegin();
-        for(auto &chandec : decoder)
+        else
         {
-            MixSamples(al::span{*input++}.first(SamplesToDo), OutBuffer, chandec.mGains,
-                chandec.mGains, 0, 0);
+            for(size_t j{0};j < mXOver.size();++j)
+            {
+                const auto hfSamples = al::span{mSamples[j*sNumBands + sHFBand]}.first(todo);
+                const auto lfSamples = al::span{mSamples[j*sNumBands + sLFBand]}.first(todo);
+                mXOver[j].process(al::span{InSamples[j]}.subspan(base, todo), hfSamples,
+                    lfSamples);
+                lines[j*sNumBands + sHFBand] = hfSamples.data();
+                lines[j*sNumBands + sLFBand] = lfSamples.data();
+            }
         }
-    };
 
-    std::visit(overloaded{decode_dualband, decode_singleband}, mChannelDec);
+        for(const OutputRow &row : mRows)
+        {
+            if(row.mOutChan >= OutBuffer.size()) UNLIKELY
+                continue;
+            MixMatrixRow(al::span{OutBuffer[row.mOutChan]}.subspan(base, todo),
+                al::span<const MatrixEntry>{mMatrix}.subspan(row.mStart, row.mCount), lines);
+        }
+
+        base += todo;
+    }
 }
 
 void BFormatDec::processStablize(const al::span<FloatBufferLine> OutBuffer,
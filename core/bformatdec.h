@@ -4,7 +4,6 @@
 #include <array>
 #include <cstddef>
 #include <memory>
-#include <variant>
 #include <vector>
 
 #include "alspan.h"
@@ -23,20 +22,35 @@ class SIMDALIGN BFormatDec {
     static constexpr size_t sLFBand{1};
     static constexpr size_t sNumBands{2};
 
-    struct ChannelDecoderSingle {
-        std::array<float,MaxOutputChannels> mGains{};
+    /* The input is decoded in chunks of this many samples, keeping the (band-
+     * split) input lines in cache while they're mixed to each output.
+     */
+    static constexpr size_t sChunkSize{128};
+
+    /* A non-silent entry of the decoder matrix, giving the gain of an input
+     * line (input channel, or band of an input channel for dual-band) on an
+     * output channel.
+     */
+    struct MatrixEntry {
+        size_t mLine;
+        float mGain;
     };
 
-    struct ChannelDecoderDual {
-        BandSplitter mXOver;
-        std::array<std::array<float,MaxOutputChannels>,sNumBands> mGains{};
+    /* The matrix entries that mix to a given output channel. */
+    struct OutputRow {
+        size_t mOutChan;
+        size_t mStart;
+        size_t mCount;
     };
 
-    alignas(16) std::array<FloatBufferLine,2> mSamples{};
+    alignas(16) std::array<std::array<float,sChunkSize>,MaxAmbiChannels*sNumBands> mSamples{};
 
     const std::unique_ptr<FrontStablizer> mStablizer;
 
-    std::variant<std::vector<ChannelDecoderSingle>,std::vector<ChannelDecoderDual>> mChannelDec;
+    size_t mNumLines{};
+    std::vector<BandSplitter> mXOver;
+    std::vector<MatrixEntry> mMatrix;
+    std::vector<OutputRow> mRows;
 
 public:
     BFormatDec(const size_t inchans, const al::span<const ChannelDec> coeffs,
@@ -88,6 +88,26 @@ void ContextBase::allocVoiceProps()
         std::memory_order_acq_rel, std::memory_order_acquire) == false);
 }
 
+void ContextBase::allocVoiceParams()
+{
+    static constexpr size_t clustersize{std::tuple_size_v<VoiceParamCluster::element_type>};
+
+    TRACE("Increasing allocated voice parameter events to %zu\n",
+        (mVoiceParamClusters.size()+1) * clustersize);
+
+    auto clusterptr = std::make_unique<VoiceParamCluster::element_type>();
+    auto cluster = al::span{*clusterptr};
+    for(size_t i{1};i < clustersize;++i)
+        cluster[i-1].next.store(std::addressof(cluster[i]), std::memory_order_relaxed);
+    mVoiceParamClusters.emplace_back(std::move(clusterptr));
+
+    VoiceParamEvent *oldhead{mFreeVoiceParams.load(std::memory_order_acquire)};
+    do {
+        mVoiceParamClusters.back()->back().next.store(oldhead, std::memory_order_relaxed);
+    } while(mFreeVoiceParams.compare_exchange_weak(oldhead, mVoiceParamClusters.back()->data(),
+        std::memory_order_acq_rel, std::memory_order_acquire) == false);
+}
+
 void ContextBase::allocVoices(size_t addcount)
 {
     static constexpr size_t clustersize{std::tuple_size_v<VoiceCluster::element_type>};
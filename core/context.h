@@ -4,6 +4,7 @@
 #include <array>
 #include <atomic>
 #include <bitset>
+#include <chrono>
 #include <cstddef>
 #include <memory>
 #include <thread>
@@ -23,6 +24,7 @@ struct EffectSlotProps;
 struct RingBuffer;
 struct Voice;
 struct VoiceChange;
+struct VoiceParamEvent;
 struct VoicePropsItem;
 
 
@@ -58,6 +60,15 @@ struct ContextProps {
     bool SourceDistanceModel;
     DistanceModel mDistanceModel;
 
+    /* Listener motion at the given time, for predicting the listener pose in
+     * later updates (the angular velocity is in radians per second, around
+     * its axis).
+     */
+    bool HasMotion;
+    std::chrono::nanoseconds MotionTime;
+    std::array<float,3> MotionVelocity;
+    std::array<float,3> AngularVelocity;
+
     std::atomic<ContextProps*> next;
 };
 
@@ -78,6 +89,19 @@ struct ContextParams {
 
     bool SourceDistanceModel{false};
     DistanceModel mDistanceModel{};
+
+    /* The listener pose and motion as last given, when it has motion. */
+    bool HasMotion{false};
+    std::chrono::nanoseconds MotionTime{};
+    alu::Vector MotionPosition{};
+    alu::Vector MotionAt{}, MotionUp{};
+    alu::Vector MotionVelocity{}, AngularVelocity{};
+    /* The listener's unrotated velocity, for the predicted orientations. */
+    alu::Vector ListenerVelocity{};
+
+    /* The predicted listener pose that voices were last fully updated with. */
+    alu::Vector VoicePosition{};
+    alu::Vector VoiceAt{}, VoiceUp{};
 };
 
 struct ContextBase {
@@ -88,6 +112,11 @@ struct ContextBase {
      */
     std::atomic<unsigned int> mUpdateCount{0u};
     std::atomic<bool> mHoldUpdates{false};
+    /* Set when waiting for the mixer to finish its updates, so it knows to
+     * post mUpdateSem when done.
+     */
+    std::atomic<bool> mUpdateWaiting{false};
+    al::semaphore mUpdateSem;
     std::atomic<bool> mStopVoicesOnDisconnect{true};
 
     float mGainBoost{1.0f};
@@ -97,6 +126,7 @@ struct ContextBase {
      */
     std::atomic<ContextProps*> mFreeContextProps{nullptr};
     std::atomic<VoicePropsItem*> mFreeVoiceProps{nullptr};
+    std::atomic<VoiceParamEvent*> mFreeVoiceParams{nullptr};
     std::atomic<EffectSlotProps*> mFreeEffectSlotProps{nullptr};
 
     /* The voice change tail is the beginning of the "free" elements, up to and
@@ -109,6 +139,7 @@ struct ContextBase {
 
     void allocVoiceChanges();
     void allocVoiceProps();
+    void allocVoiceParams();
     void allocEffectSlotProps();
     void allocContextProps();
 
@@ -118,6 +149,12 @@ struct ContextBase {
     al::atomic_unique_ptr<VoiceArray> mVoices{};
     std::atomic<size_t> mActiveVoiceCount{};
 
+    /* Sequence lock for the voices' mPlaybackInfo. It's odd while the mixer is
+     * writing the next set, and once written, the set at index (seq/2)&1 is
+     * current.
+     */
+    std::atomic<unsigned int> mPlaybackInfoSeq{0u};
+
     void allocVoices(size_t addcount);
     [[nodiscard]] auto getVoicesSpan() const noexcept -> al::span<Voice*>
     {
@@ -158,6 +195,9 @@ struct ContextBase {
     using VoicePropsCluster = std::unique_ptr<std::array<VoicePropsItem,32>>;
     std::vector<VoicePropsCluster> mVoicePropClusters;
 
+    using VoiceParamCluster = std::unique_ptr<std::array<VoiceParamEvent,64>>;
+    std::vector<VoiceParamCluster> mVoiceParamClusters;
+
 
     EffectSlot *getEffectSlot();
 
@@ -10,6 +10,11 @@
 #include <cstdint>
 #include <iterator>
 #include <climits>
+#include <cstring>
+
+#ifdef HAVE_SSE_INTRINSICS
+#include <emmintrin.h>
+#endif
 
 #include "albit.h"
 #include "alnumeric.h"
@@ -44,26 +49,188 @@ template<> constexpr float LoadSample<DevFmtUInt>(DevFmtType_t<DevFmtUInt> val)
 { return LoadSample<DevFmtInt>(static_cast<int32_t>(val - 2147483648u)); }
 
 
+#ifdef HAVE_SSE_INTRINSICS
+/* Vector versions of LoadSample and StoreSample, which convert four samples
+ * at a time. These round and clamp the same as the scalar versions.
+ */
+template<DevFmtType T>
+__m128 LoadSample4(const DevFmtType_t<T> *src) noexcept = delete;
+
+template<> inline __m128 LoadSample4<DevFmtFloat>(const float *src) noexcept
+{ return _mm_loadu_ps(src); }
+template<> inline __m128 LoadSample4<DevFmtInt>(const int32_t *src) noexcept
+{
+    const __m128i ival{_mm_loadu_si128(reinterpret_cast<const __m128i*>(src))};
+    return _mm_mul_ps(_mm_cvtepi32_ps(ival), _mm_set1_ps(1.0f/2147483648.0f));
+}
+template<> inline __m128 LoadSample4<DevFmtUInt>(const uint32_t *src) noexcept
+{
+    __m128i ival{_mm_loadu_si128(reinterpret_cast<const __m128i*>(src))};
+    ival = _mm_xor_si128(ival, _mm_set1_epi32(INT_MIN));
+    return _mm_mul_ps(_mm_cvtepi32_ps(ival), _mm_set1_ps(1.0f/2147483648.0f));
+}
+template<> inline __m128 LoadSample4<DevFmtShort>(const int16_t *src) noexcept
+{
+    /* Sign-extend by placing the 16-bit values in the upper halves and
+     * shifting them back down.
+     */
+    __m128i ival{_mm_loadl_epi64(reinterpret_cast<const __m128i*>(src))};
+    ival = _mm_srai_epi32(_mm_unpacklo_epi16(ival, ival), 16);
+    return _mm_mul_ps(_mm_cvtepi32_ps(ival), _mm_set1_ps(1.0f/32768.0f));
+}
+template<> inline __m128 LoadSample4<DevFmtUShort>(const uint16_t *src) noexcept
+{
+    __m128i ival{_mm_loadl_epi64(reinterpret_cast<const __m128i*>(src))};
+    ival = _mm_xor_si128(ival, _mm_set1_epi16(SHRT_MIN));
+    ival = _mm_srai_epi32(_mm_unpacklo_epi16(ival, ival), 16);
+    return _mm_mul_ps(_mm_cvtepi32_ps(ival), _mm_set1_ps(1.0f/32768.0f));
+}
+template<> inline __m128 LoadSample4<DevFmtByte>(const int8_t *src) noexcept
+{
+    int bits;
+    std::memcpy(&bits, src, sizeof(bits));
+    __m128i ival{_mm_cvtsi32_si128(bits)};
+    ival = _mm_unpacklo_epi8(ival, ival);
+    ival = _mm_srai_epi32(_mm_unpacklo_epi16(ival, ival), 24);
+    return _mm_mul_ps(_mm_cvtepi32_ps(ival), _mm_set1_ps(1.0f/128.0f));
+}
+template<> inline __m128 LoadSample4<DevFmtUByte>(const uint8_t *src) noexcept
+{
+    int bits;
+    std::memcpy(&bits, src, sizeof(bits));
+    __m128i ival{_mm_xor_si128(_mm_cvtsi32_si128(bits), _mm_set1_epi8(SCHAR_MIN))};
+    ival = _mm_unpacklo_epi8(ival, ival);
+    ival = _mm_srai_epi32(_mm_unpacklo_epi16(ival, ival), 24);
+    return _mm_mul_ps(_mm_cvtepi32_ps(ival), _mm_set1_ps(1.0f/128.0f));
+}
+
+
 template<DevFmtType T>
-inline void LoadSampleArray(const al::span<float> dst, const void *src, const size_t channel,
-    const size_t srcstep) noexcept
+void StoreSample4(DevFmtType_t<T> *dst, __m128 val) noexcept = delete;
+
+template<> inline void StoreSample4<DevFmtFloat>(float *dst, __m128 val) noexcept
+{ _mm_storeu_ps(dst, val); }
+template<> inline void StoreSample4<DevFmtInt>(int32_t *dst, __m128 val) noexcept
+{
+    val = _mm_mul_ps(val, _mm_set1_ps(2147483648.0f));
+    val = _mm_min_ps(_mm_max_ps(val, _mm_set1_ps(-2147483648.0f)), _mm_set1_ps(2147483520.0f));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(dst), _mm_cvtps_epi32(val));
+}
+template<> inline void StoreSample4<DevFmtUInt>(uint32_t *dst, __m128 val) noexcept
+{
+    val = _mm_mul_ps(val, _mm_set1_ps(2147483648.0f));
+    val = _mm_min_ps(_mm_max_ps(val, _mm_set1_ps(-2147483648.0f)), _mm_set1_ps(2147483520.0f));
+    const __m128i ival{_mm_xor_si128(_mm_cvtps_epi32(val), _mm_set1_epi32(INT_MIN))};
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(dst), ival);
+}
+template<> inline void StoreSample4<DevFmtShort>(int16_t *dst, __m128 val) noexcept
+{
+    val = _mm_mul_ps(val, _mm_set1_ps(32768.0f));
+    val = _mm_min_ps(_mm_max_ps(val, _mm_set1_ps(-32768.0f)), _mm_set1_ps(32767.0f));
+    const __m128i ival{_mm_cvtps_epi32(val)};
+    _mm_storel_epi64(reinterpret_cast<__m128i*>(dst), _mm_packs_epi32(ival, ival));
+}
+template<> inline void StoreSample4<DevFmtUShort>(uint16_t *dst, __m128 val) noexcept
+{
+    val = _mm_mul_ps(val, _mm_set1_ps(32768.0f));
+    val = _mm_min_ps(_mm_max_ps(val, _mm_set1_ps(-32768.0f)), _mm_set1_ps(32767.0f));
+    __m128i ival{_mm_cvtps_epi32(val)};
+    ival = _mm_xor_si128(_mm_packs_epi32(ival, ival), _mm_set1_epi16(SHRT_MIN));
+    _mm_storel_epi64(reinterpret_cast<__m128i*>(dst), ival);
+}
+template<> inline void StoreSample4<DevFmtByte>(int8_t *dst, __m128 val) noexcept
 {
-    assert(channel < srcstep);
-    const auto srcspan = al::span{static_cast<const DevFmtType_t<T>*>(src), dst.size()*srcstep};
-    auto ssrc = srcspan.cbegin();
-    std::generate(dst.begin(), dst.end(), [&ssrc,channel,srcstep]
+    val = _mm_mul_ps(val, _mm_set1_ps(128.0f));
+    val = _mm_min_ps(_mm_max_ps(val, _mm_set1_ps(-128.0f)), _mm_set1_ps(127.0f));
+    __m128i ival{_mm_cvtps_epi32(val)};
+    ival = _mm_packs_epi32(ival, ival);
+    ival = _mm_packs_epi16(ival, ival);
+    const int bits{_mm_cvtsi128_si32(ival)};
+    std::memcpy(dst, &bits, sizeof(bits));
+}
+template<> inline void StoreSample4<DevFmtUByte>(uint8_t *dst, __m128 val) noexcept
+{
+    val = _mm_mul_ps(val, _mm_set1_ps(128.0f));
+    val = _mm_min_ps(_mm_max_ps(val, _mm_set1_ps(-128.0f)), _mm_set1_ps(127.0f));
+    __m128i ival{_mm_cvtps_epi32(val)};
+    ival = _mm_packs_epi32(ival, ival);
+    ival = _mm_xor_si128(_mm_packs_epi16(ival, ival), _mm_set1_epi8(SCHAR_MIN));
+    const int bits{_mm_cvtsi128_si32(ival)};
+    std::memcpy(dst, &bits, sizeof(bits));
+}
+#endif
+
+
+using ChanSamples = SampleConverter::ChanSamples;
+
+/* Loads count interleaved sample frames from src, deinterleaving them into
+ * each channel's sample buffer at the given offset. This makes a single pass
+ * over the input for all channels.
+ */
+template<DevFmtType T>
+void LoadSampleArray(const al::span<ChanSamples> chans, const size_t offset, const size_t count,
+    const void *src) noexcept
+{
+    const size_t numchans{chans.size()};
+    const auto srcspan = al::span{static_cast<const DevFmtType_t<T>*>(src), count*numchans};
+
+    size_t pos{0};
+#ifdef HAVE_SSE_INTRINSICS
+    if(const size_t todo{count & ~3_uz})
     {
-        const float ret{LoadSample<T>(ssrc[channel])};
-        ssrc += ptrdiff_t(srcstep);
-        return ret;
-    });
+        if(numchans == 1)
+        {
+            const auto dst = al::span{chans[0].Samples}.subspan(offset, count);
+            for(;pos < todo;pos += 4)
+                _mm_storeu_ps(&dst[pos], LoadSample4<T>(&srcspan[pos]));
+        }
+        else if(numchans == 2)
+        {
+            const auto dst0 = al::span{chans[0].Samples}.subspan(offset, count);
+            const auto dst1 = al::span{chans[1].Samples}.subspan(offset, count);
+            for(;pos < todo;pos += 4)
+            {
+                const __m128 frames01{LoadSample4<T>(&srcspan[pos*2])};
+                const __m128 frames23{LoadSample4<T>(&srcspan[pos*2 + 4])};
+                _mm_storeu_ps(&dst0[pos], _mm_shuffle_ps(frames01, frames23, _MM_SHUFFLE(2,0,2,0)));
+                _mm_storeu_ps(&dst1[pos], _mm_shuffle_ps(frames01, frames23, _MM_SHUFFLE(3,1,3,1)));
+            }
+        }
+        else if(numchans == 4)
+        {
+            const auto dst0 = al::span{chans[0].Samples}.subspan(offset, count);
+            const auto dst1 = al::span{chans[1].Samples}.subspan(offset, count);
+            const auto dst2 = al::span{chans[2].Samples}.subspan(offset, count);
+            const auto dst3 = al::span{chans[3].Samples}.subspan(offset, count);
+            for(;pos < todo;pos += 4)
+            {
+                __m128 frame0{LoadSample4<T>(&srcspan[pos*4])};
+                __m128 frame1{LoadSample4<T>(&srcspan[pos*4 + 4])};
+                __m128 frame2{LoadSample4<T>(&srcspan[pos*4 + 8])};
+                __m128 frame3{LoadSample4<T>(&srcspan[pos*4 + 12])};
+                _MM_TRANSPOSE4_PS(frame0, frame1, frame2, frame3);
+                _mm_storeu_ps(&dst0[pos], frame0);
+                _mm_storeu_ps(&dst1[pos], frame1);
+                _mm_storeu_ps(&dst2[pos], frame2);
+                _mm_storeu_ps(&dst3[pos], frame3);
+            }
+        }
+    }
+#endif
+
+    auto ssrc = srcspan.begin() + ptrdiff_t(pos*numchans);
+    for(;pos < count;++pos)
+    {
+        for(auto &chan : chans)
+            chan.Samples[offset+pos] = LoadSample<T>(*(ssrc++));
+    }
 }
 
-void LoadSamples(const al::span<float> dst, const void *src, const size_t channel,
-    const size_t srcstep, const DevFmtType srctype) noexcept
+void LoadSamples(const al::span<ChanSamples> chans, const size_t offset, const size_t count,
+    const void *src, const DevFmtType srctype) noexcept
 {
 #define HANDLE_FMT(T)                                                         \
-    case T: LoadSampleArray<T>(dst, src, channel, srcstep); break
+    case T: LoadSampleArray<T>(chans, offset, count, src); break
     switch(srctype)
     {
         HANDLE_FMT(DevFmtByte);
@@ -104,15 +271,25 @@ inline void StoreSampleArray(void *dst, const al::span<const float> src, const s
 {
     assert(channel < dststep);
     const auto dstspan = al::span{static_cast<DevFmtType_t<T>*>(dst), src.size()*dststep};
-    auto sdst = dstspan.begin();
-    std::for_each(src.cbegin(), src.cend(), [&sdst,channel,dststep](const float in)
+
+    size_t pos{0};
+#ifdef HAVE_SSE_INTRINSICS
+    if(dststep == 1)
+    {
+        const size_t todo{src.size() & ~3_uz};
+        for(;pos < todo;pos += 4)
+            StoreSample4<T>(&dstspan[pos], _mm_loadu_ps(&src[pos]));
+    }
+#endif
+
+    auto sdst = dstspan.begin() + ptrdiff_t(pos*dststep);
+    std::for_each(src.cbegin()+ptrdiff_t(pos), src.cend(), [&sdst,channel,dststep](const float in)
     {
         sdst[channel] = StoreSample<T>(in);
         sdst += ptrdiff_t(dststep);
     });
 }
 
-
 void StoreSamples(void *dst, const al::span<const float> src, const size_t channel,
     const size_t dststep, const DevFmtType dsttype) noexcept
 {
@@ -131,37 +308,154 @@ void StoreSamples(void *dst, const al::span<const float> src, const size_t chann
 #undef HANDLE_FMT
 }
 
+/* Stores count sample frames to dst, interleaving them from each channel's
+ * sample buffer at the given offset. This is the counterpart to
+ * LoadSampleArray, for when no resampling is needed.
+ */
+template<DevFmtType T>
+void StoreInterleavedArray(void *dst, const al::span<const ChanSamples> chans, const size_t offset,
+    const size_t count) noexcept
+{
+    const size_t numchans{chans.size()};
+    const auto dstspan = al::span{static_cast<DevFmtType_t<T>*>(dst), count*numchans};
+
+    size_t pos{0};
+#ifdef HAVE_SSE_INTRINSICS
+    if(const size_t todo{count & ~3_uz})
+    {
+        if(numchans == 1)
+        {
+            const auto src = al::span{chans[0].Samples}.subspan(offset, count);
+            for(;pos < todo;pos += 4)
+                StoreSample4<T>(&dstspan[pos], _mm_loadu_ps(&src[pos]));
+        }
+        else if(numchans == 2)
+        {
+            const auto src0 = al::span{chans[0].Samples}.subspan(offset, count);
+            const auto src1 = al::span{chans[1].Samples}.subspan(offset, count);
+            for(;pos < todo;pos += 4)
+            {
+                const __m128 chan0{_mm_loadu_ps(&src0[pos])};
+                const __m128 chan1{_mm_loadu_ps(&src1[pos])};
+                StoreSample4<T>(&dstspan[pos*2], _mm_unpacklo_ps(chan0, chan1));
+                StoreSample4<T>(&dstspan[pos*2 + 4], _mm_unpackhi_ps(chan0, chan1));
+            }
+        }
+        else if(numchans == 4)
+        {
+            const auto src0 = al::span{chans[0].Samples}.subspan(offset, count);
+            const auto src1 = al::span{chans[1].Samples}.subspan(offset, count);
+            const auto src2 = al::span{chans[2].Samples}.subspan(offset, count);
+            const auto src3 = al::span{chans[3].Samples}.subspan(offset, count);
+            for(;pos < todo;pos += 4)
+            {
+                __m128 frame0{_mm_loadu_ps(&src0[pos])};
+                __m128 frame1{_mm_loadu_ps(&src1[pos])};
+                __m128 frame2{_mm_loadu_ps(&src2[pos])};
+                __m128 frame3{_mm_loadu_ps(&src3[pos])};
+                _MM_TRANSPOSE4_PS(frame0, frame1, frame2, frame3);
+                StoreSample4<T>(&dstspan[pos*4], frame0);
+                StoreSample4<T>(&dstspan[pos*4 + 4], frame1);
+                StoreSample4<T>(&dstspan[pos*4 + 8], frame2);
+                StoreSample4<T>(&dstspan[pos*4 + 12], frame3);
+            }
+        }
+    }
+#endif
+
+    auto sdst = dstspan.begin() + ptrdiff_t(pos*numchans);
+    for(;pos < count;++pos)
+    {
+        for(const auto &chan : chans)
+            *(sdst++) = StoreSample<T>(chan.Samples[offset+pos]);
+    }
+}
+
+void StoreInterleaved(void *dst, const al::span<const ChanSamples> chans, const size_t offset,
+    const size_t count, const DevFmtType dsttype) noexcept
+{
+#define HANDLE_FMT(T)                                                         \
+    case T: StoreInterleavedArray<T>(dst, chans, offset, count); break
+    switch(dsttype)
+    {
+        HANDLE_FMT(DevFmtByte);
+        HANDLE_FMT(DevFmtUByte);
+        HANDLE_FMT(DevFmtShort);
+        HANDLE_FMT(DevFmtUShort);
+        HANDLE_FMT(DevFmtInt);
+        HANDLE_FMT(DevFmtUInt);
+        HANDLE_FMT(DevFmtFloat);
+    }
+#undef HANDLE_FMT
+}
+
 
 template<DevFmtType T>
 void Mono2Stereo(const al::span<float> dst, const void *src) noexcept
 {
     const auto srcspan = al::span{static_cast<const DevFmtType_t<T>*>(src), dst.size()>>1};
-    auto sdst = dst.begin();
-    std::for_each(srcspan.cbegin(), srcspan.cend(), [&sdst](const auto in)
+
+    size_t pos{0};
+#ifdef HAVE_SSE_INTRINSICS
+    if(const size_t todo{srcspan.size() & ~3_uz})
+    {
+        const __m128 scale{_mm_set1_ps(0.707106781187f)};
+        for(;pos < todo;pos += 4)
+        {
+            const __m128 s{_mm_mul_ps(LoadSample4<T>(&srcspan[pos]), scale)};
+            _mm_storeu_ps(&dst[pos*2], _mm_unpacklo_ps(s, s));
+            _mm_storeu_ps(&dst[pos*2 + 4], _mm_unpackhi_ps(s, s));
+        }
+    }
+#endif
+
+    auto sdst = dst.begin() + ptrdiff_t(pos*2);
+    std::for_each(srcspan.cbegin()+ptrdiff_t(pos), srcspan.cend(), [&sdst](const auto in)
     { sdst = std::fill_n(sdst, 2, LoadSample<T>(in)*0.707106781187f); });
 }
 
 template<DevFmtType T>
-void Multi2Mono(uint chanmask, const size_t step, const float scale, const al::span<float> dst,
-    const void *src) noexcept
+void Multi2Mono(const uint chanmask, const size_t step, const float scale,
+    const al::span<float> dst, const void *src) noexcept
 {
     const auto srcspan = al::span{static_cast<const DevFmtType_t<T>*>(src), step*dst.size()};
-    std::fill_n(dst.begin(), dst.size(), 0.0f);
-    for(size_t c{0};chanmask;++c)
+
+    size_t pos{0};
+#ifdef HAVE_SSE_INTRINSICS
+    /* Stereo to mono is the common case, which can deinterleave and mix four
+     * frames at a time.
+     */
+    if(step == 2 && chanmask == 0x3)
     {
-        if((chanmask&1)) LIKELY
+        const size_t todo{dst.size() & ~3_uz};
+        const __m128 vscale{_mm_set1_ps(scale)};
+        for(;pos < todo;pos += 4)
         {
-            auto ssrc = srcspan.cbegin();
-            std::for_each(dst.begin(), dst.end(), [&ssrc,step,c](float &sample)
-            {
-                const float s{LoadSample<T>(ssrc[c])};
-                ssrc += ptrdiff_t(step);
-                sample += s;
-            });
+            const __m128 frames01{LoadSample4<T>(&srcspan[pos*2])};
+            const __m128 frames23{LoadSample4<T>(&srcspan[pos*2 + 4])};
+            const __m128 left{_mm_shuffle_ps(frames01, frames23, _MM_SHUFFLE(2,0,2,0))};
+            const __m128 right{_mm_shuffle_ps(frames01, frames23, _MM_SHUFFLE(3,1,3,1))};
+            _mm_storeu_ps(&dst[pos], _mm_mul_ps(_mm_add_ps(left, right), vscale));
         }
-        chanmask >>= 1;
     }
-    std::for_each(dst.begin(), dst.end(), [scale](float &sample) noexcept { sample *= scale; });
+#endif
+
+    /* Mix all the channels of each frame together in one pass over the input,
+     * rather than going over it once per channel.
+     */
+    auto ssrc = srcspan.cbegin() + ptrdiff_t(pos*step);
+    std::for_each(dst.begin()+ptrdiff_t(pos), dst.end(), [&ssrc,chanmask,step,scale](float &sample)
+    {
+        float sum{0.0f};
+        size_t c{0};
+        for(uint mask{chanmask};mask;mask >>= 1,++c)
+        {
+            if((mask&1)) LIKELY
+                sum += LoadSample<T>(ssrc[c]);
+        }
+        ssrc += ptrdiff_t(step);
+        sample = sum * scale;
+    });
 }
 
 } // namespace
@@ -181,20 +475,17 @@ SampleConverterPtr SampleConverter::Create(DevFmtType srcType, DevFmtType dstTyp
     converter->mSrcPrepCount = MaxResamplerPadding;
     converter->mFracOffset = 0;
     for(auto &chan : converter->mChan)
-        chan.PrevSamples.fill(0.0f);
+        std::fill_n(chan.Samples.begin(), MaxResamplerPadding, 0.0f);
 
     /* Have to set the mixer FPU mode since that's what the resampler code expects. */
     FPUCtl mixer_mode{};
     const auto step = std::min(std::round(srcRate*double{MixerFracOne}/dstRate),
         MaxPitch*double{MixerFracOne});
     converter->mIncrement = std::max(static_cast<uint>(step), 1u);
-    if(converter->mIncrement == MixerFracOne)
-    {
-        converter->mResample = [](const InterpState*, const al::span<const float> src, uint,
-            const uint, const al::span<float> dst)
-        { std::copy_n(src.begin()+MaxResamplerEdge, dst.size(), dst.begin()); };
-    }
-    else
+    /* Without a rate change, the samples are converted straight from the
+     * channel buffers and no resampler is needed.
+     */
+    if(converter->mIncrement != MixerFracOne)
         converter->mResample = PrepareResampler(resampler, converter->mIncrement,
             &converter->mState);
 
@@ -235,6 +526,7 @@ uint SampleConverter::convert(const void **src, uint *srcframes, void *dst, uint
     uint NumSrcSamples{*srcframes};
     auto SamplesIn = al::span{static_cast<const std::byte*>(*src), NumSrcSamples*SrcFrameSize};
     auto SamplesOut = al::span{static_cast<std::byte*>(dst), dstframes*DstFrameSize};
+    const auto chans = al::span{mChan.begin(), mChan.end()};
 
     FPUCtl mixer_mode{};
     uint pos{0};
@@ -243,21 +535,21 @@ uint SampleConverter::convert(const void **src, uint *srcframes, void *dst, uint
         const uint prepcount{mSrcPrepCount};
         const uint readable{std::min(NumSrcSamples, uint{BufferLineSize} - prepcount)};
 
+        /* Load the new samples for all channels after the previous samples,
+         * deinterleaving them in one pass.
+         */
+        LoadSamples(chans, prepcount, readable, SamplesIn.data(), mSrcType);
+
         if(prepcount < MaxResamplerPadding && MaxResamplerPadding-prepcount >= readable)
         {
-            /* Not enough input samples to generate an output sample. Store
+            /* Not enough input samples to generate an output sample. Keep
              * what we're given for later.
              */
-            for(size_t chan{0u};chan < mChan.size();chan++)
-                LoadSamples(al::span{mChan[chan].PrevSamples}.subspan(prepcount, readable),
-                    SamplesIn.data(), chan, mChan.size(), mSrcType);
-
             mSrcPrepCount = prepcount + readable;
             NumSrcSamples = 0;
             break;
         }
 
-        const auto SrcData = al::span<float>{mSrcSamples};
         const auto DstData = al::span<float>{mDstSamples};
         uint DataPosFrac{mFracOffset};
         uint64_t DataSize64{prepcount};
@@ -277,28 +569,36 @@ uint SampleConverter::convert(const void **src, uint *srcframes, void *dst, uint
         assert(prepcount+readable >= SrcDataEnd);
         const uint nextprep{std::min(prepcount+readable-SrcDataEnd, MaxResamplerPadding)};
 
-        for(size_t chan{0u};chan < mChan.size();chan++)
+        if(increment == MixerFracOne)
         {
-            /* Load the previous samples into the source data first, then the
-             * new samples from the input buffer.
-             */
-            std::copy_n(mChan[chan].PrevSamples.cbegin(), prepcount, SrcData.begin());
-            LoadSamples(SrcData.subspan(prepcount, readable), SamplesIn.data(), chan, mChan.size(),
-                mSrcType);
-
-            /* Store as many prep samples for next time as possible, given the
-             * number of output samples being generated.
+            /* With no rate change, the output is just the input delayed by
+             * MaxResamplerEdge samples, so convert and interleave it directly
+             * from the channel buffers.
              */
-            auto previter = std::copy_n(SrcData.begin()+ptrdiff_t(SrcDataEnd), nextprep,
-                mChan[chan].PrevSamples.begin());
-            std::fill(previter, mChan[chan].PrevSamples.end(), 0.0f);
-
-            /* Now resample, and store the result in the output buffer. */
-            mResample(&mState, SrcData, DataPosFrac, increment, DstData.first(DstSize));
+            StoreInterleaved(SamplesOut.data(), chans, MaxResamplerEdge, DstSize, mDstType);
+        }
+        else for(size_t chan{0u};chan < mChan.size();chan++)
+        {
+            /* Resample, and store the result in the output buffer. */
+            mResample(&mState, mChan[chan].Samples, DataPosFrac, increment,
+                DstData.first(DstSize));
 
             StoreSamples(SamplesOut.data(), DstData.first(DstSize), chan, mChan.size(), mDstType);
         }
 
+        /* Store as many prep samples for next time as possible, given the
+         * number of output samples generated.
+         */
+        for(auto &chan : mChan)
+        {
+            auto previter = chan.Samples.begin();
+            if(SrcDataEnd > 0)
+                previter = std::copy_n(previter+ptrdiff_t(SrcDataEnd), nextprep, previter);
+            else
+                previter += ptrdiff_t(nextprep);
+            std::fill(previter, chan.Samples.begin()+MaxResamplerPadding, 0.0f);
+        }
+
         /* Update the number of prep samples still available, as well as the
          * fractional offset.
          */
@@ -326,6 +626,7 @@ uint SampleConverter::convertPlanar(const void **src, uint *srcframes, void *con
     const auto dsts = al::span{dst, mChan.size()};
     const uint increment{mIncrement};
     uint NumSrcSamples{*srcframes};
+    const auto chans = al::span{mChan.begin(), mChan.end()};
 
     FPUCtl mixer_mode{};
     uint pos{0};
@@ -334,17 +635,19 @@ uint SampleConverter::convertPlanar(const void **src, uint *srcframes, void *con
         const uint prepcount{mSrcPrepCount};
         const uint readable{std::min(NumSrcSamples, uint{BufferLineSize} - prepcount)};
 
+        /* Load the new samples after the previous samples. */
+        for(size_t chan{0u};chan < mChan.size();chan++)
+            LoadSamples(chans.subspan(chan, 1), prepcount, readable, srcs[chan], mSrcType);
+
         if(prepcount < MaxResamplerPadding && MaxResamplerPadding-prepcount >= readable)
         {
-            /* Not enough input samples to generate an output sample. Store
+            /* Not enough input samples to generate an output sample. Keep
              * what we're given for later.
              */
             for(size_t chan{0u};chan < mChan.size();chan++)
             {
                 auto samples = al::span{static_cast<const std::byte*>(srcs[chan]),
                     NumSrcSamples*size_t{mSrcTypeSize}};
-                LoadSamples(al::span{mChan[chan].PrevSamples}.subspan(prepcount, readable),
-                    samples.data(), 0, 1, mSrcType);
                 srcs[chan] = samples.subspan(size_t{mSrcTypeSize}*readable).data();
             }
 
@@ -353,7 +656,6 @@ uint SampleConverter::convertPlanar(const void **src, uint *srcframes, void *con
             break;
         }
 
-        const auto SrcData = al::span{mSrcSamples};
         const auto DstData = al::span{mDstSamples};
         uint DataPosFrac{mFracOffset};
         uint64_t DataSize64{prepcount};
@@ -375,25 +677,32 @@ uint SampleConverter::convertPlanar(const void **src, uint *srcframes, void *con
 
         for(size_t chan{0u};chan < mChan.size();chan++)
         {
-            /* Load the previous samples into the source data first, then the
-             * new samples from the input buffer.
+            auto DstSamples = al::span{static_cast<std::byte*>(dsts[chan]),
+                size_t{mDstTypeSize}*dstframes}.subspan(pos*size_t{mDstTypeSize});
+
+            /* With no rate change, convert directly from the channel buffer
+             * (delayed by MaxResamplerEdge samples). Otherwise resample and
+             * store the result in the output buffer.
              */
-            auto srciter = std::copy_n(mChan[chan].PrevSamples.cbegin(),prepcount,SrcData.begin());
-            LoadSamples({srciter, readable}, srcs[chan], 0, 1, mSrcType);
+            const auto SrcData = al::span<const float>{mChan[chan].Samples};
+            if(increment == MixerFracOne)
+                StoreSamples(DstSamples.data(), SrcData.subspan(MaxResamplerEdge, DstSize), 0, 1,
+                    mDstType);
+            else
+            {
+                mResample(&mState, SrcData, DataPosFrac, increment, DstData.first(DstSize));
+                StoreSamples(DstSamples.data(), DstData.first(DstSize), 0, 1, mDstType);
+            }
 
             /* Store as many prep samples for next time as possible, given the
-             * number of output samples being generated.
+             * number of output samples generated.
              */
-            auto previter = std::copy_n(SrcData.begin()+ptrdiff_t(SrcDataEnd), nextprep,
-                mChan[chan].PrevSamples.begin());
-            std::fill(previter, mChan[chan].PrevSamples.end(), 0.0f);
-
-            /* Now resample, and store the result in the output buffer. */
-            mResample(&mState, SrcData, DataPosFrac, increment, DstData.first(DstSize));
-
-            auto DstSamples = al::span{static_cast<std::byte*>(dsts[chan]),
-                size_t{mDstTypeSize}*dstframes}.subspan(pos*size_t{mDstTypeSize});
-            StoreSamples(DstSamples.data(), DstData.first(DstSize), 0, 1, mDstType);
+            auto previter = mChan[chan].Samples.begin();
+            if(SrcDataEnd > 0)
+                previter = std::copy_n(previter+ptrdiff_t(SrcDataEnd), nextprep, previter);
+            else
+                previter += ptrdiff_t(nextprep);
+            std::fill(previter, mChan[chan].Samples.begin()+MaxResamplerPadding, 0.0f);
         }
 
         /* Update the number of prep samples still available, as well as the
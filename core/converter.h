@@ -27,11 +27,13 @@ struct SampleConverter {
     InterpState mState{};
     ResamplerFunc mResample{};
 
-    alignas(16) FloatBufferLine mSrcSamples{};
     alignas(16) FloatBufferLine mDstSamples{};
 
     struct ChanSamples {
-        alignas(16) std::array<float,MaxResamplerPadding> PrevSamples;
+        /* The first mSrcPrepCount samples are the prep samples left over from
+         * the last conversion, with new input loaded after them.
+         */
+        alignas(16) FloatBufferLine Samples;
     };
     al::FlexArray<ChanSamples> mChan;
 
@@ -200,6 +200,10 @@ struct SIMDALIGN EffectState : public al::intrusive_ref<EffectState> {
 
     virtual ~EffectState() = default;
 
+    /* (Re-)initializes the state for the device. This must restore everything
+     * processing depends on to how a newly created state has it, since idle
+     * states are reused by effect slots changing effects.
+     */
     virtual void deviceUpdate(const DeviceBase *device, const BufferStorage *buffer) = 0;
     virtual void update(const ContextBase *context, const EffectSlot *slot,
         const EffectProps *props, const EffectTarget target) = 0;
@@ -31,6 +31,8 @@ enum class EffectSlotType : unsigned char {
     PitchShifter,
     RingModulator,
     VocalMorpher,
+
+    Max = VocalMorpher
 };
 
 struct EffectSlotProps {
@@ -2,6 +2,7 @@
 #define CORE_FILTERS_BIQUAD_H
 
 #include <algorithm>
+#include <array>
 #include <cmath>
 #include <cstddef>
 #include <utility>
@@ -119,6 +120,10 @@ public:
     void dualProcess(BiquadFilterR &other, const al::span<const Real> src,
         const al::span<Real> dst);
 
+    /** The filter coefficients, as { b0, b1, b2, a1, a2 }. */
+    [[nodiscard]] auto getCoeffs() const noexcept -> std::array<Real,5>
+    { return {mB0, mB1, mB2, mA1, mA2}; }
+
     /* Rather hacky. It's just here to support "manual" processing. */
     [[nodiscard]] auto getComponents() const noexcept -> std::pair<Real,Real> { return {mZ1, mZ2}; }
     void setComponents(Real z1, Real z2) noexcept { mZ1 = z1; mZ2 = z2; }
@@ -0,0 +1,192 @@
+
+#include "config.h"
+
+#include "oversampler.h"
+
+#include <cassert>
+
+#ifdef HAVE_SSE_INTRINSICS
+#include <xmmintrin.h>
+#elif defined(HAVE_NEON)
+#include <arm_neon.h>
+#endif
+
+#include "alnumeric.h"
+#include "opthelpers.h"
+
+
+void BiquadOversampler::setFilters(const BiquadFilter &upfilter, const BiquadFilter &downfilter)
+{
+    mUpCoeffs = upfilter.getCoeffs();
+
+    /* The transposed direct form II biquad can be written in state-space form
+     * as:
+     *
+     * y[n] = b0*x[n] + z1[n]
+     * z[n+1] = A*z[n] + B*x[n]
+     *
+     * with A = [-a1 1; -a2 0] and B = [b1 - a1*b0; b2 - a2*b0]. Stepping that
+     * over a block of N inputs gives:
+     *
+     * z[n+N] = A^N*z[n] + sum_{k=0}^{N-1} A^(N-1-k)*B*x[n+k]
+     *
+     * so only the first output of each block needs to be computed. Calculate
+     * the block matrices with double precision to avoid accumulating errors.
+     */
+    const auto [b0, b1, b2, a1, a2] = downfilter.getCoeffs();
+    using Mat2 = std::array<double,4>;
+    const Mat2 transition{-double{a1}, 1.0, -double{a2}, 0.0};
+    auto mat_mul = [](const Mat2 &lhs, const Mat2 &rhs) noexcept -> Mat2
+    {
+        return Mat2{lhs[0]*rhs[0] + lhs[1]*rhs[2], lhs[0]*rhs[1] + lhs[1]*rhs[3],
+            lhs[2]*rhs[0] + lhs[3]*rhs[2], lhs[2]*rhs[1] + lhs[3]*rhs[3]};
+    };
+
+    auto input = std::array{double{b1} - double{a1}*double{b0},
+        double{b2} - double{a2}*double{b0}};
+    auto blockstate = Mat2{1.0, 0.0, 0.0, 1.0};
+    for(size_t k{OversampleFactor};k > 0;)
+    {
+        --k;
+        mDownInput[0][k] = static_cast<float>(input[0]);
+        mDownInput[1][k] = static_cast<float>(input[1]);
+        input = {transition[0]*input[0] + transition[1]*input[1],
+            transition[2]*input[0] + transition[3]*input[1]};
+        blockstate = mat_mul(transition, blockstate);
+    }
+    for(size_t i{0};i < mDownState.size();++i)
+        mDownState[i] = static_cast<float>(blockstate[i]);
+    mDownB0 = b0;
+}
+
+
+void BiquadOversampler::upsample(const al::span<const float> src, const al::span<float> dst)
+{
+    assert(dst.size() == src.size()*OversampleFactor);
+
+    const auto [b0, b1, b2, a1, a2] = mUpCoeffs;
+    float z1{mUpZ1};
+    float z2{mUpZ2};
+
+    auto output = dst.begin();
+    for(const float sample : src)
+    {
+        /* The first phase gets the scaled input sample. */
+        const float input{sample * float{OversampleFactor}};
+        float out{input*b0 + z1};
+        z1 = input*b1 - out*a1 + z2;
+        z2 = input*b2 - out*a2;
+        *(output++) = out;
+
+        /* The remaining phases are zero-stuffed, so there's no input to
+         * apply.
+         */
+        for(size_t i{1};i < OversampleFactor;++i)
+        {
+            out = z1;
+            z1 = z2 - out*a1;
+            z2 = -out*a2;
+            *(output++) = out;
+        }
+    }
+
+    mUpZ1 = z1;
+    mUpZ2 = z2;
+}
+
+
+void BiquadOversampler::downsample(const al::span<const float> src, const al::span<float> dst)
+{
+    static_assert(OversampleFactor == 4, "Decimation only handles 4x oversampling");
+    assert(src.size() == dst.size()*OversampleFactor);
+
+    const float b0{mDownB0};
+    const auto [s11, s12, s21, s22] = mDownState;
+    float z1{mDownZ1};
+    float z2{mDownZ2};
+
+    /* Applies the block state transition, given each state component's input
+     * contribution.
+     */
+    auto step_state = [s11,s12,s21,s22,&z1,&z2](const float in1, const float in2) noexcept
+    {
+        const float next1{s11*z1 + s12*z2 + in1};
+        z2 = s21*z1 + s22*z2 + in2;
+        z1 = next1;
+    };
+
+    size_t pos{0};
+#if defined(HAVE_SSE_INTRINSICS) || defined(HAVE_NEON)
+    /* Calculate the input contributions for four blocks at a time, before
+     * running the state through them.
+     */
+    if(const size_t todo{dst.size() & ~3_uz})
+    {
+#ifdef HAVE_SSE_INTRINSICS
+        const __m128 vb0{_mm_set1_ps(b0)};
+        const std::array w1{_mm_set1_ps(mDownInput[0][0]), _mm_set1_ps(mDownInput[0][1]),
+            _mm_set1_ps(mDownInput[0][2]), _mm_set1_ps(mDownInput[0][3])};
+        const std::array w2{_mm_set1_ps(mDownInput[1][0]), _mm_set1_ps(mDownInput[1][1]),
+            _mm_set1_ps(mDownInput[1][2]), _mm_set1_ps(mDownInput[1][3])};
+#else
+        const float32x4_t vb0{vdupq_n_f32(b0)};
+        const std::array w1{vdupq_n_f32(mDownInput[0][0]), vdupq_n_f32(mDownInput[0][1]),
+            vdupq_n_f32(mDownInput[0][2]), vdupq_n_f32(mDownInput[0][3])};
+        const std::array w2{vdupq_n_f32(mDownInput[1][0]), vdupq_n_f32(mDownInput[1][1]),
+            vdupq_n_f32(mDownInput[1][2]), vdupq_n_f32(mDownInput[1][3])};
+#endif
+        alignas(16) std::array<float,4> direct{};
+        alignas(16) std::array<float,4> input1{};
+        alignas(16) std::array<float,4> input2{};
+        for(;pos < todo;pos += 4)
+        {
+            const float *blocks{&src[pos*OversampleFactor]};
+#ifdef HAVE_SSE_INTRINSICS
+            /* Transpose the four blocks so each vector holds one phase. */
+            __m128 phase0{_mm_loadu_ps(blocks)};
+            __m128 phase1{_mm_loadu_ps(blocks+4)};
+            __m128 phase2{_mm_loadu_ps(blocks+8)};
+            __m128 phase3{_mm_loadu_ps(blocks+12)};
+            _MM_TRANSPOSE4_PS(phase0, phase1, phase2, phase3);
+
+            _mm_store_ps(direct.data(), _mm_mul_ps(phase0, vb0));
+            _mm_store_ps(input1.data(), _mm_add_ps(
+                _mm_add_ps(_mm_mul_ps(phase0, w1[0]), _mm_mul_ps(phase1, w1[1])),
+                _mm_add_ps(_mm_mul_ps(phase2, w1[2]), _mm_mul_ps(phase3, w1[3]))));
+            _mm_store_ps(input2.data(), _mm_add_ps(
+                _mm_add_ps(_mm_mul_ps(phase0, w2[0]), _mm_mul_ps(phase1, w2[1])),
+                _mm_add_ps(_mm_mul_ps(phase2, w2[2]), _mm_mul_ps(phase3, w2[3]))));
+#else
+            /* De-interleave the four blocks so each vector holds one phase. */
+            const float32x4x4_t phases{vld4q_f32(blocks)};
+
+            vst1q_f32(direct.data(), vmulq_f32(phases.val[0], vb0));
+            vst1q_f32(input1.data(), vaddq_f32(
+                vaddq_f32(vmulq_f32(phases.val[0], w1[0]), vmulq_f32(phases.val[1], w1[1])),
+                vaddq_f32(vmulq_f32(phases.val[2], w1[2]), vmulq_f32(phases.val[3], w1[3]))));
+            vst1q_f32(input2.data(), vaddq_f32(
+                vaddq_f32(vmulq_f32(phases.val[0], w2[0]), vmulq_f32(phases.val[1], w2[1])),
+                vaddq_f32(vmulq_f32(phases.val[2], w2[2]), vmulq_f32(phases.val[3], w2[3]))));
+#endif
+
+            for(size_t j{0};j < 4;++j)
+            {
+                dst[pos+j] = direct[j] + z1;
+                step_state(input1[j], input2[j]);
+            }
+        }
+    }
+#endif
+
+    const auto &[w1, w2] = mDownInput;
+    for(;pos < dst.size();++pos)
+    {
+        const auto block = src.subspan(pos*OversampleFactor, OversampleFactor);
+        dst[pos] = block[0]*b0 + z1;
+        step_state(block[0]*w1[0] + block[1]*w1[1] + block[2]*w1[2] + block[3]*w1[3],
+            block[0]*w2[0] + block[1]*w2[1] + block[2]*w2[2] + block[3]*w2[3]);
+    }
+
+    mDownZ1 = z1;
+    mDownZ2 = z2;
+}
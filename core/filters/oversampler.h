@@ -0,0 +1,59 @@
+#ifndef CORE_FILTERS_OVERSAMPLER_H
+#define CORE_FILTERS_OVERSAMPLER_H
+
+#include <array>
+#include <cstddef>
+
+#include "alspan.h"
+#include "biquad.h"
+
+
+inline constexpr size_t OversampleFactor{4};
+
+/* Polyphase oversampling stage for nonlinear processing, using biquads for the
+ * interpolation and decimation filters. Instead of filtering a zero-stuffed
+ * signal and throwing away all but one of every OversampleFactor filtered
+ * samples, the upsampler skips the multiplies with the stuffed zeros and the
+ * downsampler steps the filter over each block of OversampleFactor input
+ * samples at once, only computing the samples that are kept.
+ */
+class BiquadOversampler {
+    /* Interpolation filter, as { b0, b1, b2, a1, a2 }. */
+    std::array<float,5> mUpCoeffs{1.0f, 0.0f, 0.0f, 0.0f, 0.0f};
+    float mUpZ1{0.0f}, mUpZ2{0.0f};
+
+    /* Decimation filter, in state-space form. mDownState is the state
+     * transition over a whole block, and mDownInput is how much each input
+     * phase contributes to each state component at the end of the block.
+     */
+    alignas(16) std::array<std::array<float,OversampleFactor>,2> mDownInput{};
+    std::array<float,4> mDownState{};
+    float mDownB0{1.0f};
+    float mDownZ1{0.0f}, mDownZ2{0.0f};
+
+public:
+    void clear() noexcept { mUpZ1 = mUpZ2 = mDownZ1 = mDownZ2 = 0.0f; }
+
+    /**
+     * Sets the interpolation and decimation filters from the given biquads,
+     * which should be set for the oversampled rate. Only the coefficients are
+     * copied, the current filter state is kept.
+     */
+    void setFilters(const BiquadFilter &upfilter, const BiquadFilter &downfilter);
+
+    /**
+     * Upsamples the input, filtering the zero-stuffed signal. The output must
+     * be OversampleFactor times the input size. The input is scaled by
+     * OversampleFactor to maintain the signal's power.
+     */
+    void upsample(const al::span<const float> src, const al::span<float> dst);
+
+    /**
+     * Filters and decimates the oversampled input, keeping the first of every
+     * OversampleFactor filtered samples. The input must be OversampleFactor
+     * times the output size.
+     */
+    void downsample(const al::span<const float> src, const al::span<float> dst);
+};
+
+#endif /* CORE_FILTERS_OVERSAMPLER_H */
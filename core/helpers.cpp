@@ -68,6 +68,16 @@ void DirectorySearch(const std::filesystem::path &path, const std::string_view e
 
 } // namespace
 
+std::vector<std::string> SearchDataFiles(const std::string_view ext, const std::string_view subdir)
+{
+    std::lock_guard<std::mutex> srchlock{gSearchLock};
+
+    std::vector<std::string> results;
+    for(const auto &path : GetDataSearchDirs(subdir))
+        DirectorySearch(path, ext, &results);
+    return results;
+}
+
 #ifdef _WIN32
 
 #include <cctype>
@@ -137,24 +147,22 @@ struct CoTaskMemDeleter {
 
 } // namespace
 
-std::vector<std::string> SearchDataFiles(const std::string_view ext, const std::string_view subdir)
+auto GetDataSearchDirs(const std::string_view subdir) -> std::vector<std::filesystem::path>
 {
-    std::lock_guard<std::mutex> srchlock{gSearchLock};
-
     /* If the path is absolute, use it directly. */
-    std::vector<std::string> results;
+    std::vector<std::filesystem::path> dirs;
     auto path = std::filesystem::u8path(subdir);
     if(path.is_absolute())
     {
-        DirectorySearch(path, ext, &results);
-        return results;
+        dirs.emplace_back(std::move(path));
+        return dirs;
     }
 
     /* Search the app-local directory. */
     if(auto localpath = al::getenv(L"ALSOFT_LOCAL_PATH"))
-        DirectorySearch(*localpath, ext, &results);
+        dirs.emplace_back(*localpath);
     else if(auto curpath = std::filesystem::current_path(); !curpath.empty())
-        DirectorySearch(curpath, ext, &results);
+        dirs.emplace_back(std::move(curpath));
 
 #if !defined(ALSOFT_UWP) && !defined(_GAMING_XBOX)
     /* Search the local and global data dirs. */
@@ -166,11 +174,11 @@ std::vector<std::string> SearchDataFiles(const std::string_view ext, const std::
         if(FAILED(hr) || !buffer || !*buffer)
             continue;
 
-        DirectorySearch(std::filesystem::path{buffer.get()}/path, ext, &results);
+        dirs.emplace_back(std::filesystem::path{buffer.get()}/path);
     }
 #endif
 
-    return results;
+    return dirs;
 }
 
 void SetRTPriority()
@@ -295,29 +303,27 @@ const PathNamePair &GetProcBinary()
     return procbin;
 }
 
-std::vector<std::string> SearchDataFiles(const std::string_view ext, const std::string_view subdir)
+auto GetDataSearchDirs(const std::string_view subdir) -> std::vector<std::filesystem::path>
 {
-    std::lock_guard<std::mutex> srchlock{gSearchLock};
-
-    std::vector<std::string> results;
+    std::vector<std::filesystem::path> dirs;
     auto path = std::filesystem::u8path(subdir);
     if(path.is_absolute())
     {
-        DirectorySearch(path, ext, &results);
-        return results;
+        dirs.emplace_back(std::move(path));
+        return dirs;
     }
 
     /* Search the app-local directory. */
     if(auto localpath = al::getenv("ALSOFT_LOCAL_PATH"))
-        DirectorySearch(*localpath, ext, &results);
+        dirs.emplace_back(*localpath);
     else if(auto curpath = std::filesystem::current_path(); !curpath.empty())
-        DirectorySearch(curpath, ext, &results);
+        dirs.emplace_back(std::move(curpath));
 
     /* Search local data dir */
     if(auto datapath = al::getenv("XDG_DATA_HOME"))
-        DirectorySearch(std::filesystem::path{*datapath}/path, ext, &results);
+        dirs.emplace_back(std::filesystem::path{*datapath}/path);
     else if(auto homepath = al::getenv("HOME"))
-        DirectorySearch(std::filesystem::path{*homepath}/".local/share"/path, ext, &results);
+        dirs.emplace_back(std::filesystem::path{*homepath}/".local/share"/path);
 
     /* Search global data dirs */
     std::string datadirs{al::getenv("XDG_DATA_DIRS").value_or("/usr/local/share/:/usr/share/")};
@@ -333,16 +339,16 @@ std::vector<std::string> SearchDataFiles(const std::string_view ext, const std::
         curpos = nextpos;
 
         if(!pathname.empty())
-            DirectorySearch(std::filesystem::path{pathname}/path, ext, &results);
+            dirs.emplace_back(std::filesystem::path{pathname}/path);
     }
 
 #ifdef ALSOFT_INSTALL_DATADIR
     /* Search the installation data directory */
     if(auto instpath = std::filesystem::path{ALSOFT_INSTALL_DATADIR}; !instpath.empty())
-        DirectorySearch(instpath/path, ext, &results);
+        dirs.emplace_back(instpath/path);
 #endif
 
-    return results;
+    return dirs;
 }
 
 namespace {
@@ -1,6 +1,7 @@
 #ifndef CORE_HELPERS_H
 #define CORE_HELPERS_H
 
+#include <filesystem>
 #include <string>
 #include <string_view>
 #include <vector>
@@ -19,6 +20,10 @@ inline bool AllowRTTimeLimit{true};
 
 void SetRTPriority();
 
+/* Gets the directories searched for data files in the given subdirectory, in
+ * search order. An absolute subdirectory is used as-is.
+ */
+auto GetDataSearchDirs(const std::string_view subdir) -> std::vector<std::filesystem::path>;
 std::vector<std::string> SearchDataFiles(const std::string_view ext, const std::string_view subdir);
 
 #endif /* CORE_HELPERS_H */
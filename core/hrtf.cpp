@@ -19,6 +19,7 @@
 #include <mutex>
 #include <numeric>
 #include <optional>
+#include <system_error>
 #include <tuple>
 #include <type_traits>
 #include <utility>
@@ -118,6 +119,19 @@ std::vector<LoadedHrtf> LoadedHrtfs;
 
 std::mutex EnumeratedHrtfLock;
 std::vector<HrtfEntry> EnumeratedHrtfs;
+/* The directories the current list of HRTFs was enumerated from, with their
+ * modification times. Scanning the data directories is relatively slow, so
+ * enumerating again reuses the existing list as long as the same directories
+ * would be searched and none have had files added or removed since.
+ */
+struct HrtfSearchDir {
+    std::filesystem::path mPath;
+    std::filesystem::file_time_type mModTime;
+
+    bool operator==(const HrtfSearchDir &rhs) const
+    { return mModTime == rhs.mModTime && mPath == rhs.mPath; }
+};
+std::optional<std::vector<HrtfSearchDir>> EnumeratedHrtfDirs;
 
 
 /* NOLINTBEGIN(cppcoreguidelines-pro-bounds-pointer-arithmetic)
@@ -1180,6 +1194,16 @@ void AddBuiltInEntry(const std::string_view dispname, uint residx)
 }
 
 
+auto GetEnumeratedNames() -> std::vector<std::string>
+{
+    std::vector<std::string> list;
+    list.reserve(EnumeratedHrtfs.size());
+    for(auto &entry : EnumeratedHrtfs)
+        list.emplace_back(entry.mDispName);
+    return list;
+}
+
+
 #define IDR_DEFAULT_HRTF_MHR 1
 
 #ifndef ALSOFT_EMBED_HRTF_DATA
@@ -1207,9 +1231,7 @@ al::span<const char> GetResource(int name)
 
 std::vector<std::string> EnumerateHrtf(std::optional<std::string> pathopt)
 {
-    std::lock_guard<std::mutex> enumlock{EnumeratedHrtfLock};
-    EnumeratedHrtfs.clear();
-
+    std::vector<std::string_view> subdirs;
     bool usedefaults{true};
     if(pathopt)
     {
@@ -1234,28 +1256,49 @@ std::vector<std::string> EnumerateHrtf(std::optional<std::string> pathopt)
             while(!entry.empty() && std::isspace(entry.back()))
                 entry.remove_suffix(1);
             if(!entry.empty())
-            {
-                for(const auto &fname : SearchDataFiles(".mhr"sv, entry))
-                    AddFileEntry(fname);
-            }
+                subdirs.emplace_back(entry);
         }
     }
-
     if(usedefaults)
+        subdirs.emplace_back("openal/hrtf"sv);
+
+    /* Directories that don't exist get the minimum time, so creating them is
+     * also noticed.
+     */
+    std::vector<HrtfSearchDir> searchdirs;
+    for(const auto subdir : subdirs)
+    {
+        for(auto &path : GetDataSearchDirs(subdir))
+        {
+            auto ec = std::error_code{};
+            auto modtime = std::filesystem::last_write_time(path, ec);
+            searchdirs.emplace_back(HrtfSearchDir{std::move(path), modtime});
+        }
+    }
+
+    std::lock_guard<std::mutex> enumlock{EnumeratedHrtfLock};
+    if(EnumeratedHrtfDirs && *EnumeratedHrtfDirs == searchdirs)
     {
-        for(const auto &fname : SearchDataFiles(".mhr"sv, "openal/hrtf"sv))
+        TRACE("Reusing %zu enumerated HRTF%s\n", EnumeratedHrtfs.size(),
+            (EnumeratedHrtfs.size()==1) ? "" : "s");
+        return GetEnumeratedNames();
+    }
+    EnumeratedHrtfs.clear();
+    EnumeratedHrtfDirs = std::move(searchdirs);
+
+    for(const auto subdir : subdirs)
+    {
+        for(const auto &fname : SearchDataFiles(".mhr"sv, subdir))
             AddFileEntry(fname);
+    }
 
+    if(usedefaults)
+    {
         if(!GetResource(IDR_DEFAULT_HRTF_MHR).empty())
             AddBuiltInEntry("Built-In HRTF", IDR_DEFAULT_HRTF_MHR);
     }
 
-    std::vector<std::string> list;
-    list.reserve(EnumeratedHrtfs.size());
-    for(auto &entry : EnumeratedHrtfs)
-        list.emplace_back(entry.mDispName);
-
-    return list;
+    return GetEnumeratedNames();
 }
 
 HrtfStorePtr GetLoadedHrtf(const std::string_view name, const uint devrate)
@@ -1361,24 +1404,38 @@ try {
         ) - 1};
         const size_t irCount{size_t{hrtf->mElev[lastEv].irOffset} + hrtf->mElev[lastEv].azCount};
 
-        /* Resample all the IRs. */
-        std::array<std::array<double,HrirLength>,2> inout{};
+        /* Resample all the IRs together, with each IR's left and right
+         * channels separated into their own lines.
+         */
+        auto irlines = std::vector<float>(irCount*2*HrirLength);
+        for(size_t i{0};i < irCount;++i)
+        {
+            const auto coeffs = al::span{hrtf->mCoeffs[i]};
+            for(size_t j{0};j < 2;++j)
+            {
+                const auto line = al::span{irlines}.subspan((i*2 + j)*HrirLength, HrirLength);
+                std::transform(coeffs.cbegin(), coeffs.cend(), line.begin(),
+                    [j](const float2 &in) noexcept -> float { return in[j]; });
+            }
+        }
+
+        auto reslines = std::vector<float>(irlines.size());
         PPhaseResampler rs;
         rs.init(hrtf->mSampleRate, devrate);
+        rs.processBatch(irlines, HrirLength, HrirLength, reslines, HrirLength, HrirLength);
+        rs = {};
+
         for(size_t i{0};i < irCount;++i)
         {
             /* NOLINTNEXTLINE(*-const-cast) */
             auto coeffs = al::span{const_cast<HrirArray&>(hrtf->mCoeffs[i])};
             for(size_t j{0};j < 2;++j)
             {
-                std::transform(coeffs.cbegin(), coeffs.cend(), inout[0].begin(),
-                    [j](const float2 &in) noexcept -> double { return in[j]; });
-                rs.process(inout[0], inout[1]);
+                const auto line = al::span{reslines}.subspan((i*2 + j)*HrirLength, HrirLength);
                 for(size_t k{0};k < HrirLength;++k)
-                    coeffs[k][j] = static_cast<float>(inout[1][k]);
+                    coeffs[k][j] = line[k];
             }
         }
-        rs = {};
 
         /* Scale the delays for the new sample rate. */
         float max_delay{0.0f};
@@ -5,6 +5,7 @@
 
 #include <array>
 #include <cctype>
+#include <chrono>
 #include <cstdarg>
 #include <cstdio>
 #include <cstring>
@@ -15,6 +16,7 @@
 
 #include "alspan.h"
 #include "opthelpers.h"
+#include "rtcheck.h"
 #include "strutils.h"
 
 
@@ -154,6 +156,7 @@ try {
     __android_log_print(android_severity(level), "openal", "%s", str);
 #endif
 
+    RealtimeCheckBlocking("log callback lock");
     auto cblock = std::lock_guard{LogCallbackMutex};
     if(gLogState != LogState::Disable)
     {
@@ -174,3 +177,10 @@ try {
 catch(...) {
     /* Swallow any exceptions */
 }
+
+PhaseTimer::~PhaseTimer()
+{
+    const auto duration = std::chrono::steady_clock::now() - mStart;
+    const auto usec = std::chrono::duration_cast<std::chrono::microseconds>(duration).count();
+    TRACE("%s took %.3fms\n", mName, static_cast<double>(usec) / 1000.0);
+}
@@ -1,6 +1,7 @@
 #ifndef CORE_LOGGING_H
 #define CORE_LOGGING_H
 
+#include <chrono>
 #include <cstdio>
 
 
@@ -33,4 +34,23 @@ void al_print(LogLevel level, const char *fmt, ...) noexcept;
 
 #define ERR(...) al_print(LogLevel::Error, __VA_ARGS__)
 
+
+/* Measures how long a phase of initialization takes, from construction until
+ * it goes out of scope, and traces the result. Setting ALSOFT_LOGLEVEL=3 shows
+ * where the time goes when opening a device.
+ */
+class PhaseTimer {
+    const char *mName;
+    std::chrono::steady_clock::time_point mStart;
+
+public:
+    explicit PhaseTimer(const char *name) noexcept
+        : mName{name}, mStart{std::chrono::steady_clock::now()}
+    { }
+    PhaseTimer(const PhaseTimer&) = delete;
+    ~PhaseTimer();
+
+    PhaseTimer& operator=(const PhaseTimer&) = delete;
+};
+
 #endif /* CORE_LOGGING_H */
@@ -11,6 +11,12 @@
 #include <limits>
 #include <new>
 
+#ifdef HAVE_SSE_INTRINSICS
+#include <xmmintrin.h>
+#elif defined(HAVE_NEON)
+#include <arm_neon.h>
+#endif
+
 #include "alnumeric.h"
 #include "alspan.h"
 #include "opthelpers.h"
@@ -83,6 +89,50 @@ float UpdateSlidingHold(SlidingHold *Hold, const uint i, const float in)
     return values[upperIndex];
 }
 
+/* Block version of the sliding hold, which updates the hold in-place for a
+ * whole block of input. It maintains the same descending maxima queue (and
+ * gives the same results) as UpdateSlidingHold, but keeps the queue indices in
+ * registers for the block and walks the queue back from the newest entry
+ * without needing to restart at the wrap-around point.
+ */
+void UpdateSlidingHoldBlock(SlidingHold *Hold, const al::span<float> inout)
+{
+    static constexpr uint mask{BufferLineSize - 1};
+    const uint length{Hold->mLength};
+    const al::span values{Hold->mValues};
+    const al::span expiries{Hold->mExpiries};
+    uint lowerIndex{Hold->mLowerIndex};
+    uint upperIndex{Hold->mUpperIndex};
+
+    uint i{0};
+    for(float &sample : inout)
+    {
+        const float in{sample};
+        if(i >= expiries[upperIndex])
+            upperIndex = (upperIndex + 1) & mask;
+
+        if(in >= values[upperIndex])
+            lowerIndex = upperIndex;
+        else
+        {
+            /* The oldest (upper) entry is known to be greater than the input,
+             * so this will stop before passing it.
+             */
+            while(in >= values[lowerIndex])
+                lowerIndex = (lowerIndex - 1) & mask;
+            lowerIndex = (lowerIndex + 1) & mask;
+        }
+        values[lowerIndex] = in;
+        expiries[lowerIndex] = i + length;
+
+        sample = values[upperIndex];
+        ++i;
+    }
+
+    Hold->mLowerIndex = lowerIndex;
+    Hold->mUpperIndex = upperIndex;
+}
+
 void ShiftSlidingHold(SlidingHold *Hold, const uint n)
 {
     auto exp_upper = Hold->mExpiries.begin() + Hold->mUpperIndex;
@@ -97,6 +147,28 @@ void ShiftSlidingHold(SlidingHold *Hold, const uint n)
         [n](const uint e) noexcept { return e - n; });
 }
 
+
+/* Multiplies the samples by the given gains, four at a time where possible. */
+void ApplyGains(const al::span<const float> gains, const al::span<float> inout)
+{
+    size_t base{0};
+#ifdef HAVE_SSE_INTRINSICS
+    for(;base < (inout.size()&~3_uz);base += 4)
+    {
+        const __m128 g4{_mm_load_ps(&gains[base])};
+        _mm_store_ps(&inout[base], _mm_mul_ps(_mm_load_ps(&inout[base]), g4));
+    }
+#elif defined(HAVE_NEON)
+    for(;base < (inout.size()&~3_uz);base += 4)
+    {
+        const float32x4_t g4{vld1q_f32(&gains[base])};
+        vst1q_f32(&inout[base], vmulq_f32(vld1q_f32(&inout[base]), g4));
+    }
+#endif
+    for(;base < inout.size();++base)
+        inout[base] *= gains[base];
+}
+
 } // namespace
 
 /* Multichannel compression is linked via the absolute maximum of all
@@ -123,6 +195,46 @@ void Compressor::linkChannels(const uint SamplesToDo,
         fill_max(input);
 }
 
+/* Same as linkChannels, but works across all channels four samples at a time,
+ * keeping the running maximum in a register instead of reading and writing
+ * the side-chain for each channel.
+ */
+void Compressor::linkChannelsBlock(const uint SamplesToDo,
+    const al::span<const FloatBufferLine> OutBuffer)
+{
+    ASSUME(SamplesToDo > 0);
+    ASSUME(SamplesToDo <= BufferLineSize);
+
+    const auto sideChain = al::span{mSideChain}.subspan(mLookAhead, SamplesToDo);
+
+    size_t base{0};
+#ifdef HAVE_SSE_INTRINSICS
+    const __m128 signmask{_mm_set1_ps(-0.0f)};
+    for(;base < (SamplesToDo&~3u);base += 4)
+    {
+        __m128 maxabs{_mm_setzero_ps()};
+        for(const FloatBufferLine &input : OutBuffer)
+            maxabs = _mm_max_ps(_mm_andnot_ps(signmask, _mm_load_ps(&input[base])), maxabs);
+        _mm_storeu_ps(&sideChain[base], maxabs);
+    }
+#elif defined(HAVE_NEON)
+    for(;base < (SamplesToDo&~3u);base += 4)
+    {
+        float32x4_t maxabs{vdupq_n_f32(0.0f)};
+        for(const FloatBufferLine &input : OutBuffer)
+            maxabs = vmaxq_f32(maxabs, vabsq_f32(vld1q_f32(&input[base])));
+        vst1q_f32(&sideChain[base], maxabs);
+    }
+#endif
+    for(;base < SamplesToDo;++base)
+    {
+        float maxabs{0.0f};
+        for(const FloatBufferLine &input : OutBuffer)
+            maxabs = std::max(maxabs, std::fabs(input[base]));
+        sideChain[base] = maxabs;
+    }
+}
+
 /* This calculates the squared crest factor of the control signal for the
  * basic automation of the attack/release times.  As suggested by the paper,
  * it uses an instantaneous squared peak detector and a squared RMS detector
@@ -189,6 +301,22 @@ void Compressor::peakHoldDetector(const uint SamplesToDo)
     ShiftSlidingHold(hold, SamplesToDo);
 }
 
+/* Same as peakHoldDetector, but converts the whole block to the log domain
+ * before running the sliding hold over it.
+ */
+void Compressor::peakHoldDetectorBlock(const uint SamplesToDo)
+{
+    ASSUME(SamplesToDo > 0);
+    ASSUME(SamplesToDo <= BufferLineSize);
+
+    const auto sideChain = al::span{mSideChain}.subspan(mLookAhead, SamplesToDo);
+    std::transform(sideChain.cbegin(), sideChain.cend(), sideChain.begin(),
+        [](const float x_abs) { return std::log(std::max(0.000001f, x_abs)); });
+
+    UpdateSlidingHoldBlock(mHold.get(), sideChain);
+    ShiftSlidingHold(mHold.get(), SamplesToDo);
+}
+
 /* This is the heart of the feed-forward compressor.  It operates in the log
  * domain (to better match human hearing) and can apply some basic automation
  * to knee width, attack/release times, make-up/post gain, and clipping
@@ -321,12 +449,65 @@ void Compressor::signalDelay(const uint SamplesToDo, const al::span<FloatBufferL
     }
 }
 
+/* Applies the look-ahead delay and the compressor gains together, so each
+ * channel is only passed over once. The delayed input is written walking
+ * backward, so it never reads samples that were already written. Requires
+ * SamplesToDo to be no less than the look-ahead.
+ */
+void Compressor::signalDelayApplyBlock(const uint SamplesToDo,
+    const al::span<FloatBufferLine> OutBuffer)
+{
+    const auto lookAhead = size_t{mLookAhead};
+
+    ASSUME(SamplesToDo > 0);
+    ASSUME(SamplesToDo <= BufferLineSize);
+    ASSUME(lookAhead > 0);
+    ASSUME(lookAhead <= SamplesToDo);
+
+    const auto gains = assume_aligned_span<16>(al::span{mSideChain}.first(SamplesToDo));
+    alignas(16) std::array<float,BufferLineSize> tailbuf;
+
+    auto delays = mDelay.begin();
+    for(auto &buffer : OutBuffer)
+    {
+        const auto inout = assume_aligned_span<16>(al::span{buffer}.first(SamplesToDo));
+        const auto delaybuf = al::span{*(delays++)}.first(lookAhead);
+        const auto tail = al::span{tailbuf}.first(lookAhead);
+
+        std::copy(inout.end()-ptrdiff_t(lookAhead), inout.end(), tail.begin());
+
+        size_t i{SamplesToDo};
+        const size_t todo{(SamplesToDo-lookAhead) & 3};
+        for(;i > SamplesToDo-todo;--i)
+            inout[i-1] = inout[i-1-lookAhead] * gains[i-1];
+#ifdef HAVE_SSE_INTRINSICS
+        for(;i >= lookAhead+4;i -= 4)
+        {
+            const __m128 s4{_mm_loadu_ps(&inout[i-4-lookAhead])};
+            _mm_storeu_ps(&inout[i-4], _mm_mul_ps(s4, _mm_loadu_ps(&gains[i-4])));
+        }
+#elif defined(HAVE_NEON)
+        for(;i >= lookAhead+4;i -= 4)
+        {
+            const float32x4_t s4{vld1q_f32(&inout[i-4-lookAhead])};
+            vst1q_f32(&inout[i-4], vmulq_f32(s4, vld1q_f32(&gains[i-4])));
+        }
+#endif
+        for(;i > lookAhead;--i)
+            inout[i-1] = inout[i-1-lookAhead] * gains[i-1];
+
+        std::transform(delaybuf.begin(), delaybuf.end(), gains.begin(), inout.begin(),
+            std::multiplies{});
+        std::copy(tail.begin(), tail.end(), delaybuf.begin());
+    }
+}
+
 
 std::unique_ptr<Compressor> Compressor::Create(const size_t NumChans, const float SampleRate,
     const bool AutoKnee, const bool AutoAttack, const bool AutoRelease, const bool AutoPostGain,
     const bool AutoDeclip, const float LookAheadTime, const float HoldTime, const float PreGainDb,
     const float PostGainDb, const float ThresholdDb, const float Ratio, const float KneeDb,
-    const float AttackTime, const float ReleaseTime)
+    const float AttackTime, const float ReleaseTime, const bool BlockProcess)
 {
     const auto lookAhead = static_cast<uint>(std::clamp(std::round(LookAheadTime*SampleRate), 0.0f,
         BufferLineSize-1.0f));
@@ -339,6 +520,7 @@ std::unique_ptr<Compressor> Compressor::Create(const size_t NumChans, const floa
     Comp->mAuto.Release = AutoRelease;
     Comp->mAuto.PostGain = AutoPostGain;
     Comp->mAuto.Declip = AutoPostGain && AutoDeclip;
+    Comp->mBlockProcess = BlockProcess;
     Comp->mLookAhead = lookAhead;
     Comp->mPreGain = std::pow(10.0f, PreGainDb / 20.0f);
     Comp->mPostGain = std::log(10.0f)/20.0f * PostGainDb;
@@ -398,30 +580,48 @@ void Compressor::process(const uint SamplesToDo, const al::span<FloatBufferLine>
         std::for_each(InOut.begin(), InOut.end(), apply_gain);
     }
 
-    linkChannels(SamplesToDo, InOut);
+    if(mBlockProcess)
+        linkChannelsBlock(SamplesToDo, InOut);
+    else
+        linkChannels(SamplesToDo, InOut);
 
     if(mAuto.Attack || mAuto.Release)
         crestDetector(SamplesToDo);
 
-    if(mHold)
-        peakHoldDetector(SamplesToDo);
-    else
+    if(!mHold)
         peakDetector(SamplesToDo);
+    else if(mBlockProcess)
+        peakHoldDetectorBlock(SamplesToDo);
+    else
+        peakHoldDetector(SamplesToDo);
 
     gainCompressor(SamplesToDo);
 
-    if(!mDelay.empty())
-        signalDelay(SamplesToDo, InOut);
-
     const auto gains = assume_aligned_span<16>(al::span{mSideChain}.first(SamplesToDo));
-    auto apply_comp = [gains](const FloatBufferSpan inout) noexcept -> void
+    if(mBlockProcess && SamplesToDo >= mLookAhead)
     {
-        const auto buffer = assume_aligned_span<16>(inout);
-        std::transform(gains.cbegin(), gains.cend(), buffer.cbegin(), buffer.begin(),
-            std::multiplies{});
-    };
-    for(const FloatBufferSpan inout : InOut)
-        apply_comp(inout);
+        if(!mDelay.empty())
+            signalDelayApplyBlock(SamplesToDo, InOut);
+        else
+        {
+            for(const FloatBufferSpan inout : InOut)
+                ApplyGains(gains, assume_aligned_span<16>(inout.first(SamplesToDo)));
+        }
+    }
+    else
+    {
+        if(!mDelay.empty())
+            signalDelay(SamplesToDo, InOut);
+
+        auto apply_comp = [gains](const FloatBufferSpan inout) noexcept -> void
+        {
+            const auto buffer = assume_aligned_span<16>(inout);
+            std::transform(gains.cbegin(), gains.cend(), buffer.cbegin(), buffer.begin(),
+                std::multiplies{});
+        };
+        for(const FloatBufferSpan inout : InOut)
+            apply_comp(inout);
+    }
 
     const auto delayedGains = al::span{mSideChain}.subspan(SamplesToDo, mLookAhead);
     std::copy(delayedGains.begin(), delayedGains.end(), mSideChain.begin());
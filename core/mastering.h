@@ -34,6 +34,7 @@ class SIMDALIGN Compressor {
         bool Declip : 1;
     };
     AutoFlags mAuto{};
+    bool mBlockProcess{false};
 
     uint mLookAhead{0};
 
@@ -66,11 +67,15 @@ class SIMDALIGN Compressor {
     Compressor() = default;
 
     void linkChannels(const uint SamplesToDo, const al::span<const FloatBufferLine> OutBuffer);
+    void linkChannelsBlock(const uint SamplesToDo,
+        const al::span<const FloatBufferLine> OutBuffer);
     void crestDetector(const uint SamplesToDo);
     void peakDetector(const uint SamplesToDo);
     void peakHoldDetector(const uint SamplesToDo);
+    void peakHoldDetectorBlock(const uint SamplesToDo);
     void gainCompressor(const uint SamplesToDo);
     void signalDelay(const uint SamplesToDo, const al::span<FloatBufferLine> OutBuffer);
+    void signalDelayApplyBlock(const uint SamplesToDo, const al::span<FloatBufferLine> OutBuffer);
 
 public:
     ~Compressor();
@@ -102,13 +107,17 @@ public:
      *        automating attack time.
      * \param ReleaseTime   Release time (in seconds). Acts as a maximum when
      *        automating release time.
+     * \param BlockProcess  Whether to use the block-based (vectorized) channel
+     *        linking, peak hold, and gain application instead of the
+     *        sample-by-sample reference implementation. The output is the
+     *        same either way.
      */
     static std::unique_ptr<Compressor> Create(const size_t NumChans, const float SampleRate,
         const bool AutoKnee, const bool AutoAttack, const bool AutoRelease,
         const bool AutoPostGain, const bool AutoDeclip, const float LookAheadTime,
         const float HoldTime, const float PreGainDb, const float PostGainDb,
         const float ThresholdDb, const float Ratio, const float KneeDb, const float AttackTime,
-        const float ReleaseTime);
+        const float ReleaseTime, const bool BlockProcess=false);
 };
 using CompressorPtr = std::unique_ptr<Compressor>;
 
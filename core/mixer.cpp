@@ -16,6 +16,7 @@ struct CTag;
 
 
 MixerOutFunc MixSamplesOut{Mix_<CTag>};
+MixerChansFunc MixSamplesChans{Mix_<CTag>};
 MixerOneFunc MixSamplesOne{Mix_<CTag>};
 
 
@@ -4,6 +4,7 @@
 #include <array>
 #include <cmath>
 #include <cstddef>
+#include <cstdint>
 
 #include "alspan.h"
 #include "ambidefs.h"
@@ -22,6 +23,21 @@ inline void MixSamples(const al::span<const float> InSamples,
     const al::span<const float> TargetGains, const std::size_t Counter, const std::size_t OutPos)
 { MixSamplesOut(InSamples, OutBuffer, CurrentGains, TargetGains, Counter, OutPos); }
 
+/* Mixer functions that handle one input and a select list of output channels,
+ * skipping the others.
+ */
+using MixerChansFunc = void(*)(const al::span<const float> InSamples,
+    const al::span<FloatBufferLine> OutBuffer, const al::span<const std::uint8_t> OutChans,
+    const al::span<float> CurrentGains, const al::span<const float> TargetGains,
+    const std::size_t Counter, const std::size_t OutPos);
+
+extern MixerChansFunc MixSamplesChans;
+inline void MixSamples(const al::span<const float> InSamples,
+    const al::span<FloatBufferLine> OutBuffer, const al::span<const std::uint8_t> OutChans,
+    const al::span<float> CurrentGains, const al::span<const float> TargetGains,
+    const std::size_t Counter, const std::size_t OutPos)
+{ MixSamplesChans(InSamples, OutBuffer, OutChans, CurrentGains, TargetGains, Counter, OutPos); }
+
 /* Mixer functions that handle one input and one output channel. */
 using MixerOneFunc = void(*)(const al::span<const float> InSamples,const al::span<float> OutBuffer,
     float &CurrentGain, const float TargetGain, const std::size_t Counter);
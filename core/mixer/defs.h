@@ -82,6 +82,10 @@ void Mix_(const al::span<const float> InSamples, const al::span<FloatBufferLine>
 template<typename InstTag>
 void Mix_(const al::span<const float> InSamples, const al::span<float> OutBuffer,
     float &CurrentGain, const float TargetGain, const size_t Counter);
+template<typename InstTag>
+void Mix_(const al::span<const float> InSamples, const al::span<FloatBufferLine> OutBuffer,
+    const al::span<const std::uint8_t> OutChans, const al::span<float> CurrentGains,
+    const al::span<const float> TargetGains, const size_t Counter, const size_t OutPos);
 
 template<typename InstTag>
 void MixHrtf_(const al::span<const float> InSamples, const al::span<float2> AccumSamples,
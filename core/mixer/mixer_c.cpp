@@ -3,6 +3,7 @@
 #include <algorithm>
 #include <array>
 #include <cstddef>
+#include <cstdint>
 #include <limits>
 #include <variant>
 
@@ -269,6 +270,19 @@ void Mix_<CTag>(const al::span<const float> InSamples, const al::span<FloatBuffe
             fade_len, Counter);
 }
 
+template<>
+void Mix_<CTag>(const al::span<const float> InSamples, const al::span<FloatBufferLine> OutBuffer,
+    const al::span<const std::uint8_t> OutChans, const al::span<float> CurrentGains,
+    const al::span<const float> TargetGains, const size_t Counter, const size_t OutPos)
+{
+    const float delta{(Counter > 0) ? 1.0f / static_cast<float>(Counter) : 0.0f};
+    const auto fade_len = std::min(Counter, InSamples.size());
+
+    for(const size_t chan : OutChans)
+        MixLine(InSamples, al::span{OutBuffer[chan]}.subspan(OutPos), CurrentGains[chan],
+            TargetGains[chan], delta, fade_len, Counter);
+}
+
 template<>
 void Mix_<CTag>(const al::span<const float> InSamples, const al::span<float> OutBuffer,
     float &CurrentGain, const float TargetGain, const size_t Counter)
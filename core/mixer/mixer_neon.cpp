@@ -5,6 +5,7 @@
 #include <algorithm>
 #include <array>
 #include <cstddef>
+#include <cstdint>
 #include <limits>
 #include <variant>
 
@@ -188,6 +189,31 @@ force_inline void MixLine(const al::span<const float> InSamples, const al::span<
     }
 }
 
+/* Mixes to N output lines with constant gains, reusing each loaded input
+ * vector for all of them.
+ */
+template<size_t N>
+force_inline void MixLinesConst(const al::span<const float> InSamples,
+    const al::span<float*,N> dsts, const al::span<float,N> gains)
+{
+    auto gain4 = std::array<float32x4_t,N>{};
+    std::transform(gains.begin(), gains.end(), gain4.begin(),
+        [](const float gain) { return vdupq_n_f32(gain); });
+
+    const size_t todo{InSamples.size() & ~3_uz};
+    for(size_t pos{0};pos < todo;pos += 4)
+    {
+        const auto val4 = vld1q_f32(&InSamples[pos]);
+        for(size_t i{0};i < N;++i)
+            vst1q_f32(dsts[i]+pos, vmlaq_f32(vld1q_f32(dsts[i]+pos), val4, gain4[i]));
+    }
+    for(size_t pos{todo};pos < InSamples.size();++pos)
+    {
+        for(size_t i{0};i < N;++i)
+            dsts[i][pos] = dsts[i][pos] + InSamples[pos]*gains[i];
+    }
+}
+
 } // namespace
 
 template<>
@@ -479,6 +505,56 @@ void Mix_<NEONTag>(const al::span<const float> InSamples,const al::span<FloatBuf
             fade_len, realign_len, Counter);
 }
 
+template<>
+void Mix_<NEONTag>(const al::span<const float> InSamples,const al::span<FloatBufferLine> OutBuffer,
+    const al::span<const std::uint8_t> OutChans, const al::span<float> CurrentGains,
+    const al::span<const float> TargetGains, const size_t Counter, const size_t OutPos)
+{
+    if((OutPos&3) != 0) UNLIKELY
+        return Mix_<CTag>(InSamples, OutBuffer, OutChans, CurrentGains, TargetGains, Counter,
+            OutPos);
+
+    const float delta{(Counter > 0) ? 1.0f / static_cast<float>(Counter) : 0.0f};
+    const auto fade_len = std::min(Counter, InSamples.size());
+    const auto realign_len = std::min((fade_len+3_uz) & ~3_uz, InSamples.size()) - fade_len;
+
+    /* Lines that are fading get mixed individually. Lines with a constant
+     * gain get gathered up and mixed four at a time.
+     */
+    auto lines = std::array<float*,4>{};
+    auto gains = std::array<float,4>{};
+    size_t count{0};
+    for(const size_t chan : OutChans)
+    {
+        const auto dst = al::span{OutBuffer[chan]}.subspan(OutPos);
+        float &CurrentGain = CurrentGains[chan];
+        const float TargetGain{TargetGains[chan]};
+        if(std::abs((TargetGain-CurrentGain) * delta) > std::numeric_limits<float>::epsilon())
+        {
+            MixLine(InSamples, dst, CurrentGain, TargetGain, delta, fade_len, realign_len,
+                Counter);
+            continue;
+        }
+
+        CurrentGain = TargetGain;
+        if(!(std::abs(TargetGain) > GainSilenceThreshold))
+            continue;
+
+        lines[count] = dst.data();
+        gains[count] = TargetGain;
+        if(++count == lines.size())
+        {
+            MixLinesConst(InSamples, al::span{lines}.first<4>(), al::span{gains}.first<4>());
+            count = 0;
+        }
+    }
+    if((count&2))
+        MixLinesConst(InSamples, al::span{lines}.first<2>(), al::span{gains}.first<2>());
+    if((count&1))
+        MixLinesConst(InSamples, al::span{lines}.subspan(count-1).first<1>(),
+            al::span{gains}.subspan(count-1).first<1>());
+}
+
 template<>
 void Mix_<NEONTag>(const al::span<const float> InSamples, const al::span<float> OutBuffer,
     float &CurrentGain, const float TargetGain, const size_t Counter)
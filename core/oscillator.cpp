@@ -0,0 +1,203 @@
+
+#include "config.h"
+
+#include "oscillator.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+
+#ifdef HAVE_SSE_INTRINSICS
+#include <xmmintrin.h>
+#elif defined(HAVE_NEON)
+#include <arm_neon.h>
+#endif
+
+#include "alnumbers.h"
+#include "alnumeric.h"
+#include "opthelpers.h"
+
+
+namespace {
+
+using uint = unsigned int;
+
+/* Odd polynomial coefficients for sin(2pi*y), from the Taylor series (where
+ * the coefficient for y^n is (2pi)^n / n!, with alternating signs). With y
+ * limited to [-0.25,+0.25], the error is less than 4e-7.
+ */
+constexpr float Tau{al::numbers::pi_v<float>*2.0f};
+constexpr float Sin1{Tau};
+constexpr float Sin3{-Sin1 * Tau*Tau / (2.0f*3.0f)};
+constexpr float Sin5{-Sin3 * Tau*Tau / (4.0f*5.0f)};
+constexpr float Sin7{-Sin5 * Tau*Tau / (6.0f*7.0f)};
+constexpr float Sin9{-Sin7 * Tau*Tau / (8.0f*9.0f)};
+constexpr float Sin11{-Sin9 * Tau*Tau / (10.0f*11.0f)};
+
+/* Adding and subtracting 1.5 * 2^23 rounds a (small enough) float to the
+ * nearest integer.
+ */
+constexpr float RoundMagic{12582912.0f};
+
+
+struct SinusoidGen {
+    /* Reduces the phase to [-0.5,+0.5], then folds it to [-0.25,+0.25] with
+     * sin(2pi*x) = sin(2pi*(0.5-x)) for the polynomial.
+     */
+    static auto eval(const float p) noexcept -> float
+    {
+        const float x{p - ((p+RoundMagic) - RoundMagic)};
+        const float a{std::min(std::abs(x), 0.5f - std::abs(x))};
+        const float y{std::copysign(a, x)};
+        const float y2{y*y};
+        return y * (Sin1 + y2*(Sin3 + y2*(Sin5 + y2*(Sin7 + y2*(Sin9 + y2*Sin11)))));
+    }
+#ifdef HAVE_SSE_INTRINSICS
+    static auto eval(const __m128 p) noexcept -> __m128
+    {
+        const __m128 magic{_mm_set1_ps(RoundMagic)};
+        const __m128 signbit{_mm_set1_ps(-0.0f)};
+        const __m128 x{_mm_sub_ps(p, _mm_sub_ps(_mm_add_ps(p, magic), magic))};
+        const __m128 absx{_mm_andnot_ps(signbit, x)};
+        const __m128 a{_mm_min_ps(absx, _mm_sub_ps(_mm_set1_ps(0.5f), absx))};
+        const __m128 y{_mm_or_ps(a, _mm_and_ps(signbit, x))};
+        const __m128 y2{_mm_mul_ps(y, y)};
+        __m128 r{_mm_add_ps(_mm_set1_ps(Sin9), _mm_mul_ps(y2, _mm_set1_ps(Sin11)))};
+        r = _mm_add_ps(_mm_set1_ps(Sin7), _mm_mul_ps(y2, r));
+        r = _mm_add_ps(_mm_set1_ps(Sin5), _mm_mul_ps(y2, r));
+        r = _mm_add_ps(_mm_set1_ps(Sin3), _mm_mul_ps(y2, r));
+        r = _mm_add_ps(_mm_set1_ps(Sin1), _mm_mul_ps(y2, r));
+        return _mm_mul_ps(y, r);
+    }
+#elif defined(HAVE_NEON)
+    static auto eval(const float32x4_t p) noexcept -> float32x4_t
+    {
+        const float32x4_t magic{vdupq_n_f32(RoundMagic)};
+        const float32x4_t x{vsubq_f32(p, vsubq_f32(vaddq_f32(p, magic), magic))};
+        const float32x4_t absx{vabsq_f32(x)};
+        const float32x4_t a{vminq_f32(absx, vsubq_f32(vdupq_n_f32(0.5f), absx))};
+        const float32x4_t y{vbslq_f32(vcltq_f32(x, vdupq_n_f32(0.0f)), vnegq_f32(a), a)};
+        const float32x4_t y2{vmulq_f32(y, y)};
+        float32x4_t r{vmlaq_f32(vdupq_n_f32(Sin9), y2, vdupq_n_f32(Sin11))};
+        r = vmlaq_f32(vdupq_n_f32(Sin7), y2, r);
+        r = vmlaq_f32(vdupq_n_f32(Sin5), y2, r);
+        r = vmlaq_f32(vdupq_n_f32(Sin3), y2, r);
+        r = vmlaq_f32(vdupq_n_f32(Sin1), y2, r);
+        return vmulq_f32(y, r);
+    }
+#endif
+};
+
+struct TriangleGen {
+    static auto eval(const float p) noexcept -> float
+    { return 1.0f - std::abs(2.0f - p*4.0f); }
+#ifdef HAVE_SSE_INTRINSICS
+    static auto eval(const __m128 p) noexcept -> __m128
+    {
+        const __m128 x{_mm_sub_ps(_mm_set1_ps(2.0f), _mm_mul_ps(p, _mm_set1_ps(4.0f)))};
+        return _mm_sub_ps(_mm_set1_ps(1.0f), _mm_andnot_ps(_mm_set1_ps(-0.0f), x));
+    }
+#elif defined(HAVE_NEON)
+    static auto eval(const float32x4_t p) noexcept -> float32x4_t
+    {
+        const float32x4_t x{vmlsq_f32(vdupq_n_f32(2.0f), p, vdupq_n_f32(4.0f))};
+        return vsubq_f32(vdupq_n_f32(1.0f), vabsq_f32(x));
+    }
+#endif
+};
+
+struct SawtoothGen {
+    static auto eval(const float p) noexcept -> float
+    { return p*2.0f - 1.0f; }
+#ifdef HAVE_SSE_INTRINSICS
+    static auto eval(const __m128 p) noexcept -> __m128
+    { return _mm_sub_ps(_mm_mul_ps(p, _mm_set1_ps(2.0f)), _mm_set1_ps(1.0f)); }
+#elif defined(HAVE_NEON)
+    static auto eval(const float32x4_t p) noexcept -> float32x4_t
+    { return vmlaq_f32(vdupq_n_f32(-1.0f), p, vdupq_n_f32(2.0f)); }
+#endif
+};
+
+struct SquareGen {
+    static auto eval(const float p) noexcept -> float
+    { return (p < 0.5f) ? 1.0f : -1.0f; }
+#ifdef HAVE_SSE_INTRINSICS
+    static auto eval(const __m128 p) noexcept -> __m128
+    {
+        const __m128 high{_mm_and_ps(_mm_cmplt_ps(p, _mm_set1_ps(0.5f)), _mm_set1_ps(2.0f))};
+        return _mm_sub_ps(high, _mm_set1_ps(1.0f));
+    }
+#elif defined(HAVE_NEON)
+    static auto eval(const float32x4_t p) noexcept -> float32x4_t
+    {
+        return vbslq_f32(vcltq_f32(p, vdupq_n_f32(0.5f)), vdupq_n_f32(1.0f),
+            vdupq_n_f32(-1.0f));
+    }
+#endif
+};
+
+
+/* Replaces the normalized phases in samples with the waveform, scaled and
+ * offset.
+ */
+template<typename Gen>
+void ApplyWaveform(const al::span<float> samples, const float gain, const float offset) noexcept
+{
+    size_t pos{0};
+#if defined(HAVE_SSE_INTRINSICS)
+    if(const size_t todo{samples.size() & ~3_uz})
+    {
+        const __m128 vgain{_mm_set1_ps(gain)};
+        const __m128 voffset{_mm_set1_ps(offset)};
+        for(;pos < todo;pos += 4)
+        {
+            const __m128 p{_mm_loadu_ps(&samples[pos])};
+            _mm_storeu_ps(&samples[pos], _mm_add_ps(_mm_mul_ps(Gen::eval(p), vgain), voffset));
+        }
+    }
+#elif defined(HAVE_NEON)
+    if(const size_t todo{samples.size() & ~3_uz})
+    {
+        const float32x4_t vgain{vdupq_n_f32(gain)};
+        const float32x4_t voffset{vdupq_n_f32(offset)};
+        for(;pos < todo;pos += 4)
+        {
+            const float32x4_t p{vld1q_f32(&samples[pos])};
+            vst1q_f32(&samples[pos], vmlaq_f32(voffset, Gen::eval(p), vgain));
+        }
+    }
+#endif
+    for(;pos < samples.size();++pos)
+        samples[pos] = Gen::eval(samples[pos])*gain + offset;
+}
+
+} // namespace
+
+auto Oscillator::generate(const al::span<float> dst, uint index) const noexcept -> uint
+{
+    const uint step{mStep};
+    const uint range{mRange};
+    const float scale{mScale};
+    ASSUME(range > 0);
+    ASSUME(step < range || range == 1);
+
+    /* Fill in the normalized phases first. This is cheap integer stepping
+     * compared to the waveform evaluation, which can then be done on whole
+     * vectors.
+     */
+    for(float &phase : dst)
+    {
+        phase = static_cast<float>(index) * scale;
+        index += step;
+        if(index >= range) index -= range;
+    }
+
+    switch(mWaveform)
+    {
+    case OscWaveform::Sinusoid: ApplyWaveform<SinusoidGen>(dst, mGain, mOffset); break;
+    case OscWaveform::Triangle: ApplyWaveform<TriangleGen>(dst, mGain, mOffset); break;
+    case OscWaveform::Sawtooth: ApplyWaveform<SawtoothGen>(dst, mGain, mOffset); break;
+    case OscWaveform::Square: ApplyWaveform<SquareGen>(dst, mGain, mOffset); break;
+    }
+    return index;
+}
@@ -0,0 +1,48 @@
+#ifndef CORE_OSCILLATOR_H
+#define CORE_OSCILLATOR_H
+
+#include "alspan.h"
+
+
+enum class OscWaveform : unsigned char {
+    Sinusoid,
+    Triangle,
+    Sawtooth,
+    Square
+};
+
+/* A low-frequency oscillator, as used for modulation effects. The phase is an
+ * integer index that advances by mStep each sample and wraps around at mRange,
+ * so the phase doesn't drift over long periods. The index is multiplied by
+ * mScale to get the normalized phase p (where 1 is a full cycle), for which
+ * the waveforms are:
+ *
+ *  Sinusoid: sin(2pi*p)
+ *  Triangle: 1 - |2 - 4p|
+ *  Sawtooth: 2p - 1
+ *  Square: p < 0.5 ? 1 : -1
+ *
+ * The output is then multiplied by mGain and offset by mOffset. The sinusoid
+ * uses a polynomial approximation instead of std::sin, so all the waveforms
+ * can be vectorized.
+ */
+struct Oscillator {
+    using uint = unsigned int;
+
+    OscWaveform mWaveform{OscWaveform::Sinusoid};
+    uint mStep{1};
+    uint mRange{1};
+    float mScale{0.0f};
+    float mGain{1.0f};
+    float mOffset{0.0f};
+
+    /**
+     * Fills dst with oscillator samples, starting from the given phase index
+     * (which must be less than mRange). Returns the phase index following the
+     * last sample.
+     */
+    [[nodiscard]]
+    auto generate(const al::span<float> dst, uint index) const noexcept -> uint;
+};
+
+#endif /* CORE_OSCILLATOR_H */
@@ -0,0 +1,155 @@
+
+#include "config.h"
+
+#include "rtcheck.h"
+
+#ifdef ALSOFT_RTCHECK
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+
+#ifdef HAVE_EXECINFO_H
+#include <execinfo.h>
+#endif
+
+#include "logging.h"
+
+
+namespace {
+
+thread_local unsigned int sRealtimeDepth{0u};
+thread_local bool sReporting{false};
+
+void ReportViolation(const char *what) noexcept
+{
+    /* Reporting can itself log (and take a lock), so avoid recursing. */
+    if(sRealtimeDepth == 0 || sReporting)
+        return;
+    sReporting = true;
+
+    ERR("Real-time check: %s on the mixer thread\n", what);
+#ifdef HAVE_EXECINFO_H
+    /* backtrace_symbols_fd writes directly to the file, without allocating. */
+    if(FILE *logfile{gLogFile})
+    {
+        std::array<void*,32> frames{};
+        const int count{backtrace(frames.data(), static_cast<int>(frames.size()))};
+        fflush(logfile);
+        backtrace_symbols_fd(frames.data(), count, fileno(logfile));
+    }
+#endif
+
+    sReporting = false;
+}
+
+
+/* Aligned allocations are made by over-allocating with malloc, storing the
+ * original pointer just before the aligned block so it can be freed.
+ */
+void *AlignedAlloc(std::size_t size, std::size_t alignment) noexcept
+{
+    alignment = std::max(alignment, alignof(void*));
+    void *base{std::malloc(size + alignment + sizeof(void*))};
+    if(!base) return nullptr;
+
+    auto addr = reinterpret_cast<std::uintptr_t>(base) + sizeof(void*);
+    addr = (addr + alignment-1) & ~(alignment-1);
+    auto *ret = reinterpret_cast<void**>(addr);
+    ret[-1] = base;
+    return ret;
+}
+
+void AlignedFree(void *ptr) noexcept
+{
+    if(ptr)
+        std::free(static_cast<void**>(ptr)[-1]);
+}
+
+} // namespace
+
+
+RealtimeSection::RealtimeSection() noexcept
+{ ++sRealtimeDepth; }
+
+RealtimeSection::~RealtimeSection()
+{ --sRealtimeDepth; }
+
+void RealtimeCheckBlocking(const char *what) noexcept
+{ ReportViolation(what); }
+
+
+/* Replacements for the global allocation functions, which check for use on a
+ * real-time thread.
+ */
+void *operator new(std::size_t size)
+{
+    ReportViolation("memory allocation");
+    if(void *ret{std::malloc(size ? size : 1)})
+        return ret;
+    throw std::bad_alloc{};
+}
+void *operator new[](std::size_t size)
+{ return ::operator new(size); }
+void *operator new(std::size_t size, const std::nothrow_t&) noexcept
+{
+    ReportViolation("memory allocation");
+    return std::malloc(size ? size : 1);
+}
+void *operator new[](std::size_t size, const std::nothrow_t&) noexcept
+{ return ::operator new(size, std::nothrow); }
+
+void *operator new(std::size_t size, std::align_val_t alignment)
+{
+    ReportViolation("memory allocation");
+    if(void *ret{AlignedAlloc(size, static_cast<std::size_t>(alignment))})
+        return ret;
+    throw std::bad_alloc{};
+}
+void *operator new[](std::size_t size, std::align_val_t alignment)
+{ return ::operator new(size, alignment); }
+void *operator new(std::size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept
+{
+    ReportViolation("memory allocation");
+    return AlignedAlloc(size, static_cast<std::size_t>(alignment));
+}
+void *operator new[](std::size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept
+{ return ::operator new(size, alignment, std::nothrow); }
+
+void operator delete(void *ptr) noexcept
+{
+    if(ptr) ReportViolation("memory deallocation");
+    std::free(ptr);
+}
+void operator delete[](void *ptr) noexcept
+{ ::operator delete(ptr); }
+void operator delete(void *ptr, std::size_t) noexcept
+{ ::operator delete(ptr); }
+void operator delete[](void *ptr, std::size_t) noexcept
+{ ::operator delete(ptr); }
+void operator delete(void *ptr, const std::nothrow_t&) noexcept
+{ ::operator delete(ptr); }
+void operator delete[](void *ptr, const std::nothrow_t&) noexcept
+{ ::operator delete(ptr); }
+
+void operator delete(void *ptr, std::align_val_t) noexcept
+{
+    if(ptr) ReportViolation("memory deallocation");
+    AlignedFree(ptr);
+}
+void operator delete[](void *ptr, std::align_val_t alignment) noexcept
+{ ::operator delete(ptr, alignment); }
+void operator delete(void *ptr, std::size_t, std::align_val_t alignment) noexcept
+{ ::operator delete(ptr, alignment); }
+void operator delete[](void *ptr, std::size_t, std::align_val_t alignment) noexcept
+{ ::operator delete(ptr, alignment); }
+void operator delete(void *ptr, std::align_val_t alignment, const std::nothrow_t&) noexcept
+{ ::operator delete(ptr, alignment); }
+void operator delete[](void *ptr, std::align_val_t alignment, const std::nothrow_t&) noexcept
+{ ::operator delete(ptr, alignment); }
+
+#endif /* ALSOFT_RTCHECK */
@@ -0,0 +1,41 @@
+#ifndef CORE_RTCHECK_H
+#define CORE_RTCHECK_H
+
+/* Debugging aid for the mixer's real-time guarantees. When built with
+ * ALSOFT_RTCHECK, a RealtimeSection marks the calling thread as real-time for
+ * its lifetime, and any memory allocation or deallocation made by the thread
+ * during that time (through the global operator new/delete) is reported as an
+ * error along with a backtrace. Code that may block, like taking a lock, can
+ * call RealtimeCheckBlocking to be reported similarly.
+ *
+ * Without ALSOFT_RTCHECK, these do nothing.
+ */
+#ifdef ALSOFT_RTCHECK
+
+class RealtimeSection {
+public:
+    RealtimeSection() noexcept;
+    ~RealtimeSection();
+
+    RealtimeSection(const RealtimeSection&) = delete;
+    RealtimeSection& operator=(const RealtimeSection&) = delete;
+};
+
+void RealtimeCheckBlocking(const char *what) noexcept;
+
+#else
+
+class RealtimeSection {
+public:
+    RealtimeSection() noexcept = default;
+    ~RealtimeSection() = default;
+
+    RealtimeSection(const RealtimeSection&) = delete;
+    RealtimeSection& operator=(const RealtimeSection&) = delete;
+};
+
+inline void RealtimeCheckBlocking(const char*) noexcept { }
+
+#endif
+
+#endif /* CORE_RTCHECK_H */
@@ -86,6 +86,19 @@ inline MixerOutFunc SelectMixer()
     return Mix_<CTag>;
 }
 
+inline MixerChansFunc SelectMixerChans()
+{
+#ifdef HAVE_NEON
+    if((CPUCapFlags&CPU_CAP_NEON))
+        return Mix_<NEONTag>;
+#endif
+#ifdef HAVE_SSE
+    if((CPUCapFlags&CPU_CAP_SSE))
+        return Mix_<SSETag>;
+#endif
+    return Mix_<CTag>;
+}
+
 inline MixerOneFunc SelectMixerOne()
 {
 #ifdef HAVE_NEON
@@ -176,6 +189,7 @@ void Voice::InitMixer(std::optional<std::string> resopt)
     }
 
     MixSamplesOut = SelectMixer();
+    MixSamplesChans = SelectMixerChans();
     MixSamplesOne = SelectMixerOne();
     MixHrtfBlendSamples = SelectHrtfBlendMixer();
     MixHrtfSamples = SelectHrtfMixer();
@@ -605,8 +619,72 @@ void LoadBufferQueue(VoiceBufferItem *buffer, VoiceBufferItem *bufferLoopItem,
 }
 
 
+template<FmtType Type>
+void MixStaticSamples(const al::span<const std::byte> srcData, const size_t srcChan,
+    const size_t srcOffset, const size_t srcStep, const al::span<FloatBufferLine> OutBuffer,
+    const al::span<const std::uint8_t> OutChans, const al::span<const float> Gains,
+    const size_t OutPos, const size_t samplesToMix) noexcept
+{
+    using TypeTraits = al::FmtTypeTraits<Type>;
+    using SampleType = typename TypeTraits::Type;
+    static constexpr size_t sampleSize{sizeof(SampleType)};
+    assert(srcChan < srcStep);
+    auto converter = TypeTraits{};
+
+    const al::span<const SampleType> src{reinterpret_cast<const SampleType*>(srcData.data()),
+        srcData.size()/sampleSize};
+    for(const size_t outchan : OutChans)
+    {
+        const float outgain{Gains[outchan]};
+        if(!(std::abs(outgain) > GainSilenceThreshold))
+            continue;
+
+        /* Convert and apply the gain as the samples are read, accumulating
+         * straight into the output line.
+         */
+        auto ssrc = src.cbegin() + ptrdiff_t(srcOffset*srcStep);
+        const auto dst = al::span{OutBuffer[outchan]}.subspan(OutPos, samplesToMix);
+        std::transform(dst.begin(), dst.end(), dst.begin(),
+            [&ssrc,srcChan,srcStep,converter,outgain](const float dry) noexcept -> float
+            {
+                const float val{converter(ssrc[srcChan])};
+                ssrc += ptrdiff_t(srcStep);
+                return dry + val*outgain;
+            });
+    }
+}
+
+void MixStaticSamples(const al::span<const std::byte> srcData, const size_t srcChan,
+    const size_t srcOffset, const FmtType srcType, const size_t srcStep,
+    const al::span<FloatBufferLine> OutBuffer, const al::span<const std::uint8_t> OutChans,
+    const al::span<const float> Gains, const size_t OutPos, const size_t samplesToMix) noexcept
+{
+#define HANDLE_FMT(T) case T:                                                 \
+    MixStaticSamples<T>(srcData, srcChan, srcOffset, srcStep, OutBuffer,      \
+        OutChans, Gains, OutPos, samplesToMix);                               \
+    break
+
+    switch(srcType)
+    {
+    HANDLE_FMT(FmtUByte);
+    HANDLE_FMT(FmtShort);
+    HANDLE_FMT(FmtInt);
+    HANDLE_FMT(FmtFloat);
+    HANDLE_FMT(FmtDouble);
+    HANDLE_FMT(FmtMulaw);
+    HANDLE_FMT(FmtAlaw);
+    /* Block-compressed formats need decoding, and use the normal path. */
+    case FmtIMA4:
+    case FmtMSADPCM:
+        break;
+    }
+#undef HANDLE_FMT
+}
+
+
 void DoHrtfMix(const al::span<const float> samples, DirectParams &parms, const float TargetGain,
-    const size_t Counter, size_t OutPos, const bool IsPlaying, DeviceBase *Device)
+    const size_t Counter, size_t OutPos, const bool IsPlaying, const bool IsDelayed,
+    DeviceBase *Device)
 {
     const uint IrSize{Device->mIrSize};
     const auto HrtfSamples = al::span{Device->ExtraSampleData};
@@ -623,9 +701,9 @@ void DoHrtfMix(const al::span<const float> samples, DirectParams &parms, const f
         std::copy_n(endsamples.cbegin(), endsamples.size(), parms.Hrtf.History.begin());
     }
 
-    /* If fading and this is the first mixing pass, fade between the IRs. */
+    /* If fading and this isn't a delayed start, fade between the IRs. */
     size_t fademix{0};
-    if(Counter && OutPos == 0)
+    if(Counter && !IsDelayed)
     {
         fademix = std::min(samples.size(), Counter);
 
@@ -714,11 +792,11 @@ void DoNfcMix(const al::span<const float> samples, al::span<FloatBufferLine> Out
 } // namespace
 
 void Voice::mix(const State vstate, ContextBase *Context, const nanoseconds deviceTime,
-    const uint SamplesToDo)
+    const uint OutStart, const uint SamplesToDo)
 {
     static constexpr std::array<float,MaxOutputChannels> SilentTarget{};
 
-    ASSUME(SamplesToDo > 0);
+    ASSUME(SamplesToDo > OutStart);
 
     DeviceBase *Device{Context->mDevice};
     const uint NumSends{Device->NumAuxSends};
@@ -748,7 +826,7 @@ void Voice::mix(const State vstate, ContextBase *Context, const nanoseconds devi
             BufferLoopItem = nullptr;
     }
 
-    uint OutPos{0u};
+    uint OutPos{OutStart};
 
     /* Check if we're doing a delayed start, and we start in this update. */
     if(mStartTime > deviceTime) UNLIKELY
@@ -771,7 +849,8 @@ void Voice::mix(const State vstate, ContextBase *Context, const nanoseconds devi
          * should start at. Skip this update if it's beyond the output sample
          * count.
          */
-        OutPos = static_cast<uint>(round<seconds>(diff * Device->Frequency).count());
+        OutPos = std::max(OutStart,
+            static_cast<uint>(round<seconds>(diff * Device->Frequency).count()));
         if(OutPos >= SamplesToDo) return;
     }
 
@@ -781,6 +860,11 @@ void Voice::mix(const State vstate, ContextBase *Context, const nanoseconds devi
     const uint samplesToMix{SamplesToDo - OutPos};
     const uint samplesToLoad{samplesToMix + mDecoderPadding};
 
+    if(vstate == Playing && increment == MixerFracOne && DataPosFrac == 0 && DataPosInt >= 0
+        && mixStaticDirect(NumSends, static_cast<uint>(DataPosInt), BufferListItem,
+            BufferLoopItem, OutPos, samplesToMix))
+        return;
+
     /* Get a span of pointers to hold the floating point, deinterlaced,
      * resampled buffer data to be mixed.
      */
@@ -1053,7 +1137,7 @@ void Voice::mix(const State vstate, ContextBase *Context, const nanoseconds devi
             {
                 const float TargetGain{parms.Hrtf.Target.Gain * float(vstate == Playing)};
                 DoHrtfMix(samples, parms, TargetGain, Counter, OutPos, (vstate == Playing),
-                    Device);
+                    (OutPos > OutStart), Device);
             }
             else
             {
@@ -1062,8 +1146,8 @@ void Voice::mix(const State vstate, ContextBase *Context, const nanoseconds devi
                 if(mFlags.test(VoiceHasNfc))
                     DoNfcMix(samples, mDirect.Buffer, parms, TargetGains, Counter, OutPos, Device);
                 else
-                    MixSamples(samples, mDirect.Buffer, parms.Gains.Current, TargetGains, Counter,
-                        OutPos);
+                    MixSamples(samples, mDirect.Buffer, parms.Gains.Active.get(),
+                        parms.Gains.Current, TargetGains, Counter, OutPos);
             }
         }
 
@@ -1078,8 +1162,8 @@ void Voice::mix(const State vstate, ContextBase *Context, const nanoseconds devi
 
             const auto TargetGains = (vstate == Playing) ? al::span{parms.Gains.Target}
                 : al::span{SilentTarget};
-            MixSamples(samples, mSend[send].Buffer, parms.Gains.Current, TargetGains, Counter,
-                OutPos);
+            MixSamples(samples, mSend[send].Buffer, parms.Gains.Active.get(), parms.Gains.Current,
+                TargetGains, Counter, OutPos);
         }
 
         ++voiceSamples;
@@ -1202,6 +1286,87 @@ void Voice::mix(const State vstate, ContextBase *Context, const nanoseconds devi
     }
 }
 
+bool Voice::mixStaticDirect(const uint NumSends, const uint DataPosInt,
+    VoiceBufferItem *BufferListItem, VoiceBufferItem *BufferLoopItem, const uint OutPos,
+    const uint samplesToMix)
+{
+    if(!mFlags.test(VoiceIsStatic) || !BufferListItem || mDecoder
+        || mFlags.test(VoiceIsAmbisonic) || mFlags.test(VoiceHasHrtf) || mFlags.test(VoiceHasNfc)
+        || mDirect.FilterType != AF_None || mFmtType == FmtIMA4 || mFmtType == FmtMSADPCM)
+        return false;
+
+    /* A non-looping voice that reaches the end of its buffer needs to stop,
+     * which the normal path handles.
+     */
+    if(!BufferLoopItem && size_t{DataPosInt} + samplesToMix >= BufferListItem->mSampleLen)
+        return false;
+
+    auto send_inactive = [](const TargetData &send) noexcept { return send.Buffer.empty(); };
+    if(!std::all_of(mSend.cbegin(), mSend.cbegin()+NumSends, send_inactive))
+        return false;
+
+    /* Gains that are still fading need the normal mixer. */
+    if(mFlags.test(VoiceIsFading))
+    {
+        auto gains_stable = [](const ChannelData &chandata) noexcept
+        { return chandata.mDryParams.Gains.Current == chandata.mDryParams.Gains.Target; };
+        if(!std::all_of(mChans.cbegin(), mChans.cend(), gains_stable))
+            return false;
+    }
+
+    const size_t realChannels{(mFmtChannels == FmtMonoDup) ? 1u : mChans.size()};
+    const uint LoopStart{BufferListItem->mLoopStart};
+    const uint LoopEnd{BufferListItem->mLoopEnd};
+    auto wrap_pos = [BufferLoopItem,LoopStart,LoopEnd](size_t pos) noexcept -> uint
+    {
+        if(BufferLoopItem && pos >= LoopEnd)
+            pos = ((pos-LoopStart)%(LoopEnd-LoopStart)) + LoopStart;
+        return static_cast<uint>(pos);
+    };
+
+    for(size_t chan{0};chan < mChans.size();++chan)
+    {
+        DirectParams &parms = mChans[chan].mDryParams;
+        parms.LowPass.clear();
+        parms.HighPass.clear();
+        parms.Gains.Current = parms.Gains.Target;
+
+        const size_t srcChan{std::min(chan, realChannels-1)};
+        uint pos{DataPosInt};
+        uint outOffset{OutPos};
+        for(uint todo{samplesToMix};todo > 0;)
+        {
+            const uint count{BufferLoopItem ? std::min(todo, LoopEnd-pos) : todo};
+            MixStaticSamples(BufferListItem->mSamples, srcChan, pos, mFmtType, mFrameStep,
+                mDirect.Buffer, parms.Gains.Active.get(), parms.Gains.Target, outOffset, count);
+            todo -= count;
+            outOffset += count;
+            pos = wrap_pos(size_t{pos} + count);
+        }
+    }
+
+    /* Store the source samples around the new position, as the normal path
+     * would, so it can pick up seamlessly if the voice leaves this path.
+     */
+    for(size_t chan{0};chan < realChannels;++chan)
+    {
+        const al::span prevSamples{mPrevSamples[chan]};
+        const uint keep{(samplesToMix < MaxResamplerEdge) ? MaxResamplerEdge-samplesToMix : 0u};
+        std::copy_n(prevSamples.cbegin()+samplesToMix, keep, prevSamples.begin());
+        LoadBufferStatic(BufferListItem, BufferLoopItem,
+            wrap_pos(size_t{DataPosInt} + samplesToMix + keep - MaxResamplerEdge), mFmtType,
+            chan, mFrameStep, prevSamples.subspan(keep));
+    }
+
+    mFlags.set(VoiceIsFading);
+
+    mPosition.store(static_cast<int>(wrap_pos(size_t{DataPosInt} + samplesToMix)),
+        std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    return true;
+}
+
 void Voice::prepare(DeviceBase *device)
 {
     /* Even if storing really high order ambisonics, we only mix channels for
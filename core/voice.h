@@ -1,11 +1,13 @@
 #ifndef CORE_VOICE_H
 #define CORE_VOICE_H
 
+#include <algorithm>
 #include <array>
 #include <atomic>
 #include <bitset>
 #include <chrono>
 #include <cstddef>
+#include <cstdint>
 #include <memory>
 #include <optional>
 #include <string>
@@ -59,6 +61,31 @@ enum {
 };
 
 
+/* The output channels with a non-zero current or target gain. Only these
+ * need to be visited when mixing, as the rest stay silent.
+ */
+struct ActiveChannels {
+    std::array<std::uint8_t,MaxOutputChannels> Indices{};
+    std::uint8_t Count{0u};
+
+    void update(const al::span<const float> current, const al::span<const float> target,
+        const size_t numOutputs) noexcept
+    {
+        const size_t count{std::min({numOutputs, current.size(), target.size(),
+            Indices.size()})};
+        Count = 0u;
+        for(size_t i{0};i < count;++i)
+        {
+            if(current[i] != 0.0f || target[i] != 0.0f)
+                Indices[Count++] = static_cast<std::uint8_t>(i);
+        }
+    }
+
+    [[nodiscard]]
+    auto get() const noexcept -> al::span<const std::uint8_t>
+    { return al::span{Indices}.first(Count); }
+};
+
 struct DirectParams {
     BiquadFilter LowPass;
     BiquadFilter HighPass;
@@ -75,6 +102,7 @@ struct DirectParams {
     struct GainParams {
         std::array<float,MaxOutputChannels> Current{};
         std::array<float,MaxOutputChannels> Target{};
+        ActiveChannels Active;
     };
     GainParams Gains;
 };
@@ -86,6 +114,7 @@ struct SendParams {
     struct GainParams {
         std::array<float,MaxAmbiChannels> Current{};
         std::array<float,MaxAmbiChannels> Target{};
+        ActiveChannels Active;
     };
     GainParams Gains;
 };
@@ -102,10 +131,29 @@ struct VoiceBufferItem {
     uint mLoopStart{0u};
     uint mLoopEnd{0u};
 
+    /* Index and starting sample of this item in its queue, counted from when
+     * the queue was created, for reporting the playback position without
+     * walking the queue.
+     */
+    uint mQueueIndex{0u};
+    uint64_t mQueueOffset{0u};
+
     al::span<std::byte> mSamples{};
 };
 
 
+/* Playback position of a voice, as published by the mixer after each update.
+ * The read position is in fixed-point samples (MixerFracBits) from the start
+ * of the queue item with index 0, and a source ID of 0 means the voice wasn't
+ * playing anything.
+ */
+struct VoicePlaybackInfo {
+    std::atomic<uint> mSourceID{0u};
+    std::atomic<uint> mBufferIndex{0u};
+    std::atomic<int64_t> mReadPos{0};
+};
+
+
 struct VoiceProps {
     float Pitch;
     float Gain;
@@ -168,6 +216,28 @@ struct VoicePropsItem : public VoiceProps {
     std::atomic<VoicePropsItem*> next{nullptr};
 };
 
+/* A parameter change scheduled to happen at a specific device clock time. The
+ * mixer applies it at the matching sample offset within an update.
+ */
+struct VoiceParamEvent {
+    enum class Param : unsigned char {
+        Gain,
+        Pitch,
+        Position,
+        DirectFilter
+    };
+
+    std::atomic<VoiceParamEvent*> next{nullptr};
+
+    std::chrono::nanoseconds mTime{};
+    Param mParam{};
+    /* Gain, Pitch: { value }
+     * Position: { x, y, z }
+     * DirectFilter: { Gain, GainHF, HFReference, GainLF, LFReference }
+     */
+    std::array<float,5> mValues{};
+};
+
 enum : uint {
     VoiceIsStatic,
     VoiceIsCallback,
@@ -192,6 +262,12 @@ struct SIMDALIGN Voice {
 
     VoiceProps mProps{};
 
+    /* Newly scheduled parameter events get pushed onto mScheduledParams, which
+     * the mixer moves into mParamTimeline (ordered by time) until they apply.
+     */
+    std::atomic<VoiceParamEvent*> mScheduledParams{nullptr};
+    VoiceParamEvent *mParamTimeline{nullptr};
+
     std::atomic<uint> mSourceID{0u};
     std::atomic<State> mPlayState{Stopped};
     std::atomic<bool> mPendingChange{false};
@@ -212,6 +288,11 @@ struct SIMDALIGN Voice {
      */
     std::atomic<VoiceBufferItem*> mLoopBuffer{};
 
+    /* Double-buffered playback info, guarded by the context's
+     * mPlaybackInfoSeq.
+     */
+    std::array<VoicePlaybackInfo,2> mPlaybackInfo{};
+
     std::chrono::nanoseconds mStartTime{};
 
     /* Properties for the attached buffer(s). */
@@ -269,8 +350,22 @@ struct SIMDALIGN Voice {
     Voice(const Voice&) = delete;
     Voice& operator=(const Voice&) = delete;
 
+    /**
+     * Mixes the voice for the output samples [OutStart, SamplesToDo), where
+     * deviceTime is the device clock time at sample 0 of the update.
+     */
     void mix(const State vstate, ContextBase *Context, const std::chrono::nanoseconds deviceTime,
-        const uint SamplesToDo);
+        const uint OutStart, const uint SamplesToDo);
+
+    /**
+     * Mixes a playing static voice straight from its buffer to the dry output
+     * when it has no resampling, filtering, sends, or special processing, and
+     * its gains aren't fading. Returns false if the voice needs the normal
+     * path.
+     */
+    bool mixStaticDirect(const uint NumSends, const uint DataPosInt,
+        VoiceBufferItem *BufferListItem, VoiceBufferItem *BufferLoopItem, const uint OutPos,
+        const uint samplesToMix);
 
     void prepare(DeviceBase *device);
 
@@ -0,0 +1,125 @@
+#include <gtest/gtest.h>
+
+#define AL_ALEXT_PROTOTYPES
+#include <AL/al.h>
+#include <AL/alc.h>
+#include <AL/alext.h>
+
+#include <array>
+#include <chrono>
+#include <thread>
+
+/* Checks the error handling of the in-place capture functions. The cases that
+ * need a capture device are skipped when none can be opened.
+ */
+
+namespace {
+
+using CaptureAcquireSamplesFunc = void(ALC_APIENTRY*)(ALCdevice *device, ALCsizei samples,
+    const ALCvoid **buffers, ALCsizei *lengths) noexcept;
+using CaptureReleaseSamplesFunc = void(ALC_APIENTRY*)(ALCdevice *device) noexcept;
+
+class CaptureDirectTest : public ::testing::Test {
+protected:
+    static constexpr ALCuint SampleRate{44100};
+    static constexpr ALCsizei BufferSize{4096};
+
+    CaptureAcquireSamplesFunc mAcquire{};
+    CaptureReleaseSamplesFunc mRelease{};
+
+    void SetUp() override
+    {
+        mAcquire = reinterpret_cast<CaptureAcquireSamplesFunc>(
+            alcGetProcAddress(nullptr, "alcCaptureAcquireSamplesSOFT"));
+        mRelease = reinterpret_cast<CaptureReleaseSamplesFunc>(
+            alcGetProcAddress(nullptr, "alcCaptureReleaseSamplesSOFT"));
+        ASSERT_NE(mAcquire, nullptr);
+        ASSERT_NE(mRelease, nullptr);
+    }
+};
+
+} // namespace
+
+
+TEST_F(CaptureDirectTest, NonCaptureDevices)
+{
+    std::array<const ALCvoid*,2> buffers{};
+    std::array<ALCsizei,2> lengths{};
+
+    mAcquire(nullptr, 1, buffers.data(), lengths.data());
+    EXPECT_EQ(alcGetError(nullptr), ALC_INVALID_DEVICE);
+    mRelease(nullptr);
+    EXPECT_EQ(alcGetError(nullptr), ALC_INVALID_DEVICE);
+
+    ALCdevice *device{alcLoopbackOpenDeviceSOFT(nullptr)};
+    ASSERT_NE(device, nullptr);
+    mAcquire(device, 1, buffers.data(), lengths.data());
+    EXPECT_EQ(alcGetError(device), ALC_INVALID_DEVICE);
+    mRelease(device);
+    EXPECT_EQ(alcGetError(device), ALC_INVALID_DEVICE);
+    alcCloseDevice(device);
+}
+
+TEST_F(CaptureDirectTest, AcquireRelease)
+{
+    ALCdevice *device{alcCaptureOpenDevice(nullptr, SampleRate, AL_FORMAT_MONO16, BufferSize)};
+    if(!device)
+        GTEST_SKIP() << "No capture device available";
+
+    std::array<const ALCvoid*,2> buffers{};
+    std::array<ALCsizei,2> lengths{};
+
+    /* Releasing without acquiring fails. */
+    mRelease(device);
+    EXPECT_EQ(alcGetError(device), ALC_INVALID_DEVICE);
+
+    /* Negative counts and missing outputs are invalid. */
+    mAcquire(device, -1, buffers.data(), lengths.data());
+    EXPECT_EQ(alcGetError(device), ALC_INVALID_VALUE);
+    mAcquire(device, 0, nullptr, lengths.data());
+    EXPECT_EQ(alcGetError(device), ALC_INVALID_VALUE);
+    mAcquire(device, 0, buffers.data(), nullptr);
+    EXPECT_EQ(alcGetError(device), ALC_INVALID_VALUE);
+
+    alcCaptureStart(device);
+    ALCint avail{};
+    const auto timeout = std::chrono::steady_clock::now() + std::chrono::seconds{2};
+    do {
+        std::this_thread::sleep_for(std::chrono::milliseconds{10});
+        alcGetIntegerv(device, ALC_CAPTURE_SAMPLES, 1, &avail);
+    } while(avail < 1 && std::chrono::steady_clock::now() < timeout);
+    alcCaptureStop(device);
+    alcGetIntegerv(device, ALC_CAPTURE_SAMPLES, 1, &avail);
+    if(avail < 1)
+    {
+        alcCaptureCloseDevice(device);
+        GTEST_SKIP() << "No samples captured";
+    }
+    ASSERT_EQ(alcGetError(device), ALC_NO_ERROR);
+
+    /* Acquiring more than is available fails, without acquiring anything. */
+    mAcquire(device, avail+1, buffers.data(), lengths.data());
+    EXPECT_EQ(alcGetError(device), ALC_INVALID_VALUE);
+    mRelease(device);
+    EXPECT_EQ(alcGetError(device), ALC_INVALID_DEVICE);
+
+    /* The acquired segments cover the requested count. */
+    mAcquire(device, avail, buffers.data(), lengths.data());
+    ASSERT_EQ(alcGetError(device), ALC_NO_ERROR);
+    EXPECT_NE(buffers[0], nullptr);
+    EXPECT_EQ(lengths[0]+lengths[1], avail);
+
+    /* Acquiring again before releasing fails. */
+    mAcquire(device, 1, buffers.data(), lengths.data());
+    EXPECT_EQ(alcGetError(device), ALC_INVALID_DEVICE);
+
+    /* Releasing consumes the samples, and only works once. */
+    mRelease(device);
+    EXPECT_EQ(alcGetError(device), ALC_NO_ERROR);
+    alcGetIntegerv(device, ALC_CAPTURE_SAMPLES, 1, &avail);
+    EXPECT_EQ(avail, 0);
+    mRelease(device);
+    EXPECT_EQ(alcGetError(device), ALC_INVALID_DEVICE);
+
+    alcCaptureCloseDevice(device);
+}
@@ -0,0 +1,812 @@
+#include <gtest/gtest.h>
+
+#define AL_ALEXT_PROTOTYPES
+#include <AL/al.h>
+#include <AL/alc.h>
+#include <AL/alext.h>
+#include <AL/efx.h>
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+#include <thread>
+#include <vector>
+
+/* Drives effects and source features through a loopback device, watching the
+ * log for problems reported on the mixer thread. With ALSOFT_RTCHECK enabled,
+ * this catches memory allocations and locks while mixing.
+ */
+
+namespace {
+
+using LogCallbackFunc = void(ALC_APIENTRY*)(void *userptr, char level, const char *message,
+    int length) noexcept;
+using SetLogCallbackFunc = void(ALC_APIENTRY*)(LogCallbackFunc callback, void *userptr) noexcept;
+
+std::atomic<int> gRealtimeErrors{0};
+
+void ALC_APIENTRY LogCallback(void*, char level, const char *message, int) noexcept
+{
+    if(level == 'E' && std::strstr(message, "Real-time check") != nullptr)
+        gRealtimeErrors.fetch_add(1, std::memory_order_relaxed);
+}
+
+class LoopbackTest : public ::testing::Test {
+protected:
+    static constexpr ALCint SampleRate{48000};
+    static constexpr ALCsizei RenderSize{1024};
+
+    ALCdevice *mDevice{};
+    ALCcontext *mContext{};
+    ALuint mBuffer{};
+    ALuint mSource{};
+    std::vector<float> mOutput;
+
+    void SetUp() override
+    {
+        auto set_log_callback = reinterpret_cast<SetLogCallbackFunc>(
+            alcGetProcAddress(nullptr, "alsoft_set_log_callback"));
+        ASSERT_NE(set_log_callback, nullptr);
+        set_log_callback(LogCallback, nullptr);
+        gRealtimeErrors.store(0);
+
+        mDevice = alcLoopbackOpenDeviceSOFT(nullptr);
+        ASSERT_NE(mDevice, nullptr);
+
+        const std::array<ALCint,7> attrs{ALC_FORMAT_CHANNELS_SOFT, ALC_STEREO_SOFT,
+            ALC_FORMAT_TYPE_SOFT, ALC_FLOAT_SOFT, ALC_FREQUENCY, SampleRate, 0};
+        mContext = alcCreateContext(mDevice, attrs.data());
+        ASSERT_NE(mContext, nullptr);
+        ASSERT_TRUE(alcMakeContextCurrent(mContext));
+
+        /* A one-second 440hz tone. */
+        std::vector<float> tone(SampleRate);
+        for(size_t i{0};i < tone.size();++i)
+            tone[i] = static_cast<float>(std::sin(static_cast<double>(i) * 440.0 * 6.283185307179586
+                / SampleRate)) * 0.5f;
+        alGenBuffers(1, &mBuffer);
+        alBufferData(mBuffer, AL_FORMAT_MONO_FLOAT32, tone.data(),
+            static_cast<ALsizei>(tone.size()*sizeof(float)), SampleRate);
+
+        alGenSources(1, &mSource);
+        alSourcei(mSource, AL_BUFFER, static_cast<ALint>(mBuffer));
+        alSourcei(mSource, AL_LOOPING, AL_TRUE);
+        alSource3f(mSource, AL_POSITION, 1.0f, 0.0f, -1.0f);
+        ASSERT_EQ(alGetError(), AL_NO_ERROR);
+
+        mOutput.resize(RenderSize*2);
+    }
+
+    void TearDown() override
+    {
+        if(mContext)
+        {
+            alDeleteSources(1, &mSource);
+            alDeleteBuffers(1, &mBuffer);
+            alcMakeContextCurrent(nullptr);
+            alcDestroyContext(mContext);
+        }
+        if(mDevice)
+            alcCloseDevice(mDevice);
+
+        auto set_log_callback = reinterpret_cast<SetLogCallbackFunc>(
+            alcGetProcAddress(nullptr, "alsoft_set_log_callback"));
+        if(set_log_callback)
+            set_log_callback(nullptr, nullptr);
+    }
+
+    void render(int count)
+    {
+        for(int i{0};i < count;++i)
+            alcRenderSamplesSOFT(mDevice, mOutput.data(), RenderSize);
+    }
+};
+
+} // namespace
+
+
+TEST_F(LoopbackTest, SourceUpdates)
+{
+    alSourcePlay(mSource);
+    render(4);
+
+    for(int i{0};i < 16;++i)
+    {
+        const auto f = static_cast<float>(i);
+        alSource3f(mSource, AL_POSITION, std::sin(f), 0.0f, -std::cos(f));
+        alSourcef(mSource, AL_PITCH, 0.5f + f*0.1f);
+        alSourcef(mSource, AL_GAIN, 1.0f - f*0.05f);
+        alSource3f(mSource, AL_VELOCITY, f, 0.0f, 0.0f);
+        alListener3f(AL_POSITION, 0.0f, f*0.1f, 0.0f);
+        render(1);
+    }
+
+    alSourcePause(mSource);
+    render(1);
+    alSourcePlay(mSource);
+    render(1);
+    alSourceStop(mSource);
+    render(1);
+    alSourceRewind(mSource);
+    alSourcePlay(mSource);
+    render(2);
+
+    EXPECT_EQ(alGetError(), AL_NO_ERROR);
+    EXPECT_EQ(gRealtimeErrors.load(), 0);
+}
+
+TEST_F(LoopbackTest, StreamingSource)
+{
+    std::array<ALuint,4> buffers{};
+    alGenBuffers(static_cast<ALsizei>(buffers.size()), buffers.data());
+
+    std::vector<short> data(RenderSize);
+    for(size_t i{0};i < data.size();++i)
+        data[i] = static_cast<short>((i&63) * 512 - 16384);
+    for(ALuint buffer : buffers)
+        alBufferData(buffer, AL_FORMAT_MONO16, data.data(),
+            static_cast<ALsizei>(data.size()*sizeof(short)), SampleRate);
+
+    alSourcei(mSource, AL_BUFFER, 0);
+    alSourcei(mSource, AL_LOOPING, AL_FALSE);
+    alSourceQueueBuffers(mSource, static_cast<ALsizei>(buffers.size()), buffers.data());
+    alSourcePlay(mSource);
+
+    for(int i{0};i < 32;++i)
+    {
+        render(1);
+
+        ALint processed{};
+        alGetSourcei(mSource, AL_BUFFERS_PROCESSED, &processed);
+        while(processed-- > 0)
+        {
+            ALuint buffer{};
+            alSourceUnqueueBuffers(mSource, 1, &buffer);
+            alBufferData(buffer, AL_FORMAT_MONO16, data.data(),
+                static_cast<ALsizei>(data.size()*sizeof(short)), SampleRate);
+            alSourceQueueBuffers(mSource, 1, &buffer);
+        }
+    }
+
+    alSourceStop(mSource);
+    alSourcei(mSource, AL_BUFFER, 0);
+    alDeleteBuffers(static_cast<ALsizei>(buffers.size()), buffers.data());
+
+    EXPECT_EQ(alGetError(), AL_NO_ERROR);
+    EXPECT_EQ(gRealtimeErrors.load(), 0);
+}
+
+TEST_F(LoopbackTest, FilterUpdates)
+{
+    ALuint filter{};
+    alGenFilters(1, &filter);
+    alFilteri(filter, AL_FILTER_TYPE, AL_FILTER_BANDPASS);
+
+    alSourcePlay(mSource);
+    for(int i{0};i < 16;++i)
+    {
+        const auto f = static_cast<float>(i) / 16.0f;
+        alFilterf(filter, AL_BANDPASS_GAINLF, 1.0f - f);
+        alFilterf(filter, AL_BANDPASS_GAINHF, f);
+        alSourcei(mSource, AL_DIRECT_FILTER, static_cast<ALint>(filter));
+        render(1);
+    }
+
+    alSourcei(mSource, AL_DIRECT_FILTER, AL_FILTER_NULL);
+    alDeleteFilters(1, &filter);
+
+    EXPECT_EQ(alGetError(), AL_NO_ERROR);
+    EXPECT_EQ(gRealtimeErrors.load(), 0);
+}
+
+TEST_F(LoopbackTest, EffectUpdates)
+{
+    static constexpr std::array EffectTypes{AL_EFFECT_REVERB, AL_EFFECT_EAXREVERB,
+        AL_EFFECT_CHORUS, AL_EFFECT_DISTORTION, AL_EFFECT_ECHO, AL_EFFECT_FLANGER,
+        AL_EFFECT_FREQUENCY_SHIFTER, AL_EFFECT_VOCAL_MORPHER, AL_EFFECT_PITCH_SHIFTER,
+        AL_EFFECT_RING_MODULATOR, AL_EFFECT_AUTOWAH, AL_EFFECT_COMPRESSOR,
+        AL_EFFECT_EQUALIZER, AL_EFFECT_DEDICATED_DIALOGUE,
+        AL_EFFECT_DEDICATED_LOW_FREQUENCY_EFFECT};
+
+    ALuint slot{};
+    alGenAuxiliaryEffectSlots(1, &slot);
+    ALuint effect{};
+    alGenEffects(1, &effect);
+
+    alSource3i(mSource, AL_AUXILIARY_SEND_FILTER, static_cast<ALint>(slot), 0, AL_FILTER_NULL);
+    alSourcePlay(mSource);
+    render(2);
+
+    for(const ALenum type : EffectTypes)
+    {
+        /* Switching the effect type replaces the slot's effect state, and the
+         * old state needs to be released off the mixer thread.
+         */
+        alEffecti(effect, AL_EFFECT_TYPE, type);
+        alAuxiliaryEffectSloti(slot, AL_EFFECTSLOT_EFFECT, static_cast<ALint>(effect));
+        render(2);
+        ASSERT_EQ(alGetError(), AL_NO_ERROR) << "Effect type 0x" << std::hex << type;
+
+        /* Updating the parameters of the same effect type only updates the
+         * existing state.
+         */
+        for(int i{0};i < 4;++i)
+        {
+            alAuxiliaryEffectSlotf(slot, AL_EFFECTSLOT_GAIN, 1.0f - static_cast<float>(i)*0.2f);
+            alAuxiliaryEffectSloti(slot, AL_EFFECTSLOT_EFFECT, static_cast<ALint>(effect));
+            render(1);
+        }
+        EXPECT_EQ(gRealtimeErrors.load(), 0) << "Effect type 0x" << std::hex << type;
+    }
+
+    alSource3i(mSource, AL_AUXILIARY_SEND_FILTER, AL_EFFECTSLOT_NULL, 0, AL_FILTER_NULL);
+    alAuxiliaryEffectSloti(slot, AL_EFFECTSLOT_EFFECT, AL_EFFECT_NULL);
+    render(1);
+    alDeleteEffects(1, &effect);
+    alDeleteAuxiliaryEffectSlots(1, &slot);
+
+    EXPECT_EQ(alGetError(), AL_NO_ERROR);
+    EXPECT_EQ(gRealtimeErrors.load(), 0);
+}
+
+TEST_F(LoopbackTest, ScheduledParams)
+{
+    using SourceScheduledfvFunc = void(AL_APIENTRY*)(ALuint source, ALint64SOFT update_time,
+        ALenum param, const ALfloat *values) noexcept;
+    auto source_scheduledfv = reinterpret_cast<SourceScheduledfvFunc>(
+        alGetProcAddress("alSourceScheduledfvSOFT"));
+    ASSERT_NE(source_scheduledfv, nullptr);
+
+    /* A constant signal played at the listener, so each output sample is
+     * non-0 exactly when the source gain is.
+     */
+    const std::vector<float> dc(RenderSize, 1.0f);
+    alSourcei(mSource, AL_BUFFER, 0);
+    alBufferData(mBuffer, AL_FORMAT_MONO_FLOAT32, dc.data(),
+        static_cast<ALsizei>(dc.size()*sizeof(float)), SampleRate);
+    alSourcei(mSource, AL_BUFFER, static_cast<ALint>(mBuffer));
+    alSourcei(mSource, AL_SOURCE_RELATIVE, AL_TRUE);
+    alSource3f(mSource, AL_POSITION, 0.0f, 0.0f, 0.0f);
+    alSourcef(mSource, AL_GAIN, 0.0f);
+    alSourcePlay(mSource);
+    render(2);
+    ASSERT_EQ(alGetError(), AL_NO_ERROR);
+
+    ALCint64SOFT clock{};
+    alcGetInteger64vSOFT(mDevice, ALC_DEVICE_CLOCK_SOFT, 1, &clock);
+    ASSERT_EQ(alcGetError(mDevice), ALC_NO_ERROR);
+
+    /* Schedule the gain back to 0 at sample 600 of the next update before
+     * raising it at sample 300, so the events are queued out of time order.
+     * Of the two events at sample 300, the last one scheduled wins.
+     */
+    static constexpr ALint64SOFT RaiseOffset{300};
+    static constexpr ALint64SOFT LowerOffset{600};
+    const auto sample_time = [clock](ALint64SOFT offset) noexcept -> ALint64SOFT
+    { return clock + offset*1'000'000'000/SampleRate; };
+    const ALfloat zero{0.0f}, half{0.5f}, one{1.0f};
+    source_scheduledfv(mSource, sample_time(LowerOffset), AL_GAIN, &zero);
+    source_scheduledfv(mSource, sample_time(RaiseOffset), AL_GAIN, &half);
+    source_scheduledfv(mSource, sample_time(RaiseOffset), AL_GAIN, &one);
+    ASSERT_EQ(alGetError(), AL_NO_ERROR);
+
+    render(1);
+    const auto frame_level = [this](ALint64SOFT frame) -> float
+    { return std::abs(mOutput[static_cast<size_t>(frame)*2]); };
+
+    for(ALint64SOFT i{0};i < RaiseOffset;++i)
+        ASSERT_EQ(frame_level(i), 0.0f) << "Frame " << i;
+    EXPECT_GT(frame_level(RaiseOffset+1), 0.0f);
+    /* Gain changes fade in over 64 samples, after which the level should be
+     * that of the last event scheduled for the time.
+     */
+    const float level{frame_level(RaiseOffset+64)};
+    const float halflevel{level * 0.5f};
+    EXPECT_GT(level, 0.0f);
+    for(ALint64SOFT i{RaiseOffset+64};i < LowerOffset;++i)
+        ASSERT_NEAR(frame_level(i), level, 1e-6f) << "Frame " << i;
+    EXPECT_GT(frame_level(LowerOffset-1), halflevel);
+    EXPECT_LT(frame_level(LowerOffset+1), level);
+    for(ALint64SOFT i{LowerOffset+64};i < RenderSize;++i)
+        ASSERT_EQ(frame_level(i), 0.0f) << "Frame " << i;
+
+    /* Compare with the level of a normal update to full gain. */
+    alSourcef(mSource, AL_GAIN, 1.0f);
+    render(2);
+    EXPECT_NEAR(frame_level(RenderSize-1), level, 1e-6f);
+
+    alSourceStop(mSource);
+    EXPECT_EQ(alGetError(), AL_NO_ERROR);
+    EXPECT_EQ(gRealtimeErrors.load(), 0);
+}
+
+TEST_F(LoopbackTest, PlaybackSnapshot)
+{
+    using GetSourcePlaybackvFunc = void(AL_APIENTRY*)(ALsizei n, const ALuint *sources,
+        ALint *states, ALint64SOFT *offsets, ALint *processed) noexcept;
+    auto get_source_playbackv = reinterpret_cast<GetSourcePlaybackvFunc>(
+        alGetProcAddress("alGetSourcePlaybackvSOFT"));
+    ASSERT_NE(get_source_playbackv, nullptr);
+
+    std::array<ALuint,3> sources{};
+    alGenSources(2, sources.data());
+    sources[2] = mSource;
+    for(size_t i{0};i < 2;++i)
+    {
+        alSourcei(sources[i], AL_BUFFER, static_cast<ALint>(mBuffer));
+        alSourcei(sources[i], AL_LOOPING, AL_TRUE);
+    }
+    ASSERT_EQ(alGetError(), AL_NO_ERROR);
+
+    std::array<ALint,3> states{};
+    std::array<ALint64SOFT,3> offsets{};
+    std::array<ALint,3> processed{};
+    get_source_playbackv(3, sources.data(), states.data(), offsets.data(), processed.data());
+    ASSERT_EQ(alGetError(), AL_NO_ERROR);
+    for(size_t i{0};i < sources.size();++i)
+    {
+        EXPECT_EQ(states[i], AL_INITIAL);
+        EXPECT_EQ(offsets[i], 0);
+        EXPECT_EQ(processed[i], 0);
+    }
+
+    /* Sources started together report the same position in one snapshot,
+     * and each matches the individual queries.
+     */
+    alSourcePlayv(2, sources.data());
+    for(int i{1};i <= 4;++i)
+    {
+        render(1);
+        get_source_playbackv(3, sources.data(), states.data(), offsets.data(), processed.data());
+        ASSERT_EQ(alGetError(), AL_NO_ERROR);
+
+        const ALint64SOFT expected{ALint64SOFT{i*RenderSize} << 32};
+        for(size_t j{0};j < 2;++j)
+        {
+            EXPECT_EQ(states[j], AL_PLAYING);
+            EXPECT_EQ(offsets[j], expected);
+            EXPECT_EQ(processed[j], 0);
+
+            ALint state{}, offset{};
+            alGetSourcei(sources[j], AL_SOURCE_STATE, &state);
+            alGetSourcei(sources[j], AL_SAMPLE_OFFSET, &offset);
+            EXPECT_EQ(states[j], state);
+            EXPECT_EQ(offsets[j]>>32, offset);
+        }
+        EXPECT_EQ(states[2], AL_INITIAL);
+        EXPECT_EQ(offsets[2], 0);
+    }
+
+    /* Each output array is optional. */
+    alSourcePause(sources[0]);
+    render(1);
+    std::array<ALint,3> states2{};
+    get_source_playbackv(3, sources.data(), states2.data(), nullptr, nullptr);
+    EXPECT_EQ(states2[0], AL_PAUSED);
+    EXPECT_EQ(states2[1], AL_PLAYING);
+    EXPECT_EQ(alGetError(), AL_NO_ERROR);
+
+    /* An invalid source name fails the whole call, leaving the outputs. */
+    states2.fill(-1);
+    const std::array<ALuint,2> badsources{sources[0], 0xdeadbeef};
+    get_source_playbackv(2, badsources.data(), states2.data(), nullptr, nullptr);
+    EXPECT_EQ(alGetError(), AL_INVALID_NAME);
+    EXPECT_EQ(states2[0], -1);
+    get_source_playbackv(-1, sources.data(), states2.data(), nullptr, nullptr);
+    EXPECT_EQ(alGetError(), AL_INVALID_VALUE);
+
+    alSourceStopv(2, sources.data());
+    alDeleteSources(2, sources.data());
+    EXPECT_EQ(alGetError(), AL_NO_ERROR);
+    EXPECT_EQ(gRealtimeErrors.load(), 0);
+}
+
+TEST_F(LoopbackTest, PlaybackSnapshotStreaming)
+{
+    using GetSourcePlaybackvFunc = void(AL_APIENTRY*)(ALsizei n, const ALuint *sources,
+        ALint *states, ALint64SOFT *offsets, ALint *processed) noexcept;
+    auto get_source_playbackv = reinterpret_cast<GetSourcePlaybackvFunc>(
+        alGetProcAddress("alGetSourcePlaybackvSOFT"));
+    ASSERT_NE(get_source_playbackv, nullptr);
+
+    std::array<ALuint,3> buffers{};
+    alGenBuffers(static_cast<ALsizei>(buffers.size()), buffers.data());
+    const std::vector<short> data(RenderSize/2, 0);
+    for(ALuint buffer : buffers)
+        alBufferData(buffer, AL_FORMAT_MONO16, data.data(),
+            static_cast<ALsizei>(data.size()*sizeof(short)), SampleRate);
+
+    alSourcei(mSource, AL_BUFFER, 0);
+    alSourcei(mSource, AL_LOOPING, AL_FALSE);
+    alSourceQueueBuffers(mSource, static_cast<ALsizei>(buffers.size()), buffers.data());
+    alSourcePlay(mSource);
+    render(1);
+    ASSERT_EQ(alGetError(), AL_NO_ERROR);
+
+    /* The processed count and offset match the individual queries, including
+     * after unqueueing buffers changes the queue head.
+     */
+    for(int i{0};i < 2;++i)
+    {
+        ALint state{}, processed{};
+        ALint64SOFT offset64{};
+        get_source_playbackv(1, &mSource, &state, &offset64, &processed);
+        ASSERT_EQ(alGetError(), AL_NO_ERROR);
+        EXPECT_GT(processed, 0);
+
+        ALint state2{}, processed2{}, offset2{};
+        alGetSourcei(mSource, AL_SOURCE_STATE, &state2);
+        alGetSourcei(mSource, AL_BUFFERS_PROCESSED, &processed2);
+        alGetSourcei(mSource, AL_SAMPLE_OFFSET, &offset2);
+        EXPECT_EQ(state, state2);
+        EXPECT_EQ(processed, processed2);
+        EXPECT_EQ(offset64>>32, offset2);
+
+        std::array<ALuint,3> unqueued{};
+        alSourceUnqueueBuffers(mSource, processed, unqueued.data());
+        ASSERT_EQ(alGetError(), AL_NO_ERROR);
+        render(1);
+    }
+
+    alSourceStop(mSource);
+    alSourcei(mSource, AL_BUFFER, 0);
+    alDeleteBuffers(static_cast<ALsizei>(buffers.size()), buffers.data());
+    EXPECT_EQ(alGetError(), AL_NO_ERROR);
+}
+
+TEST_F(LoopbackTest, ListenerMotion)
+{
+    using ListenerMotionfvFunc = void(AL_APIENTRY*)(ALint64SOFT pose_time, const ALfloat *values)
+        noexcept;
+    auto listener_motionfv = reinterpret_cast<ListenerMotionfvFunc>(
+        alGetProcAddress("alListenerMotionfvSOFT"));
+    ASSERT_NE(listener_motionfv, nullptr);
+
+    /* Returns the output energy of the left channel relative to the right,
+     * for the last update.
+     */
+    const auto left_balance = [this]() -> double
+    {
+        double left{0.0}, right{0.0};
+        for(size_t i{0};i < mOutput.size();i+=2)
+        {
+            left += mOutput[i]*mOutput[i];
+            right += mOutput[i+1]*mOutput[i+1];
+        }
+        return left / std::max(right, 1e-12);
+    };
+
+    /* The source is on the left of the default listener. */
+    alSource3f(mSource, AL_POSITION, -1.0f, 0.0f, 0.0f);
+    alSourcePlay(mSource);
+    render(8);
+    EXPECT_GT(left_balance(), 2.0);
+
+    /* Position, at, up, linear velocity, and angular velocity. */
+    using MotionValues = std::array<ALfloat,15>;
+    static constexpr MotionValues turned{0.5f, 0.0f, 0.25f, 0.0f, 0.0f, 1.0f, 0.0f, 1.0f, 0.0f,
+        0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f};
+    ALCint64SOFT clock{};
+    alcGetInteger64vSOFT(mDevice, ALC_DEVICE_CLOCK_SOFT, 1, &clock);
+    listener_motionfv(clock, turned.data());
+    ASSERT_EQ(alGetError(), AL_NO_ERROR);
+
+    std::array<ALfloat,3> position{};
+    std::array<ALfloat,6> orientation{};
+    alGetListenerfv(AL_POSITION, position.data());
+    alGetListenerfv(AL_ORIENTATION, orientation.data());
+    EXPECT_TRUE(std::equal(position.cbegin(), position.cend(), turned.cbegin()));
+    EXPECT_TRUE(std::equal(orientation.cbegin(), orientation.cend(), turned.cbegin()+3));
+
+    /* Facing the other way, the source is on the right. */
+    render(2);
+    EXPECT_LT(left_balance(), 0.5);
+
+    /* Invalid values are rejected without changing the listener. */
+    MotionValues invalid{turned};
+    invalid[1] = std::numeric_limits<float>::quiet_NaN();
+    listener_motionfv(clock, invalid.data());
+    EXPECT_EQ(alGetError(), AL_INVALID_VALUE);
+    listener_motionfv(-1, turned.data());
+    EXPECT_EQ(alGetError(), AL_INVALID_VALUE);
+    listener_motionfv(clock, nullptr);
+    EXPECT_EQ(alGetError(), AL_INVALID_VALUE);
+    alGetListenerfv(AL_POSITION, position.data());
+    EXPECT_TRUE(std::equal(position.cbegin(), position.cend(), turned.cbegin()));
+
+    /* A pose from long ago is predicted forward by the velocities, up to a
+     * limit. Spinning half a turn over that time faces the listener away from
+     * the source again, and moving past the source puts it on the other side.
+     */
+    static constexpr MotionValues spinning{0.0f, 0.0f, 0.0f, 0.0f, 0.0f, -1.0f, 0.0f, 1.0f, 0.0f,
+        0.0f, 0.0f, 0.0f, 0.0f, 31.41592654f, 0.0f};
+    listener_motionfv(0, spinning.data());
+    render(2);
+    EXPECT_LT(left_balance(), 0.5);
+
+    static constexpr MotionValues moving{0.0f, 0.0f, 0.0f, 0.0f, 0.0f, -1.0f, 0.0f, 1.0f, 0.0f,
+        -20.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f};
+    listener_motionfv(0, moving.data());
+    render(2);
+    EXPECT_LT(left_balance(), 0.5);
+
+    /* A normal listener update stops the prediction. */
+    alListener3f(AL_POSITION, 0.0f, 0.0f, 0.0f);
+    alListenerfv(AL_ORIENTATION, spinning.data()+3);
+    render(2);
+    EXPECT_GT(left_balance(), 2.0);
+
+    EXPECT_EQ(alGetError(), AL_NO_ERROR);
+    EXPECT_EQ(gRealtimeErrors.load(), 0);
+}
+
+TEST_F(LoopbackTest, ConvolutionRebind)
+{
+    /* From the in-progress convolution effect extension. */
+    static constexpr ALenum EffectConvolution{0xA000};
+
+    ALuint slot{};
+    alGenAuxiliaryEffectSlots(1, &slot);
+    ALuint effect{};
+    alGenEffects(1, &effect);
+    alEffecti(effect, AL_EFFECT_TYPE, EffectConvolution);
+    alAuxiliaryEffectSloti(slot, AL_EFFECTSLOT_EFFECT, static_cast<ALint>(effect));
+    ASSERT_EQ(alGetError(), AL_NO_ERROR);
+
+    /* Rapidly bind a number of different impulse responses. Loopback devices
+     * prepare each one when it's bound, so the last one is ready to play.
+     */
+    std::array<ALuint,8> irs{};
+    alGenBuffers(static_cast<ALsizei>(irs.size()), irs.data());
+    std::vector<float> irdata(SampleRate/2);
+    for(size_t b{0};b < irs.size();++b)
+    {
+        for(size_t i{0};i < irdata.size();++i)
+            irdata[i] = std::exp(-static_cast<float>(i)/2000.0f)
+                * ((((i*(b+3))>>2)&1) ? 0.1f : -0.1f);
+        alBufferData(irs[b], AL_FORMAT_MONO_FLOAT32, irdata.data(),
+            static_cast<ALsizei>(irdata.size()*sizeof(float)), SampleRate);
+        alAuxiliaryEffectSloti(slot, AL_BUFFER, static_cast<ALint>(irs[b]));
+    }
+    ASSERT_EQ(alGetError(), AL_NO_ERROR);
+
+    /* Only send the source to the effect, so any output is from it. */
+    ALuint filter{};
+    alGenFilters(1, &filter);
+    alFilteri(filter, AL_FILTER_TYPE, AL_FILTER_LOWPASS);
+    alFilterf(filter, AL_LOWPASS_GAIN, 0.0f);
+    alSourcei(mSource, AL_DIRECT_FILTER, static_cast<ALint>(filter));
+    alSource3i(mSource, AL_AUXILIARY_SEND_FILTER, static_cast<ALint>(slot), 0, AL_FILTER_NULL);
+    alSourcePlay(mSource);
+
+    render(1);
+    EXPECT_TRUE(std::any_of(mOutput.cbegin(), mOutput.cend(),
+        [](float f) noexcept { return std::abs(f) > 1e-4f; }));
+
+    /* Rebinding an earlier impulse response finds its filter in the cache. */
+    alAuxiliaryEffectSloti(slot, AL_BUFFER, static_cast<ALint>(irs[0]));
+    render(1);
+    EXPECT_TRUE(std::any_of(mOutput.cbegin(), mOutput.cend(),
+        [](float f) noexcept { return std::abs(f) > 1e-4f; }));
+
+    alSourceStop(mSource);
+    alSource3i(mSource, AL_AUXILIARY_SEND_FILTER, AL_EFFECTSLOT_NULL, 0, AL_FILTER_NULL);
+    alSourcei(mSource, AL_DIRECT_FILTER, AL_FILTER_NULL);
+    alDeleteFilters(1, &filter);
+    alDeleteAuxiliaryEffectSlots(1, &slot);
+    alDeleteEffects(1, &effect);
+    alDeleteBuffers(static_cast<ALsizei>(irs.size()), irs.data());
+
+    EXPECT_EQ(alGetError(), AL_NO_ERROR);
+    EXPECT_EQ(gRealtimeErrors.load(), 0);
+}
+
+TEST_F(LoopbackTest, RecycledEffectState)
+{
+    ALuint echo{};
+    alGenEffects(1, &echo);
+    alEffecti(echo, AL_EFFECT_TYPE, AL_EFFECT_ECHO);
+    alEffectf(echo, AL_ECHO_DELAY, 0.01f);
+    alEffectf(echo, AL_ECHO_LRDELAY, 0.01f);
+    alEffectf(echo, AL_ECHO_DAMPING, 0.9f);
+    alEffectf(echo, AL_ECHO_FEEDBACK, 0.9f);
+    ALuint reverb{};
+    alGenEffects(1, &reverb);
+    alEffecti(reverb, AL_EFFECT_TYPE, AL_EFFECT_REVERB);
+
+    ALuint filter{};
+    alGenFilters(1, &filter);
+    alFilteri(filter, AL_FILTER_TYPE, AL_FILTER_LOWPASS);
+    alFilterf(filter, AL_LOWPASS_GAIN, 0.0f);
+    alSourcei(mSource, AL_DIRECT_FILTER, static_cast<ALint>(filter));
+    alSourcei(mSource, AL_LOOPING, AL_FALSE);
+
+    std::array<ALuint,2> slots{};
+    alGenAuxiliaryEffectSlots(static_cast<ALsizei>(slots.size()), slots.data());
+    ASSERT_EQ(alGetError(), AL_NO_ERROR);
+
+    /* Plays the source from the start through only the given slot, returning
+     * what the effect outputs.
+     */
+    auto render_through = [this](const ALuint slot)
+    {
+        alSource3i(mSource, AL_AUXILIARY_SEND_FILTER, static_cast<ALint>(slot), 0,
+            AL_FILTER_NULL);
+        alSourceRewind(mSource);
+        alSourcePlay(mSource);
+        std::vector<float> output;
+        for(int i{0};i < 8;++i)
+        {
+            render(1);
+            output.insert(output.end(), mOutput.cbegin(), mOutput.cend());
+        }
+        alSourceStop(mSource);
+        return output;
+    };
+
+    /* Run the echo until its feedback filter has history, then switch the
+     * slot to reverb so the echo state is given back to the pool. Releasing
+     * happens on the event thread, so give it a moment.
+     */
+    alAuxiliaryEffectSloti(slots[0], AL_EFFECTSLOT_EFFECT, static_cast<ALint>(echo));
+    render_through(slots[0]);
+    alAuxiliaryEffectSloti(slots[0], AL_EFFECTSLOT_EFFECT, static_cast<ALint>(reverb));
+    render(1);
+    std::this_thread::sleep_for(std::chrono::milliseconds{100});
+
+    /* Switching back reuses the old echo state, which needs to sound the same
+     * as a new one.
+     */
+    alAuxiliaryEffectSloti(slots[0], AL_EFFECTSLOT_EFFECT, static_cast<ALint>(echo));
+    const auto recycled = render_through(slots[0]);
+    alAuxiliaryEffectSloti(slots[0], AL_EFFECTSLOT_EFFECT, AL_EFFECT_NULL);
+
+    alAuxiliaryEffectSloti(slots[1], AL_EFFECTSLOT_EFFECT, static_cast<ALint>(echo));
+    const auto fresh = render_through(slots[1]);
+    ASSERT_EQ(alGetError(), AL_NO_ERROR);
+
+    ASSERT_EQ(recycled.size(), fresh.size());
+    EXPECT_TRUE(std::any_of(fresh.cbegin(), fresh.cend(),
+        [](float f) noexcept { return std::abs(f) > 1e-4f; }));
+    float maxdiff{0.0f};
+    for(size_t i{0};i < fresh.size();++i)
+        maxdiff = std::max(maxdiff, std::abs(recycled[i] - fresh[i]));
+    EXPECT_LE(maxdiff, 1e-6f);
+
+    alSource3i(mSource, AL_AUXILIARY_SEND_FILTER, AL_EFFECTSLOT_NULL, 0, AL_FILTER_NULL);
+    alSourcei(mSource, AL_DIRECT_FILTER, AL_FILTER_NULL);
+    alDeleteAuxiliaryEffectSlots(static_cast<ALsizei>(slots.size()), slots.data());
+    alDeleteFilters(1, &filter);
+    alDeleteEffects(1, &reverb);
+    alDeleteEffects(1, &echo);
+
+    EXPECT_EQ(alGetError(), AL_NO_ERROR);
+    EXPECT_EQ(gRealtimeErrors.load(), 0);
+}
+
+TEST_F(LoopbackTest, DeferredDeletes)
+{
+    /* Deleting sources and effect slots with deferred property changes takes
+     * them out of the middle of the context's dirty lists.
+     */
+    std::array<ALuint,16> sources{};
+    alGenSources(static_cast<ALsizei>(sources.size()), sources.data());
+    std::array<ALuint,8> slots{};
+    alGenAuxiliaryEffectSlots(static_cast<ALsizei>(slots.size()), slots.data());
+    ASSERT_EQ(alGetError(), AL_NO_ERROR);
+
+    alDeferUpdatesSOFT();
+    for(const ALuint source : sources)
+        alSourcef(source, AL_GAIN, 0.5f);
+    for(const ALuint slot : slots)
+        alAuxiliaryEffectSlotf(slot, AL_EFFECTSLOT_GAIN, 0.5f);
+
+    for(size_t i{1};i < sources.size();i += 2)
+        alDeleteSources(1, &sources[i]);
+    for(size_t i{0};i < slots.size();i += 3)
+        alDeleteAuxiliaryEffectSlots(1, &slots[i]);
+    alSourcef(sources[0], AL_PITCH, 1.5f);
+    alProcessUpdatesSOFT();
+    render(1);
+    ASSERT_EQ(alGetError(), AL_NO_ERROR);
+
+    for(size_t i{0};i < sources.size();i += 2)
+        alDeleteSources(1, &sources[i]);
+    for(size_t i{0};i < slots.size();++i)
+    {
+        if((i%3) != 0)
+            alDeleteAuxiliaryEffectSlots(1, &slots[i]);
+    }
+    render(1);
+
+    EXPECT_EQ(alGetError(), AL_NO_ERROR);
+    EXPECT_EQ(gRealtimeErrors.load(), 0);
+}
+
+TEST_F(LoopbackTest, LimiterModes)
+{
+    /* A quiet tone with short bursts well over full scale, so the limiter has
+     * to attack, hold, and release a few times.
+     */
+    std::vector<float> signal(SampleRate/2);
+    for(size_t i{0};i < signal.size();++i)
+    {
+        const float amp{(i%4800) < 480 ? 4.0f : 0.25f};
+        signal[i] = static_cast<float>(std::sin(static_cast<double>(i) * 1000.0
+            * 6.283185307179586 / SampleRate)) * amp;
+    }
+    ALuint buffer{};
+    alGenBuffers(1, &buffer);
+    alBufferData(buffer, AL_FORMAT_MONO_FLOAT32, signal.data(),
+        static_cast<ALsizei>(signal.size()*sizeof(float)), SampleRate);
+    alSourcei(mSource, AL_BUFFER, static_cast<ALint>(buffer));
+    alSourcei(mSource, AL_LOOPING, AL_FALSE);
+    alSource3f(mSource, AL_POSITION, 0.0f, 0.0f, -1.0f);
+    ASSERT_EQ(alGetError(), AL_NO_ERROR);
+
+    /* Resets the device with the limiter in the given mode, and returns the
+     * whole rendered signal.
+     */
+    auto render_with = [this](const char *mode)
+    {
+#ifdef _WIN32
+        _putenv_s("__ALSOFT_LIMITER_MODE", mode);
+#else
+        setenv("__ALSOFT_LIMITER_MODE", mode, 1);
+#endif
+        const std::array<ALCint,9> attrs{ALC_FORMAT_CHANNELS_SOFT, ALC_STEREO_SOFT,
+            ALC_FORMAT_TYPE_SOFT, ALC_FLOAT_SOFT, ALC_FREQUENCY, SampleRate,
+            ALC_OUTPUT_LIMITER_SOFT, ALC_TRUE, 0};
+        EXPECT_TRUE(alcResetDeviceSOFT(mDevice, attrs.data()));
+
+        alSourceRewind(mSource);
+        alSourcePlay(mSource);
+        std::vector<float> output;
+        for(int i{0};i < 28;++i)
+        {
+            render(1);
+            output.insert(output.end(), mOutput.cbegin(), mOutput.cend());
+        }
+        alSourceStop(mSource);
+        return output;
+    };
+    const auto reference = render_with("reference");
+    const auto block = render_with("block");
+#ifdef _WIN32
+    _putenv_s("__ALSOFT_LIMITER_MODE", "");
+#else
+    unsetenv("__ALSOFT_LIMITER_MODE");
+#endif
+    ASSERT_EQ(alGetError(), AL_NO_ERROR);
+
+    /* The bursts need to have been limited to full scale, while still being
+     * louder than the tone.
+     */
+    float peak{0.0f};
+    for(const float f : reference)
+        peak = std::max(peak, std::abs(f));
+    EXPECT_GT(peak, 0.5f);
+    EXPECT_LE(peak, 1.0f);
+
+    /* The block path is meant to match the reference exactly, but leave room
+     * for the compiler to contract or reorder float math differently in the
+     * two paths: well under one step of 24-bit output.
+     */
+    static constexpr float Tolerance{1e-7f};
+    ASSERT_EQ(reference.size(), block.size());
+    float maxdiff{0.0f};
+    for(size_t i{0};i < reference.size();++i)
+        maxdiff = std::max(maxdiff, std::abs(reference[i] - block[i]));
+    EXPECT_LE(maxdiff, Tolerance);
+
+    alSourcei(mSource, AL_BUFFER, static_cast<ALint>(mBuffer));
+    alDeleteBuffers(1, &buffer);
+
+    EXPECT_EQ(alGetError(), AL_NO_ERROR);
+    EXPECT_EQ(gRealtimeErrors.load(), 0);
+}
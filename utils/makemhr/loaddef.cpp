@@ -1734,17 +1734,14 @@ auto AverageHrirOnset(PPhaseResampler &rs, al::span<double> upsampled, const uin
 
 // Calculate the magnitude response of an HRIR and average it with any
 // existing responses for its field, elevation, azimuth, and ear.
-void AverageHrirMagnitude(const uint fftSize, const al::span<const double> hrir, const double f,
-    const al::span<double> mag)
+void AverageHrirMagnitude(HrirScratch &scratch, const uint fftSize,
+    const al::span<const double> hrir, const double f, const al::span<double> mag)
 {
     const uint m{1 + (fftSize/2)};
-    std::vector<complex_d> h(fftSize);
-    std::vector<double> r(m);
+    auto &r = scratch.mMags;
+    r.resize(m);
 
-    auto hiter = std::copy(hrir.cbegin(), hrir.cend(), h.begin());
-    std::fill(hiter, h.end(), 0.0);
-    forward_fft(h);
-    MagnitudeResponse(h, r);
+    MagnitudeResponse(RealFftForward(scratch, fftSize, hrir), r);
     for(uint i{0};i < m;++i)
         mag[i] = Lerp(mag[i], r[i], f);
 }
@@ -1756,6 +1753,7 @@ auto ProcessSources(TokenReaderT *tr, HrirDataT *hData, const uint outRate) -> i
     hData->mHrirsBase.resize(size_t{channels} * hData->mIrCount * hData->mIrSize);
     const auto hrirs = al::span<double>{hData->mHrirsBase};
     auto hrir = std::vector<double>(hData->mIrSize);
+    HrirScratch scratch;
     uint line, col, fi, ei, ai;
 
     std::vector<double> onsetSamples(size_t{OnsetRateMultiple} * hData->mIrPoints);
@@ -1882,8 +1880,8 @@ auto ProcessSources(TokenReaderT *tr, HrirDataT *hData, const uint outRate) -> i
                     hrirPoints, 1.0, azd->mDelays[0]);
                 if(resampler)
                     resampler->process(hrirPoints, hrir);
-                AverageHrirMagnitude(hData->mFftSize, al::span{hrir}.first(irPoints), 1.0,
-                    azd->mIrs[0]);
+                AverageHrirMagnitude(scratch, hData->mFftSize, al::span{hrir}.first(irPoints),
+                    1.0, azd->mIrs[0]);
 
                 if(src.mChannel == 1)
                 {
@@ -1894,8 +1892,8 @@ auto ProcessSources(TokenReaderT *tr, HrirDataT *hData, const uint outRate) -> i
                         hData->mIrRate, hrirPoints, 1.0, azd->mDelays[1]);
                     if(resampler)
                         resampler->process(hrirPoints, hrir);
-                    AverageHrirMagnitude(hData->mFftSize, al::span{hrir}.first(irPoints), 1.0,
-                        azd->mIrs[1]);
+                    AverageHrirMagnitude(scratch, hData->mFftSize,
+                        al::span{hrir}.first(irPoints), 1.0, azd->mIrs[1]);
                 }
 
                 // TODO: Since some SOFA files contain minimum phase HRIRs,
@@ -1956,8 +1954,8 @@ auto ProcessSources(TokenReaderT *tr, HrirDataT *hData, const uint outRate) -> i
                 hrirPoints, 1.0/factor[ti], azd->mDelays[ti]);
             if(resampler)
                 resampler->process(hrirPoints, hrir);
-            AverageHrirMagnitude(hData->mFftSize, al::span{hrir}.first(irPoints), 1.0/factor[ti],
-                azd->mIrs[ti]);
+            AverageHrirMagnitude(scratch, hData->mFftSize, al::span{hrir}.first(irPoints),
+                1.0/factor[ti], azd->mIrs[ti]);
             factor[ti] += 1.0;
             if(!TrIsOperator(tr, "+"))
                 break;
@@ -24,19 +24,14 @@
 #include "loadsofa.h"
 
 #include <algorithm>
-#include <atomic>
-#include <chrono>
 #include <cmath>
 #include <cstdio>
-#include <functional>
-#include <future>
 #include <iterator>
 #include <memory>
 #include <numeric>
 #include <optional>
 #include <string>
 #include <string_view>
-#include <thread>
 #include <vector>
 
 #include "alspan.h"
@@ -236,7 +231,7 @@ bool CheckIrData(MYSOFA_HRTF *sofaHrtf)
 
 /* Calculate the onset time of a HRIR. */
 constexpr int OnsetRateMultiple{10};
-auto CalcHrirOnset(PPhaseResampler &rs, const uint rate, al::span<double> upsampled,
+auto CalcHrirOnset(const PPhaseResampler &rs, const uint rate, al::span<double> upsampled,
     const al::span<const double> hrir) -> double
 {
     rs.process(hrir, upsampled);
@@ -249,173 +244,128 @@ auto CalcHrirOnset(PPhaseResampler &rs, const uint rate, al::span<double> upsamp
 }
 
 /* Calculate the magnitude response of a HRIR. */
-void CalcHrirMagnitude(const uint points, al::span<complex_d> h, const al::span<double> hrir)
+void CalcHrirMagnitude(HrirScratch &scratch, const uint fftSize, const uint points,
+    const al::span<double> hrir)
 {
-    auto iter = std::copy_n(hrir.cbegin(), points, h.begin());
-    std::fill(iter, h.end(), complex_d{0.0, 0.0});
-
-    forward_fft(h);
-    MagnitudeResponse(h, hrir.first((h.size()/2) + 1));
+    const auto h = RealFftForward(scratch, fftSize, hrir.first(points));
+    MagnitudeResponse(h, hrir.first((fftSize/2) + 1));
 }
 
 bool LoadResponses(MYSOFA_HRTF *sofaHrtf, HrirDataT *hData, const DelayType delayType,
-    const uint outRate)
+    const uint outRate, HrirThreadPool &pool)
 {
-    std::atomic<uint> loaded_count{0u};
+    const uint channels{(hData->mChannelType == CT_STEREO) ? 2u : 1u};
+    hData->mHrirsBase.resize(channels * size_t{hData->mIrCount} * hData->mIrSize, 0.0);
+    const auto hrirs = al::span{hData->mHrirsBase};
+
+    std::optional<PPhaseResampler> resampler;
+    if(outRate && outRate != hData->mIrRate)
+        resampler.emplace().init(hData->mIrRate, outRate);
 
-    auto load_proc = [sofaHrtf,hData,delayType,outRate,&loaded_count]() -> bool
+    /* Map each measurement to its HRIR first, then copy (and resample) the
+     * responses in parallel.
+     */
+    std::vector<std::pair<uint,HrirAzT*>> measurements;
+    measurements.reserve(sofaHrtf->M);
+
+    const auto srcPosValues = al::span{sofaHrtf->SourcePosition.values, sofaHrtf->M*3_uz};
+    for(uint si{0u};si < sofaHrtf->M;++si)
     {
-        const uint channels{(hData->mChannelType == CT_STEREO) ? 2u : 1u};
-        hData->mHrirsBase.resize(channels * size_t{hData->mIrCount} * hData->mIrSize, 0.0);
-        const auto hrirs = al::span{hData->mHrirsBase};
+        std::array aer{srcPosValues[3_uz*si], srcPosValues[3_uz*si + 1],
+            srcPosValues[3_uz*si + 2]};
+        mysofa_c2s(aer.data());
 
-        std::vector<double> restmp;
-        std::optional<PPhaseResampler> resampler;
-        if(outRate && outRate != hData->mIrRate)
+        if(std::abs(aer[1]) >= 89.999f)
+            aer[0] = 0.0f;
+        else
+            aer[0] = std::fmod(360.0f - aer[0], 360.0f);
+
+        auto field = std::find_if(hData->mFds.cbegin(), hData->mFds.cend(),
+            [&aer](const HrirFdT &fld) -> bool
+            { return (std::abs(aer[2] - fld.mDistance) < 0.001); });
+        if(field == hData->mFds.cend())
+            continue;
+
+        const double evscale{180.0 / static_cast<double>(field->mEvs.size()-1)};
+        double ef{(90.0 + aer[1]) / evscale};
+        auto ei = static_cast<uint>(std::round(ef));
+        ef = (ef - ei) * evscale;
+        if(std::abs(ef) >= 0.1) continue;
+
+        const double azscale{360.0 / static_cast<double>(field->mEvs[ei].mAzs.size())};
+        double af{aer[0] / azscale};
+        auto ai = static_cast<uint>(std::round(af));
+        af = (af-ai) * azscale;
+        ai %= static_cast<uint>(field->mEvs[ei].mAzs.size());
+        if(std::abs(af) >= 0.1) continue;
+
+        HrirAzT &azd = field->mEvs[ei].mAzs[ai];
+        if(!azd.mIrs[0].empty())
         {
-            resampler.emplace().init(hData->mIrRate, outRate);
-            restmp.resize(sofaHrtf->N);
+            fprintf(stderr, "Multiple measurements near [ a=%f, e=%f, r=%f ].\n",
+                aer[0], aer[1], aer[2]);
+            return false;
         }
 
-        const auto srcPosValues = al::span{sofaHrtf->SourcePosition.values, sofaHrtf->M*3_uz};
-        const auto irValues = al::span{sofaHrtf->DataIR.values,
-            size_t{sofaHrtf->M}*sofaHrtf->R*sofaHrtf->N};
-        for(uint si{0u};si < sofaHrtf->M;++si)
-        {
-            loaded_count.fetch_add(1u);
-
-            std::array aer{srcPosValues[3_uz*si], srcPosValues[3_uz*si + 1],
-                srcPosValues[3_uz*si + 2]};
-            mysofa_c2s(aer.data());
-
-            if(std::abs(aer[1]) >= 89.999f)
-                aer[0] = 0.0f;
-            else
-                aer[0] = std::fmod(360.0f - aer[0], 360.0f);
-
-            auto field = std::find_if(hData->mFds.cbegin(), hData->mFds.cend(),
-                [&aer](const HrirFdT &fld) -> bool
-                { return (std::abs(aer[2] - fld.mDistance) < 0.001); });
-            if(field == hData->mFds.cend())
-                continue;
-
-            const double evscale{180.0 / static_cast<double>(field->mEvs.size()-1)};
-            double ef{(90.0 + aer[1]) / evscale};
-            auto ei = static_cast<uint>(std::round(ef));
-            ef = (ef - ei) * evscale;
-            if(std::abs(ef) >= 0.1) continue;
-
-            const double azscale{360.0 / static_cast<double>(field->mEvs[ei].mAzs.size())};
-            double af{aer[0] / azscale};
-            auto ai = static_cast<uint>(std::round(af));
-            af = (af-ai) * azscale;
-            ai %= static_cast<uint>(field->mEvs[ei].mAzs.size());
-            if(std::abs(af) >= 0.1) continue;
-
-            HrirAzT &azd = field->mEvs[ei].mAzs[ai];
-            if(!azd.mIrs[0].empty())
-            {
-                fprintf(stderr, "\nMultiple measurements near [ a=%f, e=%f, r=%f ].\n",
-                    aer[0], aer[1], aer[2]);
-                return false;
-            }
+        for(uint ti{0u};ti < channels;++ti)
+            azd.mIrs[ti] = hrirs.subspan(
+                (size_t{hData->mIrCount}*ti + azd.mIndex) * hData->mIrSize, hData->mIrSize);
 
+        /* Include any per-channel or per-HRIR delays. */
+        if(delayType == DelayType::I_R)
+        {
+            const auto delayValues = al::span{sofaHrtf->DataDelay.values,
+                size_t{sofaHrtf->I}*sofaHrtf->R};
             for(uint ti{0u};ti < channels;++ti)
-            {
-                azd.mIrs[ti] = hrirs.subspan(
-                    (size_t{hData->mIrCount}*ti + azd.mIndex) * hData->mIrSize, hData->mIrSize);
-                const auto ir = irValues.subspan((size_t{si}*sofaHrtf->R + ti)*sofaHrtf->N,
-                    sofaHrtf->N);
-                if(!resampler)
-                    std::copy_n(ir.cbegin(), ir.size(), azd.mIrs[ti].begin());
-                else
-                {
-                    std::copy_n(ir.cbegin(), ir.size(), restmp.begin());
-                    resampler->process(restmp, azd.mIrs[ti]);
-                }
-            }
-
-            /* Include any per-channel or per-HRIR delays. */
-            if(delayType == DelayType::I_R)
-            {
-                const auto delayValues = al::span{sofaHrtf->DataDelay.values,
-                    size_t{sofaHrtf->I}*sofaHrtf->R};
-                for(uint ti{0u};ti < channels;++ti)
-                    azd.mDelays[ti] = delayValues[ti] / static_cast<float>(hData->mIrRate);
-            }
-            else if(delayType == DelayType::M_R)
-            {
-                const auto delayValues = al::span{sofaHrtf->DataDelay.values,
-                    size_t{sofaHrtf->M}*sofaHrtf->R};
-                for(uint ti{0u};ti < channels;++ti)
-                    azd.mDelays[ti] = delayValues[si*sofaHrtf->R + ti] /
-                        static_cast<float>(hData->mIrRate);
-            }
+                azd.mDelays[ti] = delayValues[ti] / static_cast<float>(hData->mIrRate);
         }
-
-        if(outRate && outRate != hData->mIrRate)
+        else if(delayType == DelayType::M_R)
         {
-            const double scale{static_cast<double>(outRate) / hData->mIrRate};
-            hData->mIrRate = outRate;
-            hData->mIrPoints = std::min(static_cast<uint>(std::ceil(hData->mIrPoints*scale)),
-                hData->mIrSize);
+            const auto delayValues = al::span{sofaHrtf->DataDelay.values,
+                size_t{sofaHrtf->M}*sofaHrtf->R};
+            for(uint ti{0u};ti < channels;++ti)
+                azd.mDelays[ti] = delayValues[si*sofaHrtf->R + ti] /
+                    static_cast<float>(hData->mIrRate);
         }
-        return true;
-    };
-
-    std::future_status load_status{};
-    auto load_future = std::async(std::launch::async, load_proc);
-    do {
-        load_status = load_future.wait_for(std::chrono::milliseconds{50});
-        printf("\rLoading HRIRs... %u of %u", loaded_count.load(), sofaHrtf->M);
-        fflush(stdout);
-    } while(load_status != std::future_status::ready);
-    fputc('\n', stdout);
-    return load_future.get();
-}
 
+        measurements.emplace_back(si, &azd);
+    }
 
-/* Calculates the frequency magnitudes of the HRIR set. Work is delegated to
- * this struct, which runs asynchronously on one or more threads (sharing the
- * same calculator object).
- */
-struct MagCalculator {
-    const uint mFftSize{};
-    const uint mIrPoints{};
-    std::vector<al::span<double>> mIrs{};
-    std::atomic<size_t> mCurrent{};
-    std::atomic<size_t> mDone{};
-
-    void Worker()
+    const auto irValues = al::span{sofaHrtf->DataIR.values,
+        size_t{sofaHrtf->M}*sofaHrtf->R*sofaHrtf->N};
+    pool.run(measurements.size(), [sofaHrtf,channels,irValues,&resampler,&measurements](
+        const size_t idx, HrirScratch &scratch)
     {
-        auto htemp = std::vector<complex_d>(mFftSize);
-
-        while(true)
+        const auto [si, azd] = measurements[idx];
+        for(uint ti{0u};ti < channels;++ti)
         {
-            /* Load the current index to process. */
-            size_t idx{mCurrent.load()};
-            do {
-                /* If the index is at the end, we're done. */
-                if(idx >= mIrs.size())
-                    return;
-                /* Otherwise, increment the current index atomically so other
-                 * threads know to go to the next one. If this call fails, the
-                 * current index was just changed by another thread and the new
-                 * value is loaded into idx, which we'll recheck.
-                 */
-            } while(!mCurrent.compare_exchange_weak(idx, idx+1, std::memory_order_relaxed));
-
-            CalcHrirMagnitude(mIrPoints, htemp, mIrs[idx]);
-
-            /* Increment the number of IRs done. */
-            mDone.fetch_add(1);
+            const auto ir = irValues.subspan((size_t{si}*sofaHrtf->R + ti)*sofaHrtf->N,
+                sofaHrtf->N);
+            if(!resampler)
+                std::copy_n(ir.cbegin(), ir.size(), azd->mIrs[ti].begin());
+            else
+            {
+                auto &restmp = scratch.mSamples;
+                restmp.resize(ir.size());
+                std::copy_n(ir.cbegin(), ir.size(), restmp.begin());
+                resampler->process(restmp, azd->mIrs[ti]);
+            }
         }
+    }, "Loading HRIRs... ");
+
+    if(outRate && outRate != hData->mIrRate)
+    {
+        const double scale{static_cast<double>(outRate) / hData->mIrRate};
+        hData->mIrRate = outRate;
+        hData->mIrPoints = std::min(static_cast<uint>(std::ceil(hData->mIrPoints*scale)),
+            hData->mIrSize);
     }
-};
+    return true;
+}
 
 } // namespace
 
-bool LoadSofaFile(const std::string_view filename, const uint numThreads, const uint fftSize,
+bool LoadSofaFile(const std::string_view filename, HrirThreadPool &pool, const uint fftSize,
     const uint truncSize, const uint outRate, const ChannelModeT chanMode, HrirDataT *hData)
 {
     int err;
@@ -482,7 +432,7 @@ bool LoadSofaFile(const std::string_view filename, const uint numThreads, const
         return false;
     if(!PrepareLayout(al::span{sofaHrtf->SourcePosition.values, sofaHrtf->M*3_uz}, hData))
         return false;
-    if(!LoadResponses(sofaHrtf.get(), hData, *delayType, outRate))
+    if(!LoadResponses(sofaHrtf.get(), hData, *delayType, outRate, pool))
         return false;
     sofaHrtf = nullptr;
 
@@ -521,9 +471,9 @@ bool LoadSofaFile(const std::string_view filename, const uint numThreads, const
     }
 
 
-    size_t hrir_total{0};
     const uint channels{(hData->mChannelType == CT_STEREO) ? 2u : 1u};
     const auto hrirs = al::span{hData->mHrirsBase};
+    std::vector<std::pair<HrirAzT*,uint>> measured;
     for(uint fi{0u};fi < hData->mFds.size();fi++)
     {
         for(uint ei{0u};ei < hData->mFds[fi].mEvStart;ei++)
@@ -537,79 +487,35 @@ bool LoadSofaFile(const std::string_view filename, const uint numThreads, const
             }
         }
 
-        for(uint ei{hData->mFds[fi].mEvStart};ei < hData->mFds[fi].mEvs.size();ei++)
-            hrir_total += hData->mFds[fi].mEvs[ei].mAzs.size() * channels;
-    }
-
-    std::atomic<size_t> hrir_done{0};
-    auto onset_proc = [hData,channels,&hrir_done]() -> bool
-    {
-        /* Temporary buffer used to calculate the IR's onset. */
-        auto upsampled = std::vector<double>(size_t{OnsetRateMultiple} * hData->mIrPoints);
-        /* This resampler is used to help detect the response onset. */
-        PPhaseResampler rs;
-        rs.init(hData->mIrRate, OnsetRateMultiple*hData->mIrRate);
-
-        for(auto &field : hData->mFds)
-        {
-            for(auto &elev : field.mEvs.subspan(field.mEvStart))
-            {
-                for(auto &azd : elev.mAzs)
-                {
-                    for(uint ti{0};ti < channels;ti++)
-                    {
-                        hrir_done.fetch_add(1u, std::memory_order_acq_rel);
-                        azd.mDelays[ti] += CalcHrirOnset(rs, hData->mIrRate, upsampled,
-                            azd.mIrs[ti].first(hData->mIrPoints));
-                    }
-                }
-            }
-        }
-        return true;
-    };
-
-    std::future_status load_status{};
-    auto load_future = std::async(std::launch::async, onset_proc);
-    do {
-        load_status = load_future.wait_for(std::chrono::milliseconds{50});
-        printf("\rCalculating HRIR onsets... %zu of %zu", hrir_done.load(), hrir_total);
-        fflush(stdout);
-    } while(load_status != std::future_status::ready);
-    fputc('\n', stdout);
-    if(!load_future.get())
-        return false;
-
-    MagCalculator calculator{hData->mFftSize, hData->mIrPoints};
-    for(auto &field : hData->mFds)
-    {
-        for(auto &elev : field.mEvs.subspan(field.mEvStart))
+        for(auto &elev : hData->mFds[fi].mEvs.subspan(hData->mFds[fi].mEvStart))
         {
             for(auto &azd : elev.mAzs)
             {
                 for(uint ti{0};ti < channels;ti++)
-                    calculator.mIrs.push_back(azd.mIrs[ti]);
+                    measured.emplace_back(&azd, ti);
             }
         }
     }
 
-    std::vector<std::thread> thrds;
-    thrds.reserve(numThreads);
-    for(size_t i{0};i < numThreads;++i)
-        thrds.emplace_back(std::mem_fn(&MagCalculator::Worker), &calculator);
-    size_t count;
-    do {
-        std::this_thread::sleep_for(std::chrono::milliseconds{50});
-        count = calculator.mDone.load();
-
-        printf("\rCalculating HRIR magnitudes... %zu of %zu", count, calculator.mIrs.size());
-        fflush(stdout);
-    } while(count != calculator.mIrs.size());
-    fputc('\n', stdout);
-
-    for(auto &thrd : thrds)
+    /* This resampler is used to help detect the response onset. */
+    PPhaseResampler rs;
+    rs.init(hData->mIrRate, OnsetRateMultiple*hData->mIrRate);
+    pool.run(measured.size(), [hData,&rs,&measured](const size_t idx, HrirScratch &scratch)
     {
-        if(thrd.joinable())
-            thrd.join();
-    }
+        /* Temporary buffer used to calculate the IR's onset. */
+        auto &upsampled = scratch.mSamples;
+        upsampled.resize(size_t{OnsetRateMultiple} * hData->mIrPoints);
+
+        const auto [azd, ti] = measured[idx];
+        azd->mDelays[ti] += CalcHrirOnset(rs, hData->mIrRate, upsampled,
+            azd->mIrs[ti].first(hData->mIrPoints));
+    }, "Calculating HRIR onsets... ");
+
+    pool.run(measured.size(), [hData,&measured](const size_t idx, HrirScratch &scratch)
+    {
+        const auto [azd, ti] = measured[idx];
+        CalcHrirMagnitude(scratch, hData->mFftSize, hData->mIrPoints, azd->mIrs[ti]);
+    }, "Calculating HRIR magnitudes... ");
+
     return true;
 }
@@ -6,7 +6,7 @@
 #include "makemhr.h"
 
 
-bool LoadSofaFile(const std::string_view filename, const uint numThreads, const uint fftSize,
+bool LoadSofaFile(const std::string_view filename, HrirThreadPool &pool, const uint fftSize,
     const uint truncSize, const uint outRate, const ChannelModeT chanMode, HrirDataT *hData);
 
 #endif /* LOADSOFA_H */
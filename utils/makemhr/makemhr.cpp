@@ -502,7 +502,7 @@ void CalculateDfWeights(const HrirDataT *hData, const al::span<double> weights)
  * specified magnitude range (in positive dB; 0.0 to skip).
  */
 void CalculateDiffuseFieldAverage(const HrirDataT *hData, const uint channels, const uint m,
-    const bool weighted, const double limit, const al::span<double> dfa)
+    const bool weighted, const double limit, const al::span<double> dfa, HrirThreadPool &pool)
 {
     std::vector<double> weights(hData->mFds.size() * MAX_EV_COUNT);
     uint count;
@@ -532,26 +532,37 @@ void CalculateDiffuseFieldAverage(const HrirDataT *hData, const uint channels, c
                 weights[(fi * MAX_EV_COUNT) + ei] = weight;
         }
     }
-    for(size_t ti{0};ti < channels;++ti)
+    // Sum the weighted power averages in blocks of frequency bins, which are
+    // processed in parallel. Each block adds the HRIRs in the same order, so
+    // the result doesn't depend on the number of threads.
+    static constexpr size_t BinsPerBlock{1024};
+    const size_t numBlocks{(m + BinsPerBlock - 1) / BinsPerBlock};
+    pool.run(channels * numBlocks, [hData,m,dfa,numBlocks,&weights](const size_t idx, HrirScratch&)
     {
-        for(size_t i{0};i < m;++i)
-            dfa[(ti * m) + i] = 0.0;
+        const size_t ti{idx / numBlocks};
+        const size_t start{(idx%numBlocks) * BinsPerBlock};
+        const auto total = dfa.subspan(ti*m + start, std::min(BinsPerBlock, m-start));
+
+        std::fill(total.begin(), total.end(), 0.0);
         for(size_t fi{0};fi < hData->mFds.size();++fi)
         {
             for(size_t ei{hData->mFds[fi].mEvStart};ei < hData->mFds[fi].mEvs.size();++ei)
             {
-                for(size_t ai{0};ai < hData->mFds[fi].mEvs[ei].mAzs.size();++ai)
+                // Get the weight for this elevation's HRIR contributions.
+                const double weight{weights[(fi * MAX_EV_COUNT) + ei]};
+                for(const auto &azd : hData->mFds[fi].mEvs[ei].mAzs)
                 {
-                    HrirAzT *azd = &hData->mFds[fi].mEvs[ei].mAzs[ai];
-                    // Get the weight for this HRIR's contribution.
-                    double weight = weights[(fi * MAX_EV_COUNT) + ei];
-
                     // Add this HRIR's weighted power average to the total.
-                    for(size_t i{0};i < m;++i)
-                        dfa[(ti * m) + i] += weight * azd->mIrs[ti][i] * azd->mIrs[ti][i];
+                    const auto ir = azd.mIrs[ti].subspan(start, total.size());
+                    for(size_t i{0};i < total.size();++i)
+                        total[i] += weight * ir[i] * ir[i];
                 }
             }
         }
+    });
+
+    for(size_t ti{0};ti < channels;++ti)
+    {
         // Finish the average calculation and keep it from being too small.
         for(size_t i{0};i < m;++i)
             dfa[(ti * m) + i] = std::max(sqrt(dfa[(ti * m) + i]), Epsilon);
@@ -565,22 +576,27 @@ void CalculateDiffuseFieldAverage(const HrirDataT *hData, const uint channels, c
 // Perform diffuse-field equalization on the magnitude responses of the HRIR
 // set using the given average response.
 void DiffuseFieldEqualize(const uint channels, const uint m, const al::span<const double> dfa,
-    const HrirDataT *hData)
+    const HrirDataT *hData, HrirThreadPool &pool)
 {
-    for(size_t fi{0};fi < hData->mFds.size();++fi)
+    std::vector<const HrirAzT*> azds;
+    for(const auto &field : hData->mFds)
     {
-        for(size_t ei{hData->mFds[fi].mEvStart};ei < hData->mFds[fi].mEvs.size();++ei)
+        for(const auto &elev : field.mEvs.subspan(field.mEvStart))
         {
-            for(auto &azd : hData->mFds[fi].mEvs[ei].mAzs)
-            {
-                for(size_t ti{0};ti < channels;++ti)
-                {
-                    for(size_t i{0};i < m;++i)
-                        azd.mIrs[ti][i] /= dfa[(ti * m) + i];
-                }
-            }
+            for(const auto &azd : elev.mAzs)
+                azds.emplace_back(&azd);
         }
     }
+
+    pool.run(azds.size(), [channels,m,dfa,&azds](const size_t idx, HrirScratch&)
+    {
+        for(size_t ti{0};ti < channels;++ti)
+        {
+            const auto ir = azds[idx]->mIrs[ti];
+            for(size_t i{0};i < m;++i)
+                ir[i] /= dfa[(ti * m) + i];
+        }
+    });
 }
 
 /* Given field and elevation indices and an azimuth, calculate the indices of
@@ -603,7 +619,7 @@ void CalcAzIndices(const HrirFdT &field, const uint ei, const double az, uint *a
  * This just mirrors some top elevations for the bottom, and blends the
  * remaining elevations (not an accurate model).
  */
-void SynthesizeOnsets(HrirDataT *hData)
+void SynthesizeOnsets(HrirDataT *hData, HrirThreadPool &pool)
 {
     const uint channels{(hData->mChannelType == CT_STEREO) ? 2u : 1u};
 
@@ -719,7 +735,8 @@ void SynthesizeOnsets(HrirDataT *hData)
             }
         }
     };
-    std::for_each(hData->mFds.begin(), hData->mFds.end(), proc_field);
+    pool.run(hData->mFds.size(), [hData,proc_field](const size_t fi, HrirScratch&)
+    { proc_field(hData->mFds[fi]); });
 }
 
 /* Attempt to synthesize any missing HRIRs at the bottom elevations of each
@@ -727,18 +744,48 @@ void SynthesizeOnsets(HrirDataT *hData)
  * applies a low-pass filter to simulate body occlusion.  It is a simple, if
  * inaccurate model.
  */
-void SynthesizeHrirs(HrirDataT *hData)
+void SynthesizeHrirs(HrirDataT *hData, HrirThreadPool &pool)
 {
     const uint channels{(hData->mChannelType == CT_STEREO) ? 2u : 1u};
-    auto htemp = std::vector<complex_d>(hData->mFftSize);
-    const uint m{hData->mFftSize/2u + 1u};
-    auto filter = std::vector<double>(m);
+    const uint fftSize{hData->mFftSize};
+    const uint m{fftSize/2u + 1u};
     const double beta{3.5e-6 * hData->mIrRate};
 
-    auto proc_field = [channels,m,beta,&htemp,&filter](HrirFdT &field) -> void
+    /* Calculate a low-pass filter to simulate body occlusion, returning its
+     * frequency magnitudes (phase will be reconstructed later).
+     */
+    auto calc_filter = [fftSize,m](HrirScratch &scratch, const double b) -> al::span<const double>
+    {
+        auto &htemp = scratch.mSamples;
+        htemp.resize(fftSize);
+
+        std::array<double,4> lp{};
+        lp[0] = Lerp(1.0, lp[0], b);
+        lp[1] = Lerp(lp[0], lp[1], b);
+        lp[2] = Lerp(lp[1], lp[2], b);
+        lp[3] = Lerp(lp[2], lp[3], b);
+        htemp[0] = lp[3];
+        for(size_t i{1u};i < htemp.size();i++)
+        {
+            lp[0] = Lerp(0.0, lp[0], b);
+            lp[1] = Lerp(lp[0], lp[1], b);
+            lp[2] = Lerp(lp[1], lp[2], b);
+            lp[3] = Lerp(lp[2], lp[3], b);
+            htemp[i] = lp[3];
+        }
+        const auto response = RealFftForward(scratch, fftSize, htemp);
+
+        auto &filter = scratch.mMags;
+        filter.resize(m);
+        std::transform(response.begin(), response.begin()+m, filter.begin(),
+            [](const complex_d c) -> double { return std::abs(c); });
+        return filter;
+    };
+
+    for(auto &field : hData->mFds)
     {
         const uint oi{field.mEvStart};
-        if(oi <= 0) return;
+        if(oi <= 0) continue;
 
         for(uint ti{0u};ti < channels;ti++)
         {
@@ -758,145 +805,79 @@ void SynthesizeHrirs(HrirDataT *hData)
                     field.mEvs[oi].mAzs[a1].mIrs[ti][i], af);
             }
         }
+    }
 
+    /* The missing elevations between the bottom and the lowest measured
+     * elevation are synthesized in parallel.
+     */
+    std::vector<std::pair<HrirFdT*,uint>> elevs;
+    for(auto &field : hData->mFds)
+    {
         for(uint ei{1u};ei < field.mEvStart;ei++)
-        {
-            const double of{static_cast<double>(ei) / field.mEvStart};
-            const double b{(1.0 - of) * beta};
-            std::array<double,4> lp{};
+            elevs.emplace_back(&field, ei);
+    }
+    pool.run(elevs.size(), [channels,m,beta,calc_filter,&elevs](const size_t idx,
+        HrirScratch &scratch)
+    {
+        HrirFdT &field = *elevs[idx].first;
+        const uint ei{elevs[idx].second};
+        const uint oi{field.mEvStart};
+        const double of{static_cast<double>(ei) / field.mEvStart};
+        const auto filter = calc_filter(scratch, (1.0 - of) * beta);
 
-            /* Calculate a low-pass filter to simulate body occlusion. */
-            lp[0] = Lerp(1.0, lp[0], b);
-            lp[1] = Lerp(lp[0], lp[1], b);
-            lp[2] = Lerp(lp[1], lp[2], b);
-            lp[3] = Lerp(lp[2], lp[3], b);
-            htemp[0] = lp[3];
-            for(size_t i{1u};i < htemp.size();i++)
-            {
-                lp[0] = Lerp(0.0, lp[0], b);
-                lp[1] = Lerp(lp[0], lp[1], b);
-                lp[2] = Lerp(lp[1], lp[2], b);
-                lp[3] = Lerp(lp[2], lp[3], b);
-                htemp[i] = lp[3];
-            }
-            /* Get the filter's frequency-domain response and extract the
-             * frequency magnitudes (phase will be reconstructed later)).
-             */
-            FftForward(static_cast<uint>(htemp.size()), htemp.data());
-            std::transform(htemp.cbegin(), htemp.cbegin()+m, filter.begin(),
-                [](const complex_d c) -> double { return std::abs(c); });
+        for(uint ai{0u};ai < field.mEvs[ei].mAzs.size();ai++)
+        {
+            uint a0, a1;
+            double af;
 
-            for(uint ai{0u};ai < field.mEvs[ei].mAzs.size();ai++)
+            CalcAzIndices(field, oi, field.mEvs[ei].mAzs[ai].mAzimuth, &a0, &a1, &af);
+            for(uint ti{0u};ti < channels;ti++)
             {
-                uint a0, a1;
-                double af;
-
-                CalcAzIndices(field, oi, field.mEvs[ei].mAzs[ai].mAzimuth, &a0, &a1, &af);
-                for(uint ti{0u};ti < channels;ti++)
+                for(uint i{0u};i < m;i++)
                 {
-                    for(uint i{0u};i < m;i++)
-                    {
-                        /* Blend the two defined HRIRs closest to this azimuth,
-                         * then blend that with the synthesized -90 elevation.
-                         */
-                        const double s1{Lerp(field.mEvs[oi].mAzs[a0].mIrs[ti][i],
-                            field.mEvs[oi].mAzs[a1].mIrs[ti][i], af)};
-                        const double s{Lerp(field.mEvs[0].mAzs[0].mIrs[ti][i], s1, of)};
-                        field.mEvs[ei].mAzs[ai].mIrs[ti][i] = s * filter[i];
-                    }
+                    /* Blend the two defined HRIRs closest to this azimuth,
+                     * then blend that with the synthesized -90 elevation.
+                     */
+                    const double s1{Lerp(field.mEvs[oi].mAzs[a0].mIrs[ti][i],
+                        field.mEvs[oi].mAzs[a1].mIrs[ti][i], af)};
+                    const double s{Lerp(field.mEvs[0].mAzs[0].mIrs[ti][i], s1, of)};
+                    field.mEvs[ei].mAzs[ai].mIrs[ti][i] = s * filter[i];
                 }
             }
         }
-        const double b{beta};
-        std::array<double,4> lp{};
-        lp[0] = Lerp(1.0, lp[0], b);
-        lp[1] = Lerp(lp[0], lp[1], b);
-        lp[2] = Lerp(lp[1], lp[2], b);
-        lp[3] = Lerp(lp[2], lp[3], b);
-        htemp[0] = lp[3];
-        for(size_t i{1u};i < htemp.size();i++)
-        {
-            lp[0] = Lerp(0.0, lp[0], b);
-            lp[1] = Lerp(lp[0], lp[1], b);
-            lp[2] = Lerp(lp[1], lp[2], b);
-            lp[3] = Lerp(lp[2], lp[3], b);
-            htemp[i] = lp[3];
-        }
-        FftForward(static_cast<uint>(htemp.size()), htemp.data());
-        std::transform(htemp.cbegin(), htemp.cbegin()+m, filter.begin(),
-            [](const complex_d c) -> double { return std::abs(c); });
+    });
+
+    /* Finally apply the full filter to the synthesized -90 elevation, after
+     * the elevations above are done blending with it.
+     */
+    pool.run(hData->mFds.size(), [hData,channels,m,beta,calc_filter](const size_t fi,
+        HrirScratch &scratch)
+    {
+        HrirFdT &field = hData->mFds[fi];
+        if(field.mEvStart <= 0) return;
 
+        const auto filter = calc_filter(scratch, beta);
         for(uint ti{0u};ti < channels;ti++)
         {
             for(uint i{0u};i < m;i++)
                 field.mEvs[0].mAzs[0].mIrs[ti][i] *= filter[i];
         }
-    };
-    std::for_each(hData->mFds.begin(), hData->mFds.end(), proc_field);
+    });
 }
 
 // The following routines assume a full set of HRIRs for all elevations.
 
 /* Perform minimum-phase reconstruction using the magnitude responses of the
- * HRIR set. Work is delegated to this struct, which runs asynchronously on one
- * or more threads (sharing the same reconstructor object).
+ * HRIR set, spread across the thread pool.
  */
-struct HrirReconstructor {
-    std::vector<al::span<double>> mIrs;
-    std::atomic<size_t> mCurrent{};
-    std::atomic<size_t> mDone{};
-    uint mFftSize{};
-    uint mIrPoints{};
-
-    void Worker()
-    {
-        auto h = std::vector<complex_d>(mFftSize);
-        auto mags = std::vector<double>(mFftSize);
-        size_t m{(mFftSize/2) + 1};
-
-        while(true)
-        {
-            /* Load the current index to process. */
-            size_t idx{mCurrent.load()};
-            do {
-                /* If the index is at the end, we're done. */
-                if(idx >= mIrs.size())
-                    return;
-                /* Otherwise, increment the current index atomically so other
-                 * threads know to go to the next one. If this call fails, the
-                 * current index was just changed by another thread and the new
-                 * value is loaded into idx, which we'll recheck.
-                 */
-            } while(!mCurrent.compare_exchange_weak(idx, idx+1, std::memory_order_relaxed));
-
-            /* Now do the reconstruction, and apply the inverse FFT to get the
-             * time-domain response.
-             */
-            for(size_t i{0};i < m;++i)
-                mags[i] = std::max(mIrs[idx][i], Epsilon);
-            MinimumPhase(mags, h);
-            FftInverse(mFftSize, h.data());
-            for(uint i{0u};i < mIrPoints;++i)
-                mIrs[idx][i] = h[i].real();
-
-            /* Increment the number of IRs done. */
-            mDone.fetch_add(1);
-        }
-    }
-};
-
-void ReconstructHrirs(const HrirDataT *hData, const uint numThreads)
+void ReconstructHrirs(const HrirDataT *hData, HrirThreadPool &pool)
 {
     const uint channels{(hData->mChannelType == CT_STEREO) ? 2u : 1u};
+    const uint fftSize{hData->mFftSize};
+    const uint irPoints{hData->mIrPoints};
+    const size_t m{(fftSize/2) + 1};
 
-    /* Set up the reconstructor with the needed size info and pointers to the
-     * IRs to process.
-     */
-    HrirReconstructor reconstructor;
-    reconstructor.mCurrent.store(0, std::memory_order_relaxed);
-    reconstructor.mDone.store(0, std::memory_order_relaxed);
-    reconstructor.mFftSize = hData->mFftSize;
-    reconstructor.mIrPoints = hData->mIrPoints;
+    std::vector<al::span<double>> irs;
     for(const auto &field : hData->mFds)
     {
         for(auto &elev : field.mEvs)
@@ -904,35 +885,27 @@ void ReconstructHrirs(const HrirDataT *hData, const uint numThreads)
             for(const auto &azd : elev.mAzs)
             {
                 for(uint ti{0u};ti < channels;ti++)
-                    reconstructor.mIrs.push_back(azd.mIrs[ti]);
+                    irs.push_back(azd.mIrs[ti]);
             }
         }
     }
 
-    /* Launch threads to work on reconstruction. */
-    std::vector<std::thread> thrds;
-    thrds.reserve(numThreads);
-    for(size_t i{0};i < numThreads;++i)
-        thrds.emplace_back(std::mem_fn(&HrirReconstructor::Worker), &reconstructor);
-
-    /* Keep track of the number of IRs done, periodically reporting it. */
-    size_t count;
-    do {
-        std::this_thread::sleep_for(std::chrono::milliseconds{50});
-
-        count = reconstructor.mDone.load();
-        size_t pcdone{count * 100 / reconstructor.mIrs.size()};
-
-        printf("\r%3zu%% done (%zu of %zu)", pcdone, count, reconstructor.mIrs.size());
-        fflush(stdout);
-    } while(count < reconstructor.mIrs.size());
-    fputc('\n', stdout);
-
-    for(auto &thrd : thrds)
+    pool.run(irs.size(), [fftSize,irPoints,m,&irs](const size_t idx, HrirScratch &scratch)
     {
-        if(thrd.joinable())
-            thrd.join();
-    }
+        auto &h = scratch.mComplex;
+        auto &mags = scratch.mMags;
+        h.resize(fftSize);
+        mags.resize(fftSize);
+
+        /* Now do the reconstruction, and apply the inverse FFT to get the
+         * time-domain response.
+         */
+        const auto ir = irs[idx];
+        for(size_t i{0};i < m;++i)
+            mags[i] = std::max(ir[i], Epsilon);
+        MinimumPhase(mags, h);
+        RealFftInverse(scratch, fftSize, al::span{h}.first(m), ir.first(irPoints));
+    }, "");
 }
 
 // Normalize the HRIR set and slightly attenuate the result.
@@ -1014,81 +987,82 @@ double CalcLTD(const double ev, const double az, const double rad, const double
 
 // Calculate the effective head-related time delays for each minimum-phase
 // HRIR. This is done per-field since distance delay is ignored.
-void CalculateHrtds(const HeadModelT model, const double radius, HrirDataT *hData)
+void CalculateHrtds(const HeadModelT model, const double radius, HrirDataT *hData,
+    HrirThreadPool &pool)
 {
-    uint channels = (hData->mChannelType == CT_STEREO) ? 2 : 1;
-    double customRatio{radius / hData->mRadius};
-    uint ti;
+    const uint channels{(hData->mChannelType == CT_STEREO) ? 2u : 1u};
+    const double customRatio{radius / hData->mRadius};
 
-    if(model == HM_Sphere)
+    auto maxHrtds = std::vector<double>(hData->mFds.size(), 0.0);
+    pool.run(hData->mFds.size(), [model,radius,hData,channels,customRatio,&maxHrtds](
+        const size_t fi, HrirScratch&)
     {
-        for(auto &field : hData->mFds)
+        auto &field = hData->mFds[fi];
+        if(model == HM_Sphere)
         {
             for(auto &elev : field.mEvs)
             {
                 for(auto &azd : elev.mAzs)
                 {
-                    for(ti = 0;ti < channels;ti++)
+                    for(uint ti{0};ti < channels;ti++)
                         azd.mDelays[ti] = CalcLTD(elev.mElevation, azd.mAzimuth, radius, field.mDistance);
                 }
             }
         }
-    }
-    else if(customRatio != 1.0)
-    {
-        for(auto &field : hData->mFds)
+        else if(customRatio != 1.0)
         {
             for(auto &elev : field.mEvs)
             {
                 for(auto &azd : elev.mAzs)
                 {
-                    for(ti = 0;ti < channels;ti++)
+                    for(uint ti{0};ti < channels;ti++)
                         azd.mDelays[ti] *= customRatio;
                 }
             }
         }
-    }
 
-    double maxHrtd{0.0};
-    for(auto &field : hData->mFds)
-    {
         double minHrtd{std::numeric_limits<double>::infinity()};
         for(auto &elev : field.mEvs)
         {
             for(auto &azd : elev.mAzs)
             {
-                for(ti = 0;ti < channels;ti++)
+                for(uint ti{0};ti < channels;ti++)
                     minHrtd = std::min(azd.mDelays[ti], minHrtd);
             }
         }
 
+        double maxHrtd{0.0};
         for(auto &elev : field.mEvs)
         {
             for(auto &azd : elev.mAzs)
             {
-                for(ti = 0;ti < channels;ti++)
+                for(uint ti{0};ti < channels;ti++)
                 {
                     azd.mDelays[ti] = (azd.mDelays[ti]-minHrtd) * hData->mIrRate;
                     maxHrtd = std::max(maxHrtd, azd.mDelays[ti]);
                 }
             }
         }
-    }
+        maxHrtds[fi] = maxHrtd;
+    });
+
+    const double maxHrtd{std::accumulate(maxHrtds.cbegin(), maxHrtds.cend(), 0.0,
+        [](const double a, const double b) { return std::max(a, b); })};
     if(maxHrtd > MaxHrtd)
     {
         fprintf(stdout, "  Scaling for max delay of %f samples to %f\n...\n", maxHrtd, MaxHrtd);
         const double scale{MaxHrtd / maxHrtd};
-        for(auto &field : hData->mFds)
+        pool.run(hData->mFds.size(), [hData,channels,scale](const size_t fi, HrirScratch&)
         {
-            for(auto &elev : field.mEvs)
+            for(auto &elev : hData->mFds[fi].mEvs)
             {
                 for(auto &azd : elev.mAzs)
                 {
-                    for(ti = 0;ti < channels;ti++)
+                    for(uint ti{0};ti < channels;ti++)
                         azd.mDelays[ti] *= scale;
                 }
             }
-        }
+        });
     }
 }
 
@@ -1145,6 +1119,166 @@ bool PrepareHrirData(const al::span<const double> distances,
 }
 
 
+HrirThreadPool::HrirThreadPool(const uint numThreads)
+{
+    mThreads.reserve(std::max(numThreads, 1u));
+    for(uint i{0};i < std::max(numThreads, 1u);++i)
+        mThreads.emplace_back(std::mem_fn(&HrirThreadPool::worker), this);
+}
+
+HrirThreadPool::~HrirThreadPool()
+{
+    auto lock = std::unique_lock{mLock};
+    mQuit = true;
+    lock.unlock();
+    mWakeCond.notify_all();
+
+    for(auto &thrd : mThreads)
+        thrd.join();
+}
+
+void HrirThreadPool::worker()
+{
+    /* Each worker keeps its scratch storage for the life of the pool, so the
+     * buffers are only allocated the first time they're needed.
+     */
+    HrirScratch scratch;
+    size_t generation{0};
+
+    auto lock = std::unique_lock{mLock};
+    while(true)
+    {
+        mWakeCond.wait(lock, [this,&generation]{ return mQuit || mGeneration != generation; });
+        if(mQuit) break;
+        generation = mGeneration;
+        lock.unlock();
+
+        for(size_t idx{mCurrent.fetch_add(1)};idx < mCount;idx = mCurrent.fetch_add(1))
+        {
+            (*mFunc)(idx, scratch);
+            mDone.fetch_add(1);
+        }
+
+        /* Every worker reports when it finishes the batch, so a new batch
+         * can't start while any is still looking at the current one.
+         */
+        lock.lock();
+        ++mFinished;
+        mDoneCond.notify_all();
+    }
+}
+
+void HrirThreadPool::run(const size_t count, const WorkFunc &func, const char *label)
+{
+    auto lock = std::unique_lock{mLock};
+    mFunc = &func;
+    mCount = count;
+    mCurrent.store(0);
+    mDone.store(0);
+    mFinished = 0;
+    ++mGeneration;
+    mWakeCond.notify_all();
+
+    /* Keep track of the number of items done, periodically reporting it. */
+    auto report = [label,count](const size_t done)
+    {
+        if(!label) return;
+        const size_t pcdone{count ? (done * 100 / count) : 100};
+        printf("\r%s%3zu%% done (%zu of %zu)", label, pcdone, done, count);
+        fflush(stdout);
+    };
+    while(!mDoneCond.wait_for(lock, std::chrono::milliseconds{50},
+        [this]{ return mFinished == mThreads.size(); }))
+        report(mDone.load());
+    report(count);
+    if(label)
+        fputc('\n', stdout);
+    mFunc = nullptr;
+}
+
+
+namespace {
+
+/* Gets the twiddle factors for splitting a half-size FFT into the real FFT of
+ * n samples.
+ */
+auto GetRealFftTwiddles(HrirScratch &scratch, const uint n) -> al::span<const complex_d>
+{
+    const size_t half{n / 2u};
+    if(scratch.mTwiddles.size() != half)
+    {
+        scratch.mTwiddles.resize(half);
+        for(size_t k{0};k < half;++k)
+            scratch.mTwiddles[k] = std::polar(1.0, -2.0*al::numbers::pi*static_cast<double>(k)/n);
+    }
+    return scratch.mTwiddles;
+}
+
+} // namespace
+
+auto RealFftForward(HrirScratch &scratch, const uint n, const al::span<const double> in)
+    -> al::span<const complex_d>
+{
+    const size_t half{n / 2u};
+    const auto twiddles = GetRealFftTwiddles(scratch, n);
+    scratch.mFft.resize(half);
+    scratch.mSpectrum.resize(half + 1);
+
+    /* Pack the even samples into the real part and the odd samples into the
+     * imaginary part, and transform them together.
+     */
+    const auto fft = al::span{scratch.mFft};
+    for(size_t i{0};i < half;++i)
+    {
+        const double even{(i*2 < in.size()) ? in[i*2] : 0.0};
+        const double odd{(i*2 + 1 < in.size()) ? in[i*2 + 1] : 0.0};
+        fft[i] = complex_d{even, odd};
+    }
+    forward_fft(fft);
+
+    /* Separate the spectra of the even and odd samples, and combine them into
+     * the spectrum of the whole signal.
+     */
+    const auto out = al::span{scratch.mSpectrum};
+    for(size_t k{0};k <= half;++k)
+    {
+        const complex_d zk{fft[k % half]};
+        const complex_d zc{std::conj(fft[(half - k) % half])};
+        const complex_d even{(zk + zc) * 0.5};
+        const complex_d odd{(zk - zc) * complex_d{0.0, -0.5}};
+        out[k] = even + ((k < half) ? twiddles[k] : complex_d{-1.0, 0.0})*odd;
+    }
+    return out;
+}
+
+void RealFftInverse(HrirScratch &scratch, const uint n, const al::span<const complex_d> in,
+    const al::span<double> out)
+{
+    const size_t half{n / 2u};
+    const auto twiddles = GetRealFftTwiddles(scratch, n);
+    scratch.mFft.resize(half);
+
+    /* Build the combined spectrum of the even and odd output samples. */
+    const auto fft = al::span{scratch.mFft};
+    for(size_t k{0};k < half;++k)
+    {
+        const complex_d xk{in[k]};
+        const complex_d xc{std::conj(in[half - k])};
+        const complex_d even{(xk + xc) * 0.5};
+        const complex_d odd{(xk - xc) * 0.5 * std::conj(twiddles[k])};
+        fft[k] = even + complex_d{0.0, 1.0}*odd;
+    }
+    inverse_fft(fft);
+
+    const double scale{1.0 / static_cast<double>(half)};
+    for(size_t i{0};i < out.size();++i)
+    {
+        const complex_d z{fft[i / 2]};
+        out[i] = ((i&1) ? z.imag() : z.real()) * scale;
+    }
+}
+
+
 namespace {
 
 /* Parse the data set definition and process the source data, storing the
@@ -1159,6 +1293,7 @@ bool ProcessDefinition(std::string_view inName, const uint outRate, const Channe
     HrirDataT hData;
 
     fprintf(stdout, "Using %u thread%s.\n", numThreads, (numThreads==1)?"":"s");
+    HrirThreadPool pool{numThreads};
     if(inName.empty() || inName == "-"sv)
     {
         inName = "stdin"sv;
@@ -1192,7 +1327,7 @@ bool ProcessDefinition(std::string_view inName, const uint outRate, const Channe
             input = nullptr;
             fprintf(stdout, "Reading HRTF data from %.*s...\n", al::sizei(inName),
                 inName.data());
-            if(!LoadSofaFile(inName, numThreads, fftSize, truncSize, outRate, chanMode, &hData))
+            if(!LoadSofaFile(inName, pool, fftSize, truncSize, outRate, chanMode, &hData))
                 return false;
         }
         else
@@ -1217,9 +1352,9 @@ bool ProcessDefinition(std::string_view inName, const uint outRate, const Channe
             BalanceFieldMagnitudes(&hData, c, m);
         }
         fprintf(stdout, "Calculating diffuse-field average...\n");
-        CalculateDiffuseFieldAverage(&hData, c, m, surface, limit, dfa);
+        CalculateDiffuseFieldAverage(&hData, c, m, surface, limit, dfa, pool);
         fprintf(stdout, "Performing diffuse-field equalization...\n");
-        DiffuseFieldEqualize(c, m, dfa, &hData);
+        DiffuseFieldEqualize(c, m, dfa, &hData, pool);
     }
     if(hData.mFds.size() > 1)
     {
@@ -1236,16 +1371,17 @@ bool ProcessDefinition(std::string_view inName, const uint outRate, const Channe
     }
     fprintf(stdout, "Synthesizing missing elevations...\n");
     if(model == HM_Dataset)
-        SynthesizeOnsets(&hData);
-    SynthesizeHrirs(&hData);
+        SynthesizeOnsets(&hData, pool);
+    SynthesizeHrirs(&hData, pool);
     fprintf(stdout, "Performing minimum phase reconstruction...\n");
-    ReconstructHrirs(&hData, numThreads);
+    ReconstructHrirs(&hData, pool);
     fprintf(stdout, "Truncating minimum-phase HRIRs...\n");
     hData.mIrPoints = truncSize;
     fprintf(stdout, "Normalizing final HRIRs...\n");
     NormalizeHrirs(&hData);
     fprintf(stdout, "Calculating impulse delays...\n");
-    CalculateHrtds(model, (radius > DefaultCustomRadius) ? radius : hData.mRadius, &hData);
+    CalculateHrtds(model, (radius > DefaultCustomRadius) ? radius : hData.mRadius, &hData,
+        pool);
 
     const auto rateStr = std::to_string(hData.mIrRate);
     const auto expName = StrSubst(outName, "%r"sv, rateStr);
@@ -3,7 +3,13 @@
 
 #include <algorithm>
 #include <array>
+#include <atomic>
 #include <complex>
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <mutex>
+#include <thread>
 #include <vector>
 
 #include "alcomplex.h"
@@ -121,6 +127,69 @@ bool PrepareHrirData(const al::span<const double> distances,
     const al::span<const uint,MAX_FD_COUNT> evCounts,
     const al::span<const std::array<uint,MAX_EV_COUNT>,MAX_FD_COUNT> azCounts, HrirDataT *hData);
 
+/* Scratch storage for processing HRIRs. Each worker thread has its own, which
+ * is reused for each HRIR it processes.
+ */
+struct HrirScratch {
+    /* Buffers used by the real FFT methods. */
+    std::vector<complex_d> mFft;
+    std::vector<complex_d> mTwiddles;
+    std::vector<complex_d> mSpectrum;
+
+    /* General buffers for the processing stages. */
+    std::vector<complex_d> mComplex;
+    std::vector<double> mSamples;
+    std::vector<double> mMags;
+};
+
+/* A pool of worker threads shared by the processing stages. A batch of work
+ * is run by calling a function for each index of the batch, spread across the
+ * worker threads.
+ */
+class HrirThreadPool {
+public:
+    using WorkFunc = std::function<void(size_t idx, HrirScratch &scratch)>;
+
+    explicit HrirThreadPool(const uint numThreads);
+    ~HrirThreadPool();
+
+    /* Calls func for each index from 0 to count-1, and waits for them all to
+     * complete. When a label is given, progress is reported with it.
+     */
+    void run(const size_t count, const WorkFunc &func, const char *label=nullptr);
+
+private:
+    void worker();
+
+    std::vector<std::thread> mThreads;
+    std::mutex mLock;
+    std::condition_variable mWakeCond;
+    std::condition_variable mDoneCond;
+    size_t mGeneration{0};
+    size_t mFinished{0};
+    bool mQuit{false};
+
+    const WorkFunc *mFunc{nullptr};
+    size_t mCount{0};
+    std::atomic<size_t> mCurrent{0};
+    std::atomic<size_t> mDone{0};
+};
+
+/* Performs a forward FFT of a real signal, zero-padded to n samples, using a
+ * complex FFT of half the size. Returns the n/2 + 1 bins from DC to Nyquist,
+ * stored in the scratch storage.
+ */
+auto RealFftForward(HrirScratch &scratch, const uint n, const al::span<const double> in)
+    -> al::span<const complex_d>;
+
+/* Performs an inverse FFT of a conjugate-symmetric spectrum of n bins, given
+ * the n/2 + 1 bins from DC to Nyquist, using a complex FFT of half the size.
+ * The first out.size() samples of the real result are written, scaled by the
+ * number of elements.
+ */
+void RealFftInverse(HrirScratch &scratch, const uint n, const al::span<const complex_d> in,
+    const al::span<double> out);
+
 /* Calculate the magnitude response of the given input.  This is used in
  * place of phase decomposition, since the phase residuals are discarded for
  * minimum phase reconstruction.  The mirrored half of the response is also
@@ -0,0 +1,380 @@
+/*
+ * UHJ utility methods for pipelined and parallel file processing.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include "config.h"
+
+#include "uhj-support.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdarg>
+#include <system_error>
+#include <unordered_map>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+
+namespace {
+
+/* The number of blocks to buffer ahead of reading, and behind writing. */
+constexpr std::size_t QueueDepth{8};
+
+std::mutex gMessageLock;
+
+#ifdef _WIN32
+auto ToWideString(const std::string &str) -> std::wstring
+{
+    const int len{MultiByteToWideChar(CP_UTF8, 0, str.c_str(), -1, nullptr, 0)};
+    if(len <= 0) return {};
+    auto ret = std::wstring(static_cast<std::size_t>(len), L'\0');
+    MultiByteToWideChar(CP_UTF8, 0, str.c_str(), -1, ret.data(), len);
+    ret.pop_back();
+    return ret;
+}
+#endif
+
+} // namespace
+
+
+void MappedFile::close() noexcept
+{
+#ifdef _WIN32
+    if(mData)
+        UnmapViewOfFile(mData);
+    if(mMapping)
+        CloseHandle(mMapping);
+    if(mFile)
+        CloseHandle(mFile);
+    mFile = nullptr;
+    mMapping = nullptr;
+#else
+    if(mData)
+        munmap(mData, mSize);
+    if(mFd != -1)
+        ::close(mFd);
+    mFd = -1;
+#endif
+    mData = nullptr;
+    mSize = 0;
+}
+
+MappedFile& MappedFile::operator=(MappedFile&& rhs) noexcept
+{
+    if(&rhs != this)
+    {
+        close();
+#ifdef _WIN32
+        mFile = std::exchange(rhs.mFile, nullptr);
+        mMapping = std::exchange(rhs.mMapping, nullptr);
+#else
+        mFd = std::exchange(rhs.mFd, -1);
+#endif
+        mData = std::exchange(rhs.mData, nullptr);
+        mSize = std::exchange(rhs.mSize, 0);
+    }
+    return *this;
+}
+
+auto MappedFile::OpenRead(const std::string &fname) -> std::optional<MappedFile>
+{
+    MappedFile ret;
+#ifdef _WIN32
+    HANDLE file{CreateFileW(ToWideString(fname).c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+        OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr)};
+    if(file == INVALID_HANDLE_VALUE)
+        return std::nullopt;
+    ret.mFile = file;
+
+    LARGE_INTEGER fsize{};
+    if(!GetFileSizeEx(file, &fsize) || fsize.QuadPart <= 0)
+        return std::nullopt;
+    ret.mSize = static_cast<std::size_t>(fsize.QuadPart);
+
+    ret.mMapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if(!ret.mMapping)
+        return std::nullopt;
+    ret.mData = MapViewOfFile(ret.mMapping, FILE_MAP_READ, 0, 0, 0);
+    if(!ret.mData)
+        return std::nullopt;
+#else
+    ret.mFd = open(fname.c_str(), O_RDONLY);
+    if(ret.mFd == -1)
+        return std::nullopt;
+
+    struct stat st{};
+    if(fstat(ret.mFd, &st) != 0 || st.st_size <= 0)
+        return std::nullopt;
+
+    void *ptr{mmap(nullptr, static_cast<std::size_t>(st.st_size), PROT_READ, MAP_SHARED,
+        ret.mFd, 0)};
+    if(ptr == MAP_FAILED)
+        return std::nullopt;
+    ret.mData = ptr;
+    ret.mSize = static_cast<std::size_t>(st.st_size);
+#if defined(POSIX_MADV_SEQUENTIAL)
+    posix_madvise(ret.mData, ret.mSize, POSIX_MADV_SEQUENTIAL);
+#endif
+#endif
+    return ret;
+}
+
+auto MappedFile::Create(const std::string &fname, std::size_t size) -> std::optional<MappedFile>
+{
+    MappedFile ret;
+#ifdef _WIN32
+    HANDLE file{CreateFileW(ToWideString(fname).c_str(), GENERIC_READ|GENERIC_WRITE, 0, nullptr,
+        CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr)};
+    if(file == INVALID_HANDLE_VALUE)
+        return std::nullopt;
+    ret.mFile = file;
+    if(size == 0)
+        return ret;
+
+    const auto size64 = static_cast<unsigned long long>(size);
+    ret.mMapping = CreateFileMappingW(file, nullptr, PAGE_READWRITE,
+        static_cast<DWORD>(size64>>32), static_cast<DWORD>(size64), nullptr);
+    if(!ret.mMapping)
+        return std::nullopt;
+    ret.mData = MapViewOfFile(ret.mMapping, FILE_MAP_WRITE, 0, 0, size);
+    if(!ret.mData)
+        return std::nullopt;
+#else
+    ret.mFd = open(fname.c_str(), O_RDWR|O_CREAT|O_TRUNC, 0666);
+    if(ret.mFd == -1)
+        return std::nullopt;
+    if(size == 0)
+        return ret;
+    if(ftruncate(ret.mFd, static_cast<off_t>(size)) != 0)
+        return std::nullopt;
+
+    void *ptr{mmap(nullptr, size, PROT_READ|PROT_WRITE, MAP_SHARED, ret.mFd, 0)};
+    if(ptr == MAP_FAILED)
+        return std::nullopt;
+    ret.mData = ptr;
+#endif
+    ret.mSize = size;
+    return ret;
+}
+
+
+bool BlockQueue::push(std::vector<float> block)
+{
+    auto lock = std::unique_lock{mLock};
+    mCond.wait(lock, [this]{ return mClosed || mBlocks.size() < mMaxBlocks; });
+    if(mClosed)
+        return false;
+    mBlocks.emplace_back(std::move(block));
+    lock.unlock();
+    mCond.notify_all();
+    return true;
+}
+
+auto BlockQueue::pop() -> std::optional<std::vector<float>>
+{
+    auto lock = std::unique_lock{mLock};
+    mCond.wait(lock, [this]{ return mClosed || !mBlocks.empty(); });
+    if(mBlocks.empty())
+        return std::nullopt;
+    auto ret = std::move(mBlocks.front());
+    mBlocks.pop_front();
+    lock.unlock();
+    mCond.notify_all();
+    return ret;
+}
+
+void BlockQueue::close()
+{
+    auto lock = std::unique_lock{mLock};
+    mClosed = true;
+    lock.unlock();
+    mCond.notify_all();
+}
+
+
+ReadAhead::ReadAhead(ReaderFunc reader, std::size_t blockFrames, std::size_t channels)
+    : mQueue{QueueDepth}
+{
+    mThread = std::thread{[this,reader=std::move(reader),blockFrames,channels]
+    {
+        while(true)
+        {
+            auto block = std::vector<float>(blockFrames*channels);
+            const std::size_t got{reader(block)};
+            if(got == 0)
+                break;
+            block.resize(got*channels);
+            if(!mQueue.push(std::move(block)))
+                break;
+        }
+        mQueue.close();
+    }};
+}
+
+ReadAhead::~ReadAhead()
+{
+    mQueue.close();
+    mThread.join();
+}
+
+auto ReadAhead::read(al::span<float> samples, std::size_t channels) -> std::size_t
+{
+    auto block = mQueue.pop();
+    if(!block)
+        return 0;
+    const std::size_t todo{std::min(block->size(), samples.size())};
+    std::copy_n(block->cbegin(), todo, samples.begin());
+    return todo / channels;
+}
+
+
+WriteBehind::WriteBehind(WriterFunc writer) : mQueue{QueueDepth}
+{
+    mThread = std::thread{[this,writer=std::move(writer)]
+    {
+        while(auto block = mQueue.pop())
+        {
+            if(!writer(*block))
+            {
+                mFailed = true;
+                break;
+            }
+        }
+        mQueue.close();
+    }};
+}
+
+WriteBehind::~WriteBehind()
+{
+    finish();
+}
+
+bool WriteBehind::write(al::span<const float> samples)
+{
+    return mQueue.push(std::vector<float>(samples.begin(), samples.end()));
+}
+
+bool WriteBehind::finish()
+{
+    if(mThread.joinable())
+    {
+        mQueue.close();
+        mThread.join();
+    }
+    return !mFailed;
+}
+
+
+void MessageLog::add(FILE *stream, const char *fmt, ...)
+{
+    std::va_list args, args2;
+    va_start(args, fmt);
+    va_copy(args2, args);
+    const int len{std::vsnprintf(nullptr, 0, fmt, args)};
+    va_end(args);
+
+    if(len > 0)
+    {
+        auto msg = std::string(static_cast<std::size_t>(len)+1, '\0');
+        std::vsnprintf(msg.data(), msg.size(), fmt, args2);
+        msg.pop_back();
+        mMessages.emplace_back(stream, std::move(msg));
+    }
+    va_end(args2);
+}
+
+void MessageLog::flush()
+{
+    auto lock = std::lock_guard{gMessageLock};
+    for(const auto &[stream, msg] : mMessages)
+    {
+        fputs(msg.c_str(), stream);
+        fflush(stream);
+    }
+    mMessages.clear();
+}
+
+
+void ForEachParallel(std::size_t count, unsigned int numThreads,
+    const std::function<void(std::size_t idx)> &func)
+{
+    std::atomic<std::size_t> next{0};
+    auto worker = [&next,count,&func]
+    {
+        for(std::size_t idx{next++};idx < count;idx = next++)
+            func(idx);
+    };
+
+    std::vector<std::thread> threads;
+    const auto extra = std::min(std::size_t{std::max(numThreads, 1u)}, count);
+    threads.reserve(extra > 0 ? extra-1 : 0);
+    try {
+        while(threads.size()+1 < extra)
+            threads.emplace_back(worker);
+    }
+    catch(std::system_error &e) {
+        fprintf(stderr, "Failed to start worker thread: %s\n", e.what());
+    }
+
+    worker();
+    for(auto &thrd : threads)
+        thrd.join();
+}
+
+auto GroupByName(al::span<const std::string> names) -> std::vector<std::vector<std::size_t>>
+{
+    std::vector<std::vector<std::size_t>> groups;
+    std::unordered_map<std::string_view,std::size_t> groupidx;
+    for(std::size_t idx{0};idx < names.size();++idx)
+    {
+        auto [iter, inserted] = groupidx.emplace(names[idx], groups.size());
+        if(inserted)
+            groups.emplace_back();
+        groups[iter->second].emplace_back(idx);
+    }
+    return groups;
+}
+
+auto ParseJobCount(std::string_view value) -> std::optional<unsigned int>
+{
+    if(value.empty())
+        return std::nullopt;
+    unsigned int jobs{0};
+    for(const char ch : value)
+    {
+        if(ch < '0' || ch > '9')
+            return std::nullopt;
+        jobs = jobs*10u + static_cast<unsigned int>(ch - '0');
+        if(jobs > 1024)
+            return std::nullopt;
+    }
+    if(jobs == 0)
+        jobs = std::max(std::thread::hardware_concurrency(), 1u);
+    return jobs;
+}
@@ -0,0 +1,164 @@
+#ifndef UTILS_UHJ_SUPPORT_H
+#define UTILS_UHJ_SUPPORT_H
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdio>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "alspan.h"
+
+
+/* A memory-mapped file, for reading and writing headerless 32-bit float
+ * samples (in native byte order) without going through libsndfile.
+ */
+class MappedFile {
+#ifdef _WIN32
+    void *mFile{};
+    void *mMapping{};
+#else
+    int mFd{-1};
+#endif
+    void *mData{};
+    std::size_t mSize{};
+
+    void close() noexcept;
+
+public:
+    MappedFile() = default;
+    MappedFile(MappedFile&& rhs) noexcept { *this = std::move(rhs); }
+    MappedFile(const MappedFile&) = delete;
+    ~MappedFile() { close(); }
+
+    MappedFile& operator=(MappedFile&& rhs) noexcept;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    /* Maps an existing file for reading. */
+    static auto OpenRead(const std::string &fname) -> std::optional<MappedFile>;
+    /* Creates (or truncates) a file with the given size, and maps it for
+     * writing.
+     */
+    static auto Create(const std::string &fname, std::size_t size) -> std::optional<MappedFile>;
+
+    [[nodiscard]] auto samples() const noexcept -> al::span<float>
+    { return {static_cast<float*>(mData), mSize/sizeof(float)}; }
+};
+
+
+/* A bounded queue of sample blocks, for passing samples between threads. */
+class BlockQueue {
+    std::mutex mLock;
+    std::condition_variable mCond;
+    std::deque<std::vector<float>> mBlocks;
+    std::size_t mMaxBlocks;
+    bool mClosed{false};
+
+public:
+    explicit BlockQueue(std::size_t maxblocks) : mMaxBlocks{maxblocks} { }
+
+    /* Adds a block, waiting for room. Returns false if the queue is closed. */
+    bool push(std::vector<float> block);
+    /* Removes the next block, waiting for one. Returns nullopt once the queue
+     * is closed and empty.
+     */
+    auto pop() -> std::optional<std::vector<float>>;
+    /* Stops accepting blocks, waking up any waiting threads. */
+    void close();
+};
+
+
+/* Reads input blocks on a separate thread, ahead of when they're needed. The
+ * reader function fills the given span with interleaved samples and returns
+ * the number of sample frames read, with 0 marking the end of input.
+ */
+class ReadAhead {
+public:
+    using ReaderFunc = std::function<std::size_t(al::span<float> samples)>;
+
+private:
+    BlockQueue mQueue;
+    std::thread mThread;
+
+public:
+    ReadAhead(ReaderFunc reader, std::size_t blockFrames, std::size_t channels);
+    ~ReadAhead();
+
+    /* Copies the next input block to the given span, returning the number of
+     * sample frames, or 0 at the end of input.
+     */
+    auto read(al::span<float> samples, std::size_t channels) -> std::size_t;
+};
+
+/* Writes output blocks on a separate thread. The writer function returns
+ * false if writing failed, which stops any further writes.
+ */
+class WriteBehind {
+public:
+    using WriterFunc = std::function<bool(al::span<const float> samples)>;
+
+private:
+    BlockQueue mQueue;
+    std::thread mThread;
+    bool mFailed{false};
+
+public:
+    explicit WriteBehind(WriterFunc writer);
+    ~WriteBehind();
+
+    /* Queues the given samples to be written. Returns false if a previous
+     * write failed.
+     */
+    bool write(al::span<const float> samples);
+
+    /* Waits for all queued samples to be written, returning false if any
+     * failed.
+     */
+    bool finish();
+};
+
+
+/* Collects the messages for one file being processed, so files processed in
+ * parallel don't have their messages interleaved.
+ */
+class MessageLog {
+    std::vector<std::pair<FILE*,std::string>> mMessages;
+
+public:
+#ifdef __MINGW32__
+    [[gnu::format(__MINGW_PRINTF_FORMAT,3,4)]]
+#else
+    [[gnu::format(printf,3,4)]]
+#endif
+    void add(FILE *stream, const char *fmt, ...);
+
+    /* Prints and clears the collected messages. */
+    void flush();
+};
+
+
+/* Calls func for each index from 0 to count-1, using up to numThreads
+ * threads.
+ */
+void ForEachParallel(std::size_t count, unsigned int numThreads,
+    const std::function<void(std::size_t idx)> &func);
+
+/* Groups the indices of equal names together, in order of each name's first
+ * appearance. Jobs writing the same output file can then be run one after
+ * another instead of at the same time.
+ */
+auto GroupByName(al::span<const std::string> names) -> std::vector<std::vector<std::size_t>>;
+
+/* Parses a --jobs=N option value, returning the number of threads to use.
+ * Defaults to the number of hardware threads if the value is 0.
+ */
+auto ParseJobCount(std::string_view value) -> std::optional<unsigned int>;
+
+#endif /* UTILS_UHJ_SUPPORT_H */
@@ -26,16 +26,20 @@
 
 #include <algorithm>
 #include <array>
+#include <atomic>
 #include <cassert>
 #include <cerrno>
 #include <complex>
 #include <cstddef>
 #include <cstdio>
+#include <iterator>
 #include <cstring>
 #include <memory>
+#include <optional>
 #include <string>
 #include <string_view>
 #include <system_error>
+#include <thread>
 #include <utility>
 #include <vector>
 
@@ -47,6 +51,7 @@
 #include "vector.h"
 #include "opthelpers.h"
 #include "phase_shifter.h"
+#include "uhj-support.h"
 
 #include "sndfile.h"
 
@@ -348,79 +353,103 @@ void UhjDecoder::decode2(const al::span<const float> InSamples,
 }
 
 
-int main(al::span<std::string_view> args)
+struct DecodeJob {
+    std::string_view mInName;
+    std::string mOutName;
+    bool mUseGeneral;
+    uint mRawChannels;
+};
+
+auto GetOutputName(const std::string_view inname, const uint rawchans) -> std::string
 {
-    if(args.size() < 2 || args[1] == "-h" || args[1] == "--help")
-    {
-        printf("Usage: %.*s <[options] filename.wav...>\n\n"
-            "  Options:\n"
-            "    --general      Use the general equations for 2-channel UHJ (default).\n"
-            "    --alternative  Use the alternative equations for 2-channel UHJ.\n"
-            "\n"
-            "Note: When decoding 2-channel UHJ to an .amb file, the result should not use\n"
-            "the normal B-Format shelf filters! Only 3- and 4-channel UHJ can accurately\n"
-            "reconstruct the original B-Format signal.",
-            al::sizei(args[0]), args[0].data());
-        return 1;
-    }
+    std::string outname{inname};
+    auto lastslash = outname.find_last_of('/');
+    if(lastslash != std::string::npos)
+        outname.erase(0, lastslash+1);
+    auto lastdot = outname.find_last_of('.');
+    if(lastdot != std::string::npos)
+        outname.resize(lastdot+1);
+    outname += (rawchans > 0) ? "amb.raw" : "amb";
+    return outname;
+}
 
-    std::size_t num_files{0}, num_decoded{0};
-    bool use_general{true};
-    for(size_t fidx{1};fidx < args.size();++fidx)
+bool DecodeFile(const DecodeJob &job, MessageLog &log)
+{
+    const std::string_view arg{job.mInName};
+    const bool use_general{job.mUseGeneral};
+
+    SF_INFO ininfo{};
+    SndFilePtr infile;
+    std::optional<MappedFile> rawin;
+    if(job.mRawChannels > 0)
     {
-        if(args[fidx] == "--general")
-        {
-            use_general = true;
-            continue;
-        }
-        if(args[fidx] == "--alternative")
+        rawin = MappedFile::OpenRead(std::string{arg});
+        if(!rawin)
         {
-            use_general = false;
-            continue;
+            log.add(stderr, "Failed to open %.*s\n", al::sizei(arg), arg.data());
+            return false;
         }
-        ++num_files;
-        SF_INFO ininfo{};
-        SndFilePtr infile{sf_open(std::string{args[fidx]}.c_str(), SFM_READ, &ininfo)};
+        const std::size_t numsamples{rawin->samples().size()};
+        ininfo.channels = static_cast<int>(job.mRawChannels);
+        ininfo.frames = static_cast<sf_count_t>(numsamples / job.mRawChannels);
+        if((numsamples%job.mRawChannels) != 0)
+            log.add(stderr, "Ignoring %zu trailing samples in %.*s\n",
+                numsamples%job.mRawChannels, al::sizei(arg), arg.data());
+    }
+    else
+    {
+        infile = SndFilePtr{sf_open(std::string{arg}.c_str(), SFM_READ, &ininfo)};
         if(!infile)
         {
-            fprintf(stderr, "Failed to open %.*s\n", al::sizei(args[fidx]), args[fidx].data());
-            continue;
+            log.add(stderr, "Failed to open %.*s\n", al::sizei(arg), arg.data());
+            return false;
         }
-        if(sf_command(infile.get(), SFC_WAVEX_GET_AMBISONIC, nullptr, 0) == SF_AMBISONIC_B_FORMAT)
+        if(sf_command(infile.get(), SFC_WAVEX_GET_AMBISONIC, nullptr, 0)
+            == SF_AMBISONIC_B_FORMAT)
         {
-            fprintf(stderr, "%.*s is already B-Format\n", al::sizei(args[fidx]),
-                args[fidx].data());
-            continue;
+            log.add(stderr, "%.*s is already B-Format\n", al::sizei(arg), arg.data());
+            return false;
         }
-        uint outchans{};
-        if(ininfo.channels == 2)
-            outchans = 3;
-        else if(ininfo.channels == 3 || ininfo.channels == 4)
-            outchans = static_cast<uint>(ininfo.channels);
-        else
+    }
+    uint outchans{};
+    if(ininfo.channels == 2)
+        outchans = 3;
+    else if(ininfo.channels == 3 || ininfo.channels == 4)
+        outchans = static_cast<uint>(ininfo.channels);
+    else
+    {
+        log.add(stderr, "%.*s is not a 2-, 3-, or 4-channel file\n", al::sizei(arg), arg.data());
+        return false;
+    }
+    log.add(stdout, "Converting %.*s from %d-channel UHJ%s...\n", al::sizei(arg), arg.data(),
+        ininfo.channels,
+        (ininfo.channels == 2) ? use_general ? " (general)" : " (alternative)" : "");
+
+    const std::string &outname{job.mOutName};
+
+    const auto inchans = static_cast<uint>(ininfo.channels);
+    const auto numframes = static_cast<std::size_t>(ininfo.frames);
+
+    FilePtr outfile;
+    std::optional<MappedFile> rawout;
+    long DataStart{};
+    if(rawin)
+    {
+        /* The decoder outputs as many sample frames as it takes in. */
+        rawout = MappedFile::Create(outname, numframes*outchans*sizeof(float));
+        if(!rawout)
         {
-            fprintf(stderr, "%.*s is not a 2-, 3-, or 4-channel file\n", al::sizei(args[fidx]),
-                args[fidx].data());
-            continue;
+            log.add(stderr, "Failed to create %s\n", outname.c_str());
+            return false;
         }
-        printf("Converting %.*s from %d-channel UHJ%s...\n", al::sizei(args[fidx]),
-            args[fidx].data(), ininfo.channels,
-            (ininfo.channels == 2) ? use_general ? " (general)" : " (alternative)" : "");
-
-        std::string outname{args[fidx]};
-        auto lastslash = outname.find_last_of('/');
-        if(lastslash != std::string::npos)
-            outname.erase(0, lastslash+1);
-        auto lastdot = outname.find_last_of('.');
-        if(lastdot != std::string::npos)
-            outname.resize(lastdot+1);
-        outname += "amb";
-
-        FilePtr outfile{fopen(outname.c_str(), "wb")};
+    }
+    else
+    {
+        outfile = FilePtr{fopen(outname.c_str(), "wb")};
         if(!outfile)
         {
-            fprintf(stderr, "Failed to create %s\n", outname.c_str());
-            continue;
+            log.add(stderr, "Failed to create %s\n", outname.c_str());
+            return false;
         }
 
         fputs("RIFF", outfile.get());
@@ -456,67 +485,123 @@ int main(al::span<std::string_view> args)
         fwrite32le(0xFFFFFFFF, outfile.get()); // 'data' header len; filled in at close
         if(ferror(outfile.get()))
         {
-            fprintf(stderr, "Error writing wave file header: %s (%d)\n",
+            log.add(stderr, "Error writing wave file header: %s (%d)\n",
                 std::generic_category().message(errno).c_str(), errno);
-            continue;
+            return false;
         }
 
-        auto DataStart = ftell(outfile.get());
-
-        auto decoder = std::make_unique<UhjDecoder>();
-        auto inmem = std::vector<float>(size_t{BufferLineSize}*static_cast<uint>(ininfo.channels));
-        auto decmem = al::vector<std::array<float,BufferLineSize>, 16>(outchans);
-        auto outmem = std::vector<byte4>(size_t{BufferLineSize}*outchans);
-
-        /* A number of initial samples need to be skipped to cut the lead-in
-         * from the all-pass filter delay. The same number of samples need to
-         * be fed through the decoder after reaching the end of the input file
-         * to ensure none of the original input is lost.
-         */
-        std::size_t LeadIn{UhjDecoder::sFilterDelay};
-        sf_count_t LeadOut{UhjDecoder::sFilterDelay};
-        while(LeadOut > 0)
+        DataStart = ftell(outfile.get());
+    }
+
+    /* Input is read ahead and output is written behind on their own threads,
+     * so file I/O and decompression overlap with decoding.
+     */
+    auto reader = ReadAhead::ReaderFunc{};
+    if(rawin)
+        reader = [insamples=rawin->samples().first(numframes*inchans),inchans,
+            pos=std::size_t{0}](al::span<float> samples) mutable -> std::size_t
+        {
+            const auto todo = std::min(samples.size(), insamples.size()-pos) / inchans;
+            std::copy_n(insamples.begin()+ptrdiff_t(pos), todo*inchans, samples.begin());
+            pos += todo*inchans;
+            return todo;
+        };
+    else
+        reader = [sndfile=infile.get(),inchans](al::span<float> samples) -> std::size_t
         {
-            sf_count_t sgot{sf_readf_float(infile.get(), inmem.data(), BufferLineSize)};
-            sgot = std::max<sf_count_t>(sgot, 0);
-            if(sgot < BufferLineSize)
+            const auto sgot = sf_readf_float(sndfile, samples.data(),
+                static_cast<sf_count_t>(samples.size()/inchans));
+            return static_cast<std::size_t>(std::max<sf_count_t>(sgot, 0));
+        };
+
+    int write_error{0};
+    auto writer = WriteBehind::WriterFunc{};
+    if(rawout)
+        writer = [outsamples=rawout->samples(),pos=std::size_t{0}](
+            al::span<const float> samples) mutable -> bool
+        {
+            if(samples.size() > outsamples.size()-pos)
+                return false;
+            std::copy(samples.begin(), samples.end(), outsamples.begin()+ptrdiff_t(pos));
+            pos += samples.size();
+            return true;
+        };
+    else
+        writer = [file=outfile.get(),&write_error,outmem=std::vector<byte4>{}](
+            al::span<const float> samples) mutable -> bool
+        {
+            outmem.resize(samples.size());
+            std::transform(samples.begin(), samples.end(), outmem.begin(), f32AsLEBytes);
+            const std::size_t wrote{fwrite(outmem.data(), sizeof(byte4), outmem.size(), file)};
+            if(wrote < outmem.size())
             {
-                const sf_count_t remaining{std::min(BufferLineSize - sgot, LeadOut)};
-                std::fill_n(inmem.begin() + sgot*ininfo.channels, remaining*ininfo.channels, 0.0f);
-                sgot += remaining;
-                LeadOut -= remaining;
+                write_error = errno;
+                return false;
             }
+            return true;
+        };
 
-            auto got = static_cast<std::size_t>(sgot);
-            if(ininfo.channels > 2 || use_general)
-                decoder->decode(inmem, static_cast<uint>(ininfo.channels), decmem, got);
-            else
-                decoder->decode2(inmem, decmem, got);
-            if(LeadIn >= got)
-            {
-                LeadIn -= got;
-                continue;
-            }
+    auto input = ReadAhead{std::move(reader), BufferLineSize, inchans};
+    auto output = WriteBehind{std::move(writer)};
 
-            got -= LeadIn;
-            for(std::size_t i{0};i < got;++i)
-            {
-                /* Attenuate by -3dB for FuMa output levels. */
-                constexpr auto inv_sqrt2 = static_cast<float>(1.0/al::numbers::sqrt2);
-                for(std::size_t j{0};j < outchans;++j)
-                    outmem[i*outchans + j] = f32AsLEBytes(decmem[j][LeadIn+i] * inv_sqrt2);
-            }
-            LeadIn = 0;
+    auto decoder = std::make_unique<UhjDecoder>();
+    auto inmem = std::vector<float>(std::size_t{BufferLineSize}*inchans);
+    auto decmem = al::vector<std::array<float,BufferLineSize>, 16>(outchans);
+    auto outmem = std::vector<float>(std::size_t{BufferLineSize}*outchans);
 
-            std::size_t wrote{fwrite(outmem.data(), sizeof(byte4)*outchans, got, outfile.get())};
-            if(wrote < got)
-            {
-                fprintf(stderr, "Error writing wave data: %s (%d)\n",
-                    std::generic_category().message(errno).c_str(), errno);
-                break;
-            }
+    /* A number of initial samples need to be skipped to cut the lead-in from
+     * the all-pass filter delay. The same number of samples need to be fed
+     * through the decoder after reaching the end of the input file to ensure
+     * none of the original input is lost.
+     */
+    std::size_t LeadIn{UhjDecoder::sFilterDelay};
+    sf_count_t LeadOut{UhjDecoder::sFilterDelay};
+    while(LeadOut > 0)
+    {
+        auto sgot = static_cast<sf_count_t>(input.read(inmem, inchans));
+        if(sgot < BufferLineSize)
+        {
+            const sf_count_t remaining{std::min(BufferLineSize - sgot, LeadOut)};
+            std::fill_n(inmem.begin() + sgot*ininfo.channels, remaining*ininfo.channels, 0.0f);
+            sgot += remaining;
+            LeadOut -= remaining;
         }
 
+        auto got = static_cast<std::size_t>(sgot);
+        if(ininfo.channels > 2 || use_general)
+            decoder->decode(inmem, inchans, decmem, got);
+        else
+            decoder->decode2(inmem, decmem, got);
+        if(LeadIn >= got)
+        {
+            LeadIn -= got;
+            continue;
+        }
+
+        got -= LeadIn;
+        for(std::size_t i{0};i < got;++i)
+        {
+            /* Attenuate by -3dB for FuMa output levels. */
+            constexpr auto inv_sqrt2 = static_cast<float>(1.0/al::numbers::sqrt2);
+            for(std::size_t j{0};j < outchans;++j)
+                outmem[i*outchans + j] = decmem[j][LeadIn+i] * inv_sqrt2;
+        }
+        LeadIn = 0;
+
+        if(!output.write(al::span{outmem}.first(got*outchans)))
+            break;
+    }
+    if(!output.finish())
+    {
+        if(outfile)
+            log.add(stderr, "Error writing wave data: %s (%d)\n",
+                std::generic_category().message(write_error).c_str(), write_error);
+        else
+            log.add(stderr, "Error writing raw data\n");
+    }
+
+    if(outfile)
+    {
         auto DataEnd = ftell(outfile.get());
         if(DataEnd > DataStart)
         {
@@ -527,14 +612,110 @@ int main(al::span<std::string_view> args)
                 fwrite32le(static_cast<uint>(dataLen), outfile.get()); // 'data' header len
         }
         fflush(outfile.get());
-        ++num_decoded;
     }
+    return true;
+}
+
+
+int main(al::span<std::string_view> args)
+{
+    if(args.size() < 2 || args[1] == "-h" || args[1] == "--help")
+    {
+        printf("Usage: %.*s <[options] filename.wav...>\n\n"
+            "  Options:\n"
+            "    --general      Use the general equations for 2-channel UHJ (default).\n"
+            "    --alternative  Use the alternative equations for 2-channel UHJ.\n"
+            "    --raw=N        Read the following files as headerless 32-bit float samples\n"
+            "                   with N (2, 3, or 4) interleaved UHJ channels, in native byte\n"
+            "                   order, and write the same as .amb.raw files. 0 reads files\n"
+            "                   normally (default).\n"
+            "    --jobs=N       Decode up to N files at once. 0 uses one per CPU (default).\n"
+            "\n"
+            "Note: When decoding 2-channel UHJ to an .amb file, the result should not use\n"
+            "the normal B-Format shelf filters! Only 3- and 4-channel UHJ can accurately\n"
+            "reconstruct the original B-Format signal.",
+            al::sizei(args[0]), args[0].data());
+        return 1;
+    }
+
+    bool use_general{true};
+    uint rawchans{0};
+    uint numjobs{std::max(std::thread::hardware_concurrency(), 1u)};
+    std::vector<DecodeJob> jobs;
+    for(size_t fidx{1};fidx < args.size();++fidx)
+    {
+        if(args[fidx] == "--general")
+        {
+            use_general = true;
+            continue;
+        }
+        if(args[fidx] == "--alternative")
+        {
+            use_general = false;
+            continue;
+        }
+        if(args[fidx].substr(0, 7) == "--jobs=")
+        {
+            const auto jobcount = ParseJobCount(args[fidx].substr(7));
+            if(!jobcount)
+            {
+                fprintf(stderr, "Invalid job count: %.*s\n", al::sizei(args[fidx]),
+                    args[fidx].data());
+                return 1;
+            }
+            numjobs = *jobcount;
+            continue;
+        }
+        if(args[fidx].substr(0, 6) == "--raw=")
+        {
+            const auto rawarg = args[fidx].substr(6);
+            if(rawarg != "0" && rawarg != "2" && rawarg != "3" && rawarg != "4")
+            {
+                fprintf(stderr, "Invalid raw channel count: %.*s\n", al::sizei(args[fidx]),
+                    args[fidx].data());
+                return 1;
+            }
+            rawchans = static_cast<uint>(rawarg[0] - '0');
+            continue;
+        }
+        jobs.emplace_back(DecodeJob{args[fidx], GetOutputName(args[fidx], rawchans), use_general,
+            rawchans});
+    }
+
+    /* Inputs that would write the same output file are decoded one after
+     * another, so the last one wins as it would without --jobs.
+     */
+    std::vector<std::string> outnames;
+    outnames.reserve(jobs.size());
+    std::transform(jobs.cbegin(), jobs.cend(), std::back_inserter(outnames),
+        [](const DecodeJob &job) { return job.mOutName; });
+    const auto groups = GroupByName(outnames);
+    for(const auto &group : groups)
+    {
+        if(group.size() > 1)
+            fprintf(stderr, "Warning: %zu inputs write to %s, decoding them in order\n",
+                group.size(), jobs[group.front()].mOutName.c_str());
+    }
+
+    std::atomic<std::size_t> num_decoded{0};
+    ForEachParallel(groups.size(), numjobs, [&jobs,&groups,&num_decoded](const std::size_t gidx)
+    {
+        for(const std::size_t idx : groups[gidx])
+        {
+            auto log = MessageLog{};
+            if(DecodeFile(jobs[idx], log))
+                ++num_decoded;
+            log.flush();
+        }
+    });
+
+    const std::size_t num_files{jobs.size()};
     if(num_decoded == 0)
         fprintf(stderr, "Failed to decode any input files\n");
     else if(num_decoded < num_files)
-        fprintf(stderr, "Decoded %zu of %zu files\n", num_decoded, num_files);
+        fprintf(stderr, "Decoded %zu of %zu files\n", num_decoded.load(), num_files);
     else
-        printf("Decoded %zu file%s\n", num_decoded, (num_decoded==1)?"":"s");
+        printf("Decoded %zu file%s\n", num_decoded.load(), (num_decoded==1)?"":"s");
     return 0;
 }
 
@@ -26,20 +26,25 @@
 
 #include <algorithm>
 #include <array>
+#include <atomic>
 #include <cassert>
 #include <cinttypes>
 #include <cmath>
 #include <cstddef>
 #include <cstdio>
+#include <iterator>
 #include <memory>
+#include <optional>
 #include <string>
 #include <string_view>
+#include <thread>
 #include <vector>
 
 #include "alnumbers.h"
 #include "alspan.h"
 #include "alstring.h"
 #include "phase_shifter.h"
+#include "uhj-support.h"
 #include "vector.h"
 
 #include "sndfile.h"
@@ -247,337 +252,493 @@ constexpr auto GenCoeffs(double x /*+front*/, double y /*+left*/, double z /*+up
 }
 
 
-int main(al::span<std::string_view> args)
+struct EncodeJob {
+    std::string_view mInName;
+    std::string mOutName;
+    uint mUhjChans;
+    uint mRawChannels;
+};
+
+auto GetOutputName(const std::string_view inname, const uint rawchans) -> std::string
 {
-    if(args.size() < 2 || args[1] == "-h" || args[1] == "--help")
-    {
-        printf("Usage: %.*s <[options] infile...>\n\n"
-            "  Options:\n"
-            "    -bhj  Encode 2-channel UHJ, aka \"BJH\" (default).\n"
-            "    -thj  Encode 3-channel UHJ, aka \"TJH\".\n"
-            "    -phj  Encode 4-channel UHJ, aka \"PJH\".\n"
-            "\n"
-            "3-channel UHJ supplements 2-channel UHJ with an extra channel that allows full\n"
-            "reconstruction of first-order 2D ambisonics. 4-channel UHJ supplements 3-channel\n"
-            "UHJ with an extra channel carrying height information, providing for full\n"
-            "reconstruction of first-order 3D ambisonics.\n"
-            "\n"
-            "Note: The third and fourth channels should be ignored if they're not being\n"
-            "decoded. Unlike the first two channels, they are not designed for undecoded\n"
-            "playback, so the resulting files will not play correctly if this isn't handled.\n",
-            al::sizei(args[0]), args[0].data());
-        return 1;
-    }
-    args = args.subspan(1);
+    auto outname = std::string{inname};
+    const auto lastslash = outname.rfind('/');
+    if(lastslash != std::string::npos)
+        outname.erase(0, lastslash+1);
+    const auto extpos = outname.rfind('.');
+    if(extpos != std::string::npos)
+        outname.resize(extpos);
+    outname += (rawchans > 0) ? ".uhj.raw" : ".uhj.flac";
+    return outname;
+}
 
-    uint uhjchans{2};
-    size_t num_files{0}, num_encoded{0};
-    auto process_arg = [&uhjchans,&num_files,&num_encoded](std::string_view arg) -> void
+bool EncodeFile(const EncodeJob &job, MessageLog &log)
+{
+    const std::string_view arg{job.mInName};
+    const uint uhjchans{job.mUhjChans};
+
+    const std::string &outname{job.mOutName};
+
+    SF_INFO ininfo{};
+    SndFilePtr infile;
+    std::optional<MappedFile> rawin;
+    if(job.mRawChannels > 0)
     {
-        if(arg == "-bhj"sv)
+        rawin = MappedFile::OpenRead(std::string{arg});
+        if(!rawin)
         {
-            uhjchans = 2;
-            return;
+            log.add(stderr, "Failed to open %.*s\n", al::sizei(arg), arg.data());
+            return false;
         }
-        if(arg == "-thj"sv)
+        const size_t numsamples{rawin->samples().size()};
+        ininfo.channels = static_cast<int>(job.mRawChannels);
+        ininfo.frames = static_cast<sf_count_t>(numsamples / job.mRawChannels);
+        if((numsamples%job.mRawChannels) != 0)
+            log.add(stderr, " ... ignoring %zu trailing samples\n", numsamples%job.mRawChannels);
+    }
+    else
+    {
+        infile = SndFilePtr{sf_open(std::string{arg}.c_str(), SFM_READ, &ininfo)};
+        if(!infile)
         {
-            uhjchans = 3;
-            return;
+            log.add(stderr, "Failed to open %.*s\n", al::sizei(arg), arg.data());
+            return false;
         }
-        if(arg == "-phj"sv)
+    }
+    log.add(stdout, "Converting %.*s to %s...\n", al::sizei(arg), arg.data(), outname.c_str());
+
+    /* Work out the channel map, preferably using the actual channel map from
+     * the file/format, but falling back to assuming WFX order. Raw input has
+     * no channel map, and 3- or 4-channel raw input is taken as FuMa B-Format.
+     */
+    al::span<const SpeakerPos> spkrs;
+    auto chanmap = std::vector<int>(static_cast<uint>(ininfo.channels), SF_CHANNEL_MAP_INVALID);
+    if(infile && sf_command(infile.get(), SFC_GET_CHANNEL_MAP_INFO, chanmap.data(),
+        ininfo.channels*int{sizeof(int)}) == SF_TRUE)
+    {
+        static const std::array<int,1> monomap{{SF_CHANNEL_MAP_CENTER}};
+        static const std::array<int,2> stereomap{{SF_CHANNEL_MAP_LEFT, SF_CHANNEL_MAP_RIGHT}};
+        static const std::array<int,4> quadmap{{SF_CHANNEL_MAP_LEFT, SF_CHANNEL_MAP_RIGHT,
+            SF_CHANNEL_MAP_REAR_LEFT, SF_CHANNEL_MAP_REAR_RIGHT}};
+        static const std::array<int,6> x51map{{SF_CHANNEL_MAP_LEFT, SF_CHANNEL_MAP_RIGHT,
+            SF_CHANNEL_MAP_CENTER, SF_CHANNEL_MAP_LFE,
+            SF_CHANNEL_MAP_SIDE_LEFT, SF_CHANNEL_MAP_SIDE_RIGHT}};
+        static const std::array<int,6> x51rearmap{{SF_CHANNEL_MAP_LEFT, SF_CHANNEL_MAP_RIGHT,
+            SF_CHANNEL_MAP_CENTER, SF_CHANNEL_MAP_LFE,
+            SF_CHANNEL_MAP_REAR_LEFT, SF_CHANNEL_MAP_REAR_RIGHT}};
+        static const std::array<int,8> x71map{{SF_CHANNEL_MAP_LEFT, SF_CHANNEL_MAP_RIGHT,
+            SF_CHANNEL_MAP_CENTER, SF_CHANNEL_MAP_LFE,
+            SF_CHANNEL_MAP_REAR_LEFT, SF_CHANNEL_MAP_REAR_RIGHT,
+            SF_CHANNEL_MAP_SIDE_LEFT, SF_CHANNEL_MAP_SIDE_RIGHT}};
+        static const std::array<int,12> x714map{{SF_CHANNEL_MAP_LEFT, SF_CHANNEL_MAP_RIGHT,
+            SF_CHANNEL_MAP_CENTER, SF_CHANNEL_MAP_LFE,
+            SF_CHANNEL_MAP_REAR_LEFT, SF_CHANNEL_MAP_REAR_RIGHT,
+            SF_CHANNEL_MAP_SIDE_LEFT, SF_CHANNEL_MAP_SIDE_RIGHT,
+            SF_CHANNEL_MAP_TOP_FRONT_LEFT, SF_CHANNEL_MAP_TOP_FRONT_RIGHT,
+            SF_CHANNEL_MAP_TOP_REAR_LEFT, SF_CHANNEL_MAP_TOP_REAR_RIGHT}};
+        static const std::array<int,3> ambi2dmap{{SF_CHANNEL_MAP_AMBISONIC_B_W,
+            SF_CHANNEL_MAP_AMBISONIC_B_X, SF_CHANNEL_MAP_AMBISONIC_B_Y}};
+        static const std::array<int,4> ambi3dmap{{SF_CHANNEL_MAP_AMBISONIC_B_W,
+            SF_CHANNEL_MAP_AMBISONIC_B_X, SF_CHANNEL_MAP_AMBISONIC_B_Y,
+            SF_CHANNEL_MAP_AMBISONIC_B_Z}};
+
+        auto match_chanmap = [](const al::span<int> a, const al::span<const int> b) -> bool
         {
-            uhjchans = 4;
-            return;
-        }
-        ++num_files;
-
-        auto outname = std::string{arg};
-        const auto lastslash = outname.rfind('/');
-        if(lastslash != std::string::npos)
-            outname.erase(0, lastslash+1);
-        const auto extpos = outname.rfind('.');
-        if(extpos != std::string::npos)
-            outname.resize(extpos);
-        outname += ".uhj.flac";
-
-        SF_INFO ininfo{};
-        SndFilePtr infile{sf_open(std::string{arg}.c_str(), SFM_READ, &ininfo)};
-        if(!infile)
+            if(a.size() != b.size())
+                return false;
+            auto find_channel = [b](const int id) -> bool
+            { return std::find(b.begin(), b.end(), id) != b.end(); };
+            return std::all_of(a.cbegin(), a.cend(), find_channel);
+        };
+        if(match_chanmap(chanmap, monomap))
+            spkrs = MonoMap;
+        else if(match_chanmap(chanmap, stereomap))
+            spkrs = StereoMap;
+        else if(match_chanmap(chanmap, quadmap))
+            spkrs = QuadMap;
+        else if(match_chanmap(chanmap, x51map))
+            spkrs = X51Map;
+        else if(match_chanmap(chanmap, x51rearmap))
+            spkrs = X51RearMap;
+        else if(match_chanmap(chanmap, x71map))
+            spkrs = X71Map;
+        else if(match_chanmap(chanmap, x714map))
+            spkrs = X714Map;
+        else if(match_chanmap(chanmap, ambi2dmap) || match_chanmap(chanmap, ambi3dmap))
         {
-            fprintf(stderr, "Failed to open %.*s\n", al::sizei(arg), arg.data());
-            return;
+            /* Do nothing. */
         }
-        printf("Converting %.*s to %s...\n", al::sizei(arg), arg.data(), outname.c_str());
-
-        /* Work out the channel map, preferably using the actual channel map
-         * from the file/format, but falling back to assuming WFX order.
-         */
-        al::span<const SpeakerPos> spkrs;
-        auto chanmap = std::vector<int>(static_cast<uint>(ininfo.channels), SF_CHANNEL_MAP_INVALID);
-        if(sf_command(infile.get(), SFC_GET_CHANNEL_MAP_INFO, chanmap.data(),
-            ininfo.channels*int{sizeof(int)}) == SF_TRUE)
+        else
         {
-            static const std::array<int,1> monomap{{SF_CHANNEL_MAP_CENTER}};
-            static const std::array<int,2> stereomap{{SF_CHANNEL_MAP_LEFT, SF_CHANNEL_MAP_RIGHT}};
-            static const std::array<int,4> quadmap{{SF_CHANNEL_MAP_LEFT, SF_CHANNEL_MAP_RIGHT,
-                SF_CHANNEL_MAP_REAR_LEFT, SF_CHANNEL_MAP_REAR_RIGHT}};
-            static const std::array<int,6> x51map{{SF_CHANNEL_MAP_LEFT, SF_CHANNEL_MAP_RIGHT,
-                SF_CHANNEL_MAP_CENTER, SF_CHANNEL_MAP_LFE,
-                SF_CHANNEL_MAP_SIDE_LEFT, SF_CHANNEL_MAP_SIDE_RIGHT}};
-            static const std::array<int,6> x51rearmap{{SF_CHANNEL_MAP_LEFT, SF_CHANNEL_MAP_RIGHT,
-                SF_CHANNEL_MAP_CENTER, SF_CHANNEL_MAP_LFE,
-                SF_CHANNEL_MAP_REAR_LEFT, SF_CHANNEL_MAP_REAR_RIGHT}};
-            static const std::array<int,8> x71map{{SF_CHANNEL_MAP_LEFT, SF_CHANNEL_MAP_RIGHT,
-                SF_CHANNEL_MAP_CENTER, SF_CHANNEL_MAP_LFE,
-                SF_CHANNEL_MAP_REAR_LEFT, SF_CHANNEL_MAP_REAR_RIGHT,
-                SF_CHANNEL_MAP_SIDE_LEFT, SF_CHANNEL_MAP_SIDE_RIGHT}};
-            static const std::array<int,12> x714map{{SF_CHANNEL_MAP_LEFT, SF_CHANNEL_MAP_RIGHT,
-                SF_CHANNEL_MAP_CENTER, SF_CHANNEL_MAP_LFE,
-                SF_CHANNEL_MAP_REAR_LEFT, SF_CHANNEL_MAP_REAR_RIGHT,
-                SF_CHANNEL_MAP_SIDE_LEFT, SF_CHANNEL_MAP_SIDE_RIGHT,
-                SF_CHANNEL_MAP_TOP_FRONT_LEFT, SF_CHANNEL_MAP_TOP_FRONT_RIGHT,
-                SF_CHANNEL_MAP_TOP_REAR_LEFT, SF_CHANNEL_MAP_TOP_REAR_RIGHT}};
-            static const std::array<int,3> ambi2dmap{{SF_CHANNEL_MAP_AMBISONIC_B_W,
-                SF_CHANNEL_MAP_AMBISONIC_B_X, SF_CHANNEL_MAP_AMBISONIC_B_Y}};
-            static const std::array<int,4> ambi3dmap{{SF_CHANNEL_MAP_AMBISONIC_B_W,
-                SF_CHANNEL_MAP_AMBISONIC_B_X, SF_CHANNEL_MAP_AMBISONIC_B_Y,
-                SF_CHANNEL_MAP_AMBISONIC_B_Z}};
-
-            auto match_chanmap = [](const al::span<int> a, const al::span<const int> b) -> bool
+            std::string mapstr;
+            if(!chanmap.empty())
             {
-                if(a.size() != b.size())
-                    return false;
-                auto find_channel = [b](const int id) -> bool
-                { return std::find(b.begin(), b.end(), id) != b.end(); };
-                return std::all_of(a.cbegin(), a.cend(), find_channel);
-            };
-            if(match_chanmap(chanmap, monomap))
-                spkrs = MonoMap;
-            else if(match_chanmap(chanmap, stereomap))
-                spkrs = StereoMap;
-            else if(match_chanmap(chanmap, quadmap))
-                spkrs = QuadMap;
-            else if(match_chanmap(chanmap, x51map))
-                spkrs = X51Map;
-            else if(match_chanmap(chanmap, x51rearmap))
-                spkrs = X51RearMap;
-            else if(match_chanmap(chanmap, x71map))
-                spkrs = X71Map;
-            else if(match_chanmap(chanmap, x714map))
-                spkrs = X714Map;
-            else if(match_chanmap(chanmap, ambi2dmap) || match_chanmap(chanmap, ambi3dmap))
-            {
-                /* Do nothing. */
-            }
-            else
-            {
-                std::string mapstr;
-                if(!chanmap.empty())
+                mapstr = std::to_string(chanmap[0]);
+                for(int idx : al::span<int>{chanmap}.subspan<1>())
                 {
-                    mapstr = std::to_string(chanmap[0]);
-                    for(int idx : al::span<int>{chanmap}.subspan<1>())
-                    {
-                        mapstr += ',';
-                        mapstr += std::to_string(idx);
-                    }
+                    mapstr += ',';
+                    mapstr += std::to_string(idx);
                 }
-                fprintf(stderr, " ... %zu channels not supported (map: %s)\n", chanmap.size(),
-                    mapstr.c_str());
-                return;
-            }
-        }
-        else if(sf_command(infile.get(), SFC_WAVEX_GET_AMBISONIC, nullptr,
-            0) == SF_AMBISONIC_B_FORMAT)
-        {
-            if(ininfo.channels == 4)
-            {
-                fprintf(stderr, " ... detected FuMa 3D B-Format\n");
-                chanmap[0] = SF_CHANNEL_MAP_AMBISONIC_B_W;
-                chanmap[1] = SF_CHANNEL_MAP_AMBISONIC_B_X;
-                chanmap[2] = SF_CHANNEL_MAP_AMBISONIC_B_Y;
-                chanmap[3] = SF_CHANNEL_MAP_AMBISONIC_B_Z;
-            }
-            else if(ininfo.channels == 3)
-            {
-                fprintf(stderr, " ... detected FuMa 2D B-Format\n");
-                chanmap[0] = SF_CHANNEL_MAP_AMBISONIC_B_W;
-                chanmap[1] = SF_CHANNEL_MAP_AMBISONIC_B_X;
-                chanmap[2] = SF_CHANNEL_MAP_AMBISONIC_B_Y;
-            }
-            else
-            {
-                fprintf(stderr, " ... unhandled %d-channel B-Format\n", ininfo.channels);
-                return;
             }
+            log.add(stderr, " ... %zu channels not supported (map: %s)\n", chanmap.size(),
+                mapstr.c_str());
+            return false;
         }
-        else if(ininfo.channels == 1)
-        {
-            fprintf(stderr, " ... assuming front-center\n");
-            spkrs = MonoMap;
-            chanmap[0] = SF_CHANNEL_MAP_CENTER;
-        }
-        else if(ininfo.channels == 2)
-        {
-            fprintf(stderr, " ... assuming WFX order stereo\n");
-            spkrs = StereoMap;
-            chanmap[0] = SF_CHANNEL_MAP_LEFT;
-            chanmap[1] = SF_CHANNEL_MAP_RIGHT;
-        }
-        else if(ininfo.channels == 6)
+    }
+    else if(infile ? (sf_command(infile.get(), SFC_WAVEX_GET_AMBISONIC, nullptr, 0)
+        == SF_AMBISONIC_B_FORMAT) : (ininfo.channels == 3 || ininfo.channels == 4))
+    {
+        if(ininfo.channels == 4)
         {
-            fprintf(stderr, " ... assuming WFX order 5.1\n");
-            spkrs = X51Map;
-            chanmap[0] = SF_CHANNEL_MAP_LEFT;
-            chanmap[1] = SF_CHANNEL_MAP_RIGHT;
-            chanmap[2] = SF_CHANNEL_MAP_CENTER;
-            chanmap[3] = SF_CHANNEL_MAP_LFE;
-            chanmap[4] = SF_CHANNEL_MAP_SIDE_LEFT;
-            chanmap[5] = SF_CHANNEL_MAP_SIDE_RIGHT;
+            log.add(stderr, " ... detected FuMa 3D B-Format\n");
+            chanmap[0] = SF_CHANNEL_MAP_AMBISONIC_B_W;
+            chanmap[1] = SF_CHANNEL_MAP_AMBISONIC_B_X;
+            chanmap[2] = SF_CHANNEL_MAP_AMBISONIC_B_Y;
+            chanmap[3] = SF_CHANNEL_MAP_AMBISONIC_B_Z;
         }
-        else if(ininfo.channels == 8)
+        else if(ininfo.channels == 3)
         {
-            fprintf(stderr, " ... assuming WFX order 7.1\n");
-            spkrs = X71Map;
-            chanmap[0] = SF_CHANNEL_MAP_LEFT;
-            chanmap[1] = SF_CHANNEL_MAP_RIGHT;
-            chanmap[2] = SF_CHANNEL_MAP_CENTER;
-            chanmap[3] = SF_CHANNEL_MAP_LFE;
-            chanmap[4] = SF_CHANNEL_MAP_REAR_LEFT;
-            chanmap[5] = SF_CHANNEL_MAP_REAR_RIGHT;
-            chanmap[6] = SF_CHANNEL_MAP_SIDE_LEFT;
-            chanmap[7] = SF_CHANNEL_MAP_SIDE_RIGHT;
+            log.add(stderr, " ... detected FuMa 2D B-Format\n");
+            chanmap[0] = SF_CHANNEL_MAP_AMBISONIC_B_W;
+            chanmap[1] = SF_CHANNEL_MAP_AMBISONIC_B_X;
+            chanmap[2] = SF_CHANNEL_MAP_AMBISONIC_B_Y;
         }
         else
         {
-            fprintf(stderr, " ... unmapped %d-channel audio not supported\n", ininfo.channels);
-            return;
+            log.add(stderr, " ... unhandled %d-channel B-Format\n", ininfo.channels);
+            return false;
         }
+    }
+    else if(ininfo.channels == 1)
+    {
+        log.add(stderr, " ... assuming front-center\n");
+        spkrs = MonoMap;
+        chanmap[0] = SF_CHANNEL_MAP_CENTER;
+    }
+    else if(ininfo.channels == 2)
+    {
+        log.add(stderr, " ... assuming WFX order stereo\n");
+        spkrs = StereoMap;
+        chanmap[0] = SF_CHANNEL_MAP_LEFT;
+        chanmap[1] = SF_CHANNEL_MAP_RIGHT;
+    }
+    else if(ininfo.channels == 6)
+    {
+        log.add(stderr, " ... assuming WFX order 5.1\n");
+        spkrs = X51Map;
+        chanmap[0] = SF_CHANNEL_MAP_LEFT;
+        chanmap[1] = SF_CHANNEL_MAP_RIGHT;
+        chanmap[2] = SF_CHANNEL_MAP_CENTER;
+        chanmap[3] = SF_CHANNEL_MAP_LFE;
+        chanmap[4] = SF_CHANNEL_MAP_SIDE_LEFT;
+        chanmap[5] = SF_CHANNEL_MAP_SIDE_RIGHT;
+    }
+    else if(ininfo.channels == 8)
+    {
+        log.add(stderr, " ... assuming WFX order 7.1\n");
+        spkrs = X71Map;
+        chanmap[0] = SF_CHANNEL_MAP_LEFT;
+        chanmap[1] = SF_CHANNEL_MAP_RIGHT;
+        chanmap[2] = SF_CHANNEL_MAP_CENTER;
+        chanmap[3] = SF_CHANNEL_MAP_LFE;
+        chanmap[4] = SF_CHANNEL_MAP_REAR_LEFT;
+        chanmap[5] = SF_CHANNEL_MAP_REAR_RIGHT;
+        chanmap[6] = SF_CHANNEL_MAP_SIDE_LEFT;
+        chanmap[7] = SF_CHANNEL_MAP_SIDE_RIGHT;
+    }
+    else
+    {
+        log.add(stderr, " ... unmapped %d-channel audio not supported\n", ininfo.channels);
+        return false;
+    }
+
+    const auto inchans = static_cast<uint>(ininfo.channels);
+    const auto numframes = static_cast<size_t>(ininfo.frames);
 
+    SndFilePtr outfile;
+    std::optional<MappedFile> rawout;
+    if(rawin)
+    {
+        /* The encoder outputs as many sample frames as it takes in. */
+        rawout = MappedFile::Create(outname, numframes*uhjchans*sizeof(float));
+        if(!rawout)
+        {
+            log.add(stderr, " ... failed to create %s\n", outname.c_str());
+            return false;
+        }
+    }
+    else
+    {
         SF_INFO outinfo{};
         outinfo.frames = ininfo.frames;
         outinfo.samplerate = ininfo.samplerate;
         outinfo.channels = static_cast<int>(uhjchans);
         outinfo.format = SF_FORMAT_PCM_24 | SF_FORMAT_FLAC;
-        SndFilePtr outfile{sf_open(outname.c_str(), SFM_WRITE, &outinfo)};
+        outfile = SndFilePtr{sf_open(outname.c_str(), SFM_WRITE, &outinfo)};
         if(!outfile)
         {
-            fprintf(stderr, " ... failed to create %s\n", outname.c_str());
-            return;
+            log.add(stderr, " ... failed to create %s\n", outname.c_str());
+            return false;
         }
+    }
 
-        auto encoder = std::make_unique<UhjEncoder>();
-        auto splbuf = al::vector<FloatBufferLine, 16>(9);
-        auto ambmem = al::span{splbuf}.subspan<0,4>();
-        auto encmem = al::span{splbuf}.subspan<4,4>();
-        auto srcmem = al::span{splbuf[8]};
-        auto membuf = al::vector<float,16>((static_cast<uint>(ininfo.channels)+size_t{uhjchans})
-            * BufferLineSize);
-        auto outmem = al::span{membuf}.first(size_t{BufferLineSize}*uhjchans);
-        auto inmem = al::span{membuf}.last(size_t{BufferLineSize}
-            * static_cast<uint>(ininfo.channels));
-
-        /* A number of initial samples need to be skipped to cut the lead-in
-         * from the all-pass filter delay. The same number of samples need to
-         * be fed through the encoder after reaching the end of the input file
-         * to ensure none of the original input is lost.
-         */
-        size_t total_wrote{0};
-        size_t LeadIn{UhjEncoder::sFilterDelay};
-        sf_count_t LeadOut{UhjEncoder::sFilterDelay};
-        while(LeadIn > 0 || LeadOut > 0)
+    /* Input is read ahead and output is written behind on their own threads,
+     * so file I/O and (de)compression overlap with encoding.
+     */
+    auto reader = ReadAhead::ReaderFunc{};
+    if(rawin)
+        reader = [insamples=rawin->samples().first(numframes*inchans),inchans,pos=size_t{0}](
+            al::span<float> samples) mutable -> size_t
         {
-            auto sgot = sf_readf_float(infile.get(), inmem.data(), BufferLineSize);
+            const auto todo = std::min(samples.size(), insamples.size()-pos) / inchans;
+            std::copy_n(insamples.begin()+ptrdiff_t(pos), todo*inchans, samples.begin());
+            pos += todo*inchans;
+            return todo;
+        };
+    else
+        reader = [sndfile=infile.get(),inchans](al::span<float> samples) -> size_t
+        {
+            const auto sgot = sf_readf_float(sndfile, samples.data(),
+                static_cast<sf_count_t>(samples.size()/inchans));
+            return static_cast<size_t>(std::max<sf_count_t>(sgot, 0));
+        };
+
+    size_t total_wrote{0};
+    auto writer = WriteBehind::WriterFunc{};
+    if(rawout)
+        writer = [outsamples=rawout->samples(),uhjchans,&total_wrote](
+            al::span<const float> samples) -> bool
+        {
+            const auto offset = total_wrote*uhjchans;
+            if(samples.size() > outsamples.size()-offset)
+                return false;
+            std::copy(samples.begin(), samples.end(), outsamples.begin()+ptrdiff_t(offset));
+            total_wrote += samples.size() / uhjchans;
+            return true;
+        };
+    else
+        writer = [sndfile=outfile.get(),uhjchans,&total_wrote](al::span<const float> samples)
+            -> bool
+        {
+            const auto frames = static_cast<sf_count_t>(samples.size() / uhjchans);
+            const sf_count_t wrote{sf_writef_float(sndfile, samples.data(), frames)};
+            if(wrote < 0)
+                return false;
+            total_wrote += static_cast<size_t>(wrote);
+            return wrote == frames;
+        };
+
+    auto input = ReadAhead{std::move(reader), BufferLineSize, inchans};
+    auto output = WriteBehind{std::move(writer)};
+
+    auto encoder = std::make_unique<UhjEncoder>();
+    auto splbuf = al::vector<FloatBufferLine, 16>(9);
+    auto ambmem = al::span{splbuf}.subspan<0,4>();
+    auto encmem = al::span{splbuf}.subspan<4,4>();
+    auto srcmem = al::span{splbuf[8]};
+    auto membuf = al::vector<float,16>((inchans+size_t{uhjchans}) * BufferLineSize);
+    auto outmem = al::span{membuf}.first(size_t{BufferLineSize}*uhjchans);
+    auto inmem = al::span{membuf}.last(size_t{BufferLineSize} * inchans);
+
+    /* A number of initial samples need to be skipped to cut the lead-in from
+     * the all-pass filter delay. The same number of samples need to be fed
+     * through the encoder after reaching the end of the input file to ensure
+     * none of the original input is lost.
+     */
+    size_t LeadIn{UhjEncoder::sFilterDelay};
+    sf_count_t LeadOut{UhjEncoder::sFilterDelay};
+    while(LeadIn > 0 || LeadOut > 0)
+    {
+        auto sgot = static_cast<sf_count_t>(input.read(inmem, inchans));
+        if(sgot < BufferLineSize)
+        {
+            const sf_count_t remaining{std::min(BufferLineSize - sgot, LeadOut)};
+            std::fill_n(inmem.begin() + sgot*ininfo.channels, remaining*ininfo.channels, 0.0f);
+            sgot += remaining;
+            LeadOut -= remaining;
+        }
 
-            sgot = std::max<sf_count_t>(sgot, 0);
-            if(sgot < BufferLineSize)
+        for(auto&& buf : ambmem)
+            buf.fill(0.0f);
+
+        auto got = static_cast<size_t>(sgot);
+        if(spkrs.empty())
+        {
+            /* B-Format is already in the correct order. It just needs a +3dB
+             * boost.
+             */
+            static constexpr float scale{al::numbers::sqrt2_v<float>};
+            const size_t chans{std::min<size_t>(inchans, 4u)};
+            for(size_t c{0};c < chans;++c)
             {
-                const sf_count_t remaining{std::min(BufferLineSize - sgot, LeadOut)};
-                std::fill_n(inmem.begin() + sgot*ininfo.channels, remaining*ininfo.channels, 0.0f);
-                sgot += remaining;
-                LeadOut -= remaining;
+                for(size_t i{0};i < got;++i)
+                    ambmem[c][i] = inmem[i*inchans + c] * scale;
             }
+        }
+        else for(size_t idx{0};idx < chanmap.size();++idx)
+        {
+            const int chanid{chanmap[idx]};
+            /* Skip LFE. Or mix directly into W? Or W+X? */
+            if(chanid == SF_CHANNEL_MAP_LFE)
+                continue;
 
-            for(auto&& buf : ambmem)
-                buf.fill(0.0f);
-
-            auto got = static_cast<size_t>(sgot);
-            if(spkrs.empty())
+            const auto spkr = std::find_if(spkrs.cbegin(), spkrs.cend(),
+                [chanid](const SpeakerPos pos){return pos.mChannelID == chanid;});
+            if(spkr == spkrs.cend())
             {
-                /* B-Format is already in the correct order. It just needs a
-                 * +3dB boost.
-                 */
-                static constexpr float scale{al::numbers::sqrt2_v<float>};
-                const size_t chans{std::min<size_t>(static_cast<uint>(ininfo.channels), 4u)};
-                for(size_t c{0};c < chans;++c)
-                {
-                    for(size_t i{0};i < got;++i)
-                        ambmem[c][i] = inmem[i*static_cast<uint>(ininfo.channels) + c] * scale;
-                }
+                log.add(stderr, " ... failed to find channel ID %d\n", chanid);
+                continue;
             }
-            else for(size_t idx{0};idx < chanmap.size();++idx)
-            {
-                const int chanid{chanmap[idx]};
-                /* Skip LFE. Or mix directly into W? Or W+X? */
-                if(chanid == SF_CHANNEL_MAP_LFE)
-                    continue;
-
-                const auto spkr = std::find_if(spkrs.cbegin(), spkrs.cend(),
-                    [chanid](const SpeakerPos pos){return pos.mChannelID == chanid;});
-                if(spkr == spkrs.cend())
-                {
-                    fprintf(stderr, " ... failed to find channel ID %d\n", chanid);
-                    continue;
-                }
 
+            for(size_t i{0};i < got;++i)
+                srcmem[i] = inmem[i*inchans + idx];
+
+            static constexpr auto Deg2Rad = al::numbers::pi / 180.0;
+            const auto coeffs = GenCoeffs(
+                std::cos(spkr->mAzimuth*Deg2Rad) * std::cos(spkr->mElevation*Deg2Rad),
+                std::sin(spkr->mAzimuth*Deg2Rad) * std::cos(spkr->mElevation*Deg2Rad),
+                std::sin(spkr->mElevation*Deg2Rad));
+            for(size_t c{0};c < 4;++c)
+            {
                 for(size_t i{0};i < got;++i)
-                    srcmem[i] = inmem[i*static_cast<uint>(ininfo.channels) + idx];
-
-                static constexpr auto Deg2Rad = al::numbers::pi / 180.0;
-                const auto coeffs = GenCoeffs(
-                    std::cos(spkr->mAzimuth*Deg2Rad) * std::cos(spkr->mElevation*Deg2Rad),
-                    std::sin(spkr->mAzimuth*Deg2Rad) * std::cos(spkr->mElevation*Deg2Rad),
-                    std::sin(spkr->mElevation*Deg2Rad));
-                for(size_t c{0};c < 4;++c)
-                {
-                    for(size_t i{0};i < got;++i)
-                        ambmem[c][i] += srcmem[i] * coeffs[c];
-                }
+                    ambmem[c][i] += srcmem[i] * coeffs[c];
             }
+        }
+
+        encoder->encode(encmem.subspan(0, uhjchans), ambmem, got);
+        if(LeadIn >= got)
+        {
+            LeadIn -= got;
+            continue;
+        }
+
+        got -= LeadIn;
+        for(size_t c{0};c < uhjchans;++c)
+        {
+            static constexpr float max_val{8388607.0f / 8388608.0f};
+            for(size_t i{0};i < got;++i)
+                outmem[i*uhjchans + c] = std::clamp(encmem[c][LeadIn+i], -1.0f, max_val);
+        }
+        LeadIn = 0;
+
+        if(!output.write(outmem.first(got*uhjchans)))
+            break;
+    }
+    if(!output.finish())
+    {
+        if(outfile)
+            log.add(stderr, " ... failed to write samples: %d\n", sf_error(outfile.get()));
+        else
+            log.add(stderr, " ... failed to write samples\n");
+        return false;
+    }
+    log.add(stdout, " ... wrote %zu samples (%" PRId64 ").\n", total_wrote,
+        int64_t{ininfo.frames});
+    return true;
+}
+
+
+int main(al::span<std::string_view> args)
+{
+    if(args.size() < 2 || args[1] == "-h" || args[1] == "--help")
+    {
+        printf("Usage: %.*s <[options] infile...>\n\n"
+            "  Options:\n"
+            "    -bhj      Encode 2-channel UHJ, aka \"BJH\" (default).\n"
+            "    -thj      Encode 3-channel UHJ, aka \"TJH\".\n"
+            "    -phj      Encode 4-channel UHJ, aka \"PJH\".\n"
+            "    --raw=N   Read the following files as headerless 32-bit float samples\n"
+            "              with N interleaved channels, in native byte order, and write\n"
+            "              the same as .uhj.raw files. 0 reads files normally (default).\n"
+            "    --jobs=N  Encode up to N files at once. 0 uses one per CPU (default).\n"
+            "\n"
+            "3-channel UHJ supplements 2-channel UHJ with an extra channel that allows full\n"
+            "reconstruction of first-order 2D ambisonics. 4-channel UHJ supplements 3-channel\n"
+            "UHJ with an extra channel carrying height information, providing for full\n"
+            "reconstruction of first-order 3D ambisonics.\n"
+            "\n"
+            "Raw input with 3 or 4 channels is FuMa B-Format, while 1, 2, 6, or 8 channels\n"
+            "is mono, stereo, 5.1, or 7.1 in WFX order.\n"
+            "\n"
+            "Note: The third and fourth channels should be ignored if they're not being\n"
+            "decoded. Unlike the first two channels, they are not designed for undecoded\n"
+            "playback, so the resulting files will not play correctly if this isn't handled.\n",
+            al::sizei(args[0]), args[0].data());
+        return 1;
+    }
+    args = args.subspan(1);
 
-            encoder->encode(encmem.subspan(0, uhjchans), ambmem, got);
-            if(LeadIn >= got)
+    uint uhjchans{2};
+    uint rawchans{0};
+    uint numjobs{std::max(std::thread::hardware_concurrency(), 1u)};
+    std::vector<EncodeJob> jobs;
+    for(const std::string_view arg : args)
+    {
+        if(arg == "-bhj"sv)
+            uhjchans = 2;
+        else if(arg == "-thj"sv)
+            uhjchans = 3;
+        else if(arg == "-phj"sv)
+            uhjchans = 4;
+        else if(arg.substr(0, 7) == "--jobs="sv)
+        {
+            const auto jobcount = ParseJobCount(arg.substr(7));
+            if(!jobcount)
             {
-                LeadIn -= got;
-                continue;
+                fprintf(stderr, "Invalid job count: %.*s\n", al::sizei(arg), arg.data());
+                return 1;
             }
-
-            got -= LeadIn;
-            for(size_t c{0};c < uhjchans;++c)
+            numjobs = *jobcount;
+        }
+        else if(arg.substr(0, 6) == "--raw="sv)
+        {
+            const auto rawarg = arg.substr(6);
+            if(rawarg.size() != 1 || rawarg[0] < '0' || rawarg[0] > '9')
             {
-                static constexpr float max_val{8388607.0f / 8388608.0f};
-                for(size_t i{0};i < got;++i)
-                    outmem[i*uhjchans + c] = std::clamp(encmem[c][LeadIn+i], -1.0f, max_val);
+                fprintf(stderr, "Invalid raw channel count: %.*s\n", al::sizei(arg),
+                    arg.data());
+                return 1;
             }
-            LeadIn = 0;
+            rawchans = static_cast<uint>(rawarg[0] - '0');
+        }
+        else
+            jobs.emplace_back(EncodeJob{arg, GetOutputName(arg, rawchans), uhjchans, rawchans});
+    }
 
-            sf_count_t wrote{sf_writef_float(outfile.get(), outmem.data(),
-                static_cast<sf_count_t>(got))};
-            if(wrote < 0)
-                fprintf(stderr, " ... failed to write samples: %d\n", sf_error(outfile.get()));
-            else
-                total_wrote += static_cast<size_t>(wrote);
+    /* Inputs that would write the same output file are encoded one after
+     * another, so the last one wins as it would without --jobs.
+     */
+    std::vector<std::string> outnames;
+    outnames.reserve(jobs.size());
+    std::transform(jobs.cbegin(), jobs.cend(), std::back_inserter(outnames),
+        [](const EncodeJob &job) { return job.mOutName; });
+    const auto groups = GroupByName(outnames);
+    for(const auto &group : groups)
+    {
+        if(group.size() > 1)
+            fprintf(stderr, "Warning: %zu inputs write to %s, encoding them in order\n",
+                group.size(), jobs[group.front()].mOutName.c_str());
+    }
+
+    std::atomic<size_t> num_encoded{0};
+    ForEachParallel(groups.size(), numjobs, [&jobs,&groups,&num_encoded](const size_t gidx)
+    {
+        for(const size_t idx : groups[gidx])
+        {
+            auto log = MessageLog{};
+            if(EncodeFile(jobs[idx], log))
+                ++num_encoded;
+            log.flush();
         }
-        printf(" ... wrote %zu samples (%" PRId64 ").\n", total_wrote, int64_t{ininfo.frames});
-        ++num_encoded;
-    };
-    std::for_each(args.begin(), args.end(), process_arg);
+    });
 
+    const size_t num_files{jobs.size()};
     if(num_encoded == 0)
         fprintf(stderr, "Failed to encode any input files\n");
     else if(num_encoded < num_files)
-        fprintf(stderr, "Encoded %zu of %zu files\n", num_encoded, num_files);
+        fprintf(stderr, "Encoded %zu of %zu files\n", num_encoded.load(), num_files);
     else
-        printf("Encoded %s%zu file%s\n", (num_encoded > 1) ? "all " : "", num_encoded,
+        printf("Encoded %s%zu file%s\n", (num_encoded > 1) ? "all " : "", num_encoded.load(),
             (num_encoded == 1) ? "" : "s");
     return 0;
 }